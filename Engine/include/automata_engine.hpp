@@ -76,11 +76,14 @@ Index of this file:
 #include <functional>
 // TODO: We need to check cases where we assert but ought to replace with runtime logic.
 #include <cassert>
+#include <cfloat>
 #include <tuple>
 #include <iterator>
 #include <string>
 #include <initializer_list>
 #include <mutex>
+#include <atomic>
+#include <immintrin.h>
 
 #if !defined(AUTOMATA_ENGINE_DISABLE_IMGUI)
 #include <imgui.h>
@@ -151,11 +154,38 @@ namespace automata_engine {
 
     // TODO: Types such as loaded_image_t, etc, ought to be scoped in the IO namespace.
     struct loaded_image_t;
+    struct mip_chain_t;
+    struct compressed_image_t;
     struct loaded_file_t;
     struct loaded_wav_t;
     struct raw_model_t;
+    struct loaded_mesh_t;
+    struct gltf_accessor_t;
+    struct gltf_model_t;
+    struct mesh_quantization_t;
+    struct meshlet_t;
+    struct meshlet_set_t;
+    struct mesh_lod_t;
+    struct mesh_lod_chain_t;
+    struct vertex_cache_stats_t;
+    struct archive_source_t;
+    struct audio_stream_stats_t;
     enum   update_model_t;
 
+    namespace jobs {
+        struct job_counter_t;
+    };
+
+    namespace io {
+        struct mip_options_t;
+        enum block_format_t : uint8_t;
+    };
+
+    namespace assets {
+        template <typename T> struct handle_t;
+        struct asset_usage_t;
+    };
+
     /// @brief a type for a generic game function pointer.
     typedef void (*PFN_GameFunctionKind)(game_memory_t *);
 
@@ -163,6 +193,16 @@ namespace automata_engine {
         struct transform_t;
         struct camera_t;
         struct aabb_t;
+        struct bvh_t;
+        struct bvh_node4_t;
+        struct bvh_hit_t;
+        struct frustum_t;
+        struct aabb_soa_t;
+        struct sphere_soa_t;
+        struct voxel_grid_t;
+        struct voxel_hit_t;
+        struct spatial_hash_t;
+        struct spatial_pair_t;
         struct rect_t;
         struct vec2_t;
         struct vec3_t;
@@ -420,6 +460,10 @@ namespace automata_engine {
             VkImage                       *imageOut,
             VkDeviceMemory                *memOut);
 
+        /// @brief the VkFormat of a block compressed format from io::compressImage, e.g. for createImage2D_dumb.
+        /// the levels of a compressed_image_t can be copied from a buffer as is, with no row padding.
+        VkFormat blockFormatToVkFormat(io::block_format_t format);
+
         VkShaderModule loadShaderModule(
             VkDevice vkDevice, const char *filePathIn, const WCHAR *entryPoint, const WCHAR *profile);
     }  // namespace VK
@@ -487,6 +531,15 @@ namespace automata_engine {
         /// @brief Converts a priorly parsed .OBJ into a VAO (Vertex Array Object).
         void objToVao(raw_model_t rawModel, ibo_t *iboOut, vbo_t *vboOut, GLuint *vaoOut);
 
+        /// @brief Converts a loaded .aemesh into a VAO (Vertex Array Object). attributes bind to the shader slot
+        /// given by their semantic, so this matches the slots that the raw_model_t version uses. quantized
+        /// attributes are bound as normalized, so the shader must still apply the mesh's positionScale etc.
+        void objToVao(const loaded_mesh_t &mesh, ibo_t *iboOut, vbo_t *vboOut, GLuint *vaoOut);
+
+        /// @brief Converts the position only stream of a loaded .aemesh into a VAO for depth passes. the position
+        /// binds to slot 0, and the VAO draws with the ibo from objToVao.
+        void positionStreamToVao(const loaded_mesh_t &mesh, const ibo_t &ibo, vbo_t *vboOut, GLuint *vaoOut);
+
         /// @brief Load, compile, and upload to GPU a GLSL shader program from disk.
         GLuint createShader(const char *vertFilePath, const char *fragFilePath, const char *geoFilePath = "\0");
 
@@ -502,6 +555,29 @@ namespace automata_engine {
             bool generateMips = true, GLint wrap = GL_CLAMP_TO_BORDER
         );
 
+        /// @brief Load and upload to GPU a batch of textures from disk. The images are decoded and their mips are made
+        /// on the job pool, see io::loadImages, so only the uploads happen on the calling thread.
+        /// @param texturesOut count textures. Those that failed to load are 0.
+        /// @param mipOptions  how the mips are made. nullptr for the defaults, see io::mip_options_t.
+        /// @returns the number of textures created.
+        uint32_t createTexturesFromFiles(
+            const char *const *filePaths, uint32_t count, GLuint *texturesOut, const char *cacheDir = nullptr,
+            const io::mip_options_t *mipOptions = nullptr,
+            GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR, GLint wrap = GL_CLAMP_TO_BORDER
+        );
+
+        /// @brief Upload to GPU a texture and every one of its mips. No mips are made on the GPU.
+        GLuint createTextureFromMipChain(
+            const mip_chain_t &chain,
+            GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR, GLint wrap = GL_CLAMP_TO_BORDER
+        );
+
+        /// @brief Upload to GPU a block compressed texture and every one of its levels, as is.
+        GLuint createTextureFromCompressed(
+            const compressed_image_t &image,
+            GLint minFilter = GL_LINEAR_MIPMAP_LINEAR, GLint magFilter = GL_LINEAR, GLint wrap = GL_CLAMP_TO_BORDER
+        );
+
         /// @brief Upload to GPU a texture from memory. The pixel data must be in 0xABGR (32bpp) format.
         GLuint createTexture(
             unsigned int *pixelPointer, unsigned int width, unsigned int height,
@@ -537,6 +613,28 @@ namespace automata_engine {
         float getTimeElapsed(uint64_t begin, uint64_t end);
     }
 
+    // AE job pool. a fixed set of worker threads that library routines fan work out to.
+    // the workers are started lazily on first use and stopped by shutdownModuleGlobals.
+    namespace jobs {
+        /// @brief get the number of worker threads in the pool. this excludes the calling thread.
+        uint32_t getWorkerCount();
+
+        /// @brief push a job onto the pool. the counter is incremented now and decremented once the job completes.
+        /// @param counter may be nullptr for a fire-and-forget job.
+        void submit(job_counter_t *counter, std::function<void()> job);
+
+        /// @brief block until the counter reaches zero. the calling thread executes queued jobs while it waits,
+        /// so it is safe to call this from within a job.
+        void wait(job_counter_t *counter);
+
+        /// @brief split [0, count) into ranges of at most grainSize and run fn over each range on the pool.
+        /// the calling thread participates and this call returns once every range is complete.
+        void parallelFor(uint32_t count, uint32_t grainSize, std::function<void(uint32_t begin, uint32_t end)> fn);
+
+        /// @brief NOT to be called by user.
+        void _close();
+    }  // namespace jobs
+
 // TODO(Noah): Is there any way to expose member funcs for our math stuff
 // (declare them here) so that the documentation is there for what is defined?
 
@@ -622,6 +720,125 @@ namespace automata_engine {
                                        bool *exitedEarly = nullptr,
                                        int *faceHitIdx = nullptr);
 
+        /// @brief build a BVH over an array of AABBs. primitive indices reported by queries index into boxes.
+        /// the build is a binned SAH build that runs on the job pool for large inputs. the result is a flattened
+        /// 4-wide BVH. must be freed with freeBvh.
+        bvh_t buildBvh(const aabb_t *boxes, uint32_t boxCount);
+
+        /// @brief build a BVH over the triangles of a model. primitive indices reported by queries are triangle
+        /// indices, i.e. the triangle is made of indexData[3*prim+0..2]. must be freed with freeBvh.
+        bvh_t buildBvh(raw_model_t model);
+
+        /// @brief recompute the bounds of an AABB BVH after the boxes have moved. the tree topology is kept, so
+        /// query performance degrades if the boxes move far from where they were at build time.
+        /// @param boxes must be the same array (in size and order) that the BVH was built from.
+        void refitBvh(bvh_t *bvh, const aabb_t *boxes);
+
+        /// @brief recompute the bounds of a triangle BVH after the vertices of the model have moved.
+        /// @param model must have the same index data that the BVH was built from.
+        void refitBvh(bvh_t *bvh, raw_model_t model);
+
+        /// @brief free a bvh_t.
+        void freeBvh(bvh_t bvh);
+
+        /// @brief find the closest primitive that the ray hits within [0, tMax].
+        /// for an AABB BVH, the hit distance is where the ray enters the box (0 if the ray begins inside).
+        /// @param rayDir need not be normalized. t is in units of rayDir.
+        /// @returns false if nothing was hit, in which case hitOut is not written.
+        bool bvhClosestHit(const bvh_t &bvh,
+            const vec3_t               &rayOrigin,
+            const vec3_t               &rayDir,
+            float                       tMax,
+            bvh_hit_t                  *hitOut);
+
+        /// @brief check if the ray hits any primitive within [0, tMax]. this is cheaper than bvhClosestHit since
+        /// traversal stops at the first hit found. useful for e.g. shadow/visibility rays.
+        bool bvhAnyHit(const bvh_t &bvh, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax);
+
+        /// @brief find all primitives whose bounds overlap with box.
+        /// @param primsOut     receives up to maxPrimsOut primitive indices.
+        /// @returns the total number of overlapping primitives, which may exceed maxPrimsOut.
+        uint32_t bvhOverlap(const bvh_t &bvh, const aabb_t &box, uint32_t *primsOut, uint32_t maxPrimsOut);
+
+        /// @brief allocate a voxel grid with every cell empty. must be freed with freeVoxelGrid.
+        /// @param origin   the world space position of the min corner of cell (0,0,0).
+        /// @param cellSize the world space width of a (cube) cell.
+        voxel_grid_t makeVoxelGrid(vec3_t origin, float cellSize, uint32_t dimX, uint32_t dimY, uint32_t dimZ);
+
+        /// @brief free a voxel_grid_t.
+        void freeVoxelGrid(voxel_grid_t grid);
+
+        /// @brief set or clear a cell of a voxel grid.
+        void setVoxel(voxel_grid_t *grid, uint32_t x, uint32_t y, uint32_t z, bool bOccupied);
+
+        /// @brief check if a cell of a voxel grid is occupied.
+        bool getVoxel(const voxel_grid_t &grid, uint32_t x, uint32_t y, uint32_t z);
+
+        /// @brief find the first occupied cell along a ray by walking the grid cells that the ray passes through.
+        /// the cost is proportional to the number of cells visited, not to the number of cells in the grid.
+        /// @param rayDir need not be normalized. t is in units of rayDir.
+        /// @param hitOut receives the cell, the face that the ray entered the cell through (same indices as
+        ///               doesRayIntersectWithAABB2, or -1 if the ray begins inside the cell) and the distance.
+        /// @returns false if no occupied cell is hit within [0, tMax].
+        bool voxelRaycast(
+            const voxel_grid_t &grid, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax, voxel_hit_t *hitOut);
+
+        /// @brief voxelRaycast for an unbounded grid, where the app answers the occupancy of each cell.
+        /// the cells are cellSize wide and cell (0,0,0) has its min corner at gridOrigin. cells may be negative.
+        /// @param tMax must be finite, since the walk only ends on a hit or at tMax.
+        bool voxelRaycast(const vec3_t                               &gridOrigin,
+            float                                                     cellSize,
+            const vec3_t                                             &rayOrigin,
+            const vec3_t                                             &rayDir,
+            float                                                     tMax,
+            std::function<bool(int32_t x, int32_t y, int32_t z)> isOccupied,
+            voxel_hit_t                                              *hitOut);
+
+        /// @brief voxelRaycast for many rays at once. rays are walked four at a time, one per SIMD lane.
+        /// @param hitsOut receives one result per ray. rays that do not hit anything get t=INFINITY and
+        ///                faceHitIdx=-1.
+        /// @returns the number of rays that hit an occupied cell.
+        uint32_t voxelRaycastBatch(const voxel_grid_t &grid,
+            const vec3_t                             *rayOrigins,
+            const vec3_t                             *rayDirs,
+            uint32_t                                  rayCount,
+            float                                     tMax,
+            voxel_hit_t                              *hitsOut);
+
+        /// @brief create a spatial hash broadphase for AABB overlap queries. boxes are bucketed into a grid of cubic
+        /// cells of width cellSize, which should be on the order of the size of a typical box. boxes that cover
+        /// many more cells than that are supported, but are tested against everything.
+        /// @param expectedBoxCount used to presize the internal arrays. they grow past it when needed.
+        spatial_hash_t *createSpatialHash(float cellSize, uint32_t expectedBoxCount);
+
+        /// @brief destroy a spatial hash.
+        void destroySpatialHash(spatial_hash_t *hash);
+
+        /// @brief add a box to the spatial hash.
+        /// @returns a handle for the box. handles of removed boxes are reused.
+        uint32_t spatialHashInsert(spatial_hash_t *hash, const aabb_t &box);
+
+        /// @brief move a box. a box that remains within the same cells is a simple store, so it is fine to update
+        /// every box every frame.
+        void spatialHashUpdate(spatial_hash_t *hash, uint32_t handle, const aabb_t &box);
+
+        /// @brief remove a box from the spatial hash. the handle is invalid afterwards.
+        void spatialHashRemove(spatial_hash_t *hash, uint32_t handle);
+
+        /// @brief find all pairs of overlapping boxes. each pair is reported once, with a < b.
+        /// @returns the total number of overlapping pairs, which may exceed maxPairsOut.
+        uint32_t spatialHashFindPairs(spatial_hash_t *hash, spatial_pair_t *pairsOut, uint32_t maxPairsOut);
+
+        /// @brief find the handles of all boxes that overlap box.
+        /// @returns the total number of overlapping boxes, which may exceed maxHandlesOut.
+        uint32_t spatialHashQueryBox(
+            spatial_hash_t *hash, const aabb_t &box, uint32_t *handlesOut, uint32_t maxHandlesOut);
+
+        /// @brief find the handles of all boxes that overlap the sphere.
+        /// @returns the total number of overlapping boxes, which may exceed maxHandlesOut.
+        uint32_t spatialHashQuerySphere(
+            spatial_hash_t *hash, const vec3_t &center, float radius, uint32_t *handlesOut, uint32_t maxHandlesOut);
+
         /// @brief build a 4x4 transformation matrix from a transform_t struct.
         mat4_t buildMat4fFromTransform(transform_t trans);
 
@@ -642,6 +859,44 @@ namespace automata_engine {
         /// @brief build a 4x4 inverse orthographic projection matrix from a camera_t struct.
         mat4_t buildInverseOrthoMat(camera_t cam);
 
+        /// @brief extract the six world space planes of the view frustum from a combined proj * view matrix.
+        /// @param bZeroToOneDepth true if the matrix maps the near plane to NDC_z=0 (buildProjMatForVk),
+        ///                        false if it maps to NDC_z=-1 (buildProjMat).
+        frustum_t extractFrustum(mat4_t viewProj, bool bZeroToOneDepth);
+
+        /// @brief convenience for extractFrustum(buildProjMat(cam) * buildViewMat(cam), false).
+        /// pass forVk=true to use buildProjMatForVk instead.
+        frustum_t buildFrustum(camera_t cam, bool forVk = false);
+
+        /// @brief cull the boxes in [begin, end) against the frustum and write one visibility bit per box.
+        /// bit (i % 32) of visibleBitsOut[i / 32] is set when box i is (potentially) visible. the test is conservative,
+        /// i.e. a box that straddles the frustum corner may be reported visible.
+        /// to split the work over threads, give each thread a range where begin is a multiple of 32. each thread
+        /// then writes a disjoint set of words.
+        void frustumCullAabbs(
+            const frustum_t &frustum, const aabb_soa_t &boxes, uint32_t begin, uint32_t end, uint32_t *visibleBitsOut);
+
+        /// @brief like frustumCullAabbs, but write the indices of the visible boxes in [begin, end) to indicesOut.
+        /// indicesOut must have room for (end - begin) indices.
+        /// @returns the number of visible boxes.
+        uint32_t frustumCullAabbsCompact(
+            const frustum_t &frustum, const aabb_soa_t &boxes, uint32_t begin, uint32_t end, uint32_t *indicesOut);
+
+        /// @brief cull the spheres in [begin, end) against the frustum. see frustumCullAabbs for the output layout.
+        void frustumCullSpheres(const frustum_t &frustum,
+            const sphere_soa_t                  &spheres,
+            uint32_t                             begin,
+            uint32_t                             end,
+            uint32_t                            *visibleBitsOut);
+
+        /// @brief like frustumCullSpheres, but write the indices of the visible spheres to indicesOut.
+        /// @returns the number of visible spheres.
+        uint32_t frustumCullSpheresCompact(const frustum_t &frustum,
+            const sphere_soa_t                         &spheres,
+            uint32_t                                    begin,
+            uint32_t                                    end,
+            uint32_t                                   *indicesOut);
+
         /// @brief build a 4x4 rotation matrix from a vec3_t of euler angles.
         /// Euler angles apply in the following rotation order: Z, Y, X.
         mat4_t buildRotMat4(vec3_t eulerAngles);
@@ -714,6 +969,63 @@ namespace automata_engine {
         float sin(float a);
         float cos(float a);
         float tan(float a);
+
+        // vectorized approximations of transcendental functions, at two precision tiers.
+        // math::fast is for when a few hundred ulp does not matter (audio DSP, visual effects, ...).
+        // math::accurate stays within a couple of ulp of the correctly rounded result.
+        // both tiers have the same set of functions. each function comes as a scalar, a 4-wide (SSE2) and,
+        // when compiled with AVX2, an 8-wide version, as well as an array version that picks the widest path.
+        // the scalar and SIMD versions give bit-identical results. see automata_engine_approx.cpp for the
+        // max error of each function.
+        //
+        // sin(x), cos(x)  - x in radians. accuracy is specified for |x| <= 8192.
+        // atan2(y, x)     - the angle of (x, y) in [-pi, pi]. atan2(0, 0) is 0.
+        // rsqrt(x)        - 1/sqrt(x) via rsqrtps with Newton refinement. x must be positive.
+        // exp2(x)         - 2^x. returns 0 for x < -126 and +inf for x > 128.
+        // log2(x)         - x must be a positive normal float. log2(0) = -inf, log2(x<0) = NaN.
+#define AE_APPROX_DECLARE_TIER()                                                                                      \
+    float  sin(float x);                                                                                              \
+    float  cos(float x);                                                                                              \
+    float  atan2(float y, float x);                                                                                   \
+    float  rsqrt(float x);                                                                                            \
+    float  exp2(float x);                                                                                             \
+    float  log2(float x);                                                                                             \
+    __m128 sin(__m128 x);                                                                                             \
+    __m128 cos(__m128 x);                                                                                             \
+    __m128 atan2(__m128 y, __m128 x);                                                                                 \
+    __m128 rsqrt(__m128 x);                                                                                           \
+    __m128 exp2(__m128 x);                                                                                            \
+    __m128 log2(__m128 x);                                                                                            \
+    AE_APPROX_DECLARE_TIER_8()                                                                                        \
+    void sin(const float *in, float *out, uint32_t count);                                                           \
+    void cos(const float *in, float *out, uint32_t count);                                                           \
+    void atan2(const float *y, const float *x, float *out, uint32_t count);                                          \
+    void rsqrt(const float *in, float *out, uint32_t count);                                                         \
+    void exp2(const float *in, float *out, uint32_t count);                                                          \
+    void log2(const float *in, float *out, uint32_t count);
+
+#if defined(__AVX2__)
+#define AE_APPROX_DECLARE_TIER_8()                                                                                    \
+    __m256 sin(__m256 x);                                                                                             \
+    __m256 cos(__m256 x);                                                                                             \
+    __m256 atan2(__m256 y, __m256 x);                                                                                 \
+    __m256 rsqrt(__m256 x);                                                                                           \
+    __m256 exp2(__m256 x);                                                                                            \
+    __m256 log2(__m256 x);
+#else
+#define AE_APPROX_DECLARE_TIER_8()
+#endif
+
+        namespace fast {
+            AE_APPROX_DECLARE_TIER()
+        }
+
+        namespace accurate {
+            AE_APPROX_DECLARE_TIER()
+        }
+
+#undef AE_APPROX_DECLARE_TIER
+#undef AE_APPROX_DECLARE_TIER_8
     }
 
     /// @brief this is to be called by the game to init globals.
@@ -758,16 +1070,357 @@ namespace automata_engine {
     // AE input/output engine.
     namespace io {
         /// @brief load a .WAV file into memory. this must be freed with freeWav.
+        /// the file may be mono or stereo, in any pcm_format_t, and must be at ENGINE_DESIRED_SAMPLES_PER_SECOND.
+        /// anything but 16-bit stereo is converted with convertPcm as it is loaded.
+        /// @returns a loaded_wav_t with no sampleData on failure.
         loaded_wav_t loadWav(const char *);
 
         /// @brief free a loaded_wav_t.
         void freeWav(loaded_wav_t wavFile);
 
+        /// @brief the sample formats that a .WAV file may be in.
+        enum pcm_format_t {
+            PCM_FORMAT_U8 = 0,  // 8-bit, unsigned, with silence at 128.
+            PCM_FORMAT_S16,
+            PCM_FORMAT_S24,  // 24-bit packed into 3 bytes.
+            PCM_FORMAT_S32,
+            PCM_FORMAT_F32,  // IEEE float, with full scale at 1. beyond that is clipped.
+            PCM_FORMAT_COUNT
+        };
+
+        /// @brief convert interleaved mono or stereo samples to the 16-bit stereo that the voices take. mono goes to
+        /// both channels. wider formats keep their top 16 bits, and float is rounded.
+        /// @param dst room for frameCount * 2 samples. this may not overlap src.
+        void convertPcm(const void *src, pcm_format_t format, uint32_t channels, size_t frameCount, short *dst);
+
+        /// @brief load an Ogg Vorbis file and decode all of it. this must be freed with freeWav. the file may be
+        /// mono or stereo, and must be at ENGINE_DESIRED_SAMPLES_PER_SECOND. for music, prefer openAudioStream.
+        /// this needs stb_vorbis.c on the include path, and fails without it.
+        /// @returns a loaded_wav_t with no sampleData on failure.
+        loaded_wav_t loadOgg(const char *path);
+
+        /// @brief a sound file that is read or decoded a block at a time rather than all at once, so that long music
+        /// and ambience take up AUDIO_STREAM_BLOCK_COUNT blocks of memory whatever their length. see openAudioStream.
+        struct audio_stream_t;
+
+        /// @brief how many blocks an audio_stream_t keeps. while one is played, the others are read ahead.
+        constexpr static uint32_t AUDIO_STREAM_BLOCK_COUNT = 3;
+
+        /// @brief the default block size in frames, where a frame is one sample of each channel. ~186 ms.
+        constexpr static uint32_t AUDIO_STREAM_DEFAULT_BLOCK_FRAMES = 8192;
+
+        /// @brief open a .WAV or Ogg Vorbis file for streaming, going by what is in it rather than its name. the
+        /// file is parsed once here, and the blocks are then read or decoded ahead on the job pool. the samples come
+        /// out as 16-bit stereo LPCM, as the voices take them. this must be closed with closeAudioStream.
+        ///
+        /// a .WAV may be in any format that loadWav takes, and is read a block at a time. an Ogg Vorbis is mapped
+        /// with vfs::mapEntireFile and decoded in order, one block after another. this needs stb_vorbis.c on the
+        /// include path, and without it only .WAV files can be streamed.
+        /// @param bLoop go back to the start at the end of the file rather than stopping there.
+        /// @returns nullptr if the file could not be opened or is not in a supported format. that includes every
+        /// Ogg Vorbis file when the engine is built without stb_vorbis.c.
+        audio_stream_t *openAudioStream(
+            const char *path, uint32_t blockFrames = AUDIO_STREAM_DEFAULT_BLOCK_FRAMES, bool bLoop = false);
+
+        /// @brief the length of the file in frames.
+        uint64_t getAudioStreamFrameCount(const audio_stream_t *stream);
+
+        /// @brief what a stream has cost so far. see audio_stream_stats_t.
+        audio_stream_stats_t getAudioStreamStats(const audio_stream_t *stream);
+
+        /// @brief read the next frames of the stream into dst, as interleaved 16-bit stereo. this waits for the
+        /// block to be read if it is not yet. do not use this on a stream given to streamAudioToVoice.
+        /// @returns the number of frames read, which is less than frameCount only at the end of the stream.
+        uint32_t readAudioStream(audio_stream_t *stream, short *dst, uint32_t frameCount);
+
+        /// @brief keep a voice fed from the stream. call this once per frame, after platform createVoice, and play
+        /// the voice with platform voicePlayBuffer once this has been called. the blocks are queued on the voice as
+        /// they are, so there is no copy, and each is read again once the voice is done with it.
+        /// @returns false once the voice has played the stream to the end.
+        bool streamAudioToVoice(audio_stream_t *stream, intptr_t voiceHandle);
+
+        /// @brief close a stream from openAudioStream. a voice must not play the blocks after this, so stop it and
+        /// submit something else to it before playing it again.
+        void closeAudioStream(audio_stream_t *stream);
+
         /// @brief load a .BMP file into memory. this must be freed with freeLoadedImage.
+        /// the file is mapped with vfs::mapEntireFile and decoded straight out of the mapping, so the image is
+        /// the only copy that is made. see decodeBMP for the formats that are taken.
         loaded_image_t loadBMP(const char *path);
 
+        /// @brief decode a .BMP that is already in memory to 0xAABBGGRR pixels, i.e. RGBA bytes. rows are written
+        /// bottom row first whether the file is stored bottom-up or top-down. the file may be 8-bit paletted,
+        /// 24-bit, or 32-bit, either plain or with byte aligned BI_BITFIELDS masks. 24-bit and paletted pixels
+        /// get an alpha of 0xFF.
+        /// @param dst     width * height pixels. may be nullptr to only read the size.
+        /// @returns false if the data is not a .BMP in one of the formats above.
+        bool decodeBMP(const void *data, size_t size, uint32_t *dst, uint32_t *widthOut, uint32_t *heightOut);
+
+        /// @brief the most levels that a mip_chain_t can have.
+        constexpr static uint32_t MIP_CHAIN_MAX_LEVELS = 32;
+
+        /// @brief the filter that generateMips makes each level with. a level is always made from the one before it.
+        /// MIP_FILTER_BOX averages each 2x2 block. MIP_FILTER_KAISER and MIP_FILTER_LANCZOS are windowed sincs,
+        /// which are slower but keep more detail and alias less, for a little ringing at hard edges.
+        enum mip_filter_t { MIP_FILTER_BOX = 0, MIP_FILTER_KAISER, MIP_FILTER_LANCZOS };
+
+        /// @brief how to make a chain of mips. zero initialized is the defaults: a box filter over the bytes as they
+        /// are, which is also the fastest.
+        /// @param bSrgb             the colour is sRGB, as most colour textures are, so it is filtered in linear
+        ///                          light and stored as sRGB again. alpha is always linear.
+        /// @param bPremultiplyAlpha weigh the colour of each pixel by its alpha while filtering, so that transparent
+        ///                          pixels do not bleed their colour into their neighbours. the levels are stored
+        ///                          with straight alpha all the same.
+        struct mip_options_t {
+            mip_filter_t filter;
+            bool         bSrgb;
+            bool         bPremultiplyAlpha;
+        };
+
+        /// @brief make a full chain of mips for an image. level 0 is a copy of the image.
+        /// @param options nullptr for the defaults.
+        /// @returns false if the image is empty or out of memory. out must be freed with freeMipChain otherwise.
+        bool generateMips(const loaded_image_t &image, mip_chain_t *out, const mip_options_t *options = nullptr);
+
+        /// @brief load a batch of images on the job pool, each decoded to RGBA with a full chain of mips made with
+        /// generateMips. takes the same formats as platform::stbImageLoad. the calling thread helps, and this returns
+        /// once every image is done.
+        /// @param cacheDir may be nullptr. otherwise a directory, which must exist, to keep decoded chains in between
+        ///                 runs. they are found by vfs::hashContents of the source file and the options, so a file
+        ///                 that has not changed is mapped from the cache with no decode at all, whatever its path.
+        /// @param out      count chains, each to be freed with freeMipChain. those that fail to load are left empty.
+        /// @param options  nullptr for the defaults.
+        /// @returns the number of images that loaded.
+        uint32_t loadImages(const char *const *paths, uint32_t count, mip_chain_t *out, const char *cacheDir = nullptr,
+            const mip_options_t *options = nullptr);
+
+        /// @brief same as loadImages for a single image that is already in memory, on the calling thread and with
+        /// no cache. this must be freed with freeMipChain.
+        /// @returns false if stb_image could not decode the data.
+        bool decodeImage(const void *data, size_t size, mip_chain_t *out, const mip_options_t *options = nullptr);
+
+        /// @brief free a chain from loadImages, decodeImage or generateMips.
+        void freeMipChain(mip_chain_t *chain);
+
+        /// @brief the GPU block compressed formats that compressImage can write. each packs a 4x4 block of texels.
+        /// BLOCK_FORMAT_BC1 is opaque RGB in 8 bytes, i.e. 4 bits a texel. BLOCK_FORMAT_BC3 is RGBA in 16 bytes,
+        /// with alpha kept apart from the colour. BLOCK_FORMAT_BC7 is RGBA in 16 bytes with the best quality of the
+        /// three, and is always written as mode 6.
+        enum block_format_t : uint8_t { BLOCK_FORMAT_BC1 = 0, BLOCK_FORMAT_BC3, BLOCK_FORMAT_BC7 };
+
+        /// @brief how hard compressImage looks for the best endpoints of each block. BLOCK_QUALITY_FAST takes the
+        /// bounds of the block as they are. BLOCK_QUALITY_NORMAL tries its principal axis as well and refines the
+        /// better of the two once. BLOCK_QUALITY_HIGH refines more and searches more widely. higher quality is
+        /// never worse, block by block.
+        enum block_quality_t { BLOCK_QUALITY_FAST = 0, BLOCK_QUALITY_NORMAL, BLOCK_QUALITY_HIGH };
+
+        /// @brief the size in bytes of an image of width by height in format. partial blocks at the edges count as
+        /// whole blocks.
+        size_t blockCompressedSize(block_format_t format, uint32_t width, uint32_t height);
+
+        /// @brief block compress an image on the job pool. the calling thread helps, and this returns once every
+        /// block is done. blocks that hang off of the edge repeat the last row and column of the image.
+        /// @returns false if the image is empty or out of memory. out must be freed with freeCompressedImage
+        /// otherwise.
+        bool compressImage(
+            const loaded_image_t &image, block_format_t format, block_quality_t quality, compressed_image_t *out);
+
+        /// @brief same as compressImage, for every level of a chain.
+        bool compressMipChain(
+            const mip_chain_t &chain, block_format_t format, block_quality_t quality, compressed_image_t *out);
+
+        /// @brief decode a level of a compressed image back to 0xABGR pixels, bottom row first.
+        /// @param dst the width by height of the level in pixels.
+        /// @returns false if the level does not exist, or for BC7 blocks in any mode but 6.
+        bool decompressImage(const compressed_image_t &image, uint32_t level, uint32_t *dst);
+
+        /// @brief free an image from compressImage or compressMipChain.
+        void freeCompressedImage(compressed_image_t *image);
+
         /// @brief load a .OBJ file into memory. this must be freed with freeObj.
-        raw_model_t loadObj(const char *filePath);
+        /// @param bParallel parse with loadObjFromMemoryParallel.
+        raw_model_t loadObj(const char *filePath, bool bParallel = false);
+
+        /// @brief parse .OBJ text that is already in memory. the data need not be null terminated.
+        /// faces may be given as v, v/vt, v//vn or v/vt/vn, with negative (relative) indices, and polygons are
+        /// triangulated. a corner missing a UV or normal gets zeros for it. this must be freed with freeObj.
+        raw_model_t loadObjFromMemory(const char *data, size_t size);
+
+        /// @brief the default size of the chunks that loadObjFromMemoryParallel splits a file into.
+        constexpr static size_t OBJ_PARALLEL_CHUNK_SIZE = 1 << 20;
+
+        /// @brief same as loadObjFromMemory, but the file is split into line aligned chunks that are parsed and
+        /// deduplicated on the job pool. the result is identical to loadObjFromMemory, whatever the thread count.
+        /// @param chunkSize approximate size of each chunk in bytes. 0 picks OBJ_PARALLEL_CHUNK_SIZE.
+        raw_model_t loadObjFromMemoryParallel(const char *data, size_t size, size_t chunkSize = 0);
+
+        /// @brief the version of the .aemesh format that writeMesh writes and loadMesh accepts.
+        constexpr static uint32_t AEMESH_VERSION = 2;
+
+        /// @brief pack a raw_model_t into the .aemesh binary format, in memory, at full precision.
+        /// @returns memory holding the file, which must be freed with free(). nullptr on failure.
+        void *packMesh(raw_model_t model, uint32_t *sizeOut);
+
+        /// @brief same as above.
+        /// @param quantization how to store the vertices and indices. see mesh_quantization_t.
+        void *packMesh(raw_model_t model, uint32_t *sizeOut, mesh_quantization_t quantization);
+
+        /// @brief write a raw_model_t to disk as a .aemesh file.
+        /// @returns true on success, false on failure.
+        bool writeMesh(const char *filePath, raw_model_t model);
+        bool writeMesh(const char *filePath, raw_model_t model, mesh_quantization_t quantization);
+
+        /// @brief map a .aemesh file into memory. nothing is copied or parsed: the vertex and index data point
+        /// straight into the mapping. this must be freed with freeMesh.
+        /// @returns a mesh with null vertexData if the file could not be opened or is not a valid .aemesh.
+        loaded_mesh_t loadMesh(const char *filePath);
+
+        /// @brief same as loadMesh, for a .aemesh file that is already in memory. the returned mesh points into
+        /// data, so data must outlive it.
+        loaded_mesh_t loadMeshFromMemory(const void *data, size_t size);
+
+        /// @brief free a loaded_mesh_t.
+        void freeMesh(loaded_mesh_t mesh);
+
+        /// @brief decode a loaded_mesh_t, whatever its layout, back into the 8 floats per vertex of a raw_model_t.
+        /// this must be freed with StretchyBufferFree on both the vertexData and indexData.
+        raw_model_t dequantizeMesh(const loaded_mesh_t &mesh);
+
+        /// @brief the componentType values of a glTF accessor.
+        enum gltf_component_t : uint16_t {
+            GLTF_BYTE           = 5120,
+            GLTF_UNSIGNED_BYTE  = 5121,
+            GLTF_SHORT          = 5122,
+            GLTF_UNSIGNED_SHORT = 5123,
+            GLTF_UNSIGNED_INT   = 5125,
+            GLTF_FLOAT          = 5126
+        };
+
+        /// @brief the glTF primitive mode for a triangle list, which is the default and the only one that
+        /// glbToRawModel converts.
+        constexpr static uint32_t GLTF_MODE_TRIANGLES = 4;
+
+        /// @brief map a glTF 2.0 binary (.glb) file into memory. the JSON chunk is parsed once, and every accessor
+        /// is a span straight into the binary chunk, so no vertex or index data is copied or converted. this must
+        /// be freed with freeGlb.
+        /// @returns a model with no meshes and a null parentFile if the file could not be opened or parsed.
+        gltf_model_t loadGlb(const char *filePath);
+
+        /// @brief same as loadGlb, for a .glb file that is already in memory. the returned model points into
+        /// data, so data must outlive it. it must still be freed with freeGlb.
+        /// @returns false if the data is not a valid .glb.
+        bool loadGlbFromMemory(const void *data, size_t size, gltf_model_t *out);
+
+        /// @brief free a model from loadGlb or loadGlbFromMemory.
+        void freeGlb(gltf_model_t *model);
+
+        /// @brief read an accessor as floats, decoding normalized integers per the glTF spec. each element is
+        /// written as componentCount floats, truncated or padded with zeros to fit.
+        /// @param out accessor.count * componentCount floats.
+        /// @returns the number of elements read.
+        uint32_t readAccessorFloats(const gltf_accessor_t &accessor, float *out, uint32_t componentCount);
+
+        /// @brief read an accessor of scalar unsigned integers, as an index buffer is, widening to 32 bits.
+        /// @returns the number of elements read, which is 0 if the accessor is not of that type.
+        uint32_t readAccessorIndices(const gltf_accessor_t &accessor, uint32_t *out);
+
+        /// @brief interleave every triangle primitive of the default scene of a model into one raw_model_t, with
+        /// positions and normals transformed to world space by the node hierarchy. a model with no scene has
+        /// every primitive in it as is. V is flipped so that UVs match images loaded bottom row first, as for
+        /// .OBJ files. this must be freed with freeObj.
+        raw_model_t glbToRawModel(const gltf_model_t &model);
+
+        /// @brief convert between 32 bit floats and IEEE half floats, with round to nearest even. uses F16C
+        /// where it is available and SSE2 otherwise.
+        void floatToHalf(const float *in, uint16_t *out, size_t count);
+        void halfToFloat(const uint16_t *in, float *out, size_t count);
+
+        /// @brief quantize count vectors of componentCount floats each, with value = offset + scale * (q / 65535).
+        /// @param offset,scale componentCount values each.
+        void quantizeUnorm16(const float *in, uint16_t *out, size_t count, uint32_t componentCount,
+            const float *offset, const float *scale);
+        void dequantizeUnorm16(const uint16_t *in, float *out, size_t count, uint32_t componentCount,
+            const float *offset, const float *scale);
+
+        /// @brief octahedral encode count normals (xyz, tightly packed) into two snorm components each. the
+        /// normals need not be unit length. decoding gives unit length normals.
+        void encodeOctahedral16(const float *normals, int16_t *out, size_t count);
+        void decodeOctahedral16(const int16_t *in, float *normals, size_t count);
+        void encodeOctahedral8(const float *normals, int8_t *out, size_t count);
+        void decodeOctahedral8(const int8_t *in, float *normals, size_t count);
+
+        /// @brief the vertex cache size that the mesh optimizer targets by default.
+        constexpr static uint32_t MESHOPT_DEFAULT_CACHE_SIZE = 16;
+
+        /// @brief merge vertices that are bitwise identical and remap the indices to match. vertices keep the
+        /// order in which they first appear.
+        /// @returns the new vertex count.
+        uint32_t weldVertices(raw_model_t *model);
+
+        /// @brief reorder triangles so that they reuse the post-transform vertex cache of the GPU (Tipsify).
+        void optimizeVertexCache(uint32_t *indices,
+            uint32_t                       indexCount,
+            uint32_t                       vertexCount,
+            uint32_t                       cacheSize = MESHOPT_DEFAULT_CACHE_SIZE);
+
+        /// @brief same as optimizeVertexCache, then the clusters that the cache pass leaves behind are sorted so
+        /// that outward facing ones are drawn first, to cut down on overdraw.
+        /// @param vertexData vertices in the raw_model_t format.
+        void optimizeOverdraw(uint32_t *indices,
+            uint32_t                    indexCount,
+            const float                *vertexData,
+            uint32_t                    vertexCount,
+            uint32_t                    cacheSize = MESHOPT_DEFAULT_CACHE_SIZE);
+
+        /// @brief reorder vertices into the order in which the indices first use them, for memory locality.
+        /// unused vertices are dropped.
+        /// @returns the new vertex count.
+        uint32_t optimizeVertexFetch(raw_model_t *model);
+
+        /// @brief weld, then optimize for the vertex cache (and optionally overdraw), then for vertex fetch.
+        void optimizeMesh(raw_model_t *model, bool bOptimizeOverdraw = false);
+
+        /// @brief simulate a FIFO post-transform vertex cache over an index buffer.
+        vertex_cache_stats_t analyzeVertexCache(const uint32_t *indices,
+            uint32_t                                             indexCount,
+            uint32_t                                             vertexCount,
+            uint32_t                                             cacheSize = MESHOPT_DEFAULT_CACHE_SIZE);
+
+        /// @brief split a mesh into meshlets by scanning its triangles in order, so optimize for the vertex cache
+        /// first. this must be freed with freeMeshlets.
+        /// @param maxVertices  at most 256, so that local indices fit in a byte.
+        meshlet_set_t buildMeshlets(raw_model_t model, uint32_t maxVertices = 64, uint32_t maxTriangles = 124);
+
+        /// @brief free a meshlet_set_t.
+        void freeMeshlets(meshlet_set_t set);
+
+        /// @brief test the normal cone of a meshlet. true means that every triangle in it faces away from a camera
+        /// at cameraPos, so the whole meshlet can be skipped.
+        bool isMeshletBackfacing(const meshlet_t &meshlet, math::vec3_t cameraPos);
+
+        /// @brief simplify a mesh with the quadric error metric, by collapsing vertices onto their neighbours.
+        /// UV and normal seams are kept, and the open borders of the mesh are not touched. it stops at
+        /// targetIndexCount, or before the error would go past maxError, whichever is first.
+        /// @param indicesOut room for all of the model's indices. the vertices are those of the model.
+        /// @param maxError   in the units of the mesh.
+        /// @param errorOut   optional. the largest deviation from the original mesh, in the units of the mesh.
+        /// @returns the number of indices written to indicesOut.
+        uint32_t simplifyMesh(raw_model_t model, uint32_t targetIndexCount, uint32_t *indicesOut,
+            float maxError = FLT_MAX, float *errorOut = nullptr);
+
+        /// @brief build a chain of LODs by simplifying the mesh in steps. this must be freed with freeLodChain.
+        /// weld the mesh first, since the seams are found from vertices that share a position.
+        /// @param triangleRatios the fraction of the triangles that each LOD after the first should keep, in
+        ///                       decreasing order. a LOD may stop short of its ratio when everything left is locked.
+        mesh_lod_chain_t buildLodChain(raw_model_t model, const float *triangleRatios, uint32_t ratioCount);
+
+        /// @brief free a mesh_lod_chain_t.
+        void freeLodChain(mesh_lod_chain_t chain);
+
+        /// @brief pick the coarsest LOD whose error, projected to the screen, is at most maxPixelError pixels.
+        /// @param distance from the camera to the mesh. scale it, or the errors, if the mesh is drawn scaled.
+        uint32_t selectLod(const mesh_lod_chain_t &chain, const math::camera_t &cam, float distance,
+            float maxPixelError = 1.f);
 
         /// @brief free a raw_model_t.
         void freeObj(raw_model_t obj);
@@ -777,8 +1430,188 @@ namespace automata_engine {
 
         /// @brief any .WAV file loaded must have this many samples per second.
         constexpr static uint32_t ENGINE_DESIRED_SAMPLES_PER_SECOND = 44100;
+
+        /// @brief the version of the .aepak format that packArchive writes and vfs::mountArchive accepts.
+        constexpr static uint32_t AEPAK_VERSION = 1;
+
+        /// @brief every file within a .aepak begins on a boundary of this many bytes, i.e. a page.
+        constexpr static uint32_t AEPAK_ALIGNMENT = 4096;
+
+        /// @brief pack files into the .aepak archive format, in memory. see vfs::mountArchive.
+        /// @param bCompress LZ4 compress the files that it makes smaller by at least an eighth. the rest are
+        ///                  stored as is, and can be mapped without a copy.
+        /// @returns memory holding the archive, which must be freed with free(). nullptr on failure, e.g. when two
+        /// sources have the same path.
+        void *packArchive(
+            const archive_source_t *sources, uint32_t sourceCount, size_t *sizeOut, bool bCompress = true);
+
+        /// @brief read the loose files at filePaths from disk and write them to disk as a .aepak archive. each file
+        /// is stored under the path that it was read from.
+        /// @returns true on success, false on failure.
+        bool writeArchive(
+            const char *archivePath, const char *const *filePaths, uint32_t fileCount, bool bCompress = true);
+
+        /// @brief the most that lz4Compress can write for srcSize bytes of input.
+        size_t lz4CompressBound(size_t srcSize);
+
+        /// @brief compress into the LZ4 block format.
+        /// @returns the compressed size, or 0 if dst is too small. dstCapacity of lz4CompressBound never is.
+        size_t lz4Compress(const void *src, size_t srcSize, void *dst, size_t dstCapacity);
+
+        /// @brief decompress an LZ4 block. this is safe to call on untrusted data: it never reads or writes
+        /// out of bounds.
+        /// @returns true if src decompressed to exactly dstSize bytes.
+        bool lz4Decompress(const void *src, size_t srcSize, void *dst, size_t dstSize);
     };  // namespace io
 
+    // AE virtual file system. files are looked up in the mounted .aepak archives first, then on disk. the engine
+    // loads everything through here, so mounting an archive at startup is all a game needs to do to use one.
+    namespace vfs {
+        /// @brief the most archives that can be mounted at once.
+        constexpr static uint32_t MAX_MOUNTED_ARCHIVES = 16;
+
+        /// @brief the hash that a path is looked up by. paths are not case sensitive, and '/' and '\\' are the
+        /// same, so "res\\Monke.obj" and "res/monke.obj" hash the same.
+        uint64_t hashPath(const char *path);
+
+        /// @brief a 64-bit hash of the bytes of a file, at several bytes per cycle. this is for telling files apart
+        /// by what is in them, e.g. to key a cache, and is not for anything that has to be secure.
+        uint64_t hashContents(const void *data, size_t size);
+
+        /// @brief map a .aepak archive into memory and add it to the search. archives mounted later are searched
+        /// first. mount and unmount before there are loads on other threads.
+        /// @returns false if the file could not be opened or is not a valid .aepak.
+        bool mountArchive(const char *archivePath);
+
+        /// @brief same as mountArchive, for an archive that is already in memory. data must outlive the mount.
+        bool mountArchiveFromMemory(const void *data, size_t size);
+
+        /// @brief unmount every archive. free all files read from them first.
+        void unmountArchives();
+
+        /// @brief same as platform readEntireFile, but through the mounted archives. the contents are a private
+        /// copy that may be written to. this must be freed with vfs::freeLoadedFile.
+        loaded_file_t readEntireFile(const char *path);
+
+        /// @brief free a file from vfs::readEntireFile.
+        void freeLoadedFile(loaded_file_t file);
+
+        /// @brief same as platform mapEntireFile, but through the mounted archives. the contents are read only.
+        /// files stored uncompressed in an archive are not copied at all. this must be freed with vfs::unmapFile.
+        loaded_file_t mapEntireFile(const char *path);
+
+        /// @brief free a file from vfs::mapEntireFile.
+        void unmapFile(loaded_file_t file);
+
+        /// @brief a file that is read in pieces at any offset. see openFile.
+        struct file_t;
+
+        /// @brief open a file for reads at any offset, through the mounted archives, so that large files can be
+        /// read a piece at a time. files stored uncompressed in an archive are read straight out of it, but those
+        /// that are compressed are decompressed whole here. this must be closed with vfs::closeFile.
+        /// @returns nullptr on failure.
+        file_t *openFile(const char *path);
+
+        /// @brief the size of a file from vfs::openFile in bytes.
+        uint64_t getFileSize(const file_t *file);
+
+        /// @brief read size bytes at offset. safe to call from any thread, and from several at once.
+        /// @returns the number of bytes read, which is less than size only at the end of the file or on failure.
+        uint32_t readFile(file_t *file, uint64_t offset, void *dst, uint32_t size);
+
+        /// @brief close a file from vfs::openFile.
+        void closeFile(file_t *file);
+
+        /// @brief NOT to be called by user. hands a buffer from malloc to the VFS, so that the loaded_file_t made
+        /// over it is freed by vfs::freeLoadedFile. for loaders that replace the file with what they decode.
+        void _trackHeapFile(void *contents);
+    }  // namespace vfs
+
+    // AE asset cache. loading an asset that is already loaded hands out another reference to it rather than
+    // reading the file again. an asset is freed when its last reference is released, unless there is a memory
+    // budget, in which case unreferenced assets are kept and evicted least recently used first once the assets
+    // take up more than the budget. this is all thread safe, and threads that load the same asset at the same time
+    // share a single load.
+    namespace assets {
+        enum asset_type_t {
+            ASSET_TYPE_MODEL = 0,  // raw_model_t, from io::loadObj.
+            ASSET_TYPE_IMAGE,      // loaded_image_t, from io::loadBMP for .bmp and platform::stbImageLoad otherwise.
+            ASSET_TYPE_SOUND,      // loaded_wav_t, from io::loadOgg for .ogg and io::loadWav otherwise.
+            ASSET_TYPE_MESH,       // loaded_mesh_t, from io::loadMesh.
+            ASSET_TYPE_COUNT
+        };
+
+        typedef handle_t<raw_model_t>    model_handle_t;
+        typedef handle_t<loaded_image_t> image_handle_t;
+        typedef handle_t<loaded_wav_t>   sound_handle_t;
+        typedef handle_t<loaded_mesh_t>  mesh_handle_t;
+
+        /// @brief load an asset of type T, or take another reference to it if it is loaded already. paths are
+        /// compared as in vfs::hashPath. this must be released with release.
+        /// @returns the null handle if the load failed.
+        template <typename T> handle_t<T> load(const char *path);
+
+        /// @brief get the asset behind a handle. the pointer is good for as long as the handle is held.
+        /// @returns nullptr for the null handle or one that was already released.
+        template <typename T> const T *get(handle_t<T> handle);
+
+        /// @brief take another reference to a loaded asset. each must be released with release.
+        template <typename T> handle_t<T> acquire(handle_t<T> handle);
+
+        /// @brief release a reference from load or acquire. releasing the null handle does nothing.
+        template <typename T> void release(handle_t<T> handle);
+
+        /// @brief set how many bytes the assets may take up before unreferenced ones are evicted. the default of 0
+        /// means that assets are freed as soon as they are unreferenced. referenced assets are never evicted, so
+        /// they alone may go over the budget.
+        void setMemoryBudget(size_t bytes);
+
+        /// @brief free every unreferenced asset now, whatever the budget.
+        void evictUnreferenced();
+
+        /// @brief get the memory used by the assets of a type, and how well the cache is doing for it.
+        asset_usage_t getUsage(asset_type_t type);
+
+        /// @brief how many times the asset behind a handle has been reloaded. compare against this to know when
+        /// to redo work derived from the asset, e.g. a GPU upload.
+        template <typename T> uint32_t getVersion(handle_t<T> handle);
+
+        /// @brief a function to call when a file changes. see addReloadListener.
+        typedef void (*PFN_onFileChanged)(const char *path, void *user);
+
+        /// @brief how long a file must go unchanged before it is reloaded, so that a save that is several writes
+        /// long is reloaded once and never half written.
+        constexpr static float HOT_RELOAD_DEBOUNCE_SECONDS = 0.1f;
+
+        /// @brief watch a directory for changes to the files of loaded assets, through the platform. the changed
+        /// assets are reloaded by update.
+        /// @returns false on failure.
+        bool watchDirectory(const char *dirPath);
+
+        /// @brief note that a file changed, as the directory watch does. useful for changes that the watch cannot
+        /// see. this may be called from any thread.
+        void notifyFileChanged(const char *path);
+
+        /// @brief set how long a file must go unchanged before it is reloaded. see HOT_RELOAD_DEBOUNCE_SECONDS.
+        void setReloadDebounce(float seconds);
+
+        /// @brief call fn with the path of every file that changed, once it settles, e.g. to rebuild shaders.
+        /// listeners are forgotten when the engine module is unloaded, so add them again on hot-load.
+        void addReloadListener(PFN_onFileChanged fn, void *user);
+
+        /// @brief stop calling a listener that was added with addReloadListener.
+        void removeReloadListener(PFN_onFileChanged fn, void *user);
+
+        /// @brief do the hot reload work. call this once per frame, at a point where no asset is in use, e.g.
+        /// before the update. the changed assets are reloaded on the job pool, and once a reload is complete, the
+        /// next update swaps it in: from then on, get returns the new asset and the old one is freed. so a frame
+        /// never waits on a reload.
+        void update();
+
+        /// @brief NOT to be called by user.
+        void _close();
+    }  // namespace assets
+
     // fallback rendering routines (CPU).
     namespace frender {
         /// @brief render the engine intro.
@@ -971,9 +1804,43 @@ namespace automata_engine {
         struct loaded_file_t parentFile;
     };
 
+    /// @brief an RGBA image and its full chain of mips, from io::loadImages, io::decodeImage or io::generateMips.
+    /// each level is half the size of the one before it, rounded down and at least 1, down to 1x1. all of them are
+    /// in one block.
+    /// @param pixels      level 0 and then each mip in turn. pixels are in 0xABGR (32bpp) format and rows are bottom
+    ///                    row first, as in loaded_image_t.
+    /// @param levelOffset where each level begins, in pixels from the start of pixels.
+    /// @param contentHash vfs::hashContents of the file that the image was decoded from.
+    /// @param parentFile  internal storage for the cache file that the chain was mapped from, if any.
+    struct mip_chain_t {
+        uint32_t            *pixels;
+        uint32_t             width;
+        uint32_t             height;
+        uint32_t             levelCount;
+        uint32_t             levelOffset[io::MIP_CHAIN_MAX_LEVELS];
+        uint64_t             contentHash;
+        struct loaded_file_t parentFile;
+    };
+
+    /// @brief a GPU block compressed image and its mips, from io::compressImage or io::compressMipChain. each level
+    /// is half the size of the one before it, as in mip_chain_t, and all of them are in one block.
+    /// @param blocks      each level in turn. the blocks of a level are row-major, bottom block row first, in the
+    ///                    same order as the rows of pixels that they came from.
+    /// @param levelOffset where each level begins, in bytes from the start of blocks.
+    /// @param size        the size of blocks in bytes.
+    struct compressed_image_t {
+        void                *blocks;
+        uint32_t             width;
+        uint32_t             height;
+        uint32_t             levelCount;
+        io::block_format_t   format;
+        size_t               levelOffset[io::MIP_CHAIN_MAX_LEVELS];
+        size_t               size;
+    };
+
     /// @brief a struct representing a .WAV file loaded into memory.
-    /// @param sampleData pointer to contiguous chunk of memory corresponding to 16-bit LPCM sound samples. When
-    ///                   there are two channels, the data is interleaved.
+    /// @param sampleData pointer to contiguous chunk of memory corresponding to 16-bit LPCM sound samples, with the
+    ///                   two channels interleaved. channels is always 2, as mono files are widened as they load.
     /// @param parentFile internal storage for corresponding loaded_file that contains the unparsed sound data.
     ///                   This is retained so that we can ultimately free the loaded file.
     struct loaded_wav_t {
@@ -983,6 +1850,20 @@ namespace automata_engine {
         struct loaded_file_t parentFile;
     };
 
+    /// @brief the memory and time that an audio stream has taken. see io::getAudioStreamStats.
+    /// @param residentBytes the blocks, the space to read into before converting, and the decoder, if any. this
+    ///                      does not change for as long as the stream is open.
+    /// @param mappedBytes   the size of the file mapped for an Ogg Vorbis, which is read from disk as it is decoded.
+    /// @param framesDecoded frames read or decoded so far, counting each time round a loop.
+    /// @param decodeSeconds time spent on the job pool reading and decoding them. so the share of a core that the
+    ///                      stream takes to play is decodeSeconds * 44100 / framesDecoded.
+    struct audio_stream_stats_t {
+        size_t   residentBytes;
+        size_t   mappedBytes;
+        uint64_t framesDecoded;
+        double   decodeSeconds;
+    };
+
     /// @brief a struct allocated by the engine and passed to the game layer.
     ///
     /// The game layer can use this to store its own data. This struct is persistent across time.
@@ -998,17 +1879,13 @@ namespace automata_engine {
         engine_memory_t *pEngineMemory;
 
         struct {
-            // TODO(Noah): Swap this appTable out for something more performant
-            // like a hash table. OR, could do the other design pattern where we map
-            // some index to names. We just O(1) lookup...
-            //
-            // it's also probably the case that strcmp will return true if we have a
-            // substring match? Please ... fix this code.
+            // NOTE(Noah): the names array is kept in registration order for the ImGui combo,
+            // and the lookup maps a name to its index in both arrays.
             uint32_t currentAppIndex = 0;
     
-            // NOTE: these two things are stretchy buffers.
-            bifrost_app_t *appTable_funcs = nullptr;
-            const char **appTable_names = nullptr;
+            array<bifrost_app_t> appTable_funcs;
+            array<const char *>  appTable_names;
+            hash_map<const char *, uint32_t, string_hasher_t> appTable_lookup;
 
             bool bShowDemoWindow = false;
             bool bShowEngineReadme = false;
@@ -1183,6 +2060,40 @@ namespace automata_engine {
     /// @brief free memory allocated by readEntireFile.
     typedef void (*PFN_freeLoadedFile)(loaded_file_t file);
 
+    /// @brief map an entire file into memory, read-only. pages are read from disk on first touch rather than up
+    /// front. the mapping must be released later using unmapFile.
+    typedef loaded_file_t (*PFN_mapEntireFile)(const char *fileName);
+
+    /// @brief release a mapping made by mapEntireFile.
+    typedef void (*PFN_unmapFile)(loaded_file_t file);
+
+    /// @brief start watching a directory, and everything under it, for files that are written, created or renamed
+    /// into place. watching a directory that is already watched does nothing.
+    /// @returns false on failure.
+    typedef bool (*PFN_watchDirectory)(const char *dirPath);
+
+    /// @brief pop the next change seen by the directory watches. changes pile up until they are polled.
+    /// @param pathOut receives the path of the file, i.e. the watched directory as it was given to watchDirectory
+    ///                joined with the path of the file within it.
+    /// @returns false when there are no more changes.
+    typedef bool (*PFN_pollFileChange)(char *pathOut, uint32_t pathSize);
+
+    /// @brief open a file for reads at any offset. see readFileAt.
+    /// @param sizeOut receives the size of the file in bytes.
+    /// @returns 0 on failure, a handle to the file on success. this must be closed with closeFile.
+    typedef intptr_t (*PFN_openFile)(const char *fileName, uint64_t *sizeOut);
+
+    /// @brief read size bytes at offset from a file from openFile. safe to call from any thread, and from several
+    /// at once.
+    /// @returns the number of bytes read, which is less than size only at the end of the file or on failure.
+    typedef uint32_t (*PFN_readFileAt)(intptr_t file, uint64_t offset, void *dst, uint32_t size);
+
+    /// @brief close a file from openFile.
+    typedef void (*PFN_closeFile)(intptr_t file);
+
+    /// @brief check if a file or directory exists, without logging anything when it does not.
+    typedef bool (*PFN_pathExists)(const char *path);
+
     /// @brief set the additional logger. fprintf_proxy will also print to fn.
     typedef void (*PFN_setAdditionalLogger)(void (*fn)(const char *));
 
@@ -1198,6 +2109,15 @@ namespace automata_engine {
     /// @returns INVALID_VOICE on failure, a handle to the voice on success.
     typedef intptr_t (*PFN_createVoice)();
 
+    /// @brief queue a buffer of 16-bit stereo LPCM to play after those already queued on the voice, without
+    /// stopping it. this is for streaming. the data is not copied, and must stay as it is until the voice is done
+    /// with it; see voiceGetQueuedBufferCount.
+    /// @returns false on failure.
+    typedef bool (*PFN_voiceQueueBuffer)(intptr_t voiceHandle, const void *data, uint32_t size);
+
+    /// @brief the number of buffers queued on the voice that it is not done with, including the one playing.
+    typedef uint32_t (*PFN_voiceGetQueuedBufferCount)(intptr_t voiceHandle);
+
     /// @brief  get numGpus many GPU infos. the infos _MUST_ be provided back to AE to free the enumerated adapters.
     /// @param pInfo   output array with size numGpus to receive the gpu info into.
     /// @param numGpus the size of the pInfo array.
@@ -1261,10 +2181,21 @@ namespace automata_engine {
             PFN_readEntireFile      readEntireFile;
             PFN_writeEntireFile     writeEntireFile;
             PFN_freeLoadedFile      freeLoadedFile;
+            PFN_mapEntireFile       mapEntireFile;
+            PFN_unmapFile           unmapFile;
+            PFN_watchDirectory      watchDirectory;
+            PFN_pollFileChange      pollFileChange;
+            PFN_openFile            openFile;
+            PFN_readFileAt          readFileAt;
+            PFN_closeFile           closeFile;
+            PFN_pathExists          pathExists;
             PFN_setAdditionalLogger setAdditionalLogger;
             PFN_voicePlayBuffer     voicePlayBuffer;
             PFN_voiceSubmitBuffer   voiceSubmitBuffer;
             PFN_createVoice         createVoice;
+            PFN_voiceQueueBuffer    voiceQueueBuffer;
+
+            PFN_voiceGetQueuedBufferCount voiceGetQueuedBufferCount;
             PFN_getGpuInfos         getGpuInfos;
             PFN_freeGpuInfos        freeGpuInfos;
 
@@ -1512,8 +2443,357 @@ namespace automata_engine {
             static aabb_t fromCube(vec3_t bottomLeft, float width);
             static aabb_t fromLine(vec3_t p0, vec3_t p1);
         };
+
+        /// @brief the six planes of a view frustum. a plane (a,b,c,d) is stored as the vec4_t (x,y,z,w), and a point
+        /// p is on the inside of the plane when dot(p, xyz) + w >= 0. the planes are normalized.
+        /// the order is left, right, bottom, top, near, far.
+        struct frustum_t {
+            vec4_t planes[6];
+        };
+
+        /// @brief an array of AABBs stored SoA, for batch queries. uses the same origin/halfDim form as aabb_t.
+        struct aabb_soa_t {
+            float   *originX, *originY, *originZ;
+            float   *halfDimX, *halfDimY, *halfDimZ;
+            uint32_t count;
+        };
+
+        /// @brief an array of bounding spheres stored SoA, for batch queries.
+        struct sphere_soa_t {
+            float   *centerX, *centerY, *centerZ;
+            float   *radius;
+            uint32_t count;
+        };
+
+        /// @brief a uniform grid of cube cells with one occupancy bit per cell. see makeVoxelGrid.
+        /// cell (x,y,z) is bit (x + dimX * (y + dimY * z)) of occupancy.
+        struct voxel_grid_t {
+            vec3_t    origin;
+            float     cellSize;
+            uint32_t  dimX, dimY, dimZ;
+            uint64_t *occupancy;
+        };
+
+        /// @brief the result of a voxel raycast.
+        /// @param faceHitIdx 0 front(-z), 1 back(+z), 2 left(-x), 3 right(+x), 4 top(+y), 5 bottom(-y).
+        ///                   -1 when the ray began inside the hit cell.
+        /// @param t          the distance along the ray to where it entered the cell, in units of the ray direction.
+        struct voxel_hit_t {
+            int32_t x, y, z;
+            int     faceHitIdx;
+            float   t;
+        };
+
+        static constexpr uint32_t SPATIAL_HASH_INVALID = 0xFFFFFFFF;
+
+        /// @brief a pair of overlapping boxes in a spatial hash, by handle. a < b.
+        struct spatial_pair_t {
+            uint32_t a, b;
+        };
+
+        /// @brief a node of a 4-wide BVH. the bounds of the four children are stored SoA so that a single
+        /// node visit tests all four children at once. a node is exactly two cache lines.
+        /// @param child  for an interior lane, the index of the child node. for a leaf lane, BVH_LEAF_BIT is set
+        ///               and the remaining bits are the index of the first primitive in bvh_t::primIndices.
+        ///               unused lanes are BVH_INVALID and have inverted (empty) bounds.
+        /// @param count  the number of primitives in a leaf lane. zero otherwise.
+        struct alignas(64) bvh_node4_t {
+            float    minX[4], minY[4], minZ[4];
+            float    maxX[4], maxY[4], maxZ[4];
+            uint32_t child[4];
+            uint32_t count[4];
+        };
+
+        static constexpr uint32_t BVH_LEAF_BIT = 0x80000000;
+        static constexpr uint32_t BVH_INVALID  = 0xFFFFFFFF;
+
+        /// @brief a bounding volume hierarchy for accelerating ray and overlap queries.
+        /// @param nodes       the flattened nodes, in depth-first order. the root is nodes[0].
+        ///                    a parent always precedes its children.
+        /// @param primIndices leaf primitive ranges index into this array, which maps to the original primitives.
+        /// @param triVerts    for a triangle BVH, three vertices per primitive, stored in primIndices order so that
+        ///                    leaves read contiguous memory. nullptr for an AABB BVH.
+        /// @param primBoxes   for an AABB BVH, a copy of the boxes stored in primIndices order. nullptr for a
+        ///                    triangle BVH.
+        /// @param bounds      the bounds of the entire hierarchy.
+        struct bvh_t {
+            bvh_node4_t *nodes;
+            uint32_t     nodeCount;
+            uint32_t    *primIndices;
+            uint32_t     primCount;
+            vec3_t      *triVerts;
+            aabb_t      *primBoxes;
+            aabb_t       bounds;
+        };
+
+        /// @brief the result of a BVH ray query.
+        /// @param primIndex the index of the primitive that was hit.
+        /// @param t         the distance along the ray to the hit, in units of the ray direction.
+        /// @param u,v       barycentric coordinates of the hit for a triangle BVH. zero otherwise.
+        struct bvh_hit_t {
+            uint32_t primIndex;
+            float    t;
+            float    u, v;
+        };
     }  // namespace math
 
+    namespace jobs {
+        /// @brief tracks a set of in-flight jobs. see jobs::submit and jobs::wait.
+        struct job_counter_t {
+            std::atomic<uint32_t> pending = 0;
+        };
+    }  // namespace jobs
+
+    namespace assets {
+        /// @brief a reference to an asset of type T. see assets::load. the default is the null handle.
+        template <typename T> struct handle_t {
+            uint32_t index      = 0;
+            uint32_t generation = 0;  // never 0 for a handle that came from a load.
+            bool     isValid() const { return generation != 0; }
+            bool     operator==(const handle_t &other) const
+            {
+                return index == other.index && generation == other.generation;
+            }
+        };
+
+        /// @brief the memory used by the assets of a type. see assets::getUsage.
+        /// @param bytes        the size of every asset of the type that is loaded, including cached ones.
+        /// @param cachedCount  how many are only loaded because of the memory budget, i.e. unreferenced.
+        /// @param loadCount    how many times an asset had to be read from disk.
+        /// @param hitCount     how many times a load found the asset already loaded, or loading.
+        struct asset_usage_t {
+            uint32_t assetCount;
+            uint32_t cachedCount;
+            size_t   bytes;
+            size_t   cachedBytes;
+            uint64_t loadCount;
+            uint64_t hitCount;
+        };
+    }  // namespace assets
+
+    /// @brief what a vertex attribute of a mesh holds. for the GL backend, this is also the shader slot it binds to.
+    enum mesh_attrib_semantic_t : uint8_t {
+        MESH_ATTRIB_POSITION = 0,
+        MESH_ATTRIB_UV,
+        MESH_ATTRIB_NORMAL,
+        MESH_ATTRIB_COUNT
+    };
+
+    /// @brief how the components of a vertex attribute are stored. the normalized formats are read by the GPU as
+    /// floats in [0,1] (UNORM) or [-1,1] (SNORM). a MESH_ATTRIB_NORMAL with two components is octahedral encoded,
+    /// see io::encodeOctahedral16.
+    enum mesh_attrib_format_t : uint8_t {
+        MESH_FORMAT_FLOAT32 = 0,
+        MESH_FORMAT_FLOAT16,
+        MESH_FORMAT_UNORM16,
+        MESH_FORMAT_SNORM16,
+        MESH_FORMAT_SNORM8,
+        MESH_FORMAT_COUNT
+    };
+
+    /// @brief one attribute within an interleaved vertex.
+    /// @param offset byte offset of the attribute from the start of the vertex.
+    struct mesh_attrib_t {
+        uint8_t semantic;
+        uint8_t format;
+        uint8_t componentCount;
+        uint8_t offset;
+    };
+
+    /// @brief the layout of an interleaved vertex.
+    struct mesh_layout_t {
+        uint32_t      stride;
+        uint32_t      attribCount;
+        mesh_attrib_t attribs[8];
+    };
+
+    /// @brief a mesh loaded from a .aemesh file.
+    /// @param vertexData     points straight into the mapped file. each vertex is laid out as per layout.
+    /// @param indexData      points straight into the mapped file. each index is indexSize bytes.
+    /// @param positionData   optional position only copy of the vertices, for depth passes. it is tightly packed
+    ///                       with a stride of positionStride, in the same format as the position attribute.
+    /// @param positionScale,positionOffset the position is positionOffset + positionScale * p, where p is the
+    ///                       position as the GPU reads it. this is the identity unless positions are UNORM16.
+    /// @param uvScale,uvOffset the same, for the UV.
+    /// @param parentFile     the mapping that the data lives in. this is retained so that we can ultimately unmap it.
+    struct loaded_mesh_t {
+        char                 modelName[13];
+        mesh_layout_t        layout;
+        const void          *vertexData;
+        uint32_t             vertexCount;
+        const void          *indexData;
+        uint32_t             indexCount;
+        uint32_t             indexSize;
+        const void          *positionData;
+        uint32_t             positionStride;
+        float                positionScale[3];
+        float                positionOffset[3];
+        float                uvScale[2];
+        float                uvOffset[2];
+        math::aabb_t         bounds;
+        struct loaded_file_t parentFile;
+    };
+
+    /// @brief a typed span over one accessor of a glTF model, which points straight into the binary chunk.
+    /// @param data           the first element. nullptr for an accessor that cannot be read in place, which is one
+    ///                       that is sparse, has no buffer view, or is in a buffer other than the binary chunk.
+    /// @param stride         bytes from one element to the next.
+    /// @param componentType  one of io::gltf_component_t.
+    /// @param componentCount 1 for SCALAR, 2 to 4 for VEC2 to VEC4, and 4, 9 or 16 for MAT2 to MAT4.
+    struct gltf_accessor_t {
+        const uint8_t *data;
+        uint32_t       count;
+        uint32_t       stride;
+        uint16_t       componentType;
+        uint8_t        componentCount;
+        bool           bNormalized;
+
+        /// @brief element i, for a T that matches the component type and count. it is copied out, as files need
+        /// not keep their elements aligned.
+        template <typename T> T at(uint32_t i) const
+        {
+            T result;
+            memcpy(&result, data + size_t(i) * stride, sizeof(T));
+            return result;
+        }
+    };
+
+    /// @brief one draw of a glTF mesh. attributes that the primitive does not have are empty accessors.
+    /// @param material the index of its material, or -1.
+    /// @param mode     the glTF primitive mode, e.g. io::GLTF_MODE_TRIANGLES.
+    struct gltf_primitive_t {
+        gltf_accessor_t position;
+        gltf_accessor_t normal;
+        gltf_accessor_t uv;
+        gltf_accessor_t indices;
+        int32_t         material;
+        uint32_t        mode;
+    };
+
+    /// @param primitiveCount the primitives of the mesh, which start at firstPrimitive in gltf_model_t::primitives.
+    struct gltf_mesh_t {
+        char     name[32];
+        uint32_t firstPrimitive;
+        uint32_t primitiveCount;
+    };
+
+    /// @param mesh       the index of its mesh, or -1.
+    /// @param matrix     the local transform, column-major as in glTF.
+    /// @param childCount the children of the node, which start at firstChild in gltf_model_t::children.
+    struct gltf_node_t {
+        int32_t  mesh;
+        float    matrix[16];
+        uint32_t firstChild;
+        uint32_t childCount;
+    };
+
+    /// @brief a glTF model from io::loadGlb. the arrays are in the order of the file, so the indices that glTF uses
+    /// apply to them as is.
+    /// @param accessors  every accessor in the file.
+    /// @param roots      the root nodes of the default scene.
+    /// @param binary     the binary chunk, which every accessor points into.
+    /// @param block      internal storage for the arrays.
+    /// @param parentFile the mapping that the data lives in, if any.
+    struct gltf_model_t {
+        gltf_accessor_t     *accessors;
+        uint32_t             accessorCount;
+        gltf_mesh_t         *meshes;
+        uint32_t             meshCount;
+        gltf_primitive_t    *primitives;
+        uint32_t             primitiveCount;
+        gltf_node_t         *nodes;
+        uint32_t             nodeCount;
+        uint32_t            *children;
+        uint32_t            *roots;
+        uint32_t             rootCount;
+        const uint8_t       *binary;
+        size_t               binarySize;
+        void                *block;
+        struct loaded_file_t parentFile;
+    };
+
+    /// @brief how io::packMesh stores each attribute. the default is the full precision layout.
+    /// @param positionFormat   MESH_FORMAT_FLOAT32, FLOAT16, or UNORM16 relative to the mesh bounds.
+    /// @param uvFormat         MESH_FORMAT_FLOAT32, FLOAT16, or UNORM16 relative to the UV bounds.
+    /// @param normalFormat     MESH_FORMAT_FLOAT32, or SNORM16 / SNORM8 for an octahedral encoded normal.
+    /// @param bIndex16         use 16 bit indices when the vertex count allows it.
+    /// @param bPositionStream  also write the position only stream, see loaded_mesh_t::positionData.
+    struct mesh_quantization_t {
+        uint8_t positionFormat  = MESH_FORMAT_FLOAT32;
+        uint8_t uvFormat        = MESH_FORMAT_FLOAT32;
+        uint8_t normalFormat    = MESH_FORMAT_FLOAT32;
+        bool    bIndex16        = false;
+        bool    bPositionStream = false;
+        /// @brief 16 bit positions and UVs, 2x16 bit octahedral normals and 16 bit indices. 16 bytes per vertex
+        /// rather than 32.
+        static mesh_quantization_t compact();
+    };
+
+    /// @brief a small cluster of triangles that can be culled as a unit. see io::buildMeshlets.
+    /// @param vertexOffset   where the meshlet's vertices start in meshlet_set_t::vertices.
+    /// @param triangleOffset where the meshlet's triangles start in meshlet_set_t::triangles, in triangles.
+    /// @param center,radius  bounding sphere of the meshlet.
+    /// @param coneAxis,coneCutoff normal cone of the meshlet. see io::isMeshletBackfacing for how to test it.
+    struct meshlet_t {
+        uint32_t vertexOffset;
+        uint32_t triangleOffset;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        float    center[3];
+        float    radius;
+        float    coneAxis[3];
+        float    coneCutoff;
+    };
+
+    /// @brief the meshlets of a mesh.
+    /// @param vertices  indices into the mesh's vertices. each meshlet owns a range of these.
+    /// @param triangles three bytes per triangle, each an index into the meshlet's range of vertices.
+    struct meshlet_set_t {
+        meshlet_t *meshlets;
+        uint32_t   meshletCount;
+        uint32_t  *vertices;
+        uint32_t   vertexCount;
+        uint8_t   *triangles;
+        uint32_t   triangleCount;
+    };
+
+    /// @brief one level of detail of a mesh. see io::buildLodChain.
+    /// @param indexOffset,indexCount the range of mesh_lod_chain_t::indices that the LOD draws.
+    /// @param error the largest deviation from the full detail mesh, in the units of the mesh.
+    struct mesh_lod_t {
+        uint32_t indexOffset;
+        uint32_t indexCount;
+        float    error;
+    };
+
+    /// @brief the levels of detail of a mesh, all indexing into the vertices of the full detail mesh.
+    /// @param lods    the first is the full detail mesh, and each after it has fewer triangles and more error.
+    /// @param indices the index buffers of every LOD, one after the other.
+    struct mesh_lod_chain_t {
+        mesh_lod_t *lods;
+        uint32_t    lodCount;
+        uint32_t   *indices;
+        uint32_t    indexCount;
+    };
+
+    /// @brief a file to put in an archive. see io::packArchive.
+    /// @param path the path that the file is looked up by once the archive is mounted.
+    struct archive_source_t {
+        const char *path;
+        const void *data;
+        size_t      size;
+    };
+
+    /// @brief post-transform vertex cache statistics for an index buffer. see io::analyzeVertexCache.
+    /// @param acmr average cache miss ratio, i.e. vertex shader invocations per triangle. 0.5 is the ideal for
+    ///             a large regular grid, and 3 is the worst case.
+    /// @param atvr average transformed vertex ratio, i.e. vertex shader invocations per vertex. 1 is the ideal.
+    struct vertex_cache_stats_t {
+        uint32_t transformedVertices;
+        float    acmr;
+        float    atvr;
+    };
+
 #if defined(AUTOMATA_ENGINE_VK_BACKEND)
     namespace VK {
         struct RenderPass : public VkRenderPassCreateInfo {};
@@ -1588,12 +2868,15 @@ namespace automata_engine {
     namespace GL {
 
         /// @brief A struct to describe a vertex attribute.
-        /// @param type     is the data type of the attribute.
-        /// @param count    is the number of elements in the attribute.
+        /// @param type       is the data type of the attribute.
+        /// @param count      is the number of elements in the attribute.
+        /// @param normalized whether an integer type is read by the shader as a normalized float, rather than as
+        ///                   an integer.
         struct vertex_attrib_t {
             GLenum type;
             uint32_t count;
-            vertex_attrib_t(GLenum type, uint32_t count);
+            bool normalized;
+            vertex_attrib_t(GLenum type, uint32_t count, bool normalized = false);
         };
 
         /// @brief A wrapper struct around an OpenGL VBO (Vertex Buffer Object).
@@ -1605,9 +2888,11 @@ namespace automata_engine {
 
         /// @brief A wrapper struct around an OpenGL IBO (Index Buffer Object).
         /// @param count    is the number of indices in the IBO.
+        /// @param type     is the type of each index, to pass to glDrawElements.
         struct ibo_t {
             uint32_t count;
             GLuint glHandle;
+            GLenum type = GL_UNSIGNED_INT;
         };
 
         /// @brief A struct to describe a set of vertex attributes from a VBO.
@@ -4,7 +4,19 @@
 #include <stdlib.h>
 #include <cassert>
 #include <cstdint>
+#include <climits>
+#include <cstring>
+#include <cfloat>
+#include <charconv>
 #include <functional>
+#include <string>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 // TODO(Noah): Do we trust cstdint?
 #include <cstdint>
 
@@ -46,8 +58,8 @@ privDefer<F> defer_func(F f) {
 // Inits the stretchy buffer.
 #define StretchyBufferInitWithCount(a,n)  (StretchyBuffer_Grow(a,n), StretchyBuffer_GetCount(a)=n)
 #define StretchyBufferInit(a)             (StretchyBuffer_Grow(a,1))
-// Frees the strechy buffer. Warning: the array a will be a dangling pointer after this call.
-#define StretchyBufferFree(a)             ((a) ? free(StretchyBuffer_GetMetadataPtr(a)), 0 : 0)
+// Frees the strechy buffer and sets a back to null.
+#define StretchyBufferFree(a)             ((a) ? (free(StretchyBuffer_GetMetadataPtr(a)), (a) = nullptr, 0) : 0)
 // Pushes a new element to the stretchy buffer.
 #define StretchyBufferPush(a,v)           (StretchyBuffer_MaybeGrow(a,1), (a)[StretchyBuffer_GetCount(a)++] = (v))
 // Returns a reference to the count of the stretchy buffer.
@@ -68,23 +80,734 @@ privDefer<F> defer_func(F f) {
 
 static void StretchyBuffer_Growf(void **arr, int increment, int itemsize)
 {
-   int m = *arr ? 2 * StretchyBuffer_GetBufferSize(*arr) + increment : increment + 1;
+   // NOTE(Noah): the count and capacity are ints, so a stretchy buffer tops out at INT_MAX items. ae::array does not.
+   size_t m = *arr ? 2 * size_t(StretchyBuffer_GetBufferSize(*arr)) + increment : size_t(increment) + 1;
+   assert(m <= size_t(INT_MAX));
    void *p = realloc(*arr ? StretchyBuffer_GetMetadataPtr(*arr) : 0, itemsize * m + sizeof(int) * 2);
    assert(p);
    if (p) {
       if (!*arr) ((int *) p)[1] = 0;
       *arr = (void *) ((int *) p + 2);
-      StretchyBuffer_GetBufferSize(*arr) = m;
+      StretchyBuffer_GetBufferSize(*arr) = int(m);
    }
 }
 
 
 
-// TODO(Noah): Let's do some proper fast string functions, yeah?
-// TODO(Noah): Let's also unit test these functions, yeah?
+// NOTE(Noah): ae::array is the typed replacement for stretchy buffers. sizes are size_t, memory comes from an
+// allocator_t (the heap, an arena or a pool), the first InlineCount items can live inside the array itself, and
+// types that can be moved with memcpy grow with a single realloc. new code should use it, and the shims at the end
+// convert to and from stretchy buffers for the APIs that still trade in them.
+
+namespace automata_engine {
+    /// @brief the one call an allocator makes. it allocates (ptr == nullptr), resizes, or frees (newBytes == 0) a
+    /// block, and returns the block, or nullptr if it could not. blocks are aligned to 16 bytes.
+    typedef void *(*PFN_allocatorRealloc)(void *user, void *ptr, size_t oldBytes, size_t newBytes);
+
+    /// @brief a zero allocator_t is the CRT heap. that way a default array stores no function pointer, which would
+    /// go stale when the game DLL is reloaded.
+    struct allocator_t {
+        PFN_allocatorRealloc pfnRealloc;
+        void                *user;
+    };
+
+    inline void *allocatorRealloc(const allocator_t &allocator, void *ptr, size_t oldBytes, size_t newBytes)
+    {
+        if (allocator.pfnRealloc) return allocator.pfnRealloc(allocator.user, ptr, oldBytes, newBytes);
+        if (newBytes == 0) {
+            free(ptr);
+            return nullptr;
+        }
+        return realloc(ptr, newBytes);
+    }
+
+    /// @brief a bump allocator over a block of memory that the caller owns. resizing the most recent block grows
+    /// or shrinks it in place, and everything is let go at once with arenaReset. once the arena is full, blocks
+    /// come from the heap instead. not thread-safe.
+    struct arena_t {
+        uint8_t *base;
+        size_t   size;
+        size_t   used;
+        size_t   last;  // where the most recent block starts.
+    };
+
+    void        arenaInit(arena_t *arena, void *memory, size_t size);
+    /// @returns 16 byte aligned memory from the arena, or nullptr if it is full.
+    void       *arenaAlloc(arena_t *arena, size_t bytes);
+    void        arenaReset(arena_t *arena);
+    allocator_t arenaAllocator(arena_t *arena);
+
+    /// @brief blocks of one size carved from a block of memory that the caller owns, handed out from a free list.
+    /// this suits many small arrays that stay under blockSize, which can then grow in place up to it. bigger
+    /// requests, and any once the pool is empty, go to the heap. not thread-safe.
+    struct pool_t {
+        uint8_t *base;
+        size_t   blockSize;
+        size_t   blockCount;
+        void    *freeList;
+    };
+
+    /// @param blockSize is rounded up to a multiple of 16.
+    void        poolInit(pool_t *pool, void *memory, size_t size, size_t blockSize);
+    /// @returns a block from the pool, or nullptr if it is empty.
+    void       *poolAlloc(pool_t *pool);
+    void        poolFree(pool_t *pool, void *block);
+    allocator_t poolAllocator(pool_t *pool);
+
+    /// @brief whether a T can be moved to a new address with memcpy, with nothing left to destroy at the old one.
+    /// this is true of more than the trivially copyable types. specialize it for types that own memory (but do not
+    /// point into themselves) so that arrays of them grow with realloc too.
+    template <typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename T, size_t N>
+    struct array_storage_t {
+        alignas(T) uint8_t bytes[N * sizeof(T)];
+        T *inlineItems() { return (T *)bytes; }
+    };
+    template <typename T>
+    struct array_storage_t<T, 0> {
+        T *inlineItems() { return nullptr; }
+    };
+
+    /// @brief a growable array of T. the first InlineCount items are stored in the array itself, so small arrays
+    /// do not allocate at all. pointers to items are invalidated when the array grows. arrays move but do not
+    /// copy; use append to copy one.
+    template <typename T, size_t InlineCount = 0>
+    struct array : private array_storage_t<T, InlineCount> {
+        static_assert(alignof(T) <= 16, "allocators only promise 16 byte alignment");
+
+        T          *data     = this->inlineItems();
+        size_t      count    = 0;
+        size_t      capacity = InlineCount;
+        allocator_t allocator = {};
+
+        array() = default;
+        explicit array(allocator_t allocator) : allocator(allocator) {}
+        array(const array &) = delete;
+        array &operator=(const array &) = delete;
+        array(array &&other) : allocator(other.allocator) { take(other); }
+        array &operator=(array &&other)
+        {
+            if (this != &other) {
+                reset();
+                allocator = other.allocator;
+                take(other);
+            }
+            return *this;
+        }
+        ~array() { reset(); }
+
+        size_t size() const { return count; }
+        bool   empty() const { return count == 0; }
+        T     *begin() { return data; }
+        T     *end() { return data + count; }
+        const T *begin() const { return data; }
+        const T *end() const { return data + count; }
+        T     &back() { return data[count - 1]; }
+        T     &operator[](size_t i)
+        {
+            assert(i < count);
+            return data[i];
+        }
+        const T &operator[](size_t i) const
+        {
+            assert(i < count);
+            return data[i];
+        }
+
+        /// @brief make room for at least n items, so that the next n - count pushes do not allocate.
+        void reserve(size_t n)
+        {
+            if (n > capacity) setCapacity(n);
+        }
+
+        T &push(const T &item)
+        {
+            if (count == capacity) {
+                // item may be in this array, so it has to be copied out before the array moves.
+                T copy(item);
+                grow(count + 1);
+                return *new (data + count++) T(std::move(copy));
+            }
+            return *new (data + count++) T(item);
+        }
+        T &push(T &&item)
+        {
+            if (count == capacity) {
+                T copy(std::move(item));
+                grow(count + 1);
+                return *new (data + count++) T(std::move(copy));
+            }
+            return *new (data + count++) T(std::move(item));
+        }
+        template <typename... Args>
+        T &emplace(Args &&...args)
+        {
+            if (count == capacity) grow(count + 1);
+            return *new (data + count++) T(std::forward<Args>(args)...);
+        }
+
+        /// @brief copy n items to the end. items must not be in this array.
+        void append(const T *items, size_t n)
+        {
+            if (count + n > capacity) grow(count + n);
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                if (n) memcpy(data + count, items, n * sizeof(T));
+            } else {
+                for (size_t i = 0; i < n; i++) new (data + count + i) T(items[i]);
+            }
+            count += n;
+        }
+
+        /// @brief add n default initialized items to the end (so plain data is left uninitialized), to be written
+        /// to in place.
+        /// @returns the first of them.
+        T *extend(size_t n)
+        {
+            if (count + n > capacity) grow(count + n);
+            for (size_t i = 0; i < n; i++) new (data + count + i) T;
+            count += n;
+            return data + count - n;
+        }
+
+        void pop()
+        {
+            assert(count > 0);
+            data[--count].~T();
+        }
+
+        /// @brief remove item i by moving the last item into its place.
+        void removeSwap(size_t i)
+        {
+            assert(i < count);
+            if (i != count - 1) data[i] = std::move(data[count - 1]);
+            pop();
+        }
+
+        /// @brief resize to n items, value initializing the new ones.
+        void resize(size_t n)
+        {
+            if (n > capacity) grow(n);
+            for (size_t i = count; i < n; i++) new (data + i) T();
+            for (size_t i = n; i < count; i++) data[i].~T();
+            count = n;
+        }
+
+        void clear()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t i = 0; i < count; i++) data[i].~T();
+            }
+            count = 0;
+        }
+
+        /// @brief clear and give the memory back to the allocator.
+        void reset()
+        {
+            clear();
+            if (data != this->inlineItems()) allocatorRealloc(allocator, data, capacity * sizeof(T), 0);
+            data     = this->inlineItems();
+            capacity = InlineCount;
+        }
+
+      private:
+        void grow(size_t n)
+        {
+            // NOTE(Noah): 1.5x rather than 2x, so that the blocks freed along the way can add up to the next one.
+            size_t next  = capacity + capacity / 2;
+            size_t least = (64 / sizeof(T) > 4) ? 64 / sizeof(T) : 4;
+            if (next < least) next = least;
+            setCapacity(n > next ? n : next);
+        }
+
+        void setCapacity(size_t n)
+        {
+            assert(n >= count);
+            T *inlineItems = this->inlineItems();
+            if (n <= InlineCount) return;  // the items are inline and stay there.
+            T *items = nullptr;
+            if constexpr (is_trivially_relocatable<T>::value) {
+                if (data != inlineItems) {
+                    items = (T *)allocatorRealloc(allocator, data, capacity * sizeof(T), n * sizeof(T));
+                    assert(items);
+                    data     = items;
+                    capacity = n;
+                    return;
+                }
+            }
+            items = (T *)allocatorRealloc(allocator, nullptr, 0, n * sizeof(T));
+            assert(items);
+            relocate(items, data, count);
+            if (data != inlineItems) allocatorRealloc(allocator, data, capacity * sizeof(T), 0);
+            data     = items;
+            capacity = n;
+        }
+
+        static void relocate(T *dst, T *src, size_t n)
+        {
+            if constexpr (is_trivially_relocatable<T>::value) {
+                if (n) memcpy((void *)dst, (const void *)src, n * sizeof(T));
+            } else {
+                for (size_t i = 0; i < n; i++) {
+                    new (dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+        }
+
+        // other's allocator has already been copied over, so that its block can be adopted.
+        void take(array &other)
+        {
+            if (other.data == other.inlineItems()) {
+                relocate(data, other.data, other.count);
+                count = other.count;
+            } else {
+                data     = other.data;
+                count    = other.count;
+                capacity = other.capacity;
+            }
+            other.data     = other.inlineItems();
+            other.count    = 0;
+            other.capacity = InlineCount;
+        }
+    };
+
+    // an array with no inline items is just a pointer to its block, so it can be moved with memcpy.
+    template <typename T>
+    struct is_trivially_relocatable<array<T, 0>> : std::true_type {};
+
+    /// @brief move a stretchy buffer into a new array, freeing the stretchy buffer and setting it to null.
+    template <typename T>
+    array<T> arrayFromStretchyBuffer(T *&stretchyBuffer, allocator_t allocator = {})
+    {
+        array<T> result(allocator);
+        result.reserve(size_t(StretchyBufferCount(stretchyBuffer)));
+        result.append(stretchyBuffer, size_t(StretchyBufferCount(stretchyBuffer)));
+        StretchyBufferFree(stretchyBuffer);
+        return result;
+    }
+
+    /// @brief copy an array into a new stretchy buffer, for the APIs that still take one. plain data only.
+    template <typename T, size_t N>
+    T *arrayToStretchyBuffer(const array<T, N> &items)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "stretchy buffers move their items with realloc");
+        assert(items.count <= size_t(INT_MAX));
+        T *stretchyBuffer = nullptr;
+        if (items.count == 0) return stretchyBuffer;
+        StretchyBufferInitWithCount(stretchyBuffer, int(items.count));
+        memcpy(stretchyBuffer, items.data, items.count * sizeof(T));
+        return stretchyBuffer;
+    }
+
+    inline uint32_t countTrailingZeros(uint32_t x)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return uint32_t(index);
+#else
+        return uint32_t(__builtin_ctz(x));
+#endif
+    }
+
+    /// @brief a 64-bit hash of an integer with one multiply. the top bits are the well mixed ones, and the bottom
+    /// bits get the top folded into them.
+    inline uint64_t hashInteger(uint64_t x)
+    {
+        x *= 0x9E3779B97F4A7C15ull;
+        return x ^ (x >> 32);
+    }
+
+    /// @brief a 64-bit hash of any run of bytes, 8 at a time.
+    inline uint64_t hashBytes(const void *bytes, size_t size)
+    {
+        const uint8_t *p = (const uint8_t *)bytes;
+        uint64_t       h = 0xCBF29CE484222325ull ^ (size * 0x100000001B3ull);
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word;
+            memcpy(&word, p, 8);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+            h ^= h >> 29;
+        }
+        if (size > 0) {
+            uint64_t word = 0;
+            memcpy(&word, p, size);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        }
+        h ^= h >> 32;
+        return hashInteger(h);
+    }
+
+    /// @brief how hash_map hashes and compares a K. the default hashes and compares the bytes of the key, which
+    /// is only right for keys without padding or floats; specialize it (or pass another hasher to hash_map) for
+    /// those. integers, enums and pointers take the fast path of one multiply to hash and one compare to match.
+    template <typename K, typename = void>
+    struct hasher {
+        static_assert(std::has_unique_object_representations_v<K>, "this key needs its own hasher");
+        static uint64_t hash(const K &key) { return hashBytes(&key, sizeof(K)); }
+        static bool     equal(const K &a, const K &b) { return memcmp(&a, &b, sizeof(K)) == 0; }
+    };
+    template <typename K>
+    struct hasher<K, std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K> || std::is_pointer_v<K>>> {
+        static uint64_t hash(K key)
+        {
+            if constexpr (std::is_pointer_v<K>) return hashInteger(uint64_t(uintptr_t(key)));
+            else return hashInteger(uint64_t(key));
+        }
+        static bool equal(K a, K b) { return a == b; }
+    };
+
+    /// @brief hashes null-terminated strings by their contents, for hash_map<const char *, V, string_hasher_t>.
+    /// the map keeps the pointers, not copies of the strings.
+    struct string_hasher_t {
+        static uint64_t hash(const char *key) { return hashBytes(key, strlen(key)); }
+        static bool     equal(const char *a, const char *b) { return strcmp(a, b) == 0; }
+    };
+
+    // NOTE(Noah): hash_map is a Swiss table. next to the slots sits a control byte per slot, which is either empty,
+    // deleted (a tombstone), or the top 7 bits of the hash of the key in the slot. a lookup loads a group of 16
+    // control bytes and compares all of them against the key's 7 bits with SSE2, so only slots whose bits match
+    // have their keys compared, and a group that holds an empty byte ends the search. groups are probed in
+    // triangular order, which visits every group of a power of two count. the table is kept at most 7/8 full.
+
+    /// @brief an open addressing hash map from K to V. pointers to values are invalidated by inserts that grow the
+    /// table and by rehash. maps move but do not copy.
+    template <typename K, typename V, typename H = hasher<K>>
+    struct hash_map {
+        struct entry_t {
+            K key;
+            V value;
+        };
+        // entries are carved from the same block right after the control bytes.
+        static_assert(alignof(entry_t) <= 16, "allocators only promise 16 byte alignment");
+
+        int8_t     *ctrl       = nullptr;
+        entry_t    *entries    = nullptr;
+        size_t      count      = 0;
+        size_t      capacity   = 0;  // a multiple of 16.
+        size_t      growthLeft = 0;  // how many more empty slots can be filled before the table must grow.
+        allocator_t allocator  = {};
+
+        hash_map() = default;
+        explicit hash_map(allocator_t allocator) : allocator(allocator) {}
+        hash_map(const hash_map &) = delete;
+        hash_map &operator=(const hash_map &) = delete;
+        hash_map(hash_map &&other) { take(other); }
+        hash_map &operator=(hash_map &&other)
+        {
+            if (this != &other) {
+                reset();
+                take(other);
+            }
+            return *this;
+        }
+        ~hash_map() { reset(); }
+
+        size_t size() const { return count; }
+        bool   empty() const { return count == 0; }
+
+        /// @returns the value for key, or nullptr if there is none.
+        V *find(const K &key)
+        {
+            size_t slot = findSlot(key, H::hash(key));
+            return (slot == SIZE_MAX) ? nullptr : &entries[slot].value;
+        }
+        const V *find(const K &key) const { return const_cast<hash_map *>(this)->find(key); }
+        bool     contains(const K &key) const { return find(key) != nullptr; }
+
+        /// @brief insert key with value if key is not in the map yet.
+        /// @param pInserted if not null, says whether key was inserted.
+        /// @returns the value now stored for key, which is the old one if key was already there.
+        V &findOrInsert(const K &key, const V &value, bool *pInserted = nullptr)
+        {
+            uint64_t h         = H::hash(key);
+            size_t   slot      = findSlot(key, h);
+            bool     bInserted = (slot == SIZE_MAX);
+            if (bInserted) slot = insert(key, value, h);
+            if (pInserted) *pInserted = bInserted;
+            return entries[slot].value;
+        }
+
+        /// @returns the value for key, inserting a value initialized one if it is not there.
+        V &operator[](const K &key) { return findOrInsert(key, V()); }
+
+        /// @returns whether key was in the map.
+        bool remove(const K &key)
+        {
+            size_t slot = findSlot(key, H::hash(key));
+            if (slot == SIZE_MAX) return false;
+            entries[slot].~entry_t();
+            count--;
+            // a probe stops at the first group with an empty byte, so if this group has one already, no probe
+            // can go past it, and the slot can go back to empty rather than to a tombstone.
+            __m128i group = _mm_load_si128((const __m128i *)(ctrl + (slot & ~size_t(15))));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(CTRL_EMPTY)))) {
+                ctrl[slot] = CTRL_EMPTY;
+                growthLeft++;
+            } else {
+                ctrl[slot] = CTRL_DELETED;
+            }
+            return true;
+        }
+
+        /// @brief make room for n items in total, so that inserting up to that many does not rehash.
+        void reserve(size_t n)
+        {
+            if (n <= count + growthLeft) return;
+            size_t needed = capacityFor(n);
+            rehashTo(needed > capacity ? needed : capacity);
+        }
+
+        /// @brief rebuild the table with room for n items, or just for the items it holds if that is more. this
+        /// drops all tombstones, and with a small n is how a map is shrunk.
+        void rehash(size_t n) { rehashTo(capacityFor(n > count ? n : count)); }
+
+        /// @brief calls f(const K &key, V &value) for each item, in no particular order.
+        template <typename F>
+        void forEach(F &&f)
+        {
+            for (size_t i = 0; i < capacity; i++) {
+                if (ctrl[i] >= 0) f((const K &)entries[i].key, entries[i].value);
+            }
+        }
+
+        void clear()
+        {
+            if (capacity == 0) return;
+            if constexpr (!std::is_trivially_destructible_v<entry_t>) {
+                for (size_t i = 0; i < capacity; i++) {
+                    if (ctrl[i] >= 0) entries[i].~entry_t();
+                }
+            }
+            memset(ctrl, CTRL_EMPTY, capacity);
+            count      = 0;
+            growthLeft = maxLoad(capacity);
+        }
+
+        /// @brief clear and give the memory back to the allocator.
+        void reset()
+        {
+            clear();
+            if (ctrl != nullptr) allocatorRealloc(allocator, ctrl, blockBytes(capacity), 0);
+            ctrl       = nullptr;
+            entries    = nullptr;
+            capacity   = 0;
+            growthLeft = 0;
+        }
+
+      private:
+        static constexpr int8_t CTRL_EMPTY   = -128;
+        static constexpr int8_t CTRL_DELETED = -2;
+
+        static size_t maxLoad(size_t n) { return n - n / 8; }
+        static size_t blockBytes(size_t n) { return n + n * sizeof(entry_t); }
+        static size_t capacityFor(size_t n)
+        {
+            size_t result = 16;
+            while (maxLoad(result) < n) result *= 2;
+            return result;
+        }
+
+        // the slot holding key, or SIZE_MAX.
+        size_t findSlot(const K &key, uint64_t h) const
+        {
+            if (count == 0) return SIZE_MAX;
+            const __m128i match = _mm_set1_epi8(int8_t(h >> 57));
+            const __m128i empty = _mm_set1_epi8(CTRL_EMPTY);
+            const size_t  mask  = capacity / 16 - 1;
+            size_t        g     = size_t(h) & mask;
+            for (size_t step = 1;; step++) {
+                __m128i  group = _mm_load_si128((const __m128i *)(ctrl + g * 16));
+                uint32_t bits  = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(group, match)));
+                while (bits) {
+                    size_t slot = g * 16 + countTrailingZeros(bits);
+                    if (H::equal(entries[slot].key, key)) return slot;
+                    bits &= bits - 1;
+                }
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(group, empty))) return SIZE_MAX;
+                g = (g + step) & mask;
+            }
+        }
+
+        // the first empty or deleted slot on h's probe sequence.
+        size_t findAvailable(uint64_t h) const
+        {
+            const size_t mask = capacity / 16 - 1;
+            size_t       g    = size_t(h) & mask;
+            for (size_t step = 1;; step++) {
+                // empty and deleted are the control bytes with the top bit set.
+                __m128i  group = _mm_load_si128((const __m128i *)(ctrl + g * 16));
+                uint32_t bits  = uint32_t(_mm_movemask_epi8(group));
+                if (bits) return g * 16 + countTrailingZeros(bits);
+                g = (g + step) & mask;
+            }
+        }
+
+        // insert a key that is known not to be in the map, growing the table if need be. this is kept apart from
+        // findOrInsert so that the lookup, which is the common case, stays small enough to inline.
+        size_t insert(const K &key, const V &value, uint64_t h)
+        {
+            size_t slot = (capacity > 0) ? findAvailable(h) : 0;
+            if (capacity == 0 || (growthLeft == 0 && ctrl[slot] == CTRL_EMPTY)) {
+                // when tombstones are most of what filled the table, rebuilding at the same size is enough.
+                rehashTo((capacity > 0 && count < maxLoad(capacity) / 2) ? capacity : capacityFor(count + 1));
+                slot = findAvailable(h);
+            }
+            growthLeft -= (ctrl[slot] == CTRL_EMPTY);
+            ctrl[slot] = int8_t(h >> 57);
+            count++;
+            new (&entries[slot]) entry_t{key, value};
+            return slot;
+        }
+
+        void rehashTo(size_t newCapacity)
+        {
+            assert(newCapacity % 16 == 0 && maxLoad(newCapacity) >= count);
+            int8_t  *oldCtrl     = ctrl;
+            entry_t *oldEntries  = entries;
+            size_t   oldCapacity = capacity;
+
+            ctrl = (int8_t *)allocatorRealloc(allocator, nullptr, 0, blockBytes(newCapacity));
+            assert(ctrl);
+            entries  = (entry_t *)(ctrl + newCapacity);
+            capacity = newCapacity;
+            memset(ctrl, CTRL_EMPTY, newCapacity);
+            for (size_t i = 0; i < oldCapacity; i++) {
+                if (oldCtrl[i] < 0) continue;
+                size_t slot = findAvailable(H::hash(oldEntries[i].key));
+                ctrl[slot]  = oldCtrl[i];
+                if constexpr (is_trivially_relocatable<K>::value && is_trivially_relocatable<V>::value) {
+                    memcpy((void *)&entries[slot], (const void *)&oldEntries[i], sizeof(entry_t));
+                } else {
+                    new (&entries[slot]) entry_t{std::move(oldEntries[i].key), std::move(oldEntries[i].value)};
+                    oldEntries[i].~entry_t();
+                }
+            }
+            growthLeft = maxLoad(newCapacity) - count;
+            if (oldCtrl != nullptr) allocatorRealloc(allocator, oldCtrl, blockBytes(oldCapacity), 0);
+        }
+
+        void take(hash_map &other)
+        {
+            ctrl             = other.ctrl;
+            entries          = other.entries;
+            count            = other.count;
+            capacity         = other.capacity;
+            growthLeft       = other.growthLeft;
+            allocator        = other.allocator;
+            other.ctrl       = nullptr;
+            other.entries    = nullptr;
+            other.count      = 0;
+            other.capacity   = 0;
+            other.growthLeft = 0;
+        }
+    };
+}  // namespace automata_engine
+
+
+// NOTE(Noah): nc::str is the toolkit for pulling text formats apart. everything works on [p, end) ranges and on
+// view_t tokens that point back into the caller's buffer, so the text is never written to or copied and any number of
+// threads can parse at once. the scans look at 16 bytes at a time with SSE2, or 32 with AVX2.
 
 namespace nc {
   namespace str {
+    // a run of chars inside someone else's buffer. it is not null-terminated.
+    struct view_t {
+      const char *data;
+      size_t      length;
+
+      const char *begin() const { return data; }
+      const char *end() const { return data + length; }
+      bool        empty() const { return length == 0; }
+      bool        operator==(const char *s) const { return strlen(s) == length && memcmp(data, s, length) == 0; }
+    };
+
+    inline bool isEOL(char c) { return c == '\n' || c == '\r'; }
+    inline bool isEOLOrEOF(char c) { return isEOL(c) || c == 0; }
+    inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+    inline bool isDigit(char c) { return uint32_t(c - '0') < 10; }
+
+    inline const char *skipSpace(const char *p, const char *end)
+    {
+      while (p < end && isSpace(*p)) p++;
+      return p;
+    }
+
+    /// @returns the first c in [p, end), or end if there is none.
+    const char *findChar(const char *p, const char *end, char c);
+    /// @returns the first '\n' or '\r' in [p, end), or end if there is none.
+    const char *findLineEnd(const char *p, const char *end);
+    /// @returns how many times c occurs in [p, end).
+    size_t countChar(const char *p, const char *end, char c);
+
+    /// @brief skips any empty lines at *pCursor and returns the next line through pLine, without its EOL chars.
+    /// *pCursor is left just past the line. CRLF and LF files both work.
+    /// @returns false once there are no lines left.
+    bool nextLine(const char **pCursor, const char *end, view_t *pLine);
+
+    /// @brief parses an optionally signed decimal integer at p. values out of range saturate.
+    /// @returns one past the last char used, or p if there was no number there, in which case *out is 0.
+    const char *parseInt(const char *p, const char *end, int64_t *out);
+    /// @brief parses a decimal float at p (1, -1.5, .5, 1e-3, inf, nan). the result is correctly rounded. unlike
+    /// strtof, hex floats are not taken: "0x1p3" parses as 0 and stops at the x.
+    /// @returns one past the last char used, or p if there was no number there, in which case *out is 0.
+    const char *parseFloat(const char *p, const char *end, float *out);
+
+    /// @brief calls f(view_t token, uint32_t index) for each token between delimiters. empty tokens between two
+    /// delimiters are passed along, but a delimiter at the very end does not make an empty last token.
+    template <typename F>
+    void forEachToken(view_t line, char delimiter, F &&f)
+    {
+      const char *p = line.begin(), *end = line.end();
+      uint32_t index = 0;
+      while (p < end) {
+        const char *q = findChar(p, end, delimiter);
+        f(view_t{p, size_t(q - p)}, index++);
+        p = q + 1;
+      }
+    }
+
+    /// @brief calls f(view_t word, uint32_t index) for each run of chars between spaces and tabs.
+    template <typename F>
+    void forEachWord(view_t line, F &&f)
+    {
+      const char *p = line.begin(), *end = line.end();
+      uint32_t index = 0;
+      while ((p = skipSpace(p, end)) < end) {
+        const char *q = p;
+        while (q < end && !isSpace(*q)) q++;
+        f(view_t{p, size_t(q - p)}, index++);
+        p = q;
+      }
+    }
+
+    /// @brief like forEachToken, but calls f(int64_t, uint32_t index). tokens that are not numbers give 0.
+    template <typename F>
+    void forEachInt(view_t line, char delimiter, F &&f)
+    {
+      forEachToken(line, delimiter, [&](view_t token, uint32_t index) {
+        int64_t value;
+        parseInt(skipSpace(token.begin(), token.end()), token.end(), &value);
+        f(value, index);
+      });
+    }
+
+    /// @brief like forEachToken, but calls f(float, uint32_t index). tokens that are not numbers give 0.
+    template <typename F>
+    void forEachFloat(view_t line, char delimiter, F &&f)
+    {
+      forEachToken(line, delimiter, [&](view_t token, uint32_t index) {
+        float value;
+        parseFloat(skipSpace(token.begin(), token.end()), token.end(), &value);
+        f(value, index);
+      });
+    }
+
+    // NOTE(Noah): the functions below are the older null-terminated interface, kept for code that still uses it.
+    // they sit on top of the ones above, but pay for a std::function call per token, and split copies each token
+    // out to null-terminate it. prefer the above.
     enum get_line_result {
       NC_EOL, NC_EOF
     };
@@ -97,17 +820,166 @@ namespace nc {
     void splitFloat(char *line, int32_t lineLen, char delimiter, std::function<void(float, uint32_t)>);
     void splitInt(char *line, int32_t lineLen, char delimiter, std::function<void(int, uint32_t)>);
     void split(char *line, int32_t lineLen, char delimiter, std::function<void(char *, uint32_t)>);
-    bool isEOLOrEOF(char c);
-    bool isEOL(char c);
   }
 }
 
 #if defined (NC_STR_IMPL)
 namespace nc {
   namespace str {
-    static char _funBuffer[256] = {};
-    bool isEOL(char c) { return c == '\n' || c == '\r'; }
-    bool isEOLOrEOF(char c) { return isEOL(c) || c == 0; }
+    static inline uint32_t _lowestSetBit(uint32_t x)
+    {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward(&index, x);
+      return uint32_t(index);
+#else
+      return uint32_t(__builtin_ctz(x));
+#endif
+    }
+
+    // the mask of bytes in the 16 (or 32) at p that equal a or b.
+    static inline uint32_t _matchMask16(const char *p, __m128i a, __m128i b)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i *)p);
+      return uint32_t(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b))));
+    }
+#if defined(__AVX2__)
+    static inline uint32_t _matchMask32(const char *p, __m256i a, __m256i b)
+    {
+      __m256i v = _mm256_loadu_si256((const __m256i *)p);
+      return uint32_t(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b))));
+    }
+#endif
+
+    // NOTE(Noah): the loads never go past end, so the last few bytes are done one at a time.
+    static inline const char *_findEither(const char *p, const char *end, char a, char b)
+    {
+#if defined(__AVX2__)
+      const __m256i a32 = _mm256_set1_epi8(a), b32 = _mm256_set1_epi8(b);
+      for (; end - p >= 32; p += 32) {
+        if (uint32_t mask = _matchMask32(p, a32, b32)) return p + _lowestSetBit(mask);
+      }
+#endif
+      const __m128i a16 = _mm_set1_epi8(a), b16 = _mm_set1_epi8(b);
+      for (; end - p >= 16; p += 16) {
+        if (uint32_t mask = _matchMask16(p, a16, b16)) return p + _lowestSetBit(mask);
+      }
+      while (p < end && *p != a && *p != b) p++;
+      return p;
+    }
+
+    const char *findChar(const char *p, const char *end, char c) { return _findEither(p, end, c, c); }
+    const char *findLineEnd(const char *p, const char *end) { return _findEither(p, end, '\n', '\r'); }
+
+    size_t countChar(const char *p, const char *end, char c)
+    {
+      // NOTE(Noah): each match subtracts -1 from its byte lane, and the lanes are summed with psadbw before they can
+      // wrap at 255.
+      size_t count = 0;
+      const __m128i c16 = _mm_set1_epi8(c);
+      while (end - p >= 16) {
+        __m128i lanes = _mm_setzero_si128();
+        for (uint32_t i = 0; i < 255 && end - p >= 16; i++, p += 16) {
+          lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), c16));
+        }
+        __m128i sums = _mm_sad_epu8(lanes, _mm_setzero_si128());
+        count += size_t(_mm_cvtsi128_si32(sums)) + size_t(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+      }
+      for (; p < end; p++) count += (*p == c);
+      return count;
+    }
+
+    bool nextLine(const char **pCursor, const char *end, view_t *pLine)
+    {
+      const char *p = *pCursor;
+      while (p < end && isEOL(*p)) p++;
+      if (p >= end) {
+        *pCursor = end;
+        return false;
+      }
+      const char *lineEnd = findLineEnd(p, end);
+      *pLine = view_t{p, size_t(lineEnd - p)};
+      *pCursor = lineEnd;
+      return true;
+    }
+
+    const char *parseInt(const char *p, const char *end, int64_t *out)
+    {
+      const char *start = p;
+      bool bNegative = false;
+      if (p < end && (*p == '-' || *p == '+')) bNegative = (*p++ == '-');
+      const char *digitsStart = p;
+      // anything past INT64_MAX sticks at limit, which is just enough for INT64_MIN.
+      const uint64_t limit = uint64_t(INT64_MAX) + 1;
+      uint64_t value = 0;
+      for (; p < end && isDigit(*p); p++) {
+        uint64_t digit = uint64_t(*p - '0');
+        value = (value > (limit - digit) / 10) ? limit : value * 10 + digit;
+      }
+      if (p == digitsStart) {
+        *out = 0;
+        return start;
+      }
+      if (bNegative) *out = (value == limit) ? INT64_MIN : -int64_t(value);
+      else *out = (value == limit) ? INT64_MAX : int64_t(value);
+      return p;
+    }
+
+    // NOTE(Noah): when the digits fit in a double exactly and the exponent is small, one multiply or divide by an
+    // exact power of ten gives the correctly rounded double (Clinger's fast path). going on from there to float
+    // rounds a second time, which can only go wrong when the double landed exactly halfway between two floats, so
+    // that case goes to from_chars along with everything else the fast path does not cover.
+    const char *parseFloat(const char *p, const char *end, float *out)
+    {
+      static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+        1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+      const char *start = p;
+      bool bNegative = false;
+      if (p < end && (*p == '-' || *p == '+')) bNegative = (*p++ == '-');
+      uint64_t mantissa = 0;
+      int32_t digits = 0, exponent = 0;
+      for (; p < end && isDigit(*p); p++, digits++) mantissa = mantissa * 10 + uint64_t(*p - '0');
+      if (p < end && *p == '.') {
+        p++;
+        for (; p < end && isDigit(*p); p++, digits++, exponent--) mantissa = mantissa * 10 + uint64_t(*p - '0');
+      }
+      bool bSlowPath = (digits == 0) || (digits > 19);
+      if (!bSlowPath && p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool bExpNegative = false;
+        if (q < end && (*q == '-' || *q == '+')) bExpNegative = (*q++ == '-');
+        int32_t e = 0;
+        const char *expStart = q;
+        for (; q < end && isDigit(*q) && e < 10000; q++) e = e * 10 + (*q - '0');
+        if (q != expStart) {
+          exponent += bExpNegative ? -e : e;
+          p = q;
+        }
+      }
+      if (!bSlowPath && mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+        double d = double(mantissa);
+        d = (exponent < 0) ? d / pow10[-exponent] : d * pow10[exponent];
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        // floats keep the top 24 of the 53 mantissa bits, so the dropped 29 bits being exactly one half is a tie.
+        bool bTie = (bits & ((1ull << 29) - 1)) == (1ull << 28);
+        if ((d == 0.0 || (d >= double(FLT_MIN) && d <= double(FLT_MAX))) && !bTie) {
+          *out = float(bNegative ? -d : d);
+          return p;
+        }
+      }
+      // from_chars does not take a leading plus.
+      const char *first = (start < end && *start == '+') ? start + 1 : start;
+      std::from_chars_result r = std::from_chars(first, end, *out);
+      if (r.ec == std::errc::result_out_of_range) {
+        // from_chars leaves *out alone here, and strtof knows whether it went past the top or the bottom.
+        *out = strtof(std::string(first, r.ptr).c_str(), nullptr);
+      } else if (r.ec != std::errc()) {
+        *out = 0.f;
+        return start;
+      }
+      return r.ptr;
+    }
 
     // the way that getLine works is that we expect a pointer to the
     // beginning of a line. We return through the lineLen how much chars
@@ -116,73 +988,54 @@ namespace nc {
     // and we expect the next invocation to have been advanced by at least
     // lineLen chars.
     get_line_result getLine(char **pLine, uint32_t *pLineLen) {
-      uint32_t lineLen = 0;
       if (pLine != nullptr && *pLine != nullptr && pLineLen != nullptr) {
         while(isEOL((*pLine)[0])) { *pLine += 1; }
         if ((*pLine)[0] == 0) return NC_EOF;
-        // LF = \n == 0x0A
-        // CR = \r == 0x0D
-        // file can be either CRLF or just LF.
-        while (!isEOLOrEOF((*pLine)[lineLen])) { lineLen++; }
-        *pLineLen = lineLen;
+        *pLineLen = uint32_t(strcspn(*pLine, "\r\n"));
         return NC_EOL;
       } else {
         return NC_EOF;
       }
     }
+
+    // the callback wants a null-terminated token, so each one is copied into a buffer of this thread's own.
+    static thread_local char _funBuffer[256] = {};
+
+    // NOTE(Noah): unlike forEachToken, these give n + 1 tokens for n delimiters, which is what they have always
+    // done. so an empty line is one empty token, and a trailing delimiter ends the line with an empty token.
     void split(char *line, int32_t lineLen, char delimiter, std::function<void(char *, uint32_t)> f) {
-      // add mode. use mode to make a while loop that is also a for loop.
-      // for last token parse, need lineLen. But since we have just gone
-      // thru all chars, lineLen is actually a thing now.
-      bool unlimitedMode = false;
-      if (lineLen < 0) {
-        unlimitedMode = true;
-        lineLen = 0;
-      }
-      // NOTE(Noah): Are you ready for the big brain move? How do we pass null-terminated string to
-      // f if we have a contiguous string by line? Set the delimited chars to 0 before invoke, and reset after!
-      uint32_t index = 0;
-      char *base = line;
-      uint32_t i = 0;
-      while ((unlimitedMode) ? line[i] != 0 : i < lineLen) {
-        if (line[i] == delimiter) {
-          char c_cache = line[i];
-          line[i] = 0; // override with null-terminator
-          f(base, index++);
-          base = line + i + 1;
-          line[i] = c_cache; // reset override
-        }
-        i++; if (unlimitedMode) lineLen++;
-      }
-      // was the very last char a delimited one?
-      bool lastCharDelimited = base - line > lineLen;
-      if (!lastCharDelimited) {
-        // last token to pass.
-        uint32_t lastTokenLen = lineLen - (base - line);
-        if (lastTokenLen > 255) {
-          // ew, why such a long string?
-          // TODO(Noah): This path is untested.
-          char *myFunBuffer = (char *)malloc(lastTokenLen + 1);
-          memcpy(myFunBuffer, base, lastTokenLen);
-          myFunBuffer[lastTokenLen] = 0;
-          f(myFunBuffer, index);
-          free(myFunBuffer);
-        } else {
-          memcpy(_funBuffer, base, lastTokenLen);
-          _funBuffer[lastTokenLen] = 0;
-          f(_funBuffer, index);
-        }
+      size_t length = (lineLen < 0) ? strlen(line) : size_t(lineLen);
+      uint32_t count = 0;
+      forEachToken(view_t{line, length}, delimiter, [&](view_t token, uint32_t index) {
+        char *buffer = (token.length < sizeof(_funBuffer)) ? _funBuffer : (char *)malloc(token.length + 1);
+        memcpy(buffer, token.data, token.length);
+        buffer[token.length] = 0;
+        f(buffer, index);
+        if (buffer != _funBuffer) free(buffer);
+        count = index + 1;
+      });
+      if (length == 0 || line[length - 1] == delimiter) {
+        _funBuffer[0] = 0;
+        f(_funBuffer, count);
       }
     }
     void splitInt(char *line, int32_t lineLen, char delimiter, std::function<void(int, uint32_t)> f) {
-      split(line, lineLen, delimiter, [=](char *token, uint32_t tokenIndex) {
-        f(atoi(token), tokenIndex);
+      size_t length = (lineLen < 0) ? strlen(line) : size_t(lineLen);
+      uint32_t count = 0;
+      forEachInt(view_t{line, length}, delimiter, [&](int64_t value, uint32_t index) {
+        f(int(value), index);
+        count = index + 1;
       });
+      if (length == 0 || line[length - 1] == delimiter) f(0, count);
     }
     void splitFloat(char *line, int32_t lineLen, char delimiter, std::function<void(float, uint32_t)> f) {
-      split(line, lineLen, delimiter, [=](char *token, uint32_t tokenIndex) {
-        f(atof(token), tokenIndex);
+      size_t length = (lineLen < 0) ? strlen(line) : size_t(lineLen);
+      uint32_t count = 0;
+      forEachFloat(view_t{line, length}, delimiter, [&](float value, uint32_t index) {
+        f(value, index);
+        count = index + 1;
       });
+      if (length == 0 || line[length - 1] == delimiter) f(0.f, count);
     }
   }
 }
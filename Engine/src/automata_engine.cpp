@@ -65,7 +65,7 @@ namespace automata_engine {
         int x, y, n;
         int desired_channels=4;
         loaded_image_t myImage = {};
-        loaded_file_t myFile = EM->pfn.readEntireFile(fileName);
+        loaded_file_t myFile = vfs::readEntireFile(fileName);
         if (myFile.contents) {
             myImage.parentFile = myFile;
             // NOTE(Noah): For now, let's avoid .jpg.
@@ -95,11 +95,9 @@ namespace automata_engine {
 
         void clearAppTable(game_memory_t *gameMemory)
         {
-            // TODO: the stretchy buffer free call really ought to set these to null. 
-            StretchyBufferFree(gameMemory->bifrost.appTable_funcs);
-            gameMemory->bifrost.appTable_funcs = nullptr;
-            StretchyBufferFree(gameMemory->bifrost.appTable_names);
-            gameMemory->bifrost.appTable_names = nullptr;
+            gameMemory->bifrost.appTable_funcs.reset();
+            gameMemory->bifrost.appTable_names.reset();
+            gameMemory->bifrost.appTable_lookup.reset();
         }
 
         void registerApp(
@@ -111,29 +109,29 @@ namespace automata_engine {
         ) {
             auto &bifrost = gameMemory->bifrost;
             bifrost_app_t app = {.updateFunc = callback, .transitionInto = transitionInto, .transitionOut = transitionOut};
-            StretchyBufferPush(bifrost.appTable_funcs, app);
-            StretchyBufferPush(bifrost.appTable_names, appName);
+            // a name registered twice refers to the later app.
+            bifrost.appTable_lookup[appName] = uint32_t(bifrost.appTable_funcs.count);
+            bifrost.appTable_funcs.push(app);
+            bifrost.appTable_names.push(appName);
         }
 
         void updateApp(game_memory_t * gameMemory, const char *appname) {
             auto &bifrost = gameMemory->bifrost;
-            for (uint32_t i = 0; i < StretchyBufferCount(bifrost.appTable_names); i++) {
-                if (strcmp(bifrost.appTable_names[i], appname) == 0) {
-                    auto transitionOut = bifrost.appTable_funcs[bifrost.currentAppIndex].transitionOut; 
-                    if ( transitionOut != nullptr )
-                        transitionOut(gameMemory);
-                    auto transitionInto = bifrost.appTable_funcs[i].transitionInto; 
-                    if ( transitionInto != nullptr)
-                        transitionInto(gameMemory);
-                    bifrost.currentAppIndex = i;
-                }
-            }
+            uint32_t *pIndex = bifrost.appTable_lookup.find(appname);
+            if (pIndex == nullptr) return;
+            auto transitionOut = bifrost.appTable_funcs[bifrost.currentAppIndex].transitionOut; 
+            if ( transitionOut != nullptr )
+                transitionOut(gameMemory);
+            auto transitionInto = bifrost.appTable_funcs[*pIndex].transitionInto; 
+            if ( transitionInto != nullptr)
+                transitionInto(gameMemory);
+            bifrost.currentAppIndex = *pIndex;
         }
 
         PFN_GameFunctionKind getCurrentApp(game_memory_t *gameMemory) {
             auto &bifrost = gameMemory->bifrost;
             // TODO(Noah): This can crash if _currentApp gets corrupted or something silly.
-            return (bifrost.appTable_funcs == nullptr) ? nullptr : 
+            return bifrost.appTable_funcs.empty() ? nullptr : 
                 bifrost.appTable_funcs[bifrost.currentAppIndex].updateFunc;
         }
 
@@ -152,7 +150,7 @@ namespace automata_engine {
             ImGui::Text("engine version: %s", AUTOMATA_ENGINE_VERSION_STRING);
 
             int item_current = bifrost.currentAppIndex;
-            ImGui::Combo("App", &item_current, bifrost.appTable_names, StretchyBufferCount(bifrost.appTable_names));
+            ImGui::Combo("App", &item_current, bifrost.appTable_names.data, int(bifrost.appTable_names.count));
             if (item_current != bifrost.currentAppIndex) { 
                 bifrost::updateApp(gameMemory, bifrost.appTable_names[item_current]);
             }
@@ -247,6 +245,10 @@ namespace automata_engine {
         ae::HLSL::_close();
 #endif
         ae::EM->pfn.freeGpuInfos(&userGpuInfo, 1);
+        // NOTE: assets may point into mounted archives, so they go first.
+        ae::assets::_close();
+        ae::vfs::unmountArchives();
+        ae::jobs::_close();
     }
 
     const char *updateModelToString(update_model_t updateModel) {
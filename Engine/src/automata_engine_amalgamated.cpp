@@ -8,9 +8,23 @@
 #endif
 
 #include "automata_engine_math.cpp"
+#include "automata_engine_approx.cpp"
 #include "automata_engine_utils.cpp"
+#include "automata_engine_jobs.cpp"
+#include "automata_engine_bvh.cpp"
+#include "automata_engine_frustum.cpp"
+#include "automata_engine_voxel.cpp"
+#include "automata_engine_spatial.cpp"
 #include "automata_engine.cpp"
+#include "automata_engine_quantize.cpp"
+#include "automata_engine_archive.cpp"
 #include "automata_engine_io.cpp"
+#include "automata_engine_audio.cpp"
+#include "automata_engine_image.cpp"
+#include "automata_engine_texcomp.cpp"
+#include "automata_engine_meshopt.cpp"
+#include "automata_engine_gltf.cpp"
+#include "automata_engine_assets.cpp"
 #include "automata_engine_frender.cpp"
 
 #if defined(AUTOMATA_ENGINE_DX12_BACKEND)
@@ -0,0 +1,444 @@
+#include <automata_engine.hpp>
+
+#include <immintrin.h>
+
+// NOTE(Noah): vectorized approximations of the transcendental functions.
+//
+// every function is written once as a template over a SIMD "lane" type (4-wide SSE2 or 8-wide AVX2),
+// so the two widths are guaranteed to compute the same thing. the scalar entry points run the 4-wide
+// version on a single lane. on x64 a scalar float op is an SSE op anyway, so this costs close to nothing
+// and means that scalar and SIMD results are bit-identical.
+//
+// the polynomial coefficients for the accurate tier are the well known Cephes single precision ones.
+// the fast tier coefficients are minimax fits of lower degree.
+//
+// max error vs. a double precision reference, in ulp. the "[ae::math::approx]" tests enforce these bounds.
+//
+//   function  | domain                                  | fast  | accurate
+//   ----------+-----------------------------------------+-------+---------
+//   sin, cos  | |x| <= 8192, |result| >= 1e-3           | 32    | 2
+//   atan2     | finite                                  | 512   | 4
+//   rsqrt     | positive normal                         | 4     | 2
+//   exp2      | [-126, 127]                             | 48    | 2
+//   log2      | positive normal, |result| >= 2^-10      | 1024  | 2
+//
+// NOTE: close to a zero of the result, ulp is not a useful measure. there, sin/cos are good to an absolute
+// error of 1.5e-6 (fast) and 1e-7 (accurate), and log2 to 3e-5 (fast) and 1e-7 (accurate).
+//
+// the "[!benchmark]" tests time each function over a large array against the CRT.
+
+namespace automata_engine {
+    namespace math {
+
+        // ---------------- lane types ----------------
+
+        struct lane4_t {
+            typedef __m128  V;
+            typedef __m128i I;
+            static constexpr uint32_t WIDTH = 4;
+
+            static inline V    load(const float *p) { return _mm_loadu_ps(p); }
+            static inline void store(float *p, V a) { _mm_storeu_ps(p, a); }
+            static inline V    set1(float a) { return _mm_set1_ps(a); }
+            static inline V    add(V a, V b) { return _mm_add_ps(a, b); }
+            static inline V    sub(V a, V b) { return _mm_sub_ps(a, b); }
+            static inline V    mul(V a, V b) { return _mm_mul_ps(a, b); }
+            static inline V    div(V a, V b) { return _mm_div_ps(a, b); }
+            static inline V    madd(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static inline V    min(V a, V b) { return _mm_min_ps(a, b); }
+            static inline V    max(V a, V b) { return _mm_max_ps(a, b); }
+            static inline V    rsqrt(V a) { return _mm_rsqrt_ps(a); }
+            static inline V    and_(V a, V b) { return _mm_and_ps(a, b); }
+            static inline V    andnot(V a, V b) { return _mm_andnot_ps(a, b); }  // ~a & b
+            static inline V    or_(V a, V b) { return _mm_or_ps(a, b); }
+            static inline V    xor_(V a, V b) { return _mm_xor_ps(a, b); }
+            static inline V    lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+            static inline V    le(V a, V b) { return _mm_cmple_ps(a, b); }
+            static inline V    eq(V a, V b) { return _mm_cmpeq_ps(a, b); }
+            static inline V    unord(V a, V b) { return _mm_cmpunord_ps(a, b); }
+            // select b where mask is set, else a.
+            static inline V select(V a, V b, V mask) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }
+            static inline I toIntRound(V a) { return _mm_cvtps_epi32(a); }
+            static inline V toFloat(I a) { return _mm_cvtepi32_ps(a); }
+            static inline I asInt(V a) { return _mm_castps_si128(a); }
+            static inline V asFloat(I a) { return _mm_castsi128_ps(a); }
+            static inline I iset1(int32_t a) { return _mm_set1_epi32(a); }
+            static inline I iadd(I a, I b) { return _mm_add_epi32(a, b); }
+            static inline I isub(I a, I b) { return _mm_sub_epi32(a, b); }
+            static inline I iand(I a, I b) { return _mm_and_si128(a, b); }
+            static inline I ior(I a, I b) { return _mm_or_si128(a, b); }
+            template <int N>
+            static inline I ishl(I a)
+            {
+                return _mm_slli_epi32(a, N);
+            }
+            template <int N>
+            static inline I ishr(I a)
+            {
+                return _mm_srli_epi32(a, N);
+            }
+        };
+
+#if defined(__AVX2__)
+        struct lane8_t {
+            typedef __m256  V;
+            typedef __m256i I;
+            static constexpr uint32_t WIDTH = 8;
+
+            static inline V    load(const float *p) { return _mm256_loadu_ps(p); }
+            static inline void store(float *p, V a) { _mm256_storeu_ps(p, a); }
+            static inline V    set1(float a) { return _mm256_set1_ps(a); }
+            static inline V    add(V a, V b) { return _mm256_add_ps(a, b); }
+            static inline V    sub(V a, V b) { return _mm256_sub_ps(a, b); }
+            static inline V    mul(V a, V b) { return _mm256_mul_ps(a, b); }
+            static inline V    div(V a, V b) { return _mm256_div_ps(a, b); }
+            // NOTE: deliberately not an FMA, so that results match the 4-wide path exactly.
+            static inline V madd(V a, V b, V c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+            static inline V min(V a, V b) { return _mm256_min_ps(a, b); }
+            static inline V max(V a, V b) { return _mm256_max_ps(a, b); }
+            static inline V rsqrt(V a) { return _mm256_rsqrt_ps(a); }
+            static inline V and_(V a, V b) { return _mm256_and_ps(a, b); }
+            static inline V andnot(V a, V b) { return _mm256_andnot_ps(a, b); }
+            static inline V or_(V a, V b) { return _mm256_or_ps(a, b); }
+            static inline V xor_(V a, V b) { return _mm256_xor_ps(a, b); }
+            static inline V lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static inline V le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+            static inline V eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+            static inline V unord(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_UNORD_Q); }
+            static inline V select(V a, V b, V mask) { return _mm256_blendv_ps(a, b, mask); }
+            static inline I toIntRound(V a) { return _mm256_cvtps_epi32(a); }
+            static inline V toFloat(I a) { return _mm256_cvtepi32_ps(a); }
+            static inline I asInt(V a) { return _mm256_castps_si256(a); }
+            static inline V asFloat(I a) { return _mm256_castsi256_ps(a); }
+            static inline I iset1(int32_t a) { return _mm256_set1_epi32(a); }
+            static inline I iadd(I a, I b) { return _mm256_add_epi32(a, b); }
+            static inline I isub(I a, I b) { return _mm256_sub_epi32(a, b); }
+            static inline I iand(I a, I b) { return _mm256_and_si256(a, b); }
+            static inline I ior(I a, I b) { return _mm256_or_si256(a, b); }
+            template <int N>
+            static inline I ishl(I a)
+            {
+                return _mm256_slli_epi32(a, N);
+            }
+            template <int N>
+            static inline I ishr(I a)
+            {
+                return _mm256_srli_epi32(a, N);
+            }
+        };
+#endif
+
+        // ---------------- kernels ----------------
+
+        enum approx_tier_t { APPROX_TIER_FAST, APPROX_TIER_ACCURATE };
+
+        static constexpr float APPROX_PI         = 3.14159265358979323846f;
+        static constexpr float APPROX_PI_2       = 1.57079632679489661923f;
+        static constexpr float APPROX_PI_4       = 0.78539816339744830962f;
+        static constexpr float APPROX_2_PI       = 0.63661977236758134308f;
+        static constexpr float APPROX_LOG2E_M1   = 0.44269504088896340736f;
+        static constexpr float APPROX_SQRT2      = 1.41421356237309504880f;
+        static constexpr float APPROX_TAN_PI_8   = 0.41421356237309504880f;
+        static constexpr int32_t APPROX_SIGN_BIT = int32_t(0x80000000);
+
+        // sin and cos on [-pi/4, pi/4].
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V sinPoly(typename L::V r, typename L::V z)
+        {
+            typename L::V p;
+            if (tier == APPROX_TIER_FAST) {
+                p = L::madd(L::set1(8.163281924e-03f), z, L::set1(-1.666339038e-01f));
+            } else {
+                p = L::madd(L::set1(-1.9515295891e-4f), z, L::set1(8.3321608736e-3f));
+                p = L::madd(p, z, L::set1(-1.6666654611e-1f));
+            }
+            return L::madd(L::mul(p, z), r, r);
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V cosPoly(typename L::V z)
+        {
+            typename L::V p;
+            if (tier == APPROX_TIER_FAST) {
+                p = L::madd(L::set1(-1.364871436e-03f), z, L::set1(4.166107131e-02f));
+            } else {
+                p = L::madd(L::set1(2.443315711809948e-5f), z, L::set1(-1.388731625493765e-3f));
+                p = L::madd(p, z, L::set1(4.166664568298827e-2f));
+            }
+            // 1 - z/2 + z^2 * p
+            return L::madd(L::mul(z, z), p, L::madd(L::set1(-0.5f), z, L::set1(1.f)));
+        }
+
+        // reduce x to r in [-pi/4, pi/4] with x = r + k*pi/2. pi/2 is split into three parts (Cody-Waite) so that
+        // the reduction is exact for moderately large k. the first part has few mantissa bits, so k*part is exact.
+        template <typename L>
+        static inline typename L::V reduceHalfPi(typename L::V x, typename L::I *kOut)
+        {
+            typename L::I k  = L::toIntRound(L::mul(x, L::set1(APPROX_2_PI)));
+            typename L::V kf = L::toFloat(k);
+            typename L::V r  = L::madd(kf, L::set1(-1.5703125f), x);
+            r                = L::madd(kf, L::set1(-4.837512969970703125e-4f), r);
+            r                = L::madd(kf, L::set1(-7.54978995489188216e-8f), r);
+            *kOut            = k;
+            return r;
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V sinImpl(typename L::V x)
+        {
+            typename L::I k;
+            typename L::V r = reduceHalfPi<L>(x, &k);
+            typename L::V z = L::mul(r, r);
+            typename L::V s = sinPoly<L, tier>(r, z);
+            typename L::V c = cosPoly<L, tier>(z);
+            // quadrant 0: sin(r), 1: cos(r), 2: -sin(r), 3: -cos(r).
+            typename L::V bSwap = L::asFloat(L::isub(L::iset1(0), L::iand(k, L::iset1(1))));
+            typename L::V sign  = L::asFloat(L::template ishl<30>(L::iand(k, L::iset1(2))));
+            return L::xor_(L::select(s, c, bSwap), sign);
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V cosImpl(typename L::V x)
+        {
+            typename L::I k;
+            typename L::V r = reduceHalfPi<L>(x, &k);
+            typename L::V z = L::mul(r, r);
+            typename L::V s = sinPoly<L, tier>(r, z);
+            typename L::V c = cosPoly<L, tier>(z);
+            // quadrant 0: cos(r), 1: -sin(r), 2: -cos(r), 3: sin(r).
+            typename L::V bSwap = L::asFloat(L::isub(L::iset1(0), L::iand(k, L::iset1(1))));
+            typename L::V sign  = L::asFloat(L::template ishl<30>(L::iand(L::iadd(k, L::iset1(1)), L::iset1(2))));
+            return L::xor_(L::select(c, s, bSwap), sign);
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V atan2Impl(typename L::V y, typename L::V x)
+        {
+            typedef typename L::V V;
+            const V signMask = L::asFloat(L::iset1(APPROX_SIGN_BIT));
+            V       ax       = L::andnot(signMask, x);
+            V       ay       = L::andnot(signMask, y);
+            V       mn       = L::min(ax, ay);
+            V       mx       = L::max(ax, ay);
+            // a = mn / mx in [0, 1]. atan2(0, 0) is defined to be 0 here.
+            V a = L::andnot(L::eq(mx, L::set1(0.f)), L::div(mn, mx));
+
+            V r;
+            if (tier == APPROX_TIER_FAST) {
+                V z = L::mul(a, a);
+                V p = L::madd(L::set1(2.386387354e-02f), z, L::set1(-9.192762515e-02f));
+                p   = L::madd(p, z, L::set1(1.852164585e-01f));
+                p   = L::madd(p, z, L::set1(-3.317010563e-01f));
+                p   = L::madd(p, z, L::set1(9.999700500e-01f));
+                r   = L::mul(p, a);
+            } else {
+                // reduce a further to [0, tan(pi/8)] with atan(a) = pi/4 + atan((a-1)/(a+1)).
+                V bBig   = L::lt(L::set1(APPROX_TAN_PI_8), a);
+                V t      = L::select(a, L::div(L::sub(a, L::set1(1.f)), L::add(a, L::set1(1.f))), bBig);
+                V offset = L::and_(bBig, L::set1(APPROX_PI_4));
+                V z      = L::mul(t, t);
+                V p      = L::madd(L::set1(8.05374449538e-2f), z, L::set1(-1.38776856032e-1f));
+                p        = L::madd(p, z, L::set1(1.99777106478e-1f));
+                p        = L::madd(p, z, L::set1(-3.33329491539e-1f));
+                r        = L::add(offset, L::madd(L::mul(p, z), t, t));
+            }
+
+            r = L::select(r, L::sub(L::set1(APPROX_PI_2), r), L::lt(ax, ay));
+            r = L::select(r, L::sub(L::set1(APPROX_PI), r), L::lt(x, L::set1(0.f)));
+            // NOTE: copy the sign of y. this is also what makes atan2(-0, x) = -0.
+            return L::or_(r, L::and_(y, signMask));
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V rsqrtImpl(typename L::V x)
+        {
+            typedef typename L::V V;
+            const V half      = L::set1(0.5f);
+            const V threeHalf = L::set1(1.5f);
+            V       hx        = L::mul(x, half);
+            V       y         = L::rsqrt(x);
+            // Newton step: y = y * (1.5 - 0.5 * x * y * y). each step roughly doubles the number of correct bits,
+            // and rsqrtps is good to ~12 bits.
+            y = L::mul(y, L::sub(threeHalf, L::mul(hx, L::mul(y, y))));
+            if (tier == APPROX_TIER_ACCURATE) { y = L::mul(y, L::sub(threeHalf, L::mul(hx, L::mul(y, y)))); }
+            return y;
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V exp2Impl(typename L::V x)
+        {
+            typedef typename L::V V;
+            typedef typename L::I I;
+            // clamp so that the exponent arithmetic below does not overflow. out of range lanes are patched up
+            // at the end.
+            V xc = L::min(L::max(x, L::set1(-126.f)), L::set1(127.f));
+            I k  = L::toIntRound(xc);
+            V f  = L::sub(xc, L::toFloat(k));  // [-0.5, 0.5]
+
+            V p;
+            if (tier == APPROX_TIER_FAST) {
+                p = L::madd(L::set1(9.582853038e-03f), f, L::set1(5.590642468e-02f));
+                p = L::madd(p, f, L::set1(2.402409861e-01f));
+                p = L::madd(p, f, L::set1(6.931241934e-01f));
+            } else {
+                p = L::madd(L::set1(1.535336188319500e-4f), f, L::set1(1.339887440266574e-3f));
+                p = L::madd(p, f, L::set1(9.618437357674640e-3f));
+                p = L::madd(p, f, L::set1(5.550332471162809e-2f));
+                p = L::madd(p, f, L::set1(2.402264791363012e-1f));
+                p = L::madd(p, f, L::set1(6.931472028550421e-1f));
+            }
+            p = L::madd(p, f, L::set1(1.f));
+
+            V scale  = L::asFloat(L::template ishl<23>(L::iadd(k, L::iset1(127))));
+            V result = L::mul(p, scale);
+            result   = L::andnot(L::lt(x, L::set1(-126.f)), result);  // underflow to 0.
+            result   = L::select(result, L::set1(INFINITY), L::lt(L::set1(128.f), x));
+            return L::select(result, x, L::unord(x, x));  // NaN in, NaN out.
+        }
+
+        template <typename L, approx_tier_t tier>
+        static inline typename L::V log2Impl(typename L::V x)
+        {
+            typedef typename L::V V;
+            typedef typename L::I I;
+            I bits = L::asInt(x);
+            I e    = L::isub(L::template ishr<23>(bits), L::iset1(127));
+            V m    = L::asFloat(L::ior(L::iand(bits, L::iset1(0x007FFFFF)), L::iset1(0x3F800000)));  // [1, 2)
+            // center the mantissa on 1, i.e. [sqrt(0.5), sqrt(2)), so that the polynomial argument is small.
+            V bBig = L::lt(L::set1(APPROX_SQRT2), m);
+            m      = L::select(m, L::mul(m, L::set1(0.5f)), bBig);
+            V ef   = L::add(L::toFloat(e), L::and_(bBig, L::set1(1.f)));
+            V t    = L::sub(m, L::set1(1.f));
+
+            V result;
+            if (tier == APPROX_TIER_FAST) {
+                V p    = L::madd(L::set1(2.547518050e-01f), t, L::set1(-3.908924257e-01f));
+                p      = L::madd(p, t, L::set1(4.853065216e-01f));
+                p      = L::madd(p, t, L::set1(-7.205549733e-01f));
+                p      = L::madd(p, t, L::set1(1.442646251e+00f));
+                result = L::madd(p, t, ef);
+            } else {
+                // ln(1+t) = t - t^2/2 + t^3 * P(t).
+                V z = L::mul(t, t);
+                V p = L::madd(L::set1(7.0376836292e-2f), t, L::set1(-1.1514610310e-1f));
+                p   = L::madd(p, t, L::set1(1.1676998740e-1f));
+                p   = L::madd(p, t, L::set1(-1.2420140846e-1f));
+                p   = L::madd(p, t, L::set1(1.4249322787e-1f));
+                p   = L::madd(p, t, L::set1(-1.6668057665e-1f));
+                p   = L::madd(p, t, L::set1(2.0000714765e-1f));
+                p   = L::madd(p, t, L::set1(-2.4999993993e-1f));
+                p   = L::madd(p, t, L::set1(3.3333331174e-1f));
+                V y = L::madd(L::set1(-0.5f), z, L::mul(L::mul(p, z), t));
+                // NOTE: log2e is split as 1 + (log2e - 1), so that t and y are added exactly once each and only
+                // the small products round. this holds the bound with or without the compiler forming FMAs.
+                V r    = L::add(L::mul(y, L::set1(APPROX_LOG2E_M1)), L::mul(t, L::set1(APPROX_LOG2E_M1)));
+                result = L::add(L::add(L::add(r, y), t), ef);
+            }
+
+            result = L::select(result, L::set1(-INFINITY), L::eq(x, L::set1(0.f)));
+            result = L::select(result, L::set1(INFINITY), L::eq(x, L::set1(INFINITY)));
+            return L::select(result, L::set1(NAN), L::or_(L::lt(x, L::set1(0.f)), L::unord(x, x)));
+        }
+
+        // ---------------- array helpers ----------------
+
+        template <typename L4, typename L8, typename FN4, typename FN8>
+        static inline void approxArray(const float *in, float *out, uint32_t count, FN4 fn4, FN8 fn8)
+        {
+            uint32_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 8 <= count; i += 8) { L8::store(out + i, fn8(L8::load(in + i))); }
+#else
+            (void)fn8;
+#endif
+            for (; i + 4 <= count; i += 4) { L4::store(out + i, fn4(L4::load(in + i))); }
+            for (; i < count; i++) { _mm_store_ss(out + i, fn4(_mm_set_ss(in[i]))); }
+        }
+
+        template <typename L4, typename L8, typename FN4, typename FN8>
+        static inline void approxArray2(
+            const float *in0, const float *in1, float *out, uint32_t count, FN4 fn4, FN8 fn8)
+        {
+            uint32_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 8 <= count; i += 8) { L8::store(out + i, fn8(L8::load(in0 + i), L8::load(in1 + i))); }
+#else
+            (void)fn8;
+#endif
+            for (; i + 4 <= count; i += 4) { L4::store(out + i, fn4(L4::load(in0 + i), L4::load(in1 + i))); }
+            for (; i < count; i++) { _mm_store_ss(out + i, fn4(_mm_set_ss(in0[i]), _mm_set_ss(in1[i]))); }
+        }
+
+#if !defined(__AVX2__)
+        // keeps the array helpers above happy when there is no 8-wide path.
+        typedef lane4_t lane8_t;
+#endif
+
+        // ---------------- public entry points ----------------
+
+        // NOTE: the fast and accurate namespaces expose the exact same set of functions, so they are
+        // stamped out by this macro.
+#define AE_APPROX_DEFINE_TIER(TIER)                                                                                   \
+    float sin(float x) { return _mm_cvtss_f32(sinImpl<lane4_t, TIER>(_mm_set_ss(x))); }                               \
+    float cos(float x) { return _mm_cvtss_f32(cosImpl<lane4_t, TIER>(_mm_set_ss(x))); }                               \
+    float atan2(float y, float x) { return _mm_cvtss_f32(atan2Impl<lane4_t, TIER>(_mm_set_ss(y), _mm_set_ss(x))); }   \
+    float rsqrt(float x) { return _mm_cvtss_f32(rsqrtImpl<lane4_t, TIER>(_mm_set_ss(x))); }                           \
+    float exp2(float x) { return _mm_cvtss_f32(exp2Impl<lane4_t, TIER>(_mm_set_ss(x))); }                             \
+    float log2(float x) { return _mm_cvtss_f32(log2Impl<lane4_t, TIER>(_mm_set_ss(x))); }                             \
+    __m128 sin(__m128 x) { return sinImpl<lane4_t, TIER>(x); }                                                        \
+    __m128 cos(__m128 x) { return cosImpl<lane4_t, TIER>(x); }                                                        \
+    __m128 atan2(__m128 y, __m128 x) { return atan2Impl<lane4_t, TIER>(y, x); }                                       \
+    __m128 rsqrt(__m128 x) { return rsqrtImpl<lane4_t, TIER>(x); }                                                    \
+    __m128 exp2(__m128 x) { return exp2Impl<lane4_t, TIER>(x); }                                                      \
+    __m128 log2(__m128 x) { return log2Impl<lane4_t, TIER>(x); }                                                      \
+    AE_APPROX_DEFINE_TIER_8(TIER)                                                                                     \
+    void sin(const float *in, float *out, uint32_t count)                                                            \
+    {                                                                                                                 \
+        approxArray<lane4_t, lane8_t>(in, out, count, sinImpl<lane4_t, TIER>, sinImpl<lane8_t, TIER>);                \
+    }                                                                                                                 \
+    void cos(const float *in, float *out, uint32_t count)                                                            \
+    {                                                                                                                 \
+        approxArray<lane4_t, lane8_t>(in, out, count, cosImpl<lane4_t, TIER>, cosImpl<lane8_t, TIER>);                \
+    }                                                                                                                 \
+    void atan2(const float *y, const float *x, float *out, uint32_t count)                                           \
+    {                                                                                                                 \
+        approxArray2<lane4_t, lane8_t>(y, x, out, count, atan2Impl<lane4_t, TIER>, atan2Impl<lane8_t, TIER>);         \
+    }                                                                                                                 \
+    void rsqrt(const float *in, float *out, uint32_t count)                                                          \
+    {                                                                                                                 \
+        approxArray<lane4_t, lane8_t>(in, out, count, rsqrtImpl<lane4_t, TIER>, rsqrtImpl<lane8_t, TIER>);            \
+    }                                                                                                                 \
+    void exp2(const float *in, float *out, uint32_t count)                                                           \
+    {                                                                                                                 \
+        approxArray<lane4_t, lane8_t>(in, out, count, exp2Impl<lane4_t, TIER>, exp2Impl<lane8_t, TIER>);              \
+    }                                                                                                                 \
+    void log2(const float *in, float *out, uint32_t count)                                                           \
+    {                                                                                                                 \
+        approxArray<lane4_t, lane8_t>(in, out, count, log2Impl<lane4_t, TIER>, log2Impl<lane8_t, TIER>);              \
+    }
+
+#if defined(__AVX2__)
+#define AE_APPROX_DEFINE_TIER_8(TIER)                                                                                 \
+    __m256 sin(__m256 x) { return sinImpl<lane8_t, TIER>(x); }                                                        \
+    __m256 cos(__m256 x) { return cosImpl<lane8_t, TIER>(x); }                                                        \
+    __m256 atan2(__m256 y, __m256 x) { return atan2Impl<lane8_t, TIER>(y, x); }                                       \
+    __m256 rsqrt(__m256 x) { return rsqrtImpl<lane8_t, TIER>(x); }                                                    \
+    __m256 exp2(__m256 x) { return exp2Impl<lane8_t, TIER>(x); }                                                      \
+    __m256 log2(__m256 x) { return log2Impl<lane8_t, TIER>(x); }
+#else
+#define AE_APPROX_DEFINE_TIER_8(TIER)
+#endif
+
+        namespace fast {
+            AE_APPROX_DEFINE_TIER(APPROX_TIER_FAST)
+        }
+
+        namespace accurate {
+            AE_APPROX_DEFINE_TIER(APPROX_TIER_ACCURATE)
+        }
+
+#undef AE_APPROX_DEFINE_TIER
+#undef AE_APPROX_DEFINE_TIER_8
+
+    }  // namespace math
+}  // namespace automata_engine
@@ -0,0 +1,707 @@
+#include <automata_engine.hpp>
+
+#include <climits>
+#include <cstring>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "stb_ds.h"
+
+// NOTE(Noah): a .aepak archive is this header, then the table of contents, then the names of the files, then the
+// files themselves, each on a 4K boundary. the table of contents is an open addressed hash table keyed by the
+// hash of the path, with linear probing and at most half of the slots used. so once the archive is mapped, a lookup
+// is a hash and a probe or two straight into the mapping, with no parsing at mount time and no open() per file.
+// everything is little endian.
+
+namespace automata_engine {
+    namespace io {
+
+        // ----------- [SECTION] LZ4 -----------
+        // the LZ4 block format: a run of sequences, each a token byte (literal length in the high nibble, match
+        // length - 4 in the low nibble, 15 meaning that more length bytes follow), the literals, then a 16 bit
+        // offset back into the output. the last sequence is literals only. the format requires that the last 5
+        // bytes are literals and that the last match starts at least 12 bytes before the end.
+
+        static constexpr uint32_t LZ4_MIN_MATCH     = 4;
+        static constexpr uint32_t LZ4_LAST_LITERALS = 5;
+        static constexpr uint32_t LZ4_MF_LIMIT      = 12;
+        static constexpr uint32_t LZ4_MAX_OFFSET    = 65535;
+        static constexpr uint32_t LZ4_HASH_LOG      = 12;
+
+        static inline uint32_t lz4Read32(const uint8_t *p)
+        {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return v;
+        }
+
+        static inline uint32_t lz4Hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - LZ4_HASH_LOG);
+        }
+
+        static inline uint32_t lz4Ctz64(uint64_t x)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, x);
+            return uint32_t(index);
+#else
+            return uint32_t(__builtin_ctzll(x));
+#endif
+        }
+
+        // how many bytes match between a and b, without going past aEnd. a is always ahead of b.
+        static inline size_t lz4MatchLength(const uint8_t *a, const uint8_t *b, const uint8_t *aEnd)
+        {
+            const uint8_t *start = a;
+            while (a + 8 <= aEnd) {
+                uint64_t x, y;
+                memcpy(&x, a, 8);
+                memcpy(&y, b, 8);
+                if (x != y) return size_t(a - start) + (lz4Ctz64(x ^ y) >> 3);
+                a += 8;
+                b += 8;
+            }
+            while (a < aEnd && *a == *b) a++, b++;
+            return size_t(a - start);
+        }
+
+        // write the bytes that follow a nibble of 15.
+        static inline uint8_t *lz4WriteLength(uint8_t *op, size_t length)
+        {
+            for (; length >= 255; length -= 255) *op++ = 255;
+            *op++ = uint8_t(length);
+            return op;
+        }
+
+        // write one sequence. matchLength of 0 is the final, literals only, sequence.
+        // @returns nullptr if it does not fit.
+        static uint8_t *lz4WriteSequence(uint8_t *op, uint8_t *oend, const uint8_t *literals, size_t literalLength,
+            size_t offset, size_t matchLength)
+        {
+            size_t worst = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+            if (worst > size_t(oend - op)) return nullptr;
+            uint8_t *token = op++;
+            *token = uint8_t(math::min(literalLength, size_t(15)) << 4);
+            if (literalLength >= 15) op = lz4WriteLength(op, literalLength - 15);
+            if (literalLength) memcpy(op, literals, literalLength);
+            op += literalLength;
+            if (matchLength) {
+                *op++ = uint8_t(offset);
+                *op++ = uint8_t(offset >> 8);
+                size_t m = matchLength - LZ4_MIN_MATCH;
+                *token |= uint8_t(math::min(m, size_t(15)));
+                if (m >= 15) op = lz4WriteLength(op, m - 15);
+            }
+            return op;
+        }
+
+        size_t lz4CompressBound(size_t srcSize)
+        {
+            return srcSize + srcSize / 255 + 16;
+        }
+
+        size_t lz4Compress(const void *src, size_t srcSize, void *dst, size_t dstCapacity)
+        {
+            const uint8_t *base   = (const uint8_t *)src;
+            const uint8_t *ip     = base;
+            const uint8_t *anchor = base;
+            const uint8_t *iend   = base + srcSize;
+            uint8_t       *op     = (uint8_t *)dst;
+            uint8_t       *oend   = op + dstCapacity;
+
+            if (srcSize > LZ4_MF_LIMIT) {
+                // NOTE(Noah): stale or unset entries are harmless, since every candidate is compared before use.
+                uint32_t       table[1 << LZ4_HASH_LOG] = {};
+                const uint8_t *mflimit                  = iend - LZ4_MF_LIMIT;
+                const uint8_t *matchlimit               = iend - LZ4_LAST_LITERALS;
+                ip++;
+                while (ip <= mflimit) {
+                    uint32_t       sequence = lz4Read32(ip);
+                    uint32_t       h        = lz4Hash(sequence);
+                    const uint8_t *ref      = base + table[h];
+                    table[h]                = uint32_t(ip - base);
+                    if (ref >= ip || size_t(ip - ref) > LZ4_MAX_OFFSET || lz4Read32(ref) != sequence) {
+                        // skip ahead faster the longer that nothing has matched, so incompressible data is quick.
+                        ip += 1 + (size_t(ip - anchor) >> 6);
+                        continue;
+                    }
+                    while (ip > anchor && ref > base && ip[-1] == ref[-1]) ip--, ref--;
+                    size_t length = LZ4_MIN_MATCH + lz4MatchLength(ip + LZ4_MIN_MATCH, ref + LZ4_MIN_MATCH, matchlimit);
+                    op = lz4WriteSequence(op, oend, anchor, size_t(ip - anchor), size_t(ip - ref), length);
+                    if (op == nullptr) return 0;
+                    ip += length;
+                    anchor = ip;
+                    if (ip <= mflimit) table[lz4Hash(lz4Read32(ip - 2))] = uint32_t(ip - 2 - base);
+                }
+            }
+            op = lz4WriteSequence(op, oend, anchor, size_t(iend - anchor), 0, 0);
+            return op ? size_t(op - (uint8_t *)dst) : 0;
+        }
+
+        bool lz4Decompress(const void *src, size_t srcSize, void *dst, size_t dstSize)
+        {
+            const uint8_t *ip      = (const uint8_t *)src;
+            const uint8_t *iend    = ip + srcSize;
+            uint8_t       *op      = (uint8_t *)dst;
+            uint8_t *const ostart  = op;
+            uint8_t *const oend    = op + dstSize;
+
+            while (ip < iend) {
+                uint32_t token         = *ip++;
+                size_t   literalLength = token >> 4;
+                if (literalLength == 15) {
+                    uint8_t b;
+                    do {
+                        if (ip >= iend) return false;
+                        b = *ip++;
+                        literalLength += b;
+                    } while (b == 255);
+                }
+                if (literalLength > size_t(iend - ip) || literalLength > size_t(oend - op)) return false;
+                // the common case of a short run is a single 16 byte copy, when there is room to overshoot.
+                if (literalLength <= 16 && iend - ip >= 16 && oend - op >= 16) memcpy(op, ip, 16);
+                else memcpy(op, ip, literalLength);
+                op += literalLength;
+                ip += literalLength;
+                if (ip == iend) break;
+
+                if (iend - ip < 2) return false;
+                size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > size_t(op - ostart)) return false;
+                size_t matchLength = token & 15;
+                if (matchLength == 15) {
+                    uint8_t b;
+                    do {
+                        if (ip >= iend) return false;
+                        b = *ip++;
+                        matchLength += b;
+                    } while (b == 255);
+                }
+                matchLength += LZ4_MIN_MATCH;
+                if (matchLength > size_t(oend - op)) return false;
+
+                // NOTE(Noah): a chunk of the copy never reads bytes that the same chunk writes when the offset is at
+                // least the chunk size. the chunks may overshoot the match, which later writes then overwrite.
+                const uint8_t *ref = op - offset;
+                if (offset >= 16 && size_t(oend - op) >= matchLength + 16) {
+                    for (size_t i = 0; i < matchLength; i += 16) memcpy(op + i, ref + i, 16);
+                } else if (offset >= 8 && size_t(oend - op) >= matchLength + 8) {
+                    for (size_t i = 0; i < matchLength; i += 8) memcpy(op + i, ref + i, 8);
+                } else {
+                    for (size_t i = 0; i < matchLength; i++) op[i] = ref[i];
+                }
+                op += matchLength;
+            }
+            return ip == iend && op == oend;
+        }
+
+        // ----------- [SECTION] .aepak -----------
+
+        static constexpr uint32_t AEPAK_MAGIC = ('A' << 0) | ('E' << 8) | ('P' << 16) | ('K' << 24);
+
+        enum aepak_compression_t : uint32_t {
+            AEPAK_COMPRESSION_NONE = 0,
+            AEPAK_COMPRESSION_LZ4,
+            AEPAK_COMPRESSION_COUNT
+        };
+
+        struct aepak_header_t {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t headerSize;
+            uint32_t entryCount;
+            uint32_t slotCount;  // pow2.
+            uint32_t namesSize;
+            uint64_t tocOffset;
+            uint64_t namesOffset;
+            uint64_t fileSize;
+            uint32_t reserved[4];
+        };
+        static_assert(sizeof(aepak_header_t) == 64, "the .aepak header must not change size within a version");
+
+        // a slot in the table of contents. a hash of 0 marks an empty slot, so hashPath never returns 0.
+        struct aepak_entry_t {
+            uint64_t hash;
+            uint64_t offset;
+            uint32_t size;
+            uint32_t storedSize;
+            uint32_t compression;
+            uint32_t nameOffset;
+        };
+        static_assert(sizeof(aepak_entry_t) == 32, "the .aepak entry must not change size within a version");
+
+        static inline uint64_t aepakAlign(uint64_t offset)
+        {
+            return (offset + AEPAK_ALIGNMENT - 1) & ~uint64_t(AEPAK_ALIGNMENT - 1);
+        }
+
+        void *packArchive(const archive_source_t *sources, uint32_t sourceCount, size_t *sizeOut, bool bCompress)
+        {
+            uint32_t slotCount = 16;
+            while (slotCount < sourceCount * 2) slotCount *= 2;
+            aepak_entry_t *toc    = (aepak_entry_t *)calloc(slotCount, sizeof(aepak_entry_t));
+            void         **stored = (void **)calloc(math::max(sourceCount, 1u), sizeof(void *));
+            uint64_t namesSize = 0;
+            uint64_t dataSize  = 0;
+            bool     bValid    = true;
+
+            for (uint32_t i = 0; bValid && i < sourceCount; i++) {
+                const archive_source_t &source = sources[i];
+                bValid = source.path && (source.data || source.size == 0) && source.size <= UINT32_MAX;
+                if (!bValid) break;
+                uint64_t h    = vfs::hashPath(source.path);
+                uint32_t slot = uint32_t(h) & (slotCount - 1);
+                while (toc[slot].hash && toc[slot].hash != h) slot = (slot + 1) & (slotCount - 1);
+                if (toc[slot].hash == h) {
+                    AELoggerError("cannot pack %s, as its path hashes the same as %s", source.path,
+                        sources[toc[slot].nameOffset].path);
+                    bValid = false;
+                    break;
+                }
+                aepak_entry_t &entry = toc[slot];
+                entry.hash           = h;
+                entry.size           = uint32_t(source.size);
+                entry.storedSize     = uint32_t(source.size);
+                entry.compression    = AEPAK_COMPRESSION_NONE;
+                entry.nameOffset     = i;  // patched to the real offset below.
+
+                // only keep the compressed file when it is worth the decompress, else it may as well be mapped.
+                size_t bound = lz4CompressBound(source.size);
+                if (bCompress && source.size >= 64 && bound <= UINT32_MAX) {
+                    void  *compressed     = malloc(bound);
+                    size_t compressedSize = compressed ? lz4Compress(source.data, source.size, compressed, bound) : 0;
+                    if (compressedSize && compressedSize <= source.size - source.size / 8) {
+                        stored[i]         = compressed;
+                        entry.storedSize  = uint32_t(compressedSize);
+                        entry.compression = AEPAK_COMPRESSION_LZ4;
+                    } else {
+                        free(compressed);
+                    }
+                }
+                namesSize += strlen(source.path) + 1;
+                dataSize += aepakAlign(entry.storedSize);
+            }
+
+            void *result = nullptr;
+            if (bValid) {
+                aepak_header_t header = {};
+                header.magic          = AEPAK_MAGIC;
+                header.version        = AEPAK_VERSION;
+                header.headerSize     = sizeof(aepak_header_t);
+                header.entryCount     = sourceCount;
+                header.slotCount      = slotCount;
+                header.namesSize      = uint32_t(namesSize);
+                header.tocOffset      = sizeof(aepak_header_t);
+                header.namesOffset    = header.tocOffset + uint64_t(slotCount) * sizeof(aepak_entry_t);
+                header.fileSize       = aepakAlign(header.namesOffset + namesSize) + dataSize;
+
+                uint8_t *file = (uint8_t *)calloc(1, size_t(header.fileSize));
+                result        = file;
+                if (file == nullptr) {
+                    AELoggerError("could not allocate %llu bytes to pack an archive",
+                        (unsigned long long)header.fileSize);
+                    bValid = false;
+                }
+                uint64_t nameCursor = 0;
+                uint64_t dataCursor = aepakAlign(header.namesOffset + namesSize);
+                for (uint32_t slot = 0; bValid && slot < slotCount; slot++) {
+                    aepak_entry_t &entry = toc[slot];
+                    if (entry.hash == 0) continue;
+                    uint32_t    i    = entry.nameOffset;
+                    const char *path = sources[i].path;
+                    size_t      len  = strlen(path) + 1;
+                    memcpy(file + header.namesOffset + nameCursor, path, len);
+                    entry.nameOffset = uint32_t(nameCursor);
+                    nameCursor += len;
+                    entry.offset = dataCursor;
+                    if (entry.storedSize) {
+                        memcpy(file + dataCursor, stored[i] ? stored[i] : sources[i].data, entry.storedSize);
+                    }
+                    dataCursor += aepakAlign(entry.storedSize);
+                }
+                if (bValid) {
+                    memcpy(file, &header, sizeof(header));
+                    memcpy(file + header.tocOffset, toc, sizeof(aepak_entry_t) * slotCount);
+                    *sizeOut = size_t(header.fileSize);
+                }
+            }
+
+            for (uint32_t i = 0; i < sourceCount; i++) free(stored[i]);
+            free(stored);
+            free(toc);
+            return result;
+        }
+
+        bool writeArchive(const char *archivePath, const char *const *filePaths, uint32_t fileCount, bool bCompress)
+        {
+            loaded_file_t    *files   = (loaded_file_t *)calloc(math::max(fileCount, 1u), sizeof(loaded_file_t));
+            archive_source_t *sources = (archive_source_t *)calloc(math::max(fileCount, 1u), sizeof(archive_source_t));
+            bool              bResult = true;
+            for (uint32_t i = 0; bResult && i < fileCount; i++) {
+                // NOTE(Noah): straight from disk. the archive being written could be mounted.
+                files[i]   = EM->pfn.readEntireFile(filePaths[i]);
+                sources[i] = {filePaths[i], files[i].contents, size_t(files[i].contentSize)};
+                bResult    = files[i].contents != nullptr;
+            }
+            if (bResult) {
+                size_t size;
+                void  *archive = packArchive(sources, fileCount, &size, bCompress);
+                bResult        = archive && size <= UINT32_MAX &&
+                          EM->pfn.writeEntireFile(archivePath, archive, uint32_t(size));
+                free(archive);
+            }
+            for (uint32_t i = 0; i < fileCount; i++) {
+                if (files[i].contents) EM->pfn.freeLoadedFile(files[i]);
+            }
+            free(sources);
+            free(files);
+            return bResult;
+        }
+
+    }  // namespace io
+
+    namespace vfs {
+
+        using io::aepak_entry_t;
+        using io::aepak_header_t;
+
+        struct vfs_archive_t {
+            const uint8_t       *data;
+            size_t               size;
+            const aepak_entry_t *slots;
+            uint32_t             slotMask;
+            loaded_file_t        mapping;  // empty for mountArchiveFromMemory.
+        };
+
+        // how the contents of a loaded_file_t handed out by the VFS were made. files read from disk are not
+        // tracked, and go back to the platform.
+        enum vfs_file_kind_t : uint8_t {
+            VFS_FILE_HEAP = 1,  // a copy or a decompress, from malloc.
+            VFS_FILE_BORROWED,  // points into a mounted archive.
+        };
+
+        static vfs_archive_t s_archives[MAX_MOUNTED_ARCHIVES];
+        static uint32_t      s_archiveCount = 0;
+
+        // NOTE(Noah): mapping the same stored entry twice hands out the same pointer, so borrowed files are counted,
+        // and the pointer is only forgotten when the last of them is unmapped.
+        struct vfs_file_t {
+            vfs_file_kind_t kind;
+            uint32_t        refCount;
+        };
+
+        static std::mutex s_filesMutex;
+        static struct {
+            void      *key;
+            vfs_file_t value;
+        } *s_files = nullptr;
+
+        uint64_t hashPath(const char *path)
+        {
+            // FNV-1a over the normalized path, then a final mix so that the low bits, which pick the slot, are
+            // as good as the high ones.
+            uint64_t h     = 0xCBF29CE484222325ull;
+            char     prev  = '/';
+            while (path[0] == '.' && (path[1] == '/' || path[1] == '\\')) path += 2;
+            for (const char *c = path; *c; c++) {
+                char ch = *c;
+                if (ch == '\\') ch = '/';
+                else if (ch >= 'A' && ch <= 'Z') ch += 'a' - 'A';
+                if (ch == '/' && prev == '/') continue;
+                prev = ch;
+                h    = (h ^ uint8_t(ch)) * 0x100000001B3ull;
+            }
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h ? h : 1;
+        }
+
+        static inline uint64_t hashRotl(uint64_t v, int r) { return (v << r) | (v >> (64 - r)); }
+
+        static inline uint64_t hashRound(uint64_t acc, const uint8_t *p)
+        {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            return hashRotl(acc + v * 0xC2B2AE3D27D4EB4Full, 31) * 0x9E3779B185EBCA87ull;
+        }
+
+        uint64_t hashContents(const void *data, size_t size)
+        {
+            // NOTE(Noah): four lanes of 8 bytes each, so that the multiplies of one round overlap, then folded and
+            // mixed as in hashPath. this only has to tell files apart, not stand up to someone picking collisions.
+            const uint8_t *p        = (const uint8_t *)data;
+            uint64_t       lanes[4] = {0x60EA27EEADC0B5D6ull, 0xC2B2AE3D27D4EB4Full, 0, 0x61C8864E7A143579ull};
+            size_t         i        = 0;
+            for (; i + 32 <= size; i += 32) {
+                lanes[0] = hashRound(lanes[0], p + i);
+                lanes[1] = hashRound(lanes[1], p + i + 8);
+                lanes[2] = hashRound(lanes[2], p + i + 16);
+                lanes[3] = hashRound(lanes[3], p + i + 24);
+            }
+            uint64_t h = uint64_t(size) * 0x9E3779B185EBCA87ull;
+            h += hashRotl(lanes[0], 1) + hashRotl(lanes[1], 7) + hashRotl(lanes[2], 12) + hashRotl(lanes[3], 18);
+            for (; i + 8 <= size; i += 8) h = hashRotl(h ^ hashRound(0, p + i), 27) * 0x9E3779B185EBCA87ull;
+            for (; i < size; i++) h = (h ^ p[i]) * 0x100000001B3ull;
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // check everything that lookups depend on, so that a bad archive can never read out of bounds.
+        static bool vfsValidateArchive(const void *data, size_t size)
+        {
+            if (data == nullptr || size < sizeof(aepak_header_t)) return false;
+            const aepak_header_t *header = (const aepak_header_t *)data;
+            bool bValid = header->magic == io::AEPAK_MAGIC && header->version == io::AEPAK_VERSION &&
+                          header->headerSize == sizeof(aepak_header_t) && header->fileSize <= size &&
+                          header->slotCount && (header->slotCount & (header->slotCount - 1)) == 0 &&
+                          header->entryCount < header->slotCount && (header->tocOffset % 8) == 0 &&
+                          header->tocOffset <= header->fileSize &&
+                          uint64_t(header->slotCount) * sizeof(aepak_entry_t) <= header->fileSize - header->tocOffset &&
+                          header->namesOffset <= header->fileSize &&
+                          header->namesSize <= header->fileSize - header->namesOffset;
+            if (!bValid) return false;
+            const aepak_entry_t *slots = (const aepak_entry_t *)((const uint8_t *)data + header->tocOffset);
+            uint32_t             used  = 0;
+            for (uint32_t i = 0; bValid && i < header->slotCount; i++) {
+                const aepak_entry_t &e = slots[i];
+                if (e.hash == 0) continue;
+                used++;
+                bValid = (e.offset % io::AEPAK_ALIGNMENT) == 0 && e.offset <= header->fileSize &&
+                         e.storedSize <= header->fileSize - e.offset &&
+                         e.compression < io::AEPAK_COMPRESSION_COUNT && e.nameOffset < header->namesSize &&
+                         (e.compression != io::AEPAK_COMPRESSION_NONE || e.storedSize == e.size);
+            }
+            // an empty slot must remain, else a probe for a missing path would never end.
+            return bValid && used == header->entryCount;
+        }
+
+        static bool vfsMount(const void *data, size_t size, loaded_file_t mapping)
+        {
+            if (s_archiveCount >= MAX_MOUNTED_ARCHIVES || !vfsValidateArchive(data, size)) return false;
+            const aepak_header_t *header  = (const aepak_header_t *)data;
+            vfs_archive_t        &archive = s_archives[s_archiveCount++];
+            archive.data                  = (const uint8_t *)data;
+            archive.size                  = size;
+            archive.slots                 = (const aepak_entry_t *)(archive.data + header->tocOffset);
+            archive.slotMask              = header->slotCount - 1;
+            archive.mapping               = mapping;
+            return true;
+        }
+
+        bool mountArchive(const char *archivePath)
+        {
+            loaded_file_t file = EM->pfn.mapEntireFile(archivePath);
+            if (file.contents == nullptr) return false;
+            if (!vfsMount(file.contents, size_t(file.contentSize), file)) {
+                AELoggerError("could not mount %s, as it is not a valid .aepak or too many are mounted", archivePath);
+                EM->pfn.unmapFile(file);
+                return false;
+            }
+            return true;
+        }
+
+        bool mountArchiveFromMemory(const void *data, size_t size)
+        {
+            return vfsMount(data, size, loaded_file_t{});
+        }
+
+        void unmountArchives()
+        {
+            for (uint32_t i = 0; i < s_archiveCount; i++) {
+                if (s_archives[i].mapping.contents) EM->pfn.unmapFile(s_archives[i].mapping);
+            }
+            s_archiveCount = 0;
+        }
+
+        static const aepak_entry_t *vfsFind(const char *path, const vfs_archive_t **archiveOut)
+        {
+            if (s_archiveCount == 0) return nullptr;
+            uint64_t h = hashPath(path);
+            for (uint32_t i = s_archiveCount; i-- > 0;) {
+                const vfs_archive_t &archive = s_archives[i];
+                for (uint32_t slot = uint32_t(h) & archive.slotMask;; slot = (slot + 1) & archive.slotMask) {
+                    const aepak_entry_t &entry = archive.slots[slot];
+                    if (entry.hash == h) {
+                        *archiveOut = &archive;
+                        return &entry;
+                    }
+                    if (entry.hash == 0) break;
+                }
+            }
+            return nullptr;
+        }
+
+        static void vfsTrack(void *contents, vfs_file_kind_t kind)
+        {
+            std::lock_guard<std::mutex> lock(s_filesMutex);
+            ptrdiff_t                   i = hmgeti(s_files, contents);
+            if (i >= 0) s_files[i].value.refCount++;
+            else hmput(s_files, contents, (vfs_file_t{kind, 1}));
+        }
+
+        void _trackHeapFile(void *contents)
+        {
+            vfsTrack(contents, VFS_FILE_HEAP);
+        }
+
+        // @returns the kind that contents was tracked as, or 0 if it came from the platform.
+        static uint8_t vfsUntrack(void *contents)
+        {
+            std::lock_guard<std::mutex> lock(s_filesMutex);
+            ptrdiff_t                   i = hmgeti(s_files, contents);
+            if (i < 0) return 0;
+            uint8_t kind = s_files[i].value.kind;
+            if (--s_files[i].value.refCount == 0) hmdel(s_files, contents);
+            return kind;
+        }
+
+        // copy or decompress an entry into a new heap allocation.
+        static void *vfsReadEntry(const vfs_archive_t &archive, const aepak_entry_t &entry)
+        {
+            const aepak_header_t *header   = (const aepak_header_t *)archive.data;
+            const char           *name     = (const char *)archive.data + header->namesOffset + entry.nameOffset;
+            void                 *contents = malloc(entry.size);
+            if (contents == nullptr) {
+                AELoggerError("could not allocate %u bytes to read %s from a mounted .aepak", entry.size, name);
+                return nullptr;
+            }
+            const uint8_t *src     = archive.data + entry.offset;
+            bool           bResult = true;
+            if (entry.compression == io::AEPAK_COMPRESSION_LZ4) {
+                bResult = io::lz4Decompress(src, entry.storedSize, contents, entry.size);
+            } else {
+                memcpy(contents, src, entry.size);
+            }
+            if (!bResult) {
+                AELoggerError("%s in a mounted .aepak is corrupt", name);
+                free(contents);
+                return nullptr;
+            }
+            vfsTrack(contents, VFS_FILE_HEAP);
+            return contents;
+        }
+
+        loaded_file_t readEntireFile(const char *path)
+        {
+            const vfs_archive_t *archive;
+            const aepak_entry_t *entry = vfsFind(path, &archive);
+            if (entry == nullptr) return EM->pfn.readEntireFile(path);
+            // NOTE(Noah): an empty file reads as nothing, same as it does from disk.
+            loaded_file_t file = {};
+            file.fileName      = path;
+            if (entry->size == 0) return file;
+            if (entry->size > uint32_t(INT_MAX)) {
+                AELoggerError("cannot load %s, as it is over the 2 GB that a loaded_file_t holds", path);
+                return file;
+            }
+            file.contents = vfsReadEntry(*archive, *entry);
+            if (file.contents) file.contentSize = int(entry->size);
+            return file;
+        }
+
+        loaded_file_t mapEntireFile(const char *path)
+        {
+            const vfs_archive_t *archive;
+            const aepak_entry_t *entry = vfsFind(path, &archive);
+            if (entry == nullptr) return EM->pfn.mapEntireFile(path);
+            loaded_file_t file = {};
+            file.fileName      = path;
+            if (entry->size == 0) return file;
+            if (entry->size > uint32_t(INT_MAX)) {
+                AELoggerError("cannot load %s, as it is over the 2 GB that a loaded_file_t holds", path);
+                return file;
+            }
+            if (entry->compression == io::AEPAK_COMPRESSION_NONE) {
+                file.contents = (void *)(archive->data + entry->offset);
+                vfsTrack(file.contents, VFS_FILE_BORROWED);
+            } else {
+                file.contents = vfsReadEntry(*archive, *entry);
+            }
+            if (file.contents) file.contentSize = int(entry->size);
+            return file;
+        }
+
+        void freeLoadedFile(loaded_file_t file)
+        {
+            if (file.contents == nullptr) return;
+            uint8_t kind = vfsUntrack(file.contents);
+            if (kind == VFS_FILE_HEAP) free(file.contents);
+            else if (kind == 0) EM->pfn.freeLoadedFile(file);
+        }
+
+        void unmapFile(loaded_file_t file)
+        {
+            if (file.contents == nullptr) return;
+            uint8_t kind = vfsUntrack(file.contents);
+            if (kind == VFS_FILE_HEAP) free(file.contents);
+            else if (kind == 0) EM->pfn.unmapFile(file);
+        }
+
+        struct file_t {
+            const uint8_t *data;          // for files in an archive, the entry or a decompress of it.
+            bool           bOwned;        // data is a decompress, from malloc.
+            intptr_t       platformFile;  // for files on disk.
+            uint64_t       size;
+        };
+
+        file_t *openFile(const char *path)
+        {
+            const vfs_archive_t *archive;
+            const aepak_entry_t *entry = vfsFind(path, &archive);
+            file_t               file  = {};
+            if (entry == nullptr) {
+                file.platformFile = EM->pfn.openFile(path, &file.size);
+                if (file.platformFile == 0) return nullptr;
+            } else if (entry->compression == io::AEPAK_COMPRESSION_NONE) {
+                file.data = archive->data + entry->offset;
+                file.size = entry->size;
+            } else {
+                // NOTE(Noah): a compressed block must be decompressed from the start, so there is nothing to do but
+                // decompress the lot. vfsReadEntry tracks it for freeLoadedFile, which is not needed here.
+                void *contents = vfsReadEntry(*archive, *entry);
+                if (contents == nullptr) return nullptr;
+                vfsUntrack(contents);
+                file.data   = (const uint8_t *)contents;
+                file.bOwned = true;
+                file.size   = entry->size;
+            }
+            return new file_t(file);
+        }
+
+        uint64_t getFileSize(const file_t *file)
+        {
+            return file->size;
+        }
+
+        uint32_t readFile(file_t *file, uint64_t offset, void *dst, uint32_t size)
+        {
+            if (file->platformFile) return EM->pfn.readFileAt(file->platformFile, offset, dst, size);
+            if (offset >= file->size) return 0;
+            uint32_t bytes = uint32_t(math::min(uint64_t(size), file->size - offset));
+            memcpy(dst, file->data + offset, bytes);
+            return bytes;
+        }
+
+        void closeFile(file_t *file)
+        {
+            if (file == nullptr) return;
+            if (file->platformFile) EM->pfn.closeFile(file->platformFile);
+            if (file->bOwned) free((void *)file->data);
+            delete file;
+        }
+
+    }  // namespace vfs
+}  // namespace automata_engine
@@ -0,0 +1,610 @@
+#include <automata_engine.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// NOTE: stb_ds.h comes in through automata_engine_io.cpp, which also holds its implementation.
+
+// NOTE(Noah): the cache is a table of slots that never move (they live in fixed size blocks), a hash map from the
+// path hash to the slot, and an intrusive LRU list through the slots that are loaded but unreferenced. everything
+// but get() takes the one mutex. a load that misses marks its slot as loading and lets go of the mutex while it
+// reads the file, and any other thread that loads the same path meanwhile takes a reference and waits for it.
+// get() takes no lock at all: whoever holds a reference knows that the slot cannot be freed or reused under it.
+//
+// a hot reload loads the new asset into a separate allocation on the job pool, holding a reference so that the
+// slot stays put. update() swaps the pointer in the slot once the load is complete, which is why update() must
+// be called when no one is using the assets.
+
+namespace automata_engine {
+    namespace assets {
+
+        enum asset_state_t : uint32_t {
+            ASSET_STATE_FREE = 0,
+            ASSET_STATE_LOADING,
+            ASSET_STATE_READY,
+            ASSET_STATE_FAILED,
+        };
+
+        static constexpr uint32_t ASSET_BLOCK_SIZE = 256;
+        static constexpr uint32_t ASSET_MAX_BLOCKS = 256;
+        static constexpr uint32_t ASSET_NIL        = 0xFFFFFFFF;
+
+        struct asset_slot_t {
+            std::atomic<uint32_t> generation = 1;
+            asset_state_t         state      = ASSET_STATE_FREE;
+            asset_type_t          type;
+            uint32_t              refCount;
+            uint64_t              key;
+            uint64_t              pathHash;
+            char                 *path;
+            std::atomic<void *>   data;
+            size_t                bytes;
+            std::atomic<uint32_t> version;
+            bool                  bReloading;
+            uint32_t              lruPrev, lruNext;  // in the LRU list while unreferenced and ready.
+            uint32_t              nextFree;
+        };
+
+        // a reload in flight on the job pool. see update.
+        struct asset_reload_t {
+            uint32_t            index;
+            void               *data;
+            size_t              bytes;
+            jobs::job_counter_t counter;
+        };
+
+        // a file that changed, waiting to settle.
+        struct asset_change_t {
+            uint64_t pathHash;
+            char    *path;
+            double   lastChangeTime;
+        };
+
+        // called from update once a change to a file has settled.
+        struct asset_listener_t {
+            PFN_onFileChanged fn;
+            void             *user;
+        };
+
+        struct asset_cache_t {
+            std::mutex              mutex;
+            std::condition_variable cv;
+            asset_slot_t           *blocks[ASSET_MAX_BLOCKS];
+            uint32_t                slotCount = 0;
+            uint32_t                freeList  = ASSET_NIL;
+            struct {
+                uint64_t key;
+                uint32_t value;
+            } *lookup = nullptr;
+            uint32_t      lruHead = ASSET_NIL;  // the most recently used.
+            uint32_t      lruTail = ASSET_NIL;
+            size_t        budget  = 0;
+            size_t        bytes   = 0;
+            asset_usage_t usage[ASSET_TYPE_COUNT];
+
+            // hot reload. the changes have their own lock, since they come in from any thread.
+            std::mutex        changeMutex;
+            asset_change_t   *changes   = nullptr;  // stb_ds array.
+            asset_reload_t  **reloads   = nullptr;  // stb_ds array.
+            float             debounce  = HOT_RELOAD_DEBOUNCE_SECONDS;
+            bool              bWatching = false;
+            asset_listener_t *listeners = nullptr;  // stb_ds array.
+        };
+
+        static asset_cache_t s_cache;
+
+        // how each type is loaded, freed and measured.
+        template <typename T> struct asset_traits_t;
+
+        template <> struct asset_traits_t<raw_model_t> {
+            static constexpr asset_type_t type = ASSET_TYPE_MODEL;
+            static bool                   load(const char *path, raw_model_t *out)
+            {
+                *out = io::loadObj(path);
+                return out->vertexData != nullptr;
+            }
+            static void   unload(raw_model_t *model) { io::freeObj(*model); }
+            static size_t size(const raw_model_t &model)
+            {
+                return size_t(StretchyBufferCount(model.vertexData)) * sizeof(float) +
+                       size_t(StretchyBufferCount(model.indexData)) * sizeof(uint32_t);
+            }
+        };
+
+        template <> struct asset_traits_t<loaded_image_t> {
+            static constexpr asset_type_t type = ASSET_TYPE_IMAGE;
+            static bool                   load(const char *path, loaded_image_t *out)
+            {
+                size_t len  = strlen(path);
+                bool   bBmp = len >= 4 && path[len - 4] == '.' && (path[len - 3] | 0x20) == 'b' &&
+                            (path[len - 2] | 0x20) == 'm' && (path[len - 1] | 0x20) == 'p';
+                *out = bBmp ? io::loadBMP(path) : platform::stbImageLoad(path);
+                return out->pixelPointer != nullptr;
+            }
+            static void   unload(loaded_image_t *image) { io::freeLoadedImage(*image); }
+            static size_t size(const loaded_image_t &image)
+            {
+                return size_t(image.width) * image.height * sizeof(uint32_t) + size_t(image.parentFile.contentSize);
+            }
+        };
+
+        template <> struct asset_traits_t<loaded_wav_t> {
+            static constexpr asset_type_t type = ASSET_TYPE_SOUND;
+            static bool                   load(const char *path, loaded_wav_t *out)
+            {
+                size_t len  = strlen(path);
+                bool   bOgg = len >= 4 && path[len - 4] == '.' && (path[len - 3] | 0x20) == 'o' &&
+                            (path[len - 2] | 0x20) == 'g' && (path[len - 1] | 0x20) == 'g';
+                *out = bOgg ? io::loadOgg(path) : io::loadWav(path);
+                return out->sampleData != nullptr;
+            }
+            static void   unload(loaded_wav_t *wav) { io::freeWav(*wav); }
+            static size_t size(const loaded_wav_t &wav) { return size_t(wav.parentFile.contentSize); }
+        };
+
+        template <> struct asset_traits_t<loaded_mesh_t> {
+            static constexpr asset_type_t type = ASSET_TYPE_MESH;
+            static bool                   load(const char *path, loaded_mesh_t *out)
+            {
+                *out = io::loadMesh(path);
+                return out->vertexData != nullptr;
+            }
+            static void   unload(loaded_mesh_t *mesh) { io::freeMesh(*mesh); }
+            static size_t size(const loaded_mesh_t &mesh) { return size_t(mesh.parentFile.contentSize); }
+        };
+
+        template <typename T> static void assetUnload(void *data)
+        {
+            asset_traits_t<T>::unload((T *)data);
+        }
+
+        // load into a new allocation, for the reloads, which do not know the type statically.
+        // @returns nullptr on failure.
+        template <typename T> static void *assetLoadUntyped(const char *path, size_t *bytesOut)
+        {
+            T *data = (T *)calloc(1, sizeof(T));
+            if (!asset_traits_t<T>::load(path, data)) {
+                free(data);
+                return nullptr;
+            }
+            *bytesOut = asset_traits_t<T>::size(*data);
+            return data;
+        }
+
+        static void (*const s_unloaders[ASSET_TYPE_COUNT])(void *) = {
+            assetUnload<raw_model_t>, assetUnload<loaded_image_t>, assetUnload<loaded_wav_t>,
+            assetUnload<loaded_mesh_t>};
+
+        static void *(*const s_loaders[ASSET_TYPE_COUNT])(const char *, size_t *) = {
+            assetLoadUntyped<raw_model_t>, assetLoadUntyped<loaded_image_t>, assetLoadUntyped<loaded_wav_t>,
+            assetLoadUntyped<loaded_mesh_t>};
+
+        static inline asset_slot_t &assetSlot(uint32_t index)
+        {
+            return s_cache.blocks[index / ASSET_BLOCK_SIZE][index % ASSET_BLOCK_SIZE];
+        }
+
+        // the functions below must be called with the mutex held.
+
+        static uint32_t assetAllocSlot()
+        {
+            if (s_cache.freeList != ASSET_NIL) {
+                uint32_t index   = s_cache.freeList;
+                s_cache.freeList = assetSlot(index).nextFree;
+                return index;
+            }
+            if (s_cache.slotCount == ASSET_BLOCK_SIZE * ASSET_MAX_BLOCKS) return ASSET_NIL;
+            if (s_cache.slotCount % ASSET_BLOCK_SIZE == 0) {
+                s_cache.blocks[s_cache.slotCount / ASSET_BLOCK_SIZE] = new asset_slot_t[ASSET_BLOCK_SIZE];
+            }
+            return s_cache.slotCount++;
+        }
+
+        static void assetLruRemove(uint32_t index)
+        {
+            asset_slot_t &slot = assetSlot(index);
+            if (slot.lruPrev != ASSET_NIL) assetSlot(slot.lruPrev).lruNext = slot.lruNext;
+            else s_cache.lruHead = slot.lruNext;
+            if (slot.lruNext != ASSET_NIL) assetSlot(slot.lruNext).lruPrev = slot.lruPrev;
+            else s_cache.lruTail = slot.lruPrev;
+            asset_usage_t &usage = s_cache.usage[slot.type];
+            usage.cachedCount--;
+            usage.cachedBytes -= slot.bytes;
+        }
+
+        static void assetLruPushFront(uint32_t index)
+        {
+            asset_slot_t &slot = assetSlot(index);
+            slot.lruPrev       = ASSET_NIL;
+            slot.lruNext       = s_cache.lruHead;
+            if (s_cache.lruHead != ASSET_NIL) assetSlot(s_cache.lruHead).lruPrev = index;
+            else s_cache.lruTail = index;
+            s_cache.lruHead      = index;
+            asset_usage_t &usage = s_cache.usage[slot.type];
+            usage.cachedCount++;
+            usage.cachedBytes += slot.bytes;
+        }
+
+        // free the asset in a slot and put the slot back on the free list. the slot must be out of the LRU list.
+        static void assetFreeSlot(uint32_t index)
+        {
+            asset_slot_t &slot = assetSlot(index);
+            void         *data = slot.data.load(std::memory_order_relaxed);
+            if (slot.state == ASSET_STATE_READY) {
+                s_unloaders[slot.type](data);
+                asset_usage_t &usage = s_cache.usage[slot.type];
+                usage.assetCount--;
+                usage.bytes -= slot.bytes;
+                s_cache.bytes -= slot.bytes;
+            }
+            free(data);
+            free(slot.path);
+            hmdel(s_cache.lookup, slot.key);
+            // NOTE(Noah): the generation is what turns old handles to the slot into stale ones.
+            uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+            slot.generation.store(generation ? generation : 1, std::memory_order_relaxed);
+            slot.state = ASSET_STATE_FREE;
+            slot.data.store(nullptr, std::memory_order_relaxed);
+            slot.path        = nullptr;
+            slot.nextFree    = s_cache.freeList;
+            s_cache.freeList = index;
+        }
+
+        static void assetEvict()
+        {
+            while (s_cache.bytes > s_cache.budget && s_cache.lruTail != ASSET_NIL) {
+                uint32_t index = s_cache.lruTail;
+                assetLruRemove(index);
+                assetFreeSlot(index);
+            }
+        }
+
+        static void assetReleaseLocked(uint32_t index)
+        {
+            asset_slot_t &slot = assetSlot(index);
+            if (--slot.refCount) return;
+            if (slot.state == ASSET_STATE_READY && s_cache.budget > 0) {
+                assetLruPushFront(index);
+                assetEvict();
+            } else {
+                assetFreeSlot(index);
+            }
+        }
+
+        static bool assetIsLive(uint32_t index, uint32_t generation)
+        {
+            return generation && index < s_cache.slotCount &&
+                   assetSlot(index).generation.load(std::memory_order_relaxed) == generation &&
+                   assetSlot(index).refCount > 0;
+        }
+
+        template <typename T> handle_t<T> load(const char *path)
+        {
+            const asset_type_t type = asset_traits_t<T>::type;
+            // the type goes into the key, so that the same file loaded as two types is two assets.
+            const uint64_t pathHash = vfs::hashPath(path);
+            const uint64_t key      = pathHash ^ (uint64_t(type + 1) * 0x9E3779B97F4A7C15ull);
+            handle_t<T>    handle;
+
+            std::unique_lock<std::mutex> lock(s_cache.mutex);
+            ptrdiff_t                    found = hmgeti(s_cache.lookup, key);
+            if (found >= 0) {
+                uint32_t      index = s_cache.lookup[found].value;
+                asset_slot_t &slot  = assetSlot(index);
+                s_cache.usage[type].hitCount++;
+                if (slot.refCount++ == 0 && slot.state == ASSET_STATE_READY) assetLruRemove(index);
+                s_cache.cv.wait(lock, [&slot] { return slot.state != ASSET_STATE_LOADING; });
+                if (slot.state != ASSET_STATE_READY) {
+                    assetReleaseLocked(index);
+                    return handle;
+                }
+                handle.index      = index;
+                handle.generation = slot.generation.load(std::memory_order_relaxed);
+                return handle;
+            }
+
+            uint32_t index = assetAllocSlot();
+            if (index == ASSET_NIL) return handle;
+            asset_slot_t &slot = assetSlot(index);
+            slot.state         = ASSET_STATE_LOADING;
+            slot.type          = type;
+            slot.refCount      = 1;
+            slot.key           = key;
+            slot.pathHash      = pathHash;
+            slot.path          = strdup(path);
+            slot.bytes         = 0;
+            slot.bReloading    = false;
+            slot.data.store(nullptr, std::memory_order_relaxed);
+            slot.version.store(0, std::memory_order_relaxed);
+            hmput(s_cache.lookup, key, index);
+            s_cache.usage[type].loadCount++;
+            lock.unlock();
+
+            T   *data  = (T *)calloc(1, sizeof(T));
+            bool bLoad = asset_traits_t<T>::load(path, data);
+
+            lock.lock();
+            if (bLoad) {
+                slot.data.store(data, std::memory_order_release);
+                slot.bytes = asset_traits_t<T>::size(*data);
+                slot.state = ASSET_STATE_READY;
+                s_cache.usage[type].assetCount++;
+                s_cache.usage[type].bytes += slot.bytes;
+                s_cache.bytes += slot.bytes;
+                handle.index      = index;
+                handle.generation = slot.generation.load(std::memory_order_relaxed);
+                assetEvict();
+            } else {
+                AELoggerError("could not load asset %s", path);
+                free(data);
+                slot.state = ASSET_STATE_FAILED;
+                assetReleaseLocked(index);
+            }
+            s_cache.cv.notify_all();
+            return handle;
+        }
+
+        template <typename T> const T *get(handle_t<T> handle)
+        {
+            if (!handle.isValid() || handle.index >= ASSET_BLOCK_SIZE * ASSET_MAX_BLOCKS) return nullptr;
+            asset_slot_t *block = s_cache.blocks[handle.index / ASSET_BLOCK_SIZE];
+            if (block == nullptr) return nullptr;
+            asset_slot_t &slot = block[handle.index % ASSET_BLOCK_SIZE];
+            if (slot.generation.load(std::memory_order_relaxed) != handle.generation) return nullptr;
+            return (const T *)slot.data.load(std::memory_order_acquire);
+        }
+
+        template <typename T> uint32_t getVersion(handle_t<T> handle)
+        {
+            if (get(handle) == nullptr) return 0;
+            return assetSlot(handle.index).version.load(std::memory_order_relaxed);
+        }
+
+        template <typename T> handle_t<T> acquire(handle_t<T> handle)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            if (!assetIsLive(handle.index, handle.generation)) return handle_t<T>();
+            assetSlot(handle.index).refCount++;
+            return handle;
+        }
+
+        template <typename T> void release(handle_t<T> handle)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            if (assetIsLive(handle.index, handle.generation)) assetReleaseLocked(handle.index);
+        }
+
+#define AE_ASSETS_INSTANTIATE(T)                                                                                       \
+    template handle_t<T> load<T>(const char *);                                                                        \
+    template const T    *get<T>(handle_t<T>);                                                                          \
+    template handle_t<T> acquire<T>(handle_t<T>);                                                                      \
+    template void        release<T>(handle_t<T>);                                                                      \
+    template uint32_t    getVersion<T>(handle_t<T>);
+        AE_ASSETS_INSTANTIATE(raw_model_t)
+        AE_ASSETS_INSTANTIATE(loaded_image_t)
+        AE_ASSETS_INSTANTIATE(loaded_wav_t)
+        AE_ASSETS_INSTANTIATE(loaded_mesh_t)
+#undef AE_ASSETS_INSTANTIATE
+
+        void setMemoryBudget(size_t bytes)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            s_cache.budget = bytes;
+            assetEvict();
+        }
+
+        void evictUnreferenced()
+        {
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            while (s_cache.lruTail != ASSET_NIL) {
+                uint32_t index = s_cache.lruTail;
+                assetLruRemove(index);
+                assetFreeSlot(index);
+            }
+        }
+
+        asset_usage_t getUsage(asset_type_t type)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            return s_cache.usage[type];
+        }
+
+        void _close()
+        {
+            // NOTE(Noah): the reloads are waited on without the lock, since jobs::wait may run a job on this thread
+            // that loads or releases an asset. they hold references, but everything is going away regardless.
+            asset_reload_t **reloads = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(s_cache.mutex);
+                reloads         = s_cache.reloads;
+                s_cache.reloads = nullptr;
+            }
+            for (ptrdiff_t i = 0; i < arrlen(reloads); i++) jobs::wait(&reloads[i]->counter);
+
+            std::lock_guard<std::mutex> lock(s_cache.mutex);
+            for (ptrdiff_t i = 0; i < arrlen(reloads); i++) {
+                asset_reload_t *reload = reloads[i];
+                if (reload->data) s_unloaders[assetSlot(reload->index).type](reload->data);
+                free(reload->data);
+                delete reload;
+            }
+            arrfree(reloads);
+            for (uint32_t i = 0; i < s_cache.slotCount; i++) {
+                asset_slot_t &slot = assetSlot(i);
+                void         *data = slot.data.load(std::memory_order_relaxed);
+                if (slot.state == ASSET_STATE_READY) s_unloaders[slot.type](data);
+                free(data);
+                free(slot.path);
+            }
+            for (uint32_t b = 0; b * ASSET_BLOCK_SIZE < s_cache.slotCount; b++) {
+                delete[] s_cache.blocks[b];
+                s_cache.blocks[b] = nullptr;
+            }
+            hmfree(s_cache.lookup);
+            s_cache.slotCount = 0;
+            s_cache.freeList  = ASSET_NIL;
+            s_cache.lruHead   = ASSET_NIL;
+            s_cache.lruTail   = ASSET_NIL;
+            s_cache.bytes     = 0;
+            memset(s_cache.usage, 0, sizeof(s_cache.usage));
+
+            std::lock_guard<std::mutex> changeLock(s_cache.changeMutex);
+            for (ptrdiff_t i = 0; i < arrlen(s_cache.changes); i++) free(s_cache.changes[i].path);
+            arrfree(s_cache.changes);
+            arrfree(s_cache.listeners);
+            s_cache.bWatching = false;
+            s_cache.debounce  = HOT_RELOAD_DEBOUNCE_SECONDS;
+        }
+
+        // ----------- [SECTION] Hot reload -----------
+
+        static double assetNow()
+        {
+            using namespace std::chrono;
+            return duration<double>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool watchDirectory(const char *dirPath)
+        {
+            if (!EM->pfn.watchDirectory(dirPath)) return false;
+            s_cache.bWatching = true;
+            return true;
+        }
+
+        void notifyFileChanged(const char *path)
+        {
+            uint64_t                    pathHash = vfs::hashPath(path);
+            double                      now      = assetNow();
+            std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+            for (ptrdiff_t i = 0; i < arrlen(s_cache.changes); i++) {
+                if (s_cache.changes[i].pathHash == pathHash) {
+                    s_cache.changes[i].lastChangeTime = now;
+                    return;
+                }
+            }
+            asset_change_t change = {pathHash, strdup(path), now};
+            arrput(s_cache.changes, change);
+        }
+
+        void setReloadDebounce(float seconds)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+            s_cache.debounce = seconds;
+        }
+
+        void addReloadListener(PFN_onFileChanged fn, void *user)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+            ptrdiff_t                   count = arrlen(s_cache.listeners);
+            arraddnptr(s_cache.listeners, 1);
+            s_cache.listeners[count].fn   = fn;
+            s_cache.listeners[count].user = user;
+        }
+
+        void removeReloadListener(PFN_onFileChanged fn, void *user)
+        {
+            std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+            for (ptrdiff_t i = 0; i < arrlen(s_cache.listeners); i++) {
+                if (s_cache.listeners[i].fn == fn && s_cache.listeners[i].user == user) {
+                    arrdel(s_cache.listeners, i);
+                    return;
+                }
+            }
+        }
+
+        // start reloading every asset of the file. the reload holds a reference until update retires it.
+        // must be called with the mutex held.
+        static void assetStartReloads(uint64_t pathHash)
+        {
+            for (uint32_t i = 0; i < s_cache.slotCount; i++) {
+                asset_slot_t &slot = assetSlot(i);
+                if (slot.state != ASSET_STATE_READY || slot.pathHash != pathHash || slot.bReloading) continue;
+                if (slot.refCount == 0) {
+                    // nobody is using it, so just drop it. the next load reads the new file.
+                    assetLruRemove(i);
+                    assetFreeSlot(i);
+                    continue;
+                }
+                slot.refCount++;
+                slot.bReloading        = true;
+                asset_reload_t *reload = new asset_reload_t();
+                reload->index          = i;
+                arrput(s_cache.reloads, reload);
+                // NOTE(Noah): the path and type cannot change while the reload holds its reference.
+                const char  *path = slot.path;
+                asset_type_t type = slot.type;
+                jobs::submit(&reload->counter,
+                             [reload, path, type] { reload->data = s_loaders[type](path, &reload->bytes); });
+            }
+        }
+
+        void update()
+        {
+            char path[512];
+            while (s_cache.bWatching && EM->pfn.pollFileChange(path, sizeof(path))) notifyFileChanged(path);
+
+            // pick out the changes that have settled.
+            asset_change_t *settled = nullptr;
+            {
+                double                      now = assetNow();
+                std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+                for (ptrdiff_t i = 0; i < arrlen(s_cache.changes);) {
+                    if (now - s_cache.changes[i].lastChangeTime >= s_cache.debounce) {
+                        arrput(settled, s_cache.changes[i]);
+                        arrdelswap(s_cache.changes, i);
+                    } else {
+                        i++;
+                    }
+                }
+            }
+            if (settled == nullptr && arrlen(s_cache.reloads) == 0) return;
+
+            {
+                std::lock_guard<std::mutex> lock(s_cache.mutex);
+                for (ptrdiff_t i = 0; i < arrlen(settled); i++) assetStartReloads(settled[i].pathHash);
+
+                // swap in the reloads that are complete.
+                for (ptrdiff_t i = 0; i < arrlen(s_cache.reloads);) {
+                    asset_reload_t *reload = s_cache.reloads[i];
+                    if (reload->counter.pending.load(std::memory_order_acquire) != 0) {
+                        i++;
+                        continue;
+                    }
+                    asset_slot_t &slot = assetSlot(reload->index);
+                    if (reload->data) {
+                        void *old = slot.data.exchange(reload->data, std::memory_order_acq_rel);
+                        s_unloaders[slot.type](old);
+                        free(old);
+                        s_cache.usage[slot.type].bytes += reload->bytes - slot.bytes;
+                        s_cache.bytes += reload->bytes - slot.bytes;
+                        slot.bytes = reload->bytes;
+                        slot.version.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        AELoggerError("could not reload asset %s, so the old one stays", slot.path);
+                    }
+                    slot.bReloading = false;
+                    uint32_t index  = reload->index;
+                    delete reload;
+                    arrdelswap(s_cache.reloads, i);
+                    assetReleaseLocked(index);
+                }
+            }
+
+            // NOTE(Noah): the listeners are copied out, since a callback may add or remove one.
+            asset_listener_t *listeners = nullptr;
+            if (settled) {
+                std::lock_guard<std::mutex> lock(s_cache.changeMutex);
+                ptrdiff_t                   count = arrlen(s_cache.listeners);
+                if (count) memcpy(arraddnptr(listeners, count), s_cache.listeners, sizeof(asset_listener_t) * count);
+            }
+            for (ptrdiff_t i = 0; i < arrlen(settled); i++) {
+                for (ptrdiff_t j = 0; j < arrlen(listeners); j++) listeners[j].fn(settled[i].path, listeners[j].user);
+                free(settled[i].path);
+            }
+            arrfree(listeners);
+            arrfree(settled);
+        }
+
+    }  // namespace assets
+}  // namespace automata_engine
@@ -0,0 +1,521 @@
+#include <automata_engine.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#include <immintrin.h>
+
+// NOTE(Noah): stb_vorbis is not vendored with the engine. drop stb_vorbis.c next to the other stb headers to get
+// Ogg Vorbis, and without it loadOgg and openAudioStream say so and fail on .ogg files.
+#if defined(__has_include)
+#if __has_include("stb_vorbis.c")
+#define AUTOMATA_ENGINE_STB_VORBIS
+#define STB_VORBIS_NO_STDIO
+#define STB_VORBIS_NO_PUSHDATA_API
+#include "stb_vorbis.c"
+#endif
+#endif
+
+#if !defined(AUTOMATA_ENGINE_STB_VORBIS)
+struct stb_vorbis;
+#endif
+
+namespace automata_engine {
+    namespace io {
+
+        // ----------- [SECTION] PCM conversion -----------
+        // NOTE(Noah): each format has a kernel that turns 8 samples into 8 shorts at once, and one that does a single
+        // sample for the tail. the two must agree exactly.
+
+        template <pcm_format_t F> struct pcm_kernel_t;
+
+        template <> struct pcm_kernel_t<PCM_FORMAT_U8> {
+            static constexpr uint32_t size = 1;
+            static inline short       convert1(const uint8_t *p) { return short((int(p[0]) - 128) * 256); }
+            static inline __m128i     convert8(const uint8_t *p)
+            {
+                __m128i x = _mm_xor_si128(_mm_loadl_epi64((const __m128i *)p), _mm_set1_epi8(char(0x80)));
+                return _mm_unpacklo_epi8(_mm_setzero_si128(), x);
+            }
+        };
+
+        template <> struct pcm_kernel_t<PCM_FORMAT_S16> {
+            static constexpr uint32_t size = 2;
+            static inline short       convert1(const uint8_t *p) { return short(p[0] | (p[1] << 8)); }
+            static inline __m128i     convert8(const uint8_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+        };
+
+        template <> struct pcm_kernel_t<PCM_FORMAT_S24> {
+            static constexpr uint32_t size = 3;
+            static inline short       convert1(const uint8_t *p) { return short(p[1] | (p[2] << 8)); }
+            // NOTE(Noah): this reads 4 bytes past the 8 samples.
+            static inline __m128i convert8(const uint8_t *p)
+            {
+#if defined(__AVX2__) || defined(__SSSE3__)
+                // the top two bytes of each of the first 4 samples of a 16 byte load.
+                const __m128i top = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1);
+                __m128i       lo  = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), top);
+                __m128i       hi  = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 12)), top);
+                return _mm_unpacklo_epi64(lo, hi);
+#else
+                alignas(16) short out[8];
+                for (uint32_t i = 0; i < 8; i++) out[i] = convert1(p + i * 3);
+                return _mm_load_si128((const __m128i *)out);
+#endif
+            }
+        };
+
+        template <> struct pcm_kernel_t<PCM_FORMAT_S32> {
+            static constexpr uint32_t size = 4;
+            static inline short       convert1(const uint8_t *p) { return short(p[2] | (p[3] << 8)); }
+            static inline __m128i     convert8(const uint8_t *p)
+            {
+                __m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)p), 16);
+                __m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(p + 16)), 16);
+                return _mm_packs_epi32(a, b);
+            }
+        };
+
+        template <> struct pcm_kernel_t<PCM_FORMAT_F32> {
+            static constexpr uint32_t size = 4;
+            static inline short       convert1(const uint8_t *p)
+            {
+                float f;
+                memcpy(&f, p, sizeof(f));
+                // NOTE(Noah): written so that NaN goes to the bottom, as it does with _mm_max_ps below.
+                f = f * 32767.f;
+                f = (f > -32768.f) ? f : -32768.f;
+                f = (f < 32767.f) ? f : 32767.f;
+                return short(lrintf(f));
+            }
+            static inline __m128i convert8(const uint8_t *p)
+            {
+                const __m128 scale = _mm_set1_ps(32767.f), lo = _mm_set1_ps(-32768.f), hi = _mm_set1_ps(32767.f);
+                __m128       a     = _mm_mul_ps(_mm_loadu_ps((const float *)p), scale);
+                __m128       b     = _mm_mul_ps(_mm_loadu_ps((const float *)(p + 16)), scale);
+                a                  = _mm_min_ps(_mm_max_ps(a, lo), hi);
+                b                  = _mm_min_ps(_mm_max_ps(b, lo), hi);
+                return _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+            }
+        };
+
+        template <pcm_format_t F>
+        static void pcmConvert(const uint8_t *src, uint32_t channels, size_t frameCount, short *dst)
+        {
+            using kernel_t           = pcm_kernel_t<F>;
+            const size_t sampleCount = frameCount * channels;
+            size_t       i           = 0;
+            // NOTE(Noah): stopping 8 samples short leaves room for the kernels that read past their 8 samples.
+            if (channels == 2) {
+                for (; i + 16 <= sampleCount; i += 8) {
+                    _mm_storeu_si128((__m128i *)(dst + i), kernel_t::convert8(src + i * kernel_t::size));
+                }
+                for (; i < sampleCount; i++) dst[i] = kernel_t::convert1(src + i * kernel_t::size);
+            } else {
+                for (; i + 16 <= sampleCount; i += 8) {
+                    __m128i v = kernel_t::convert8(src + i * kernel_t::size);
+                    _mm_storeu_si128((__m128i *)(dst + i * 2), _mm_unpacklo_epi16(v, v));
+                    _mm_storeu_si128((__m128i *)(dst + i * 2 + 8), _mm_unpackhi_epi16(v, v));
+                }
+                for (; i < sampleCount; i++) dst[i * 2] = dst[i * 2 + 1] = kernel_t::convert1(src + i * kernel_t::size);
+            }
+        }
+
+        void convertPcm(const void *src, pcm_format_t format, uint32_t channels, size_t frameCount, short *dst)
+        {
+            assert(channels == 1 || channels == 2);
+            static void (*const converters[PCM_FORMAT_COUNT])(const uint8_t *, uint32_t, size_t, short *) = {
+                pcmConvert<PCM_FORMAT_U8>, pcmConvert<PCM_FORMAT_S16>, pcmConvert<PCM_FORMAT_S24>,
+                pcmConvert<PCM_FORMAT_S32>, pcmConvert<PCM_FORMAT_F32>};
+            converters[format]((const uint8_t *)src, channels, frameCount, dst);
+        }
+
+        // ----------- [SECTION] Ogg Vorbis -----------
+
+#if defined(AUTOMATA_ENGINE_STB_VORBIS)
+        // open an Ogg Vorbis that is already in memory, and check that it is one that we can play.
+        static stb_vorbis *vorbisOpen(const char *path, const loaded_file_t &file)
+        {
+            int         error  = 0;
+            stb_vorbis *vorbis = stb_vorbis_open_memory((const unsigned char *)file.contents, file.contentSize, &error,
+                nullptr);
+            if (vorbis == nullptr) {
+                AELoggerError("could not open %s, as it is not a valid Ogg Vorbis (error %d)", path, error);
+                return nullptr;
+            }
+            stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+            if (info.sample_rate != ENGINE_DESIRED_SAMPLES_PER_SECOND || info.channels < 1 || info.channels > 2) {
+                AELoggerError("could not open %s, as it is not a mono or stereo Ogg Vorbis at %u Hz", path,
+                    ENGINE_DESIRED_SAMPLES_PER_SECOND);
+                stb_vorbis_close(vorbis);
+                return nullptr;
+            }
+            return vorbis;
+        }
+
+        // decode up to frameCount frames as 16-bit stereo. mono goes to both channels.
+        // @returns the frames decoded, which is less than frameCount only at the end of the file.
+        static uint32_t vorbisDecode(stb_vorbis *vorbis, short *dst, uint32_t frameCount, bool bLoop)
+        {
+            uint32_t frames   = 0;
+            bool     bRewound = false;
+            while (frames < frameCount) {
+                int got = stb_vorbis_get_samples_short_interleaved(
+                    vorbis, 2, dst + size_t(frames) * 2, int(frameCount - frames) * 2);
+                if (got > 0) {
+                    frames += uint32_t(got);
+                    bRewound = false;
+                } else if (bLoop && !bRewound) {
+                    // NOTE(Noah): the rewind guard is for a file that ends as soon as it starts.
+                    stb_vorbis_seek_start(vorbis);
+                    bRewound = true;
+                } else {
+                    break;
+                }
+            }
+            return frames;
+        }
+#endif
+
+        loaded_wav_t loadOgg(const char *path)
+        {
+            loaded_wav_t wav = {};
+#if defined(AUTOMATA_ENGINE_STB_VORBIS)
+            loaded_file_t file = vfs::mapEntireFile(path);
+            if (file.contents == nullptr) return wav;
+            if (stb_vorbis *vorbis = vorbisOpen(path, file)) {
+                uint32_t frameCount = stb_vorbis_stream_length_in_samples(vorbis);
+                short   *samples    = (short *)malloc(math::max(size_t(frameCount) * 2 * sizeof(short), size_t(1)));
+                frameCount          = vorbisDecode(vorbis, samples, frameCount, false);
+                stb_vorbis_close(vorbis);
+                // NOTE(Noah): as in loadWav, the samples stand in for the file, so that freeWav frees them.
+                vfs::_trackHeapFile(samples);
+                wav.parentFile.fileName    = path;
+                wav.parentFile.contents    = samples;
+                wav.parentFile.contentSize = int(frameCount * 2 * sizeof(short));
+                wav.sampleCount            = int(frameCount);
+                wav.channels               = 2;
+                wav.sampleData             = samples;
+            }
+            vfs::unmapFile(file);
+#else
+            AELoggerError("could not load %s, as the engine was built without stb_vorbis", path);
+#endif
+            return wav;
+        }
+
+        // ----------- [SECTION] Audio streams -----------
+        // NOTE(Noah): an audio stream is a ring of AUDIO_STREAM_BLOCK_COUNT blocks of 16-bit stereo. each block is
+        // read or decoded on the job pool, then used, i.e. copied out by readAudioStream or queued on a voice by
+        // streamAudioToVoice, then filled again with the next part of the file. so while one block is in use, the
+        // ones after it are being read ahead. the blocks go round in order, which means that they can be tracked with
+        // three running counts rather than per block state:
+        //
+        //   consumed <= queued <= submitted <= consumed + AUDIO_STREAM_BLOCK_COUNT
+        //
+        // where submitted counts the blocks sent off to be filled, queued those given to the voice, and consumed
+        // those that are done with. block n lives at blocks[n % AUDIO_STREAM_BLOCK_COUNT].
+        //
+        // a .WAV can be read at any offset, so its blocks are filled at the same time. a Vorbis decoder can only go
+        // in order, so the job for block n decodes every block up to n that is not yet, under a lock. whichever job
+        // runs first does the work, and the others find it done.
+
+        enum audio_stream_source_t {
+            AUDIO_SOURCE_WAV = 0,
+            AUDIO_SOURCE_VORBIS,
+        };
+
+        struct audio_stream_block_t {
+            short              *samples;
+            uint8_t            *raw;     // the samples as they are in a .WAV, when they need to be converted.
+            uint32_t            frames;  // less than blockFrames only at the end of the stream.
+            uint32_t            sequence;
+            uint64_t            startFrame;
+            jobs::job_counter_t counter;
+        };
+
+        struct audio_stream_t {
+            audio_stream_source_t source;
+            uint64_t              frameCount;
+            uint32_t              blockFrames;
+            bool                  bLoop;
+
+            // a .WAV.
+            vfs::file_t *file;
+            uint64_t     dataOffset;
+            uint32_t     channels;
+            pcm_format_t format;
+            uint32_t     frameBytes;  // in the file.
+
+            // an Ogg Vorbis.
+            loaded_file_t oggFile;
+            stb_vorbis   *vorbis;
+            std::mutex    decodeMutex;
+            uint32_t      decoded;  // blocks decoded so far.
+
+            uint64_t             nextFrame;  // where the next block to be filled starts.
+            uint32_t             submitted, queued, consumed;
+            uint32_t             readOffset;  // frames of the oldest block copied out by readAudioStream.
+            audio_stream_block_t blocks[AUDIO_STREAM_BLOCK_COUNT];
+
+            size_t                residentBytes;
+            std::atomic<uint64_t> framesDecoded;
+            std::atomic<uint64_t> decodeNanoseconds;
+        };
+
+        // read the frames of a block from a .WAV.
+        static void audioStreamReadWav(audio_stream_t *stream, audio_stream_block_t *block)
+        {
+            const uint32_t frameBytes = stream->frameBytes;
+            uint8_t       *dst        = block->raw ? block->raw : (uint8_t *)block->samples;
+            uint64_t       frame      = block->startFrame;
+            uint32_t       frames     = 0;
+            while (frames < stream->blockFrames && frame < stream->frameCount) {
+                uint64_t left   = stream->frameCount - frame;
+                uint32_t count  = uint32_t(math::min(uint64_t(stream->blockFrames - frames), left));
+                uint32_t wanted = count * frameBytes;
+                uint32_t got    = vfs::readFile(stream->file, stream->dataOffset + frame * frameBytes,
+                    dst + size_t(frames) * frameBytes, wanted);
+                frames += got / frameBytes;
+                // NOTE(Noah): a short read means the file is shorter than its data chunk says, so end it there.
+                if (got != wanted) break;
+                frame += count;
+                if (frame == stream->frameCount && stream->bLoop) frame = 0;
+            }
+            if (block->raw) convertPcm(block->raw, stream->format, stream->channels, frames, block->samples);
+            block->frames = frames;
+            stream->framesDecoded.fetch_add(frames, std::memory_order_relaxed);
+        }
+
+        // decode every block up to and including this one.
+        static void audioStreamDecodeVorbis(audio_stream_t *stream, audio_stream_block_t *block)
+        {
+#if defined(AUTOMATA_ENGINE_STB_VORBIS)
+            std::lock_guard<std::mutex> lock(stream->decodeMutex);
+            while (int32_t(stream->decoded - block->sequence) <= 0) {
+                audio_stream_block_t *next = &stream->blocks[stream->decoded++ % AUDIO_STREAM_BLOCK_COUNT];
+                next->frames = vorbisDecode(stream->vorbis, next->samples, stream->blockFrames, stream->bLoop);
+                stream->framesDecoded.fetch_add(next->frames, std::memory_order_relaxed);
+            }
+#else
+            // openAudioStream never makes a vorbis stream without stb_vorbis, so this is never reached.
+            (void)stream;
+            (void)block;
+#endif
+        }
+
+        // fill a block. this runs on the job pool.
+        static void audioStreamFill(audio_stream_t *stream, audio_stream_block_t *block)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (stream->source == AUDIO_SOURCE_WAV) audioStreamReadWav(stream, block);
+            else audioStreamDecodeVorbis(stream, block);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            stream->decodeNanoseconds.fetch_add(
+                uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+
+        // send the next block off to be filled.
+        static void audioStreamSubmit(audio_stream_t *stream)
+        {
+            audio_stream_block_t *block = &stream->blocks[stream->submitted % AUDIO_STREAM_BLOCK_COUNT];
+            block->sequence             = stream->submitted++;
+            block->startFrame           = stream->nextFrame;
+            block->frames               = 0;
+            // move past the frames of this block. it takes fewer than blockFrames only at the end of the stream.
+            uint64_t end = stream->nextFrame + stream->blockFrames;
+            if (stream->bLoop) stream->nextFrame = end % stream->frameCount;
+            else stream->nextFrame = math::min(end, stream->frameCount);
+            if (block->startFrame == stream->frameCount) return;  // past the end.
+            jobs::submit(&block->counter, [stream, block] { audioStreamFill(stream, block); });
+        }
+
+        // parse the chunks of a .WAV, for the stream to read the data chunk from.
+        static bool audioStreamOpenWav(const char *path, audio_stream_t *stream)
+        {
+            vfs::file_t   *file       = stream->file;
+            const uint64_t fileSize   = vfs::getFileSize(file);
+            wav_header_t   header     = {};
+            wav_fmt_t      fmt        = {};
+            uint64_t       dataOffset = 0, dataSize = 0;
+            int            fmtSize    = 0;
+            if (vfs::readFile(file, 0, &header, sizeof(header)) == sizeof(header) &&
+                header.chunkID == Wav_ChunkID_RIFF && header.waveID == Wav_ChunkID_WAVE) {
+                for (uint64_t offset = sizeof(header); offset + sizeof(wav_chunk_header_t) <= fileSize;) {
+                    wav_chunk_header_t chunk;
+                    if (vfs::readFile(file, offset, &chunk, sizeof(chunk)) != sizeof(chunk)) break;
+                    offset += sizeof(chunk);
+                    if (chunk.chunkID == Wav_ChunkID_fmt) {
+                        uint32_t size = math::min(uint32_t(chunk.chunkSize), uint32_t(sizeof(fmt)));
+                        fmtSize       = vfs::readFile(file, offset, &fmt, size) == size ? int(size) : 0;
+                    } else if (chunk.chunkID == Wav_ChunkID_data) {
+                        dataOffset = offset;
+                        dataSize   = math::min(uint64_t(uint32_t(chunk.chunkSize)), fileSize - offset);
+                        break;
+                    }
+                    offset += (uint32_t(chunk.chunkSize) + 1) & ~1u;
+                }
+            }
+            pcm_format_t   format;
+            const bool     bSupported = LoadWav_GetPcmFormat(&fmt, fmtSize, &format) &&
+                                    (fmt.nChannels == 1 || fmt.nChannels == 2) &&
+                                    uint32_t(fmt.nSamplesPerSec) == ENGINE_DESIRED_SAMPLES_PER_SECOND;
+            const uint32_t frameBytes = bSupported ? fmt.nChannels * LoadWav_pcmFormatSizes[format] : 0;
+            if (!bSupported) {
+                AELoggerError("could not stream %s, as it is not a mono or stereo .WAV at %u Hz in a format that we "
+                              "take",
+                    path, ENGINE_DESIRED_SAMPLES_PER_SECOND);
+                return false;
+            }
+            stream->frameCount = dataSize / frameBytes;
+            stream->dataOffset = dataOffset;
+            stream->channels   = fmt.nChannels;
+            stream->format     = format;
+            stream->frameBytes = frameBytes;
+            return true;
+        }
+
+        static void audioStreamFree(audio_stream_t *stream)
+        {
+            free(stream->blocks[0].samples);
+            vfs::closeFile(stream->file);
+#if defined(AUTOMATA_ENGINE_STB_VORBIS)
+            if (stream->vorbis) stb_vorbis_close(stream->vorbis);
+#endif
+            vfs::unmapFile(stream->oggFile);
+            delete stream;
+        }
+
+        audio_stream_t *openAudioStream(const char *path, uint32_t blockFrames, bool bLoop)
+        {
+            vfs::file_t *file = vfs::openFile(path);
+            if (file == nullptr) {
+                AELoggerError("could not open %s to stream", path);
+                return nullptr;
+            }
+            audio_stream_t *stream = new audio_stream_t();
+            stream->file           = file;
+            stream->blockFrames    = blockFrames;
+            stream->bLoop          = bLoop;
+
+            // go by the magic at the start of the file.
+            char magic[4]   = {};
+            bool bSupported = false;
+            vfs::readFile(file, 0, magic, sizeof(magic));
+            if (memcmp(magic, "OggS", 4) == 0) {
+                vfs::closeFile(file);
+                stream->file   = nullptr;
+                stream->source = AUDIO_SOURCE_VORBIS;
+#if defined(AUTOMATA_ENGINE_STB_VORBIS)
+                stream->oggFile = vfs::mapEntireFile(path);
+                stream->vorbis  = stream->oggFile.contents ? vorbisOpen(path, stream->oggFile) : nullptr;
+                if (stream->vorbis) {
+                    stream->frameCount     = stb_vorbis_stream_length_in_samples(stream->vorbis);
+                    stb_vorbis_info info   = stb_vorbis_get_info(stream->vorbis);
+                    stream->residentBytes += info.setup_memory_required + info.temp_memory_required;
+                    bSupported             = true;
+                }
+#else
+                AELoggerError("could not stream %s, as the engine was built without stb_vorbis", path);
+#endif
+            } else {
+                stream->source = AUDIO_SOURCE_WAV;
+                bSupported     = audioStreamOpenWav(path, stream);
+            }
+            if (!bSupported || stream->frameCount == 0 || blockFrames == 0) {
+                if (bSupported) AELoggerError("could not stream %s, as it is empty", path);
+                audioStreamFree(stream);
+                return nullptr;
+            }
+
+            // NOTE(Noah): the blocks are all allocated at once. unless the file is 16-bit stereo already, each block
+            // also needs room to read the file into before it is converted.
+            const bool   bConvert    = stream->source == AUDIO_SOURCE_WAV &&
+                                    (stream->format != PCM_FORMAT_S16 || stream->channels != 2);
+            const size_t sampleBytes = size_t(blockFrames) * 2 * sizeof(short);
+            const size_t rawBytes    = bConvert ? size_t(blockFrames) * stream->frameBytes : 0;
+            uint8_t     *memory      = (uint8_t *)malloc((sampleBytes + rawBytes) * AUDIO_STREAM_BLOCK_COUNT);
+            uint8_t     *raw         = memory + sampleBytes * AUDIO_STREAM_BLOCK_COUNT;
+            for (uint32_t i = 0; i < AUDIO_STREAM_BLOCK_COUNT; i++) {
+                stream->blocks[i].samples = (short *)(memory + sampleBytes * i);
+                stream->blocks[i].raw     = bConvert ? raw + rawBytes * i : nullptr;
+            }
+            stream->residentBytes += (sampleBytes + rawBytes) * AUDIO_STREAM_BLOCK_COUNT + sizeof(audio_stream_t);
+            for (uint32_t i = 0; i < AUDIO_STREAM_BLOCK_COUNT; i++) audioStreamSubmit(stream);
+            return stream;
+        }
+
+        uint64_t getAudioStreamFrameCount(const audio_stream_t *stream)
+        {
+            return stream->frameCount;
+        }
+
+        audio_stream_stats_t getAudioStreamStats(const audio_stream_t *stream)
+        {
+            audio_stream_stats_t stats = {};
+            stats.residentBytes        = stream->residentBytes;
+            stats.mappedBytes          = size_t(stream->oggFile.contentSize);
+            stats.framesDecoded        = stream->framesDecoded.load(std::memory_order_relaxed);
+            stats.decodeSeconds        = double(stream->decodeNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+            return stats;
+        }
+
+        uint32_t readAudioStream(audio_stream_t *stream, short *dst, uint32_t frameCount)
+        {
+            uint32_t done = 0;
+            while (done < frameCount) {
+                audio_stream_block_t *block = &stream->blocks[stream->consumed % AUDIO_STREAM_BLOCK_COUNT];
+                jobs::wait(&block->counter);
+                if (stream->readOffset == block->frames) {
+                    if (block->frames < stream->blockFrames) break;  // the end.
+                    stream->consumed++;
+                    stream->queued++;
+                    stream->readOffset = 0;
+                    audioStreamSubmit(stream);
+                    continue;
+                }
+                uint32_t count = math::min(frameCount - done, block->frames - stream->readOffset);
+                memcpy(dst + done * 2, block->samples + stream->readOffset * 2, count * 2 * sizeof(short));
+                stream->readOffset += count;
+                done += count;
+            }
+            return done;
+        }
+
+        bool streamAudioToVoice(audio_stream_t *stream, intptr_t voiceHandle)
+        {
+            // the voice plays the blocks in the order that they were queued, so those it is done with are the
+            // oldest ones. read them again.
+            uint32_t inUse   = stream->queued - stream->consumed;
+            uint32_t playing = math::min(EM->pfn.voiceGetQueuedBufferCount(voiceHandle), inUse);
+            for (; inUse > playing; inUse--) {
+                stream->consumed++;
+                audioStreamSubmit(stream);
+            }
+            // queue what has been read, without waiting on what has not.
+            bool bEnd = false;
+            while (stream->queued != stream->submitted) {
+                audio_stream_block_t *block = &stream->blocks[stream->queued % AUDIO_STREAM_BLOCK_COUNT];
+                if (block->counter.pending.load(std::memory_order_acquire) != 0) break;
+                if (block->frames == 0) {
+                    bEnd = true;
+                    break;
+                }
+                if (!EM->pfn.voiceQueueBuffer(voiceHandle, block->samples, block->frames * 2 * sizeof(short))) break;
+                stream->queued++;
+            }
+            return !(bEnd && stream->queued == stream->consumed);
+        }
+
+        void closeAudioStream(audio_stream_t *stream)
+        {
+            if (stream == nullptr) return;
+            for (uint32_t i = 0; i < AUDIO_STREAM_BLOCK_COUNT; i++) jobs::wait(&stream->blocks[i].counter);
+            audioStreamFree(stream);
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
@@ -0,0 +1,700 @@
+#include <automata_engine.hpp>
+
+#include <float.h>
+#include <immintrin.h>
+
+// NOTE(Noah): the BVH is built in two steps. first a binary tree is built top-down with a
+// binned SAH (surface area heuristic). then that tree is collapsed into a 4-wide tree, where
+// each node stores the bounds of its four children SoA. that way the traversal tests a ray
+// against four boxes with a handful of SSE instructions, and every node visit touches exactly
+// two cache lines.
+
+namespace automata_engine {
+    namespace math {
+
+        static constexpr uint32_t BVH_BIN_COUNT          = 16;
+        static constexpr uint32_t BVH_MAX_LEAF_SIZE      = 4;
+        static constexpr uint32_t BVH_PARALLEL_THRESHOLD = 4096;  // subtrees larger than this are built on the pool.
+        static constexpr uint32_t BVH_STACK_SIZE         = 256;
+        // NOTE: subtrees past this depth are made into one leaf, however big. a BVH4 level takes at least one BVH2
+        // level and a traversal step pushes at most 3 more nodes than it pops, so this bounds the stack.
+        static constexpr uint32_t BVH_MAX_DEPTH = 64;
+        static_assert(3 * BVH_MAX_DEPTH + 1 <= BVH_STACK_SIZE, "the traversal stack must fit the deepest tree");
+
+        // NOTE: relative cost of a node traversal step vs. a primitive intersection for the SAH.
+        static constexpr float BVH_TRAVERSAL_COST = 1.0f;
+        static constexpr float BVH_PRIM_COST      = 1.0f;
+
+        struct bvh_bounds_t {
+            float min[3];
+            float max[3];
+        };
+
+        struct bvh_node2_t {
+            bvh_bounds_t bounds;
+            uint32_t     left;  // 0 means this is a leaf. the root is never a child, so 0 is free to use.
+            uint32_t     right;
+            uint32_t     first;
+            uint32_t     count;
+        };
+
+        struct bvh_build_ctx_t {
+            const bvh_bounds_t   *primBounds;
+            uint32_t             *primIndices;
+            bvh_node2_t          *nodes;
+            std::atomic<uint32_t> nodeCount;
+        };
+
+        static inline bvh_bounds_t boundsEmpty()
+        {
+            return {{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+        }
+
+        static inline void boundsGrow(bvh_bounds_t &a, const bvh_bounds_t &b)
+        {
+            for (uint32_t i = 0; i < 3; i++) {
+                a.min[i] = min(a.min[i], b.min[i]);
+                a.max[i] = max(a.max[i], b.max[i]);
+            }
+        }
+
+        static inline void boundsGrowPoint(bvh_bounds_t &a, const float *p)
+        {
+            for (uint32_t i = 0; i < 3; i++) {
+                a.min[i] = min(a.min[i], p[i]);
+                a.max[i] = max(a.max[i], p[i]);
+            }
+        }
+
+        static inline float boundsHalfArea(const bvh_bounds_t &a)
+        {
+            float dx = a.max[0] - a.min[0];
+            float dy = a.max[1] - a.min[1];
+            float dz = a.max[2] - a.min[2];
+            if (dx < 0.f || dy < 0.f || dz < 0.f) return 0.f;
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        static inline float primCentroid(const bvh_bounds_t &b, uint32_t axis)
+        {
+            return (b.min[axis] + b.max[axis]) * 0.5f;
+        }
+
+        struct bvh_bin_t {
+            bvh_bounds_t bounds;
+            uint32_t     count;
+        };
+
+        static void binPrims(const bvh_build_ctx_t *ctx,
+            uint32_t                                begin,
+            uint32_t                                end,
+            const bvh_bounds_t                     &centroidBounds,
+            bvh_bin_t (*bins)[BVH_BIN_COUNT])
+        {
+            for (uint32_t a = 0; a < 3; a++) {
+                for (uint32_t b = 0; b < BVH_BIN_COUNT; b++) { bins[a][b] = {boundsEmpty(), 0}; }
+            }
+            float scale[3];
+            for (uint32_t a = 0; a < 3; a++) {
+                float extent = centroidBounds.max[a] - centroidBounds.min[a];
+                scale[a]     = (extent > 0.f) ? (float(BVH_BIN_COUNT) * 0.9999f) / extent : 0.f;
+            }
+            for (uint32_t i = begin; i < end; i++) {
+                const bvh_bounds_t &pb = ctx->primBounds[ctx->primIndices[i]];
+                for (uint32_t a = 0; a < 3; a++) {
+                    uint32_t b = uint32_t((primCentroid(pb, a) - centroidBounds.min[a]) * scale[a]);
+                    b          = min(b, BVH_BIN_COUNT - 1);
+                    boundsGrow(bins[a][b].bounds, pb);
+                    bins[a][b].count++;
+                }
+            }
+        }
+
+        static void buildNode2(bvh_build_ctx_t *ctx, uint32_t nodeIdx, uint32_t begin, uint32_t end, uint32_t depth);
+
+        static void splitNode2(bvh_build_ctx_t *ctx, uint32_t nodeIdx, uint32_t mid, uint32_t depth)
+        {
+            bvh_node2_t &node  = ctx->nodes[nodeIdx];
+            uint32_t     begin = node.first;
+            uint32_t     end   = node.first + node.count;
+            uint32_t     left  = ctx->nodeCount.fetch_add(2, std::memory_order_relaxed);
+            node.left          = left;
+            node.right         = left + 1;
+            node.count         = 0;
+
+            if ((end - begin) >= BVH_PARALLEL_THRESHOLD) {
+                jobs::job_counter_t counter;
+                jobs::submit(&counter, [=] { buildNode2(ctx, left + 1, mid, end, depth + 1); });
+                buildNode2(ctx, left, begin, mid, depth + 1);
+                jobs::wait(&counter);
+            } else {
+                buildNode2(ctx, left, begin, mid, depth + 1);
+                buildNode2(ctx, left + 1, mid, end, depth + 1);
+            }
+        }
+
+        static void buildNode2(bvh_build_ctx_t *ctx, uint32_t nodeIdx, uint32_t begin, uint32_t end, uint32_t depth)
+        {
+            bvh_node2_t &node = ctx->nodes[nodeIdx];
+            node.left         = 0;
+            node.right        = 0;
+            node.first        = begin;
+            node.count        = end - begin;
+
+            bvh_bounds_t bounds         = boundsEmpty();
+            bvh_bounds_t centroidBounds = boundsEmpty();
+            for (uint32_t i = begin; i < end; i++) {
+                const bvh_bounds_t &pb = ctx->primBounds[ctx->primIndices[i]];
+                boundsGrow(bounds, pb);
+                float c[3] = {primCentroid(pb, 0), primCentroid(pb, 1), primCentroid(pb, 2)};
+                boundsGrowPoint(centroidBounds, c);
+            }
+            node.bounds = bounds;
+
+            const uint32_t count = end - begin;
+            if (count <= BVH_MAX_LEAF_SIZE || depth >= BVH_MAX_DEPTH) return;
+
+            // find the best split over all axes and bin boundaries.
+            bvh_bin_t bins[3][BVH_BIN_COUNT];
+            if (count >= BVH_PARALLEL_THRESHOLD * 16) {
+                // for the top of the tree, the binning pass itself dominates, so fan it out as well.
+                constexpr uint32_t grain     = BVH_PARALLEL_THRESHOLD * 4;
+                const uint32_t     taskCount = (count + grain - 1) / grain;
+                bvh_bin_t(*taskBins)[3][BVH_BIN_COUNT] =
+                    (bvh_bin_t(*)[3][BVH_BIN_COUNT])malloc(sizeof(bvh_bin_t) * 3 * BVH_BIN_COUNT * taskCount);
+                jobs::parallelFor(count, grain, [&](uint32_t b, uint32_t e) {
+                    binPrims(ctx, begin + b, begin + e, centroidBounds, taskBins[b / grain]);
+                });
+                for (uint32_t a = 0; a < 3; a++) {
+                    for (uint32_t b = 0; b < BVH_BIN_COUNT; b++) {
+                        bins[a][b] = {boundsEmpty(), 0};
+                        for (uint32_t t = 0; t < taskCount; t++) {
+                            boundsGrow(bins[a][b].bounds, taskBins[t][a][b].bounds);
+                            bins[a][b].count += taskBins[t][a][b].count;
+                        }
+                    }
+                }
+                free(taskBins);
+            } else {
+                binPrims(ctx, begin, end, centroidBounds, bins);
+            }
+
+            float    bestCost  = FLT_MAX;
+            uint32_t bestAxis  = 0;
+            uint32_t bestSplit = 0;
+            for (uint32_t a = 0; a < 3; a++) {
+                if (centroidBounds.max[a] <= centroidBounds.min[a]) continue;
+                // sweep from the right to get the area and count of every right-hand partition.
+                float        rightArea[BVH_BIN_COUNT];
+                uint32_t     rightCount[BVH_BIN_COUNT];
+                bvh_bounds_t acc      = boundsEmpty();
+                uint32_t     accCount = 0;
+                for (uint32_t b = BVH_BIN_COUNT - 1; b > 0; b--) {
+                    boundsGrow(acc, bins[a][b].bounds);
+                    accCount += bins[a][b].count;
+                    rightArea[b]  = boundsHalfArea(acc);
+                    rightCount[b] = accCount;
+                }
+                acc      = boundsEmpty();
+                accCount = 0;
+                for (uint32_t b = 0; b < BVH_BIN_COUNT - 1; b++) {
+                    boundsGrow(acc, bins[a][b].bounds);
+                    accCount += bins[a][b].count;
+                    if (accCount == 0 || rightCount[b + 1] == 0) continue;
+                    float cost = boundsHalfArea(acc) * accCount + rightArea[b + 1] * rightCount[b + 1];
+                    if (cost < bestCost) {
+                        bestCost  = cost;
+                        bestAxis  = a;
+                        bestSplit = b + 1;
+                    }
+                }
+            }
+
+            uint32_t mid;
+            if (bestCost == FLT_MAX) {
+                // every centroid is in the same spot. the SAH cannot separate them, so split down the middle
+                // to keep the leaves small.
+                mid = begin + count / 2;
+            } else {
+                const float nodeArea = boundsHalfArea(bounds);
+                const float leafCost = BVH_PRIM_COST * count;
+                const float splitCost =
+                    BVH_TRAVERSAL_COST + BVH_PRIM_COST * bestCost / ((nodeArea > 0.f) ? nodeArea : 1.f);
+                // leaves are capped in size since the BVH4 stores the count per lane and we do not want degenerate
+                // leaves when boxes heavily overlap.
+                if (splitCost >= leafCost && count <= BVH_MAX_LEAF_SIZE * 4) return;
+
+                const float extent = centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis];
+                const float scale  = (float(BVH_BIN_COUNT) * 0.9999f) / extent;
+                uint32_t   *idx    = ctx->primIndices;
+                uint32_t    i      = begin;
+                uint32_t    j      = end;
+                while (i < j) {
+                    const bvh_bounds_t &pb = ctx->primBounds[idx[i]];
+                    uint32_t b = uint32_t((primCentroid(pb, bestAxis) - centroidBounds.min[bestAxis]) * scale);
+                    if (min(b, BVH_BIN_COUNT - 1) < bestSplit) {
+                        i++;
+                    } else {
+                        uint32_t tmp = idx[i];
+                        idx[i]       = idx[--j];
+                        idx[j]       = tmp;
+                    }
+                }
+                mid = i;
+                if (mid == begin || mid == end) mid = begin + count / 2;
+            }
+
+            splitNode2(ctx, nodeIdx, mid, depth);
+        }
+
+        // NOTE: collapse the binary tree into the 4-wide one. nodes are appended in depth-first order so
+        // that a parent always precedes its children, which is what refit relies on.
+        static void collapseNode(const bvh_node2_t *nodes2, uint32_t node2Idx, bvh_t *bvh, uint32_t node4Idx)
+        {
+            uint32_t lanes[4];
+            uint32_t laneCount = 0;
+            const bvh_node2_t &root = nodes2[node2Idx];
+            lanes[laneCount++]      = root.left;
+            lanes[laneCount++]      = root.right;
+
+            // open up the child with the largest surface area until we have four lanes.
+            while (laneCount < 4) {
+                int   bestLane = -1;
+                float bestArea = -1.f;
+                for (uint32_t i = 0; i < laneCount; i++) {
+                    const bvh_node2_t &n = nodes2[lanes[i]];
+                    if (n.left == 0) continue;
+                    float area = boundsHalfArea(n.bounds);
+                    if (area > bestArea) {
+                        bestArea = area;
+                        bestLane = int(i);
+                    }
+                }
+                if (bestLane < 0) break;
+                const bvh_node2_t &n = nodes2[lanes[bestLane]];
+                lanes[bestLane]      = n.left;
+                lanes[laneCount++]   = n.right;
+            }
+
+            bvh_node4_t &node4 = bvh->nodes[node4Idx];
+            for (uint32_t i = 0; i < 4; i++) {
+                if (i >= laneCount) {
+                    node4.minX[i] = node4.minY[i] = node4.minZ[i] = FLT_MAX;
+                    node4.maxX[i] = node4.maxY[i] = node4.maxZ[i] = -FLT_MAX;
+                    node4.child[i]                                = BVH_INVALID;
+                    node4.count[i]                                = 0;
+                    continue;
+                }
+                const bvh_node2_t &n = nodes2[lanes[i]];
+                node4.minX[i]        = n.bounds.min[0];
+                node4.minY[i]        = n.bounds.min[1];
+                node4.minZ[i]        = n.bounds.min[2];
+                node4.maxX[i]        = n.bounds.max[0];
+                node4.maxY[i]        = n.bounds.max[1];
+                node4.maxZ[i]        = n.bounds.max[2];
+                if (n.left == 0) {
+                    node4.child[i] = BVH_LEAF_BIT | n.first;
+                    node4.count[i] = n.count;
+                } else {
+                    node4.child[i] = bvh->nodeCount++;
+                    node4.count[i] = 0;
+                }
+            }
+            // recurse after the lanes are written so that children are allocated after their parent.
+            for (uint32_t i = 0; i < laneCount; i++) {
+                if (!(node4.child[i] & BVH_LEAF_BIT)) { collapseNode(nodes2, lanes[i], bvh, node4.child[i]); }
+            }
+        }
+
+        static bvh_t buildBvhFromBounds(const bvh_bounds_t *primBounds, uint32_t primCount)
+        {
+            bvh_t bvh = {};
+            if (primCount == 0) return bvh;
+
+            bvh.primCount   = primCount;
+            bvh.primIndices = (uint32_t *)malloc(sizeof(uint32_t) * primCount);
+            for (uint32_t i = 0; i < primCount; i++) bvh.primIndices[i] = i;
+
+            // a binary tree with N leaves has at most 2N-1 nodes.
+            bvh_build_ctx_t ctx = {};
+            ctx.primBounds      = primBounds;
+            ctx.primIndices     = bvh.primIndices;
+            ctx.nodes           = (bvh_node2_t *)malloc(sizeof(bvh_node2_t) * (2 * primCount));
+            ctx.nodeCount       = 1;
+            buildNode2(&ctx, 0, 0, primCount, 0);
+
+            const bvh_node2_t &root = ctx.nodes[0];
+            bvh.bounds              = aabb_t::fromLine(vec3_t(root.bounds.min[0], root.bounds.min[1], root.bounds.min[2]),
+                vec3_t(root.bounds.max[0], root.bounds.max[1], root.bounds.max[2]));
+
+            // every BVH4 node consumes at least one BVH2 interior node, so this is an upper bound.
+            uint32_t nodes2Count = ctx.nodeCount.load();
+            bvh.nodes     = (bvh_node4_t *)_aligned_malloc(sizeof(bvh_node4_t) * max(nodes2Count, 1u), alignof(bvh_node4_t));
+            bvh.nodeCount = 1;
+            if (root.left == 0) {
+                // the whole thing fits in a single leaf. the root is still an interior BVH4 node with one lane.
+                bvh_node4_t &node4 = bvh.nodes[0];
+                for (uint32_t i = 0; i < 4; i++) {
+                    node4.minX[i] = node4.minY[i] = node4.minZ[i] = FLT_MAX;
+                    node4.maxX[i] = node4.maxY[i] = node4.maxZ[i] = -FLT_MAX;
+                    node4.child[i]                                = BVH_INVALID;
+                    node4.count[i]                                = 0;
+                }
+                node4.minX[0]  = root.bounds.min[0];
+                node4.minY[0]  = root.bounds.min[1];
+                node4.minZ[0]  = root.bounds.min[2];
+                node4.maxX[0]  = root.bounds.max[0];
+                node4.maxY[0]  = root.bounds.max[1];
+                node4.maxZ[0]  = root.bounds.max[2];
+                node4.child[0] = BVH_LEAF_BIT | root.first;
+                node4.count[0] = root.count;
+            } else {
+                collapseNode(ctx.nodes, 0, &bvh, 0);
+            }
+
+            free(ctx.nodes);
+            return bvh;
+        }
+
+        static void gatherPrimBoxes(bvh_t *bvh, const aabb_t *boxes)
+        {
+            jobs::parallelFor(bvh->primCount, BVH_PARALLEL_THRESHOLD * 4, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) bvh->primBoxes[i] = boxes[bvh->primIndices[i]];
+            });
+        }
+
+        bvh_t buildBvh(const aabb_t *boxes, uint32_t boxCount)
+        {
+            bvh_bounds_t *primBounds = (bvh_bounds_t *)malloc(sizeof(bvh_bounds_t) * max(boxCount, 1u));
+            defer(free(primBounds));
+            jobs::parallelFor(boxCount, BVH_PARALLEL_THRESHOLD * 4, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    primBounds[i] = {{boxes[i].min.x, boxes[i].min.y, boxes[i].min.z},
+                        {boxes[i].max.x, boxes[i].max.y, boxes[i].max.z}};
+                }
+            });
+            bvh_t bvh = buildBvhFromBounds(primBounds, boxCount);
+            if (boxCount) {
+                bvh.primBoxes = (aabb_t *)malloc(sizeof(aabb_t) * boxCount);
+                gatherPrimBoxes(&bvh, boxes);
+            }
+            return bvh;
+        }
+
+        static void gatherTriVerts(bvh_t *bvh, raw_model_t model)
+        {
+            jobs::parallelFor(bvh->primCount, BVH_PARALLEL_THRESHOLD * 4, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    uint32_t tri = bvh->primIndices[i];
+                    for (uint32_t k = 0; k < 3; k++) {
+                        const float *p           = model.vertexData + 8 * model.indexData[3 * tri + k];
+                        bvh->triVerts[3 * i + k] = vec3_t(p[0], p[1], p[2]);
+                    }
+                }
+            });
+        }
+
+        bvh_t buildBvh(raw_model_t model)
+        {
+            const uint32_t triCount   = StretchyBufferCount(model.indexData) / 3;
+            bvh_bounds_t  *primBounds = (bvh_bounds_t *)malloc(sizeof(bvh_bounds_t) * max(triCount, 1u));
+            defer(free(primBounds));
+            jobs::parallelFor(triCount, BVH_PARALLEL_THRESHOLD * 4, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    primBounds[i] = boundsEmpty();
+                    for (uint32_t k = 0; k < 3; k++) {
+                        boundsGrowPoint(primBounds[i], model.vertexData + 8 * model.indexData[3 * i + k]);
+                    }
+                }
+            });
+            bvh_t bvh = buildBvhFromBounds(primBounds, triCount);
+            if (triCount) {
+                bvh.triVerts = (vec3_t *)malloc(sizeof(vec3_t) * 3 * triCount);
+                gatherTriVerts(&bvh, model);
+            }
+            return bvh;
+        }
+
+        void freeBvh(bvh_t bvh)
+        {
+            if (bvh.nodes) _aligned_free(bvh.nodes);
+            free(bvh.primIndices);
+            free(bvh.triVerts);
+            free(bvh.primBoxes);
+        }
+
+        // NOTE: the prim bounds lookup for refit is from the (already updated) primBoxes or triVerts. parents precede children, so a reverse sweep sees every child before its parent.
+        template <typename FN_leafBounds>
+        static void refitNodes(bvh_t *bvh, FN_leafBounds leafBounds)
+        {
+            for (int32_t n = int32_t(bvh->nodeCount) - 1; n >= 0; n--) {
+                bvh_node4_t &node = bvh->nodes[n];
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (node.child[i] == BVH_INVALID) continue;
+                    bvh_bounds_t b = boundsEmpty();
+                    if (node.child[i] & BVH_LEAF_BIT) {
+                        uint32_t first = node.child[i] & ~BVH_LEAF_BIT;
+                        for (uint32_t p = first; p < first + node.count[i]; p++) { boundsGrow(b, leafBounds(p)); }
+                    } else {
+                        const bvh_node4_t &c = bvh->nodes[node.child[i]];
+                        for (uint32_t j = 0; j < 4; j++) {
+                            b.min[0] = min(b.min[0], c.minX[j]);
+                            b.min[1] = min(b.min[1], c.minY[j]);
+                            b.min[2] = min(b.min[2], c.minZ[j]);
+                            b.max[0] = max(b.max[0], c.maxX[j]);
+                            b.max[1] = max(b.max[1], c.maxY[j]);
+                            b.max[2] = max(b.max[2], c.maxZ[j]);
+                        }
+                    }
+                    node.minX[i] = b.min[0];
+                    node.minY[i] = b.min[1];
+                    node.minZ[i] = b.min[2];
+                    node.maxX[i] = b.max[0];
+                    node.maxY[i] = b.max[1];
+                    node.maxZ[i] = b.max[2];
+                }
+            }
+            if (bvh->nodeCount) {
+                const bvh_node4_t &r   = bvh->nodes[0];
+                vec3_t             lo  = vec3_t(FLT_MAX, FLT_MAX, FLT_MAX);
+                vec3_t             hi  = vec3_t(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                for (uint32_t j = 0; j < 4; j++) {
+                    lo = vec3_t(min(lo.x, r.minX[j]), min(lo.y, r.minY[j]), min(lo.z, r.minZ[j]));
+                    hi = vec3_t(max(hi.x, r.maxX[j]), max(hi.y, r.maxY[j]), max(hi.z, r.maxZ[j]));
+                }
+                bvh->bounds = aabb_t::fromLine(lo, hi);
+            }
+        }
+
+        void refitBvh(bvh_t *bvh, const aabb_t *boxes)
+        {
+            assert(bvh->primBoxes != nullptr);
+            gatherPrimBoxes(bvh, boxes);
+            refitNodes(bvh, [&](uint32_t p) -> bvh_bounds_t {
+                const aabb_t &box = bvh->primBoxes[p];
+                return {{box.min.x, box.min.y, box.min.z}, {box.max.x, box.max.y, box.max.z}};
+            });
+        }
+
+        void refitBvh(bvh_t *bvh, raw_model_t model)
+        {
+            assert(bvh->triVerts != nullptr);
+            gatherTriVerts(bvh, model);
+            refitNodes(bvh, [&](uint32_t p) -> bvh_bounds_t {
+                bvh_bounds_t b = boundsEmpty();
+                for (uint32_t k = 0; k < 3; k++) boundsGrowPoint(b, &bvh->triVerts[3 * p + k].x);
+                return b;
+            });
+        }
+
+        // ---------------- queries ----------------
+
+        struct bvh_ray_t {
+            vec3_t origin;
+            vec3_t invDir;
+            vec3_t dir;
+            __m128 ox, oy, oz;
+            __m128 idx, idy, idz;
+        };
+
+        static inline bvh_ray_t makeBvhRay(const vec3_t &origin, const vec3_t &dir)
+        {
+            bvh_ray_t r;
+            r.origin = origin;
+            r.dir    = dir;
+            // NOTE: a zero direction component gives +-inf, which the slab test handles fine as long as we never
+            // compute 0*inf. the min/max ordering of SSE takes care of the NaN that may produce.
+            r.invDir = vec3_t(1.f / dir.x, 1.f / dir.y, 1.f / dir.z);
+            r.ox     = _mm_set1_ps(origin.x);
+            r.oy     = _mm_set1_ps(origin.y);
+            r.oz     = _mm_set1_ps(origin.z);
+            r.idx    = _mm_set1_ps(r.invDir.x);
+            r.idy    = _mm_set1_ps(r.invDir.y);
+            r.idz    = _mm_set1_ps(r.invDir.z);
+            return r;
+        }
+
+        // test the ray against the four lanes of a node. returns a 4-bit hit mask and the entry distances.
+        static inline int intersectNode4(const bvh_ray_t &r, const bvh_node4_t &node, float tMax, __m128 *tEntryOut)
+        {
+            __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minX), r.ox), r.idx);
+            __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxX), r.ox), r.idx);
+            __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minY), r.oy), r.idy);
+            __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxY), r.oy), r.idy);
+            __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minZ), r.oz), r.idz);
+            __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxZ), r.oz), r.idz);
+
+            __m128 tEntry = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+                _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+            __m128 tExit  = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+                _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(tMax)));
+
+            *tEntryOut = tEntry;
+            return _mm_movemask_ps(_mm_cmple_ps(tEntry, tExit));
+        }
+
+        static inline bool intersectPrimBox(const bvh_ray_t &r, const aabb_t &box, float tMax, float *tOut)
+        {
+            float tEntry = 0.f;
+            float tExit  = tMax;
+            for (uint32_t a = 0; a < 3; a++) {
+                float o  = (&r.origin.x)[a];
+                float id = (&r.invDir.x)[a];
+                float t0 = ((&box.min.x)[a] - o) * id;
+                float t1 = ((&box.max.x)[a] - o) * id;
+                // NOTE: written so that a NaN (0*inf) leaves the interval untouched.
+                tEntry = (t0 < t1) ? max(tEntry, t0) : max(tEntry, t1);
+                tExit  = (t0 < t1) ? min(tExit, t1) : min(tExit, t0);
+            }
+            *tOut = tEntry;
+            return tEntry <= tExit;
+        }
+
+        // Moller-Trumbore.
+        static inline bool intersectPrimTri(
+            const bvh_ray_t &r, const vec3_t *v, float tMax, float *tOut, float *uOut, float *vOut)
+        {
+            const vec3_t e1  = v[1] - v[0];
+            const vec3_t e2  = v[2] - v[0];
+            const vec3_t p   = cross(r.dir, e2);
+            const float  det = dot(e1, p);
+            if (det > -1e-12f && det < 1e-12f) return false;
+            const float  invDet = 1.f / det;
+            const vec3_t s      = r.origin - v[0];
+            const float  u      = dot(s, p) * invDet;
+            if (u < 0.f || u > 1.f) return false;
+            const vec3_t q  = cross(s, e1);
+            const float  vv = dot(r.dir, q) * invDet;
+            if (vv < 0.f || u + vv > 1.f) return false;
+            const float t = dot(e2, q) * invDet;
+            if (t < 0.f || t > tMax) return false;
+            *tOut = t;
+            *uOut = u;
+            *vOut = vv;
+            return true;
+        }
+
+        template <bool bAnyHit>
+        static bool traverseRay(const bvh_t &bvh, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax,
+            bvh_hit_t *hitOut)
+        {
+            if (bvh.nodeCount == 0) return false;
+            const bvh_ray_t r = makeBvhRay(rayOrigin, rayDir);
+
+            uint32_t stack[BVH_STACK_SIZE];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+
+            bool      bHit = false;
+            bvh_hit_t best = {BVH_INVALID, tMax, 0.f, 0.f};
+
+            while (stackSize) {
+                const bvh_node4_t &node = bvh.nodes[stack[--stackSize]];
+                __m128             tEntry4;
+                int                mask = intersectNode4(r, node, best.t, &tEntry4);
+                if (!mask) continue;
+
+                alignas(16) float tEntry[4];
+                _mm_store_ps(tEntry, tEntry4);
+
+                // sort the hit lanes far-to-near so that the nearest child is popped first.
+                uint32_t order[4];
+                uint32_t orderCount = 0;
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (!(mask & (1 << i))) continue;
+                    uint32_t j = orderCount++;
+                    while (j > 0 && tEntry[order[j - 1]] < tEntry[i]) {
+                        order[j] = order[j - 1];
+                        j--;
+                    }
+                    order[j] = i;
+                }
+
+                for (uint32_t o = 0; o < orderCount; o++) {
+                    const uint32_t lane  = order[o];
+                    const uint32_t child = node.child[lane];
+                    if (!(child & BVH_LEAF_BIT)) {
+                        assert(stackSize < BVH_STACK_SIZE);
+                        stack[stackSize++] = child;
+                        continue;
+                    }
+                    const uint32_t first = child & ~BVH_LEAF_BIT;
+                    for (uint32_t p = first; p < first + node.count[lane]; p++) {
+                        float t, u = 0.f, v = 0.f;
+                        bool  bPrimHit = (bvh.triVerts) ? intersectPrimTri(r, &bvh.triVerts[3 * p], best.t, &t, &u, &v)
+                                                        : intersectPrimBox(r, bvh.primBoxes[p], best.t, &t);
+                        if (bPrimHit && t <= best.t) {
+                            bHit = true;
+                            best = {bvh.primIndices[p], t, u, v};
+                            if (bAnyHit) return true;
+                        }
+                    }
+                }
+            }
+            if (bHit && hitOut) *hitOut = best;
+            return bHit;
+        }
+
+        bool bvhClosestHit(
+            const bvh_t &bvh, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax, bvh_hit_t *hitOut)
+        {
+            return traverseRay<false>(bvh, rayOrigin, rayDir, tMax, hitOut);
+        }
+
+        bool bvhAnyHit(const bvh_t &bvh, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax)
+        {
+            return traverseRay<true>(bvh, rayOrigin, rayDir, tMax, nullptr);
+        }
+
+        uint32_t bvhOverlap(const bvh_t &bvh, const aabb_t &box, uint32_t *primsOut, uint32_t maxPrimsOut)
+        {
+            if (bvh.nodeCount == 0) return 0;
+            const __m128 qMinX = _mm_set1_ps(box.min.x), qMaxX = _mm_set1_ps(box.max.x);
+            const __m128 qMinY = _mm_set1_ps(box.min.y), qMaxY = _mm_set1_ps(box.max.y);
+            const __m128 qMinZ = _mm_set1_ps(box.min.z), qMaxZ = _mm_set1_ps(box.max.z);
+
+            uint32_t stack[BVH_STACK_SIZE];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            uint32_t found     = 0;
+
+            while (stackSize) {
+                const bvh_node4_t &node = bvh.nodes[stack[--stackSize]];
+                __m128 overlap = _mm_and_ps(
+                    _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minX), qMaxX), _mm_cmpge_ps(_mm_loadu_ps(node.maxX), qMinX)),
+                    _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minY), qMaxY), _mm_cmpge_ps(_mm_loadu_ps(node.maxY), qMinY)));
+                overlap = _mm_and_ps(overlap,
+                    _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(node.minZ), qMaxZ), _mm_cmpge_ps(_mm_loadu_ps(node.maxZ), qMinZ)));
+                int mask = _mm_movemask_ps(overlap);
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (!(mask & (1 << i))) continue;
+                    const uint32_t child = node.child[i];
+                    if (!(child & BVH_LEAF_BIT)) {
+                        assert(stackSize < BVH_STACK_SIZE);
+                        stack[stackSize++] = child;
+                        continue;
+                    }
+                    const uint32_t first = child & ~BVH_LEAF_BIT;
+                    for (uint32_t p = first; p < first + node.count[i]; p++) {
+                        bool bOverlap = true;
+                        if (bvh.triVerts) {
+                            bvh_bounds_t b = boundsEmpty();
+                            for (uint32_t k = 0; k < 3; k++) boundsGrowPoint(b, &bvh.triVerts[3 * p + k].x);
+                            bOverlap = b.min[0] <= box.max.x && b.max[0] >= box.min.x && b.min[1] <= box.max.y &&
+                                       b.max[1] >= box.min.y && b.min[2] <= box.max.z && b.max[2] >= box.min.z;
+                        } else {
+                            const aabb_t &b = bvh.primBoxes[p];
+                            bOverlap = b.min.x <= box.max.x && b.max.x >= box.min.x && b.min.y <= box.max.y &&
+                                       b.max.y >= box.min.y && b.min.z <= box.max.z && b.max.z >= box.min.z;
+                        }
+                        if (!bOverlap) continue;
+                        if (found < maxPrimsOut) primsOut[found] = bvh.primIndices[p];
+                        found++;
+                    }
+                }
+            }
+            return found;
+        }
+
+    }  // namespace math
+}  // namespace automata_engine
@@ -0,0 +1,186 @@
+#include <automata_engine.hpp>
+
+#include <immintrin.h>
+
+namespace automata_engine {
+    namespace math {
+
+        static vec4_t normalizePlane(vec4_t p)
+        {
+            float len = sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+            float inv = (len > 0.f) ? 1.f / len : 0.f;
+            return vec4_t(p.x * inv, p.y * inv, p.z * inv, p.w * inv);
+        }
+
+        frustum_t extractFrustum(mat4_t m, bool bZeroToOneDepth)
+        {
+            // NOTE(Noah): this is the Gribb/Hartmann method. clip = M * p, and p is inside when -w <= x <= w, etc.
+            // so each plane is a sum/difference of the rows of M. remember that our matrices are column-major, i.e.
+            // mat[col][row].
+            vec4_t row[4];
+            for (int r = 0; r < 4; r++) { row[r] = vec4_t(m.mat[0][r], m.mat[1][r], m.mat[2][r], m.mat[3][r]); }
+            auto add = [](vec4_t a, vec4_t b) { return vec4_t(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); };
+            auto sub = [](vec4_t a, vec4_t b) { return vec4_t(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); };
+
+            frustum_t f;
+            f.planes[0] = normalizePlane(add(row[3], row[0]));  // left
+            f.planes[1] = normalizePlane(sub(row[3], row[0]));  // right
+            f.planes[2] = normalizePlane(add(row[3], row[1]));  // bottom
+            f.planes[3] = normalizePlane(sub(row[3], row[1]));  // top
+            // for a [0,1] depth range the near plane is z >= 0 rather than z >= -w.
+            f.planes[4] = normalizePlane(bZeroToOneDepth ? row[2] : add(row[3], row[2]));  // near
+            f.planes[5] = normalizePlane(sub(row[3], row[2]));                             // far
+            return f;
+        }
+
+        frustum_t buildFrustum(camera_t cam, bool forVk)
+        {
+            mat4_t proj = forVk ? buildProjMatForVk(cam) : buildProjMat(cam);
+            return extractFrustum(proj * buildViewMat(cam), forVk);
+        }
+
+        // NOTE: the culling below works on 4 objects at a time. each plane is splatted across the lanes once,
+        // outside the loop, so the inner loop is just loads, mul-adds and compares.
+        struct frustum_simd_t {
+            __m128 nx[6], ny[6], nz[6], d[6];
+            __m128 absNx[6], absNy[6], absNz[6];
+        };
+
+        static frustum_simd_t splatFrustum(const frustum_t &f)
+        {
+            frustum_simd_t s;
+            for (uint32_t i = 0; i < 6; i++) {
+                s.nx[i]    = _mm_set1_ps(f.planes[i].x);
+                s.ny[i]    = _mm_set1_ps(f.planes[i].y);
+                s.nz[i]    = _mm_set1_ps(f.planes[i].z);
+                s.d[i]     = _mm_set1_ps(f.planes[i].w);
+                s.absNx[i] = _mm_set1_ps(abs(f.planes[i].x));
+                s.absNy[i] = _mm_set1_ps(abs(f.planes[i].y));
+                s.absNz[i] = _mm_set1_ps(abs(f.planes[i].z));
+            }
+            return s;
+        }
+
+        // a box is outside when its center is further behind a plane than its projected radius on the normal.
+        static inline int cullAabb4(const frustum_simd_t &f, __m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey,
+            __m128 ez)
+        {
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (uint32_t i = 0; i < 6; i++) {
+                __m128 dist =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(f.nx[i], cx), _mm_mul_ps(f.ny[i], cy)),
+                        _mm_add_ps(_mm_mul_ps(f.nz[i], cz), f.d[i]));
+                __m128 radius = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(f.absNx[i], ex), _mm_mul_ps(f.absNy[i], ey)), _mm_mul_ps(f.absNz[i], ez));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+            }
+            return _mm_movemask_ps(visible);
+        }
+
+        static inline int cullSphere4(const frustum_simd_t &f, __m128 cx, __m128 cy, __m128 cz, __m128 r)
+        {
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (uint32_t i = 0; i < 6; i++) {
+                __m128 dist =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(f.nx[i], cx), _mm_mul_ps(f.ny[i], cy)),
+                        _mm_add_ps(_mm_mul_ps(f.nz[i], cz), f.d[i]));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(dist, r), _mm_setzero_ps()));
+            }
+            return _mm_movemask_ps(visible);
+        }
+
+        // loads 4 floats starting at i. for the tail of the range, the missing lanes are padded with zero,
+        // and the caller masks off their result.
+        static inline __m128 load4(const float *p, uint32_t i, uint32_t end)
+        {
+            if (i + 4 <= end) return _mm_loadu_ps(p + i);
+            alignas(16) float tmp[4] = {};
+            for (uint32_t k = 0; i + k < end; k++) tmp[k] = p[i + k];
+            return _mm_load_ps(tmp);
+        }
+
+        static inline int aabbMask4(const frustum_simd_t &f, const aabb_soa_t &b, uint32_t i, uint32_t end)
+        {
+            return cullAabb4(f, load4(b.originX, i, end), load4(b.originY, i, end), load4(b.originZ, i, end),
+                load4(b.halfDimX, i, end), load4(b.halfDimY, i, end), load4(b.halfDimZ, i, end));
+        }
+
+        static inline int sphereMask4(const frustum_simd_t &f, const sphere_soa_t &s, uint32_t i, uint32_t end)
+        {
+            return cullSphere4(f, load4(s.centerX, i, end), load4(s.centerY, i, end), load4(s.centerZ, i, end),
+                load4(s.radius, i, end));
+        }
+
+        template <typename FN_mask4>
+        static void cullToBits(uint32_t begin, uint32_t end, uint32_t *visibleBitsOut, FN_mask4 mask4)
+        {
+            assert((begin & 31) == 0);
+            for (uint32_t word = begin; word < end; word += 32) {
+                uint32_t bits = 0;
+                for (uint32_t i = word; i < min(word + 32, end); i += 4) {
+                    uint32_t m = uint32_t(mask4(i));
+                    if (i + 4 > end) m &= (1u << (end - i)) - 1u;
+                    bits |= m << (i - word);
+                }
+                visibleBitsOut[word >> 5] = bits;
+            }
+        }
+
+        template <typename FN_mask4>
+        static uint32_t cullToIndices(uint32_t begin, uint32_t end, uint32_t *indicesOut, FN_mask4 mask4)
+        {
+            uint32_t written = 0;
+            for (uint32_t i = begin; i < end; i += 4) {
+                uint32_t m = uint32_t(mask4(i));
+                if (i + 4 > end) m &= (1u << (end - i)) - 1u;
+                // NOTE: write all four candidates unconditionally and only advance by the visible ones. this keeps
+                // the loop branch free, which matters since visibility is close to random from the CPU's view.
+                // it is why indicesOut must have room for the full range.
+                for (uint32_t k = 0; k < 4; k++) {
+                    if (written < end - begin) indicesOut[written] = i + k;
+                    written += (m >> k) & 1;
+                }
+            }
+            return written;
+        }
+
+        void frustumCullAabbs(
+            const frustum_t &frustum, const aabb_soa_t &boxes, uint32_t begin, uint32_t end, uint32_t *visibleBitsOut)
+        {
+            assert(end <= boxes.count);
+            const frustum_simd_t f = splatFrustum(frustum);
+            cullToBits(begin, end, visibleBitsOut, [&](uint32_t i) { return aabbMask4(f, boxes, i, end); });
+        }
+
+        uint32_t frustumCullAabbsCompact(
+            const frustum_t &frustum, const aabb_soa_t &boxes, uint32_t begin, uint32_t end, uint32_t *indicesOut)
+        {
+            assert(end <= boxes.count);
+            const frustum_simd_t f = splatFrustum(frustum);
+            return cullToIndices(begin, end, indicesOut, [&](uint32_t i) { return aabbMask4(f, boxes, i, end); });
+        }
+
+        void frustumCullSpheres(const frustum_t &frustum,
+            const sphere_soa_t                  &spheres,
+            uint32_t                             begin,
+            uint32_t                             end,
+            uint32_t                            *visibleBitsOut)
+        {
+            assert(end <= spheres.count);
+            const frustum_simd_t f = splatFrustum(frustum);
+            cullToBits(begin, end, visibleBitsOut, [&](uint32_t i) { return sphereMask4(f, spheres, i, end); });
+        }
+
+        uint32_t frustumCullSpheresCompact(const frustum_t &frustum,
+            const sphere_soa_t                         &spheres,
+            uint32_t                                    begin,
+            uint32_t                                    end,
+            uint32_t                                   *indicesOut)
+        {
+            assert(end <= spheres.count);
+            const frustum_simd_t f = splatFrustum(frustum);
+            return cullToIndices(begin, end, indicesOut, [&](uint32_t i) { return sphereMask4(f, spheres, i, end); });
+        }
+
+    }  // namespace math
+}  // namespace automata_engine
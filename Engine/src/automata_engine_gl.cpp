@@ -24,13 +24,16 @@ namespace automata_engine {
             vbo_t vbo,
             bool iterInstance
         ) : attribIndex(attribIndex), indices(nullptr), vbo(vbo), iterInstance(iterInstance) {
-            for (uint32_t i = 0; i < indices_list.size(); i++) {
-                StretchyBufferPush(indices, std::data(indices_list)[i]);
+            // NOTE(Noah): these go through va_args, so they have to stay plain data and the indices a stretchy buffer.
+            // but they can at least be sized in one go.
+            if (indices_list.size() > 0) {
+                StretchyBufferInitWithCount(indices, int(indices_list.size()));
+                memcpy(indices, std::data(indices_list), sizeof(uint32_t) * indices_list.size());
             }
         };
-        vertex_attrib_t::vertex_attrib_t(GLenum type, uint32_t count)
+        vertex_attrib_t::vertex_attrib_t(GLenum type, uint32_t count, bool normalized)
             :
-            type(type), count(count) {};
+            type(type), count(count), normalized(normalized) {};
         bool glewIsInit = false;
         static GLuint compileShader(uint32_t type, char *shader) {
             uint32_t id = glCreateShader(type);
@@ -63,7 +66,7 @@ namespace automata_engine {
         GLuint createComputeShader(const char *filePath) {
             uint32_t program;
             // Step 1: Setup our vertex and fragment GLSL shaders!
-            loaded_file_t f1 = ae::EM->pfn.readEntireFile(filePath);
+            loaded_file_t f1 = ae::vfs::readEntireFile(filePath);
             GL_CALL(program = glCreateProgram());
             uint32_t cs = compileShader(GL_COMPUTE_SHADER, (char *)f1.contents);
             auto findAndlogError = [=]() {
@@ -101,7 +104,7 @@ namespace automata_engine {
         createComputeShader_end:
             // Cleanup
             glDeleteShader(cs);
-            EM->pfn.freeLoadedFile(f1);
+            vfs::freeLoadedFile(f1);
             return program;
         }
 
@@ -111,8 +114,8 @@ namespace automata_engine {
         ) {
             uint32_t program;
             // Step 1: Setup our vertex and fragment GLSL shaders!
-            loaded_file_t f1 = ae::EM->pfn.readEntireFile(vertFilePath);
-            loaded_file_t f2 = ae::EM->pfn.readEntireFile(fragFilePath);
+            loaded_file_t f1 = ae::vfs::readEntireFile(vertFilePath);
+            loaded_file_t f2 = ae::vfs::readEntireFile(fragFilePath);
             GL_CALL(program = glCreateProgram());
             uint32_t vs = compileShader(GL_VERTEX_SHADER, (char *)f1.contents);
             uint32_t fs = compileShader(GL_FRAGMENT_SHADER, (char *)f2.contents);
@@ -129,8 +132,8 @@ namespace automata_engine {
                 AELoggerError("Program link or validation failure:\n%s", logMsg);
             };
             if (geoFilePath[0]) {
-                loaded_file_t f3 = ae::EM->pfn.readEntireFile(geoFilePath);
-                defer(ae::EM->pfn.freeLoadedFile(f3));
+                loaded_file_t f3 = ae::vfs::readEntireFile(geoFilePath);
+                defer(ae::vfs::freeLoadedFile(f3));
                 gs = compileShader(GL_GEOMETRY_SHADER, (char *)f3.contents);
                 if ((int)gs == -1) {
                     goto createShader_Fail;
@@ -166,8 +169,8 @@ namespace automata_engine {
             if (gs != -1) {
                 glDeleteShader(gs);
             }
-            ae::EM->pfn.freeLoadedFile(f1);
-            ae::EM->pfn.freeLoadedFile(f2);
+            ae::vfs::freeLoadedFile(f1);
+            ae::vfs::freeLoadedFile(f2);
             return program;
         }
         // TODO: Can we remove this? Maybe make it so that if using glew, the game decides so.
@@ -208,6 +211,75 @@ namespace automata_engine {
             return tex;
         }
 
+        uint32_t createTexturesFromFiles(
+            const char *const *filePaths, uint32_t count, GLuint *texturesOut, const char *cacheDir,
+            const io::mip_options_t *mipOptions, GLint minFilter, GLint magFilter, GLint wrap
+        ) {
+            mip_chain_t *chains = (mip_chain_t *)malloc(sizeof(mip_chain_t) * count);
+            ae::io::loadImages(filePaths, count, chains, cacheDir, mipOptions);
+            uint32_t created = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                texturesOut[i] = 0;
+                if (chains[i].pixels != nullptr) {
+                    texturesOut[i] = createTextureFromMipChain(chains[i], minFilter, magFilter, wrap);
+                    created++;
+                }
+                ae::io::freeMipChain(&chains[i]);
+            }
+            free(chains);
+            return created;
+        }
+
+        GLuint createTextureFromMipChain(const mip_chain_t &chain, GLint minFilter, GLint magFilter, GLint wrap) {
+            GLuint newTexture;
+            glGenTextures(1, &newTexture);
+            glBindTexture(GL_TEXTURE_2D, newTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(chain.levelCount - 1));
+            for (uint32_t level = 0; level < chain.levelCount; level++) {
+                GLsizei w = GLsizei(ae::math::max(chain.width >> level, 1u));
+                GLsizei h = GLsizei(ae::math::max(chain.height >> level, 1u));
+                glTexImage2D(GL_TEXTURE_2D, GLint(level), GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                    chain.pixels + chain.levelOffset[level]);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return newTexture;
+        }
+
+        static GLenum blockFormatToGLenum(io::block_format_t format) {
+            switch (format) {
+                case io::BLOCK_FORMAT_BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                case io::BLOCK_FORMAT_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case io::BLOCK_FORMAT_BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+            }
+            return GL_NONE;
+        }
+
+        GLuint createTextureFromCompressed(
+            const compressed_image_t &image, GLint minFilter, GLint magFilter, GLint wrap
+        ) {
+            GLuint newTexture;
+            glGenTextures(1, &newTexture);
+            glBindTexture(GL_TEXTURE_2D, newTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GLint(image.levelCount - 1));
+            for (uint32_t level = 0; level < image.levelCount; level++) {
+                GLsizei w = GLsizei(ae::math::max(image.width >> level, 1u));
+                GLsizei h = GLsizei(ae::math::max(image.height >> level, 1u));
+                size_t end = (level + 1 < image.levelCount) ? image.levelOffset[level + 1] : image.size;
+                glCompressedTexImage2D(GL_TEXTURE_2D, GLint(level), blockFormatToGLenum(image.format), w, h, 0,
+                    GLsizei(end - image.levelOffset[level]), (uint8_t *)image.blocks + image.levelOffset[level]);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return newTexture;
+        }
+
         GLuint createTexture(
             unsigned int *pixelPointer, unsigned int width, unsigned int height,
             GLint minFilter, GLint magFilter, bool generateMips, GLint wrap
@@ -318,7 +390,7 @@ namespace automata_engine {
                             uint32_t attribCount    = attrib.count - (w * 4);
                             uint32_t componentCount = (attribCount > 4) ? 4 : attribCount;
                             intptr_t ptr            = (intptr_t)offset + vbo_GetOffset(*pVbo, k);
-                            switch (attrib.type) {
+                            switch (attrib.normalized ? GL_FLOAT : attrib.type) {
                                 case GL_BYTE:
                                 case GL_UNSIGNED_BYTE:
                                 case GL_SHORT:
@@ -336,7 +408,7 @@ namespace automata_engine {
                                         componentCount,
                                         attrib.type,
                                         // NOTE: we are basically going to be making this a default - glfalse.
-                                        GL_FALSE,
+                                        attrib.normalized ? GL_TRUE : GL_FALSE,
                                         vbo_GetStride(*pVbo),
                                         (const void *)ptr);
                             }
@@ -365,6 +437,8 @@ namespace automata_engine {
             glGenBuffers(1, &iboOut->glHandle);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iboOut->glHandle);
             iboOut->count = StretchyBufferCount(rawModel.indexData);
+            // NOTE(Noah): set even though it is the default, since callers often keep the ibo_t in zeroed memory.
+            iboOut->type = GL_UNSIGNED_INT;
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, iboOut->count * sizeof(unsigned int),
                 rawModel.indexData, GL_STATIC_DRAW);
             // vbo def defines components
@@ -389,6 +463,62 @@ namespace automata_engine {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
             glBindBuffer(GL_ARRAY_BUFFER, 0);
         }
+
+        static vertex_attrib_t meshAttribToGl(const mesh_attrib_t &attrib) {
+            switch (attrib.format) {
+                case MESH_FORMAT_FLOAT16: return vertex_attrib_t(GL_HALF_FLOAT, attrib.componentCount);
+                case MESH_FORMAT_UNORM16: return vertex_attrib_t(GL_UNSIGNED_SHORT, attrib.componentCount, true);
+                case MESH_FORMAT_SNORM16: return vertex_attrib_t(GL_SHORT, attrib.componentCount, true);
+                case MESH_FORMAT_SNORM8: return vertex_attrib_t(GL_BYTE, attrib.componentCount, true);
+            }
+            return vertex_attrib_t(GL_FLOAT, attrib.componentCount);
+        }
+
+        void objToVao(const loaded_mesh_t &mesh, ibo_t *iboOut, vbo_t *vboOut, GLuint *vaoOut) {
+            assert(mesh.indexSize == sizeof(uint32_t) || mesh.indexSize == sizeof(uint16_t));
+            glGenBuffers(1, &iboOut->glHandle);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iboOut->glHandle);
+            iboOut->count = mesh.indexCount;
+            iboOut->type = (mesh.indexSize == sizeof(uint16_t)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            // the data goes straight from the mapped file to the driver.
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indexCount * mesh.indexSize, mesh.indexData, GL_STATIC_DRAW);
+            // vbo_t describes attributes as tightly packed and in order, and createAndSetupVao binds them to
+            // consecutive slots. so the layout must be the semantics in order, which is what writeMesh writes.
+            *vboOut = {};
+            glGenBuffers(1, &vboOut->glHandle);
+            vertex_attrib_desc_t desc = vertex_attrib_desc_t(0, {}, *vboOut, false /* per vertex */);
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < mesh.layout.attribCount; i++) {
+                const mesh_attrib_t &attrib = mesh.layout.attribs[i];
+                assert(attrib.semantic == i && attrib.offset == offset);
+                vertex_attrib_t glAttrib = meshAttribToGl(attrib);
+                StretchyBufferPush(vboOut->attribs, glAttrib);
+                StretchyBufferPush(desc.indices, i);
+                offset += GLenumToBytes(glAttrib.type) * glAttrib.count;
+            }
+            // the tail padding of the vertex goes in as an attribute that nothing binds.
+            if (offset < mesh.layout.stride) {
+                StretchyBufferPush(vboOut->attribs, vertex_attrib_t(GL_UNSIGNED_BYTE, mesh.layout.stride - offset));
+            }
+            desc.vbo = *vboOut;
+            *vaoOut = ae::GL::createAndSetupVao(1, desc);
+            glBindBuffer(GL_ARRAY_BUFFER, vboOut->glHandle);
+            glBufferData(GL_ARRAY_BUFFER, mesh.vertexCount * mesh.layout.stride, mesh.vertexData, GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        void positionStreamToVao(const loaded_mesh_t &mesh, const ibo_t &ibo, vbo_t *vboOut, GLuint *vaoOut) {
+            assert(mesh.positionData != nullptr && mesh.layout.attribs[0].semantic == MESH_ATTRIB_POSITION);
+            vertex_attrib_t glAttrib = meshAttribToGl(mesh.layout.attribs[0]);
+            assert(GLenumToBytes(glAttrib.type) * glAttrib.count == mesh.positionStride);
+            *vboOut = ae::GL::createAndSetupVbo(1, glAttrib);
+            *vaoOut = ae::GL::createAndSetupVao(1, vertex_attrib_desc_t(0, {0}, *vboOut, false /* per vertex */));
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo.glHandle);
+            glBindBuffer(GL_ARRAY_BUFFER, vboOut->glHandle);
+            glBufferData(GL_ARRAY_BUFFER, mesh.vertexCount * mesh.positionStride, mesh.positionData, GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
     }
 };
 
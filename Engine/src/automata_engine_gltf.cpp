@@ -0,0 +1,635 @@
+#include <automata_engine.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace automata_engine {
+    namespace io {
+
+        // ----------- [SECTION] JSON -----------
+        // NOTE(Noah): just enough JSON for the glTF chunk. the text is tokenized once, in order, into a flat array
+        // where each token knows the index of the token after all of its children. so a lookup is a walk over the
+        // direct children of an object, skipping the rest, and nothing is ever copied out of the text.
+        enum json_type_t : uint8_t { JSON_NULL = 0, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+        // @param start,length the text of the token. for a string, this is inside the quotes, escapes and all.
+        // @param childCount   elements for an array, keys and values for an object, i.e. twice the pairs.
+        struct json_token_t {
+            json_type_t type;
+            uint32_t    start;
+            uint32_t    length;
+            uint32_t    childCount;
+            uint32_t    next;
+        };
+
+        struct json_parser_t {
+            const char          *text;
+            uint32_t             size;
+            uint32_t             pos;
+            array<json_token_t> tokens;
+        };
+
+        static constexpr uint32_t JSON_MAX_DEPTH = 64;
+
+        static void jsonSkipSpace(json_parser_t *p)
+        {
+            while (p->pos < p->size &&
+                   (p->text[p->pos] == ' ' || p->text[p->pos] == '\t' || p->text[p->pos] == '\n' ||
+                       p->text[p->pos] == '\r')) {
+                p->pos++;
+            }
+        }
+
+        static bool jsonMatch(json_parser_t *p, const char *word)
+        {
+            size_t n = strlen(word);
+            if (p->size - p->pos < n || memcmp(p->text + p->pos, word, n) != 0) return false;
+            p->pos += uint32_t(n);
+            return true;
+        }
+
+        static inline bool jsonIsNumberChar(char c)
+        {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        static bool jsonParseValue(json_parser_t *p, uint32_t depth)
+        {
+            jsonSkipSpace(p);
+            if (p->pos >= p->size || depth > JSON_MAX_DEPTH) return false;
+            uint32_t     index = uint32_t(p->tokens.count);
+            json_token_t token = {};
+            token.start        = p->pos;
+            p->tokens.push(token);
+
+            char c = p->text[p->pos];
+            if (c == '{' || c == '[') {
+                char close = (c == '{') ? '}' : ']';
+                p->pos++;
+                uint32_t childCount = 0;
+                jsonSkipSpace(p);
+                if (p->pos < p->size && p->text[p->pos] == close) {
+                    p->pos++;
+                } else {
+                    for (;;) {
+                        if (c == '{') {
+                            jsonSkipSpace(p);
+                            if (p->pos >= p->size || p->text[p->pos] != '"') return false;
+                            if (!jsonParseValue(p, depth + 1)) return false;
+                            jsonSkipSpace(p);
+                            if (p->pos >= p->size || p->text[p->pos] != ':') return false;
+                            p->pos++;
+                            childCount++;
+                        }
+                        if (!jsonParseValue(p, depth + 1)) return false;
+                        childCount++;
+                        jsonSkipSpace(p);
+                        if (p->pos >= p->size) return false;
+                        if (p->text[p->pos] == close) {
+                            p->pos++;
+                            break;
+                        }
+                        if (p->text[p->pos] != ',') return false;
+                        p->pos++;
+                    }
+                }
+                p->tokens[index].type       = (c == '{') ? JSON_OBJECT : JSON_ARRAY;
+                p->tokens[index].childCount = childCount;
+            } else if (c == '"') {
+                p->pos++;
+                uint32_t start = p->pos;
+                while (p->pos < p->size && p->text[p->pos] != '"') p->pos += (p->text[p->pos] == '\\') ? 2 : 1;
+                if (p->pos >= p->size) return false;
+                p->tokens[index].type  = JSON_STRING;
+                p->tokens[index].start = start;
+                p->pos++;
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                while (p->pos < p->size && jsonIsNumberChar(p->text[p->pos])) p->pos++;
+                p->tokens[index].type = JSON_NUMBER;
+            } else if (jsonMatch(p, "true") || jsonMatch(p, "false")) {
+                p->tokens[index].type = JSON_BOOL;
+            } else if (jsonMatch(p, "null")) {
+                p->tokens[index].type = JSON_NULL;
+            } else {
+                return false;
+            }
+            if (p->tokens[index].type != JSON_STRING) p->tokens[index].length = p->pos - p->tokens[index].start;
+            else p->tokens[index].length = p->pos - 1 - p->tokens[index].start;
+            p->tokens[index].next = uint32_t(p->tokens.count);
+            return true;
+        }
+
+        // the value for key in the object at index, or UINT32_MAX.
+        static uint32_t jsonFind(const json_parser_t &p, uint32_t object, const char *key)
+        {
+            if (object == UINT32_MAX || p.tokens[object].type != JSON_OBJECT) return UINT32_MAX;
+            size_t   n = strlen(key);
+            uint32_t t = object + 1;
+            for (uint32_t i = 0; i < p.tokens[object].childCount; i += 2) {
+                const json_token_t &k = p.tokens[t];
+                if (k.length == n && memcmp(p.text + k.start, key, n) == 0) return k.next;
+                t = p.tokens[k.next].next;
+            }
+            return UINT32_MAX;
+        }
+
+        // the element at i of the array at index, or UINT32_MAX.
+        static uint32_t jsonAt(const json_parser_t &p, uint32_t array, uint32_t i)
+        {
+            if (array == UINT32_MAX || p.tokens[array].type != JSON_ARRAY || i >= p.tokens[array].childCount) {
+                return UINT32_MAX;
+            }
+            uint32_t t = array + 1;
+            while (i--) t = p.tokens[t].next;
+            return t;
+        }
+
+        static uint32_t jsonCount(const json_parser_t &p, uint32_t array)
+        {
+            return (array != UINT32_MAX && p.tokens[array].type == JSON_ARRAY) ? p.tokens[array].childCount : 0;
+        }
+
+        // every element of an array, for the large arrays that are looked up by index, where jsonAt would be
+        // quadratic.
+        static array<uint32_t> jsonElements(const json_parser_t &p, uint32_t list)
+        {
+            array<uint32_t> elements;
+            elements.reserve(jsonCount(p, list));
+            for (uint32_t i = 0, t = list + 1; i < jsonCount(p, list); i++, t = p.tokens[t].next) elements.push(t);
+            return elements;
+        }
+
+        static double jsonNumber(const json_parser_t &p, uint32_t index, double fallback)
+        {
+            if (index == UINT32_MAX || p.tokens[index].type != JSON_NUMBER || p.tokens[index].length >= 64) {
+                return fallback;
+            }
+            char buffer[64];
+            memcpy(buffer, p.text + p.tokens[index].start, p.tokens[index].length);
+            buffer[p.tokens[index].length] = 0;
+            return strtod(buffer, nullptr);
+        }
+
+        static int64_t jsonInt(const json_parser_t &p, uint32_t index, int64_t fallback)
+        {
+            // NOTE(Noah): nearly every number in glTF is a plain index or count, which skip strtod.
+            if (index != UINT32_MAX && p.tokens[index].type == JSON_NUMBER && p.tokens[index].length <= 15) {
+                const char *text   = p.text + p.tokens[index].start;
+                bool        bMinus = text[0] == '-';
+                int64_t     v      = 0;
+                uint32_t    i      = bMinus ? 1 : 0;
+                for (; i < p.tokens[index].length && text[i] >= '0' && text[i] <= '9'; i++)
+                    v = v * 10 + (text[i] - '0');
+                if (i == p.tokens[index].length && i > uint32_t(bMinus)) return bMinus ? -v : v;
+            }
+            double v = jsonNumber(p, index, double(fallback));
+            return (v >= -9e15 && v <= 9e15) ? int64_t(v) : fallback;
+        }
+
+        static bool jsonIsString(const json_parser_t &p, uint32_t index, const char *value)
+        {
+            return index != UINT32_MAX && p.tokens[index].type == JSON_STRING &&
+                   p.tokens[index].length == strlen(value) &&
+                   memcmp(p.text + p.tokens[index].start, value, p.tokens[index].length) == 0;
+        }
+
+        static bool jsonIsTrue(const json_parser_t &p, uint32_t index)
+        {
+            return index != UINT32_MAX && p.tokens[index].type == JSON_BOOL && p.text[p.tokens[index].start] == 't';
+        }
+
+        // ----------- [SECTION] glTF -----------
+        static constexpr uint32_t GLB_MAGIC      = 0x46546C67;  // "glTF"
+        static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+        static constexpr uint32_t GLB_CHUNK_BIN  = 0x004E4942;  // "BIN\0"
+
+        static uint32_t gltfComponentSize(uint32_t componentType)
+        {
+            switch (componentType) {
+                case GLTF_BYTE:
+                case GLTF_UNSIGNED_BYTE:
+                    return 1;
+                case GLTF_SHORT:
+                case GLTF_UNSIGNED_SHORT:
+                    return 2;
+                case GLTF_UNSIGNED_INT:
+                case GLTF_FLOAT:
+                    return 4;
+            }
+            return 0;
+        }
+
+        static uint32_t gltfComponentCount(const json_parser_t &p, uint32_t type)
+        {
+            const char *names[]  = {"SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4"};
+            const uint32_t counts[] = {1, 2, 3, 4, 4, 9, 16};
+            for (uint32_t i = 0; i < 7; i++) {
+                if (jsonIsString(p, type, names[i])) return counts[i];
+            }
+            return 0;
+        }
+
+        // NOTE(Noah): every accessor is checked against its buffer view, and every view against the binary chunk,
+        // so that no span can reach past the file. accessors that cannot be read in place are left empty: sparse
+        // ones, ones with no buffer view, and ones in a buffer other than the binary chunk.
+        static gltf_accessor_t gltfParseAccessor(const json_parser_t &p, uint32_t accessor, const uint32_t *views,
+            uint32_t viewCount, const uint8_t *binary, size_t binarySize)
+        {
+            gltf_accessor_t out       = {};
+            int64_t         viewIndex = jsonInt(p, jsonFind(p, accessor, "bufferView"), -1);
+            uint32_t view = (viewIndex >= 0 && viewIndex < int64_t(viewCount)) ? views[viewIndex] : UINT32_MAX;
+            uint32_t componentType  = uint32_t(jsonInt(p, jsonFind(p, accessor, "componentType"), 0));
+            uint32_t componentCount = gltfComponentCount(p, jsonFind(p, accessor, "type"));
+            int64_t  count          = jsonInt(p, jsonFind(p, accessor, "count"), 0);
+            uint32_t elementSize    = gltfComponentSize(componentType) * componentCount;
+            if (view == UINT32_MAX || elementSize == 0 || count <= 0 || count > UINT32_MAX ||
+                jsonFind(p, accessor, "sparse") != UINT32_MAX || jsonInt(p, jsonFind(p, view, "buffer"), 0) != 0) {
+                return out;
+            }
+            int64_t viewOffset = jsonInt(p, jsonFind(p, view, "byteOffset"), 0);
+            int64_t viewLength = jsonInt(p, jsonFind(p, view, "byteLength"), -1);
+            int64_t stride     = jsonInt(p, jsonFind(p, view, "byteStride"), 0);
+            int64_t offset     = jsonInt(p, jsonFind(p, accessor, "byteOffset"), 0);
+            if (stride == 0) stride = elementSize;
+            if (viewOffset < 0 || viewLength < 0 || uint64_t(viewOffset + viewLength) > binarySize || offset < 0 ||
+                stride < elementSize || stride > 255 || offset + (count - 1) * stride + elementSize > viewLength) {
+                return out;
+            }
+            out.data           = binary + viewOffset + offset;
+            out.count          = uint32_t(count);
+            out.stride         = uint32_t(stride);
+            out.componentType  = uint16_t(componentType);
+            out.componentCount = uint8_t(componentCount);
+            out.bNormalized    = jsonIsTrue(p, jsonFind(p, accessor, "normalized"));
+            return out;
+        }
+
+        static void gltfMatMul(const float a[16], const float b[16], float out[16])
+        {
+            float r[16];
+            for (uint32_t c = 0; c < 4; c++) {
+                for (uint32_t row = 0; row < 4; row++) {
+                    r[c * 4 + row] = 0.0f;
+                    for (uint32_t k = 0; k < 4; k++) r[c * 4 + row] += a[k * 4 + row] * b[c * 4 + k];
+                }
+            }
+            memcpy(out, r, sizeof(r));
+        }
+
+        // the local matrix of a node, column-major as glTF has it, from matrix or from translation, rotation and
+        // scale.
+        static void gltfNodeMatrix(const json_parser_t &p, uint32_t node, float out[16])
+        {
+            uint32_t matrix = jsonFind(p, node, "matrix");
+            if (jsonCount(p, matrix) == 16) {
+                for (uint32_t i = 0; i < 16; i++) out[i] = float(jsonNumber(p, jsonAt(p, matrix, i), 0.0));
+                return;
+            }
+            float    t[3] = {0, 0, 0}, q[4] = {0, 0, 0, 1}, s[3] = {1, 1, 1};
+            uint32_t translation = jsonFind(p, node, "translation"), rotation = jsonFind(p, node, "rotation");
+            uint32_t scale = jsonFind(p, node, "scale");
+            for (uint32_t i = 0; i < 3; i++) t[i] = float(jsonNumber(p, jsonAt(p, translation, i), t[i]));
+            for (uint32_t i = 0; i < 4; i++) q[i] = float(jsonNumber(p, jsonAt(p, rotation, i), q[i]));
+            for (uint32_t i = 0; i < 3; i++) s[i] = float(jsonNumber(p, jsonAt(p, scale, i), s[i]));
+            float x = q[0], y = q[1], z = q[2], w = q[3];
+            float rm[9] = {1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w), 2 * (x * y - z * w),
+                1 - 2 * (x * x + z * z), 2 * (y * z + x * w), 2 * (x * z + y * w), 2 * (y * z - x * w),
+                1 - 2 * (x * x + y * y)};
+            for (uint32_t c = 0; c < 3; c++) {
+                for (uint32_t row = 0; row < 3; row++) out[c * 4 + row] = rm[c * 3 + row] * s[c];
+                out[c * 4 + 3] = 0.0f;
+            }
+            out[12] = t[0], out[13] = t[1], out[14] = t[2], out[15] = 1.0f;
+        }
+
+        bool loadGlbFromMemory(const void *data, size_t size, gltf_model_t *out)
+        {
+            *out = {};
+            const uint8_t *bytes = (const uint8_t *)data;
+            uint32_t       header[5];
+            if (data == nullptr || size < sizeof(header)) return false;
+            memcpy(header, bytes, sizeof(header));
+            if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > size || header[2] < sizeof(header) ||
+                header[3] > header[2] - sizeof(header) || header[4] != GLB_CHUNK_JSON) {
+                return false;
+            }
+            size = header[2];
+            json_parser_t p = {};
+            p.text          = (const char *)bytes + 20;
+            p.size          = header[3];
+
+            const uint8_t *binary     = nullptr;
+            size_t         binarySize = 0;
+            size_t         binChunk   = 20 + ((size_t(header[3]) + 3) & ~size_t(3));
+            if (binChunk + 8 <= size) {
+                uint32_t chunk[2];
+                memcpy(chunk, bytes + binChunk, sizeof(chunk));
+                if (chunk[1] == GLB_CHUNK_BIN && chunk[0] <= size - binChunk - 8) {
+                    binary     = bytes + binChunk + 8;
+                    binarySize = chunk[0];
+                }
+            }
+
+            // glTF JSON runs to about one token for every 8 bytes, so this is usually the only allocation.
+            p.tokens.reserve(p.size / 8 + 16);
+            if (!jsonParseValue(&p, 0) || p.tokens[0].type != JSON_OBJECT) return false;
+            array<uint32_t> views      = jsonElements(p, jsonFind(p, 0, "bufferViews"));
+            array<uint32_t> accessors  = jsonElements(p, jsonFind(p, 0, "accessors"));
+            array<uint32_t> meshes     = jsonElements(p, jsonFind(p, 0, "meshes"));
+            array<uint32_t> nodes      = jsonElements(p, jsonFind(p, 0, "nodes"));
+            uint32_t scene = jsonAt(p, jsonFind(p, 0, "scenes"), uint32_t(jsonInt(p, jsonFind(p, 0, "scene"), 0)));
+            uint32_t sceneNodes = jsonFind(p, scene, "nodes");
+
+            // NOTE(Noah): everything but the spans goes in one block, which is sized up front.
+            out->accessorCount  = uint32_t(accessors.count);
+            out->meshCount      = uint32_t(meshes.count);
+            out->nodeCount      = uint32_t(nodes.count);
+            out->rootCount      = jsonCount(p, sceneNodes);
+            uint32_t childCount = 0;
+            for (uint32_t i = 0; i < out->meshCount; i++) {
+                out->primitiveCount += jsonCount(p, jsonFind(p, meshes[i], "primitives"));
+            }
+            for (uint32_t i = 0; i < out->nodeCount; i++) childCount += jsonCount(p, jsonFind(p, nodes[i], "children"));
+            size_t blockSize = sizeof(gltf_accessor_t) * out->accessorCount + sizeof(gltf_mesh_t) * out->meshCount +
+                               sizeof(gltf_primitive_t) * out->primitiveCount + sizeof(gltf_node_t) * out->nodeCount +
+                               sizeof(uint32_t) * (childCount + out->rootCount);
+            out->block = calloc(1, blockSize ? blockSize : 1);
+            if (out->block != nullptr) {
+                uint8_t *cursor = (uint8_t *)out->block;
+                auto     carve  = [&](size_t bytes) {
+                    void *result = cursor;
+                    cursor += bytes;
+                    return result;
+                };
+                out->accessors  = (gltf_accessor_t *)carve(sizeof(gltf_accessor_t) * out->accessorCount);
+                out->meshes     = (gltf_mesh_t *)carve(sizeof(gltf_mesh_t) * out->meshCount);
+                out->primitives = (gltf_primitive_t *)carve(sizeof(gltf_primitive_t) * out->primitiveCount);
+                out->nodes      = (gltf_node_t *)carve(sizeof(gltf_node_t) * out->nodeCount);
+                out->children   = (uint32_t *)carve(sizeof(uint32_t) * childCount);
+                out->roots      = (uint32_t *)carve(sizeof(uint32_t) * out->rootCount);
+                out->binary     = binary;
+                out->binarySize = binarySize;
+
+                for (uint32_t i = 0; i < out->accessorCount; i++) {
+                    out->accessors[i] = gltfParseAccessor(
+                        p, accessors[i], views.data, uint32_t(views.count), binary, binarySize);
+                }
+                auto accessorAt = [&](uint32_t index) {
+                    int64_t i = jsonInt(p, index, -1);
+                    return (i >= 0 && i < int64_t(out->accessorCount)) ? out->accessors[i] : gltf_accessor_t{};
+                };
+
+                uint32_t primitive = 0;
+                for (uint32_t i = 0; i < out->meshCount; i++) {
+                    uint32_t     primitives = jsonFind(p, meshes[i], "primitives");
+                    uint32_t     name       = jsonFind(p, meshes[i], "name");
+                    gltf_mesh_t &m          = out->meshes[i];
+                    if (name != UINT32_MAX && p.tokens[name].type == JSON_STRING) {
+                        memcpy(m.name, p.text + p.tokens[name].start, math::min(p.tokens[name].length, 31u));
+                    }
+                    m.firstPrimitive = primitive;
+                    m.primitiveCount = jsonCount(p, primitives);
+                    for (uint32_t j = 0, t = primitives + 1; j < m.primitiveCount; j++, t = p.tokens[t].next) {
+                        uint32_t          attributes = jsonFind(p, t, "attributes");
+                        gltf_primitive_t &dst        = out->primitives[primitive++];
+                        dst.position                 = accessorAt(jsonFind(p, attributes, "POSITION"));
+                        dst.normal                   = accessorAt(jsonFind(p, attributes, "NORMAL"));
+                        dst.uv                       = accessorAt(jsonFind(p, attributes, "TEXCOORD_0"));
+                        dst.indices                  = accessorAt(jsonFind(p, t, "indices"));
+                        dst.material                 = int32_t(jsonInt(p, jsonFind(p, t, "material"), -1));
+                        dst.mode = uint32_t(jsonInt(p, jsonFind(p, t, "mode"), GLTF_MODE_TRIANGLES));
+                    }
+                }
+
+                // NOTE(Noah): glTF asks that nodes form a forest. a node with two parents would be walked once per
+                // path to it when converting, which a small file could make exponential, so it is rejected here.
+                bool           bForest    = true;
+                array<uint8_t> bHasParent;
+                bHasParent.resize(out->nodeCount);
+                uint32_t child = 0;
+                for (uint32_t i = 0; i < out->nodeCount; i++) {
+                    uint32_t     children = jsonFind(p, nodes[i], "children");
+                    gltf_node_t &n        = out->nodes[i];
+                    int64_t      mesh     = jsonInt(p, jsonFind(p, nodes[i], "mesh"), -1);
+                    n.mesh                = (mesh >= 0 && mesh < int64_t(out->meshCount)) ? int32_t(mesh) : -1;
+                    gltfNodeMatrix(p, nodes[i], n.matrix);
+                    n.firstChild = child;
+                    for (uint32_t j = 0, t = children + 1; j < jsonCount(p, children); j++, t = p.tokens[t].next) {
+                        int64_t c = jsonInt(p, t, -1);
+                        if (c < 0 || c >= int64_t(out->nodeCount)) continue;
+                        bForest = bForest && !bHasParent[uint32_t(c)];
+                        bHasParent[uint32_t(c)] = 1;
+                        out->children[child++]  = uint32_t(c);
+                    }
+                    n.childCount = child - n.firstChild;
+                }
+                uint32_t rootCount = 0;
+                for (uint32_t i = 0, t = sceneNodes + 1; i < out->rootCount; i++, t = p.tokens[t].next) {
+                    int64_t r = jsonInt(p, t, -1);
+                    if (r >= 0 && r < int64_t(out->nodeCount)) out->roots[rootCount++] = uint32_t(r);
+                }
+                out->rootCount = rootCount;
+                if (!bForest) {
+                    free(out->block);
+                    *out = {};
+                    return false;
+                }
+            } else {
+                *out = {};
+            }
+            return out->block != nullptr;
+        }
+
+        gltf_model_t loadGlb(const char *filePath)
+        {
+            gltf_model_t  model = {};
+            loaded_file_t file  = vfs::mapEntireFile(filePath);
+            if (file.contents == nullptr) {
+                AELoggerError("could not load %s", filePath);
+                return model;
+            }
+            if (!loadGlbFromMemory(file.contents, size_t(file.contentSize), &model)) {
+                AELoggerError("%s is not a valid .glb", filePath);
+                vfs::unmapFile(file);
+                return model;
+            }
+            model.parentFile = file;
+            return model;
+        }
+
+        void freeGlb(gltf_model_t *model)
+        {
+            free(model->block);
+            if (model->parentFile.contents) vfs::unmapFile(model->parentFile);
+            *model = {};
+        }
+
+        // ----------- [SECTION] Conversion -----------
+
+        // NOTE(Noah): nothing makes a file keep its byteOffset and byteStride aligned, so components are read with
+        // memcpy rather than through a cast pointer.
+        template <typename T> static T gltfReadComponent(const uint8_t *element, uint32_t c)
+        {
+            T result;
+            memcpy(&result, element + size_t(c) * sizeof(T), sizeof(T));
+            return result;
+        }
+
+        uint32_t readAccessorFloats(const gltf_accessor_t &accessor, float *out, uint32_t componentCount)
+        {
+            uint32_t n = math::min(componentCount, uint32_t(accessor.componentCount));
+            for (uint32_t i = 0; i < accessor.count; i++) {
+                const uint8_t *element = accessor.data + size_t(i) * accessor.stride;
+                float         *dst     = out + size_t(i) * componentCount;
+                if (accessor.componentType == GLTF_FLOAT) {
+                    memcpy(dst, element, n * sizeof(float));
+                } else {
+                    for (uint32_t c = 0; c < n; c++) {
+                        float v = 0.0f, scale = 1.0f;
+                        switch (accessor.componentType) {
+                            case GLTF_BYTE:
+                                v = float(((const int8_t *)element)[c]), scale = 127.0f;
+                                break;
+                            case GLTF_UNSIGNED_BYTE:
+                                v = float(element[c]), scale = 255.0f;
+                                break;
+                            case GLTF_SHORT:
+                                v = float(gltfReadComponent<int16_t>(element, c)), scale = 32767.0f;
+                                break;
+                            case GLTF_UNSIGNED_SHORT:
+                                v = float(gltfReadComponent<uint16_t>(element, c)), scale = 65535.0f;
+                                break;
+                            case GLTF_UNSIGNED_INT:
+                                v = float(gltfReadComponent<uint32_t>(element, c));
+                                break;
+                        }
+                        dst[c] = accessor.bNormalized ? math::max(v / scale, -1.0f) : v;
+                    }
+                }
+                for (uint32_t c = n; c < componentCount; c++) dst[c] = 0.0f;
+            }
+            return accessor.count;
+        }
+
+        uint32_t readAccessorIndices(const gltf_accessor_t &accessor, uint32_t *out)
+        {
+            if (accessor.componentCount != 1) return 0;
+            for (uint32_t i = 0; i < accessor.count; i++) {
+                const uint8_t *element = accessor.data + size_t(i) * accessor.stride;
+                switch (accessor.componentType) {
+                    case GLTF_UNSIGNED_BYTE:
+                        out[i] = *element;
+                        break;
+                    case GLTF_UNSIGNED_SHORT:
+                        out[i] = gltfReadComponent<uint16_t>(element, 0);
+                        break;
+                    case GLTF_UNSIGNED_INT:
+                        out[i] = gltfReadComponent<uint32_t>(element, 0);
+                        break;
+                    default:
+                        return 0;
+                }
+            }
+            return accessor.count;
+        }
+
+        // appends a primitive to the model, with positions and normals in world space.
+        static void gltfAppendPrimitive(const gltf_primitive_t &primitive, const float world[16], raw_model_t *model)
+        {
+            uint32_t vertexCount = primitive.position.count;
+            if (primitive.mode != GLTF_MODE_TRIANGLES || vertexCount == 0 || primitive.position.componentCount != 3) {
+                return;
+            }
+            uint32_t base      = StretchyBufferCount(model->vertexData) / 8;
+            float   *positions = (float *)malloc(sizeof(float) * 8 * vertexCount);
+            float   *normals   = positions + 3 * size_t(vertexCount);
+            float   *uvs       = normals + 3 * size_t(vertexCount);
+            readAccessorFloats(primitive.position, positions, 3);
+            bool bNormals = primitive.normal.count == vertexCount;
+            bool bUvs     = primitive.uv.count == vertexCount;
+            if (bNormals) readAccessorFloats(primitive.normal, normals, 3);
+            if (bUvs) readAccessorFloats(primitive.uv, uvs, 2);
+
+            // NOTE(Noah): normals go through the inverse transpose of the upper 3x3, which is its cofactor matrix up
+            // to scale, and the scale is normalized away.
+            const float *m = world;
+            float cof[9] = {m[5] * m[10] - m[6] * m[9], m[6] * m[8] - m[4] * m[10], m[4] * m[9] - m[5] * m[8],
+                m[2] * m[9] - m[1] * m[10], m[0] * m[10] - m[2] * m[8], m[1] * m[8] - m[0] * m[9],
+                m[1] * m[6] - m[2] * m[5], m[2] * m[4] - m[0] * m[6], m[0] * m[5] - m[1] * m[4]};
+            uint32_t first = StretchyBufferCount(model->vertexData);
+            // NOTE(Noah): StretchyBuffer_Grow always doubles, so each primitive only grows the buffers if it must.
+            StretchyBuffer_MaybeGrow(model->vertexData, vertexCount * 8);
+            StretchyBuffer_GetCount(model->vertexData) = int(first + vertexCount * 8);
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                const float *p = positions + 3 * size_t(i);
+                float       *v = model->vertexData + first + 8 * size_t(i);
+                for (uint32_t r = 0; r < 3; r++) v[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+                // glTF puts the UV origin at the top left, and the engine at the bottom left like the images.
+                v[3] = bUvs ? uvs[2 * size_t(i)] : 0.0f;
+                v[4] = bUvs ? 1.0f - uvs[2 * size_t(i) + 1] : 0.0f;
+                v[5] = v[6] = v[7] = 0.0f;
+                if (bNormals) {
+                    const float *n = normals + 3 * size_t(i);
+                    float        length = 0.0f;
+                    for (uint32_t r = 0; r < 3; r++) {
+                        v[5 + r] = cof[r] * n[0] + cof[3 + r] * n[1] + cof[6 + r] * n[2];
+                        length += v[5 + r] * v[5 + r];
+                    }
+                    length = (length > 0.0f) ? 1.0f / sqrtf(length) : 0.0f;
+                    for (uint32_t r = 0; r < 3; r++) v[5 + r] *= length;
+                }
+            }
+            free(positions);
+
+            if (primitive.indices.count > 0) {
+                first = StretchyBufferCount(model->indexData);
+                StretchyBuffer_MaybeGrow(model->indexData, primitive.indices.count);
+                uint32_t count = readAccessorIndices(primitive.indices, model->indexData + first);
+                for (uint32_t i = 0; i < count; i++) {
+                    uint32_t index              = model->indexData[first + i];
+                    model->indexData[first + i] = base + ((index < vertexCount) ? index : 0);
+                }
+                StretchyBuffer_GetCount(model->indexData) = int(first + count);
+            } else {
+                for (uint32_t i = 0; i < vertexCount; i++) StretchyBufferPush(model->indexData, base + i);
+            }
+        }
+
+        static void gltfAppendNode(
+            const gltf_model_t &gltf, uint32_t node, const float parent[16], uint32_t depth, raw_model_t *model)
+        {
+            // loading makes sure no node has two parents, but a bad file could still loop.
+            if (depth > 256) return;
+            const gltf_node_t &n = gltf.nodes[node];
+            float              world[16];
+            gltfMatMul(parent, n.matrix, world);
+            if (n.mesh >= 0) {
+                const gltf_mesh_t &mesh = gltf.meshes[n.mesh];
+                for (uint32_t i = 0; i < mesh.primitiveCount; i++) {
+                    gltfAppendPrimitive(gltf.primitives[mesh.firstPrimitive + i], world, model);
+                }
+            }
+            for (uint32_t i = 0; i < n.childCount; i++) {
+                gltfAppendNode(gltf, gltf.children[n.firstChild + i], world, depth + 1, model);
+            }
+        }
+
+        raw_model_t glbToRawModel(const gltf_model_t &gltf)
+        {
+            raw_model_t model       = {};
+            const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+            if (gltf.meshCount > 0) memcpy(model.modelName, gltf.meshes[0].name, sizeof(model.modelName) - 1);
+            if (gltf.rootCount > 0) {
+                for (uint32_t i = 0; i < gltf.rootCount; i++) gltfAppendNode(gltf, gltf.roots[i], identity, 0, &model);
+            } else {
+                // a file with no scene is just a library of meshes.
+                for (uint32_t i = 0; i < gltf.primitiveCount; i++) {
+                    gltfAppendPrimitive(gltf.primitives[i], identity, &model);
+                }
+            }
+            return model;
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
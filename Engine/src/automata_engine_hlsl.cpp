@@ -38,12 +38,12 @@ namespace automata_engine {
             const char *filePathIn, const WCHAR *entryPoint, const WCHAR *profile, IDxcBlob **blobOut, bool emitSpirv)
         {
             // load from disk.
-            loaded_file_t lf = ae::EM->pfn.readEntireFile(filePathIn);
+            loaded_file_t lf = ae::vfs::readEntireFile(filePathIn);
             if (!lf.contents) {
                 AELoggerError("unable to read file: %s", filePathIn);
                 return false;
             }
-            defer(ae::EM->pfn.freeLoadedFile(lf));
+            defer(ae::vfs::freeLoadedFile(lf));
 
             const char *srcCode = (const char *)lf.contents;
 
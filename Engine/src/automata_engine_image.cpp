@@ -0,0 +1,517 @@
+#include <automata_engine.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <immintrin.h>
+
+// NOTE(Noah): stb_image is compiled in automata_engine.cpp, which comes before this file in the amalgamation, so
+// its declarations are already here.
+
+namespace automata_engine {
+    namespace io {
+
+        // ----------- [SECTION] Mip chains -----------
+        // NOTE(Noah): a chain is one block of memory: the levels in order, and then an image_cache_footer_t. that is
+        // exactly what a file in the decoded image cache holds, so a miss writes the block out as is, and a hit maps
+        // the file and uses it without a copy.
+        static constexpr uint32_t IMAGE_CACHE_MAGIC   = 0x58544541;  // "AETX"
+        static constexpr uint32_t IMAGE_CACHE_VERSION = 2;
+
+        struct image_cache_footer_t {
+            uint64_t contentHash;
+            uint32_t width;
+            uint32_t height;
+            uint32_t levelCount;
+            uint32_t version;
+            uint32_t options;  // mipOptionsKey of the options that the mips were made with.
+            uint32_t magic;
+        };
+        static_assert(sizeof(image_cache_footer_t) == 32, "the cache footer is part of the file format");
+
+        static uint32_t mipOptionsKey(const mip_options_t &options)
+        {
+            return uint32_t(options.filter) | (options.bSrgb ? 0x100 : 0) | (options.bPremultiplyAlpha ? 0x200 : 0);
+        }
+
+        // fills in levelCount and levelOffset for width and height.
+        // @returns the pixel count of the whole chain.
+        static size_t mipChainLayout(mip_chain_t *chain)
+        {
+            uint32_t w     = chain->width, h = chain->height;
+            size_t   total = 0;
+            chain->levelCount = 0;
+            for (;;) {
+                chain->levelOffset[chain->levelCount++] = uint32_t(total);
+                total += size_t(w) * h;
+                if (w == 1 && h == 1) break;
+                w = (w > 1) ? w / 2 : 1;
+                h = (h > 1) ? h / 2 : 1;
+            }
+            return total;
+        }
+
+        static size_t mipChainBytes(const mip_chain_t &chain)
+        {
+            size_t last = chain.levelOffset[chain.levelCount - 1] + 1;  // the last level is always 1x1.
+            return last * sizeof(uint32_t) + sizeof(image_cache_footer_t);
+        }
+
+        // ----------- [SECTION] Mip generation -----------
+        // NOTE(Noah): there are two paths. the default options are a box filter over the bytes as they are, which is
+        // done on the bytes, 4 pixels at a time. anything else (sRGB, premultiplied alpha, or a windowed filter) is
+        // done on float RGBA, one pixel to a __m128. each of those levels is made from the float level before it, not
+        // from its bytes, so rounding does not build up down the chain.
+
+        // each destination pixel is the rounded average of a 2x2 block. a side of 1 is clamped to, which is the only
+        // time that the block can fall off of the edge, as an odd side of 2n + 1 halves to n.
+        static void mipBoxBytes(const uint32_t *src, uint32_t srcWidth, uint32_t srcHeight, uint32_t *dst,
+            uint32_t dstWidth, uint32_t dstHeight)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i bias = _mm_set1_epi16(2);
+            for (uint32_t y = 0; y < dstHeight; y++) {
+                const uint32_t *row0 = src + size_t(math::min(2 * y, srcHeight - 1)) * srcWidth;
+                const uint32_t *row1 = src + size_t(math::min(2 * y + 1, srcHeight - 1)) * srcWidth;
+                uint32_t       *out  = dst + size_t(y) * dstWidth;
+                uint32_t        x    = 0;
+                if (srcWidth > 1) {
+                    for (; x + 4 <= dstWidth; x += 4) {
+                        __m128i a0 = _mm_loadu_si128((const __m128i *)(row0 + 2 * x));
+                        __m128i a1 = _mm_loadu_si128((const __m128i *)(row0 + 2 * x + 4));
+                        __m128i b0 = _mm_loadu_si128((const __m128i *)(row1 + 2 * x));
+                        __m128i b1 = _mm_loadu_si128((const __m128i *)(row1 + 2 * x + 4));
+                        // the two rows summed for each of the 8 source pixels, two pixels to a register.
+                        __m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                        __m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                        __m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                        __m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+                        // then each pair of columns.
+                        __m128i d01 = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+                        __m128i d23 = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+                        d01         = _mm_srli_epi16(_mm_add_epi16(d01, bias), 2);
+                        d23         = _mm_srli_epi16(_mm_add_epi16(d23, bias), 2);
+                        _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(d01, d23));
+                    }
+                }
+                for (; x < dstWidth; x++) {
+                    uint32_t x0 = math::min(2 * x, srcWidth - 1), x1 = math::min(2 * x + 1, srcWidth - 1);
+                    uint32_t a = row0[x0], b = row0[x1], c = row1[x0], d = row1[x1];
+                    // red/blue and green/alpha two at a time, in 16-bit halves where 4 bytes and the bias fit.
+                    uint32_t rb = (a & 0xFF00FF) + (b & 0xFF00FF) + (c & 0xFF00FF) + (d & 0xFF00FF) + 0x00020002;
+                    uint32_t ga = ((a >> 8) & 0xFF00FF) + ((b >> 8) & 0xFF00FF) + ((c >> 8) & 0xFF00FF) +
+                                  ((d >> 8) & 0xFF00FF) + 0x00020002;
+                    out[x] = ((rb >> 2) & 0x00FF00FF) | (((ga >> 2) & 0x00FF00FF) << 8);
+                }
+            }
+        }
+
+        // NOTE(Noah): sRGB goes to linear through a table of all 256 values, and back through a table of 4096 linear
+        // steps, which is fine enough that every byte makes the round trip unchanged.
+        static constexpr uint32_t MIP_SRGB_STEPS = 4096;
+
+        struct mip_srgb_tables_t {
+            float   toLinear[256];
+            uint8_t toSrgb[MIP_SRGB_STEPS];
+
+            mip_srgb_tables_t()
+            {
+                for (uint32_t i = 0; i < 256; i++) {
+                    float c     = float(i) / 255.0f;
+                    toLinear[i] = (c <= 0.04045f) ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (uint32_t i = 0; i < MIP_SRGB_STEPS; i++) {
+                    float l   = float(i) / float(MIP_SRGB_STEPS - 1);
+                    float c   = (l <= 0.0031308f) ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+                    toSrgb[i] = uint8_t(c * 255.0f + 0.5f);
+                }
+            }
+        };
+
+        static const mip_srgb_tables_t &mipSrgbTables()
+        {
+            static const mip_srgb_tables_t tables;
+            return tables;
+        }
+
+        // the lanes of a pixel that hold colour, as opposed to alpha.
+        static inline __m128 mipColorMask() { return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)); }
+
+        static void mipBytesToFloat(const uint32_t *src, uint32_t count, const mip_options_t &options, __m128 *dst)
+        {
+            const float *toLinear  = mipSrgbTables().toLinear;
+            const __m128 scale     = _mm_set1_ps(1.0f / 255.0f);
+            const __m128 colorMask = mipColorMask();
+            const __m128 alphaOne  = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t p = src[i];
+                uint32_t r = p & 0xFF, g = (p >> 8) & 0xFF, b = (p >> 16) & 0xFF, a = p >> 24;
+                __m128   v;
+                if (options.bSrgb) v = _mm_setr_ps(toLinear[r], toLinear[g], toLinear[b], float(a) * (1.0f / 255.0f));
+                else v = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(int(r), int(g), int(b), int(a))), scale);
+                if (options.bPremultiplyAlpha) {
+                    // (a, a, a, 1), so that the colour is scaled by alpha and alpha is left alone.
+                    __m128 alpha = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                    v            = _mm_mul_ps(v, _mm_or_ps(_mm_and_ps(alpha, colorMask), alphaOne));
+                }
+                dst[i] = v;
+            }
+        }
+
+        static void mipFloatToBytes(const __m128 *src, uint32_t count, const mip_options_t &options, uint32_t *dst)
+        {
+            const uint8_t *toSrgb    = mipSrgbTables().toSrgb;
+            const __m128   zero      = _mm_setzero_ps();
+            const __m128   one       = _mm_set1_ps(1.0f);
+            const __m128   half      = _mm_set1_ps(0.5f);
+            const __m128   byteScale = _mm_set1_ps(255.0f);
+            const __m128   srgbScale = _mm_set1_ps(float(MIP_SRGB_STEPS - 1));
+            const __m128   colorMask = mipColorMask();
+            const __m128   tiny      = _mm_set1_ps(1.0f / 65536.0f);
+            for (uint32_t i = 0; i < count; i++) {
+                __m128 v = src[i];
+                if (options.bPremultiplyAlpha) {
+                    // back to straight alpha. a texel with next to no alpha left has no colour to speak of.
+                    __m128 alpha = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                    __m128 color = _mm_and_ps(_mm_div_ps(v, _mm_max_ps(alpha, tiny)), _mm_cmpgt_ps(alpha, tiny));
+                    v            = _mm_or_ps(_mm_and_ps(color, colorMask), _mm_andnot_ps(colorMask, v));
+                }
+                // the windowed filters ring, so a level can go a little past either end.
+                v             = _mm_min_ps(_mm_max_ps(v, zero), one);
+                __m128i bytes = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, byteScale), half));
+                if (options.bSrgb) {
+                    alignas(16) int32_t steps[4], alpha[4];
+                    _mm_store_si128((__m128i *)steps, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, srgbScale), half)));
+                    _mm_store_si128((__m128i *)alpha, bytes);
+                    dst[i] = uint32_t(toSrgb[steps[0]]) | (uint32_t(toSrgb[steps[1]]) << 8) |
+                             (uint32_t(toSrgb[steps[2]]) << 16) | (uint32_t(alpha[3]) << 24);
+                } else {
+                    bytes  = _mm_packs_epi32(bytes, bytes);
+                    dst[i] = uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(bytes, bytes)));
+                }
+            }
+        }
+
+        // NOTE(Noah): the windowed filters reach 3 texels of the smaller level to either side, i.e. 6 of the larger.
+        // Kaiser is a sinc under a Kaiser window with alpha = 4, and Lanczos a sinc under a wider sinc. both keep more
+        // detail than a box and alias less, for a little ringing at hard edges.
+        static constexpr float MIP_FILTER_RADIUS = 3.0f;
+        static constexpr float MIP_KAISER_ALPHA  = 4.0f;
+
+        static float mipSinc(float x)
+        {
+            x *= 3.14159265358979f;
+            return (fabsf(x) < 1e-5f) ? 1.0f : sinf(x) / x;
+        }
+
+        // the modified Bessel function of the first kind, by its series, which converges quickly for small x.
+        static float mipBesselI0(float x)
+        {
+            float sum = 1.0f, term = 1.0f, q = x * x * 0.25f;
+            for (uint32_t k = 1; k < 32 && term > sum * 1e-8f; k++) {
+                term *= q / float(k * k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        static float mipFilterWeight(mip_filter_t filter, float t)
+        {
+            if (fabsf(t) >= MIP_FILTER_RADIUS) return 0.0f;
+            if (filter == MIP_FILTER_LANCZOS) return mipSinc(t) * mipSinc(t / MIP_FILTER_RADIUS);
+            float r = t / MIP_FILTER_RADIUS;
+            return mipSinc(t) * mipBesselI0(MIP_KAISER_ALPHA * sqrtf(1.0f - r * r)) / mipBesselI0(MIP_KAISER_ALPHA);
+        }
+
+        // the source pixels and weights for each pixel along one side of a level. every destination pixel has
+        // tapCount taps, some of which may weigh nothing, with indices clamped to the edge.
+        struct mip_taps_t {
+            uint32_t  tapCount;
+            uint32_t *index;
+            float    *weight;
+        };
+
+        static bool mipBuildTaps(mip_filter_t filter, uint32_t srcSize, uint32_t dstSize, mip_taps_t *taps)
+        {
+            float scale = float(srcSize) / float(dstSize);
+            taps->tapCount =
+                (filter == MIP_FILTER_BOX) ? 2 : 2 * uint32_t(ceilf(MIP_FILTER_RADIUS * scale)) + 1;
+            taps->index  = (uint32_t *)malloc(sizeof(uint32_t) * dstSize * taps->tapCount);
+            taps->weight = (float *)malloc(sizeof(float) * dstSize * taps->tapCount);
+            if (taps->index == nullptr || taps->weight == nullptr) return false;
+            for (uint32_t i = 0; i < dstSize; i++) {
+                uint32_t *index  = taps->index + size_t(i) * taps->tapCount;
+                float    *weight = taps->weight + size_t(i) * taps->tapCount;
+                if (filter == MIP_FILTER_BOX) {
+                    index[0]  = math::min(2 * i, srcSize - 1);
+                    index[1]  = math::min(2 * i + 1, srcSize - 1);
+                    weight[0] = weight[1] = 0.5f;
+                    continue;
+                }
+                // the centre of the destination pixel, in source pixels.
+                float center = (float(i) + 0.5f) * scale - 0.5f;
+                int   first  = int(floorf(center)) - int(taps->tapCount / 2);
+                float sum    = 0.0f;
+                for (uint32_t k = 0; k < taps->tapCount; k++) {
+                    int j     = first + int(k);
+                    weight[k] = mipFilterWeight(filter, (float(j) - center) / scale);
+                    index[k]  = uint32_t(math::min(math::max(j, 0), int(srcSize) - 1));
+                    sum += weight[k];
+                }
+                for (uint32_t k = 0; k < taps->tapCount; k++) weight[k] /= sum;
+            }
+            return true;
+        }
+
+        // one level from the level before it, as floats. level 0 is passed as srcBytes instead of src, and is
+        // converted a row at a time into rowScratch.
+        static bool mipResample(const __m128 *src, const uint32_t *srcBytes, uint32_t srcWidth, uint32_t srcHeight,
+            __m128 *dst, uint32_t dstWidth, uint32_t dstHeight, const mip_options_t &options, __m128 *rowScratch,
+            __m128 *columnScratch)
+        {
+            mip_taps_t tx = {}, ty = {};
+            bool       bResult = mipBuildTaps(options.filter, srcWidth, dstWidth, &tx) &&
+                           mipBuildTaps(options.filter, srcHeight, dstHeight, &ty);
+            if (bResult) {
+                // across each row first, into columnScratch, which is dstWidth by srcHeight.
+                for (uint32_t y = 0; y < srcHeight; y++) {
+                    const __m128 *row = src + size_t(y) * srcWidth;
+                    if (srcBytes) {
+                        mipBytesToFloat(srcBytes + size_t(y) * srcWidth, srcWidth, options, rowScratch);
+                        row = rowScratch;
+                    }
+                    __m128 *out = columnScratch + size_t(y) * dstWidth;
+                    for (uint32_t x = 0; x < dstWidth; x++) {
+                        const uint32_t *index  = tx.index + size_t(x) * tx.tapCount;
+                        const float    *weight = tx.weight + size_t(x) * tx.tapCount;
+                        __m128          acc    = _mm_setzero_ps();
+                        for (uint32_t k = 0; k < tx.tapCount; k++) {
+                            acc = _mm_add_ps(acc, _mm_mul_ps(row[index[k]], _mm_set1_ps(weight[k])));
+                        }
+                        out[x] = acc;
+                    }
+                }
+                // then down each column, a whole row of the result at a time.
+                for (uint32_t y = 0; y < dstHeight; y++) {
+                    __m128 *out = dst + size_t(y) * dstWidth;
+                    for (uint32_t x = 0; x < dstWidth; x++) out[x] = _mm_setzero_ps();
+                    for (uint32_t k = 0; k < ty.tapCount; k++) {
+                        float weight = ty.weight[size_t(y) * ty.tapCount + k];
+                        if (weight == 0.0f) continue;
+                        const __m128 *row = columnScratch + size_t(ty.index[size_t(y) * ty.tapCount + k]) * dstWidth;
+                        const __m128  w   = _mm_set1_ps(weight);
+                        for (uint32_t x = 0; x < dstWidth; x++) out[x] = _mm_add_ps(out[x], _mm_mul_ps(row[x], w));
+                    }
+                }
+            }
+            free(tx.index), free(tx.weight), free(ty.index), free(ty.weight);
+            return bResult;
+        }
+
+        // fill in levels 1 and on, for a chain that has level 0 in place.
+        static bool mipGenerateLevels(mip_chain_t *chain, const mip_options_t &options)
+        {
+            uint32_t *pixels = chain->pixels;
+            if (options.filter == MIP_FILTER_BOX && !options.bSrgb && !options.bPremultiplyAlpha) {
+                for (uint32_t i = 1; i < chain->levelCount; i++) {
+                    mipBoxBytes(pixels + chain->levelOffset[i - 1], math::max(chain->width >> (i - 1), 1u),
+                        math::max(chain->height >> (i - 1), 1u), pixels + chain->levelOffset[i],
+                        math::max(chain->width >> i, 1u), math::max(chain->height >> i, 1u));
+                }
+                return true;
+            }
+            if (chain->levelCount == 1) return true;
+
+            // NOTE(Noah): level 1 is the largest of the float levels. two level buffers trade places on the way down
+            // the chain, and the scratch for the first pass of level 1 is large enough for that of every later one.
+            uint32_t w1 = math::max(chain->width >> 1, 1u), h1 = math::max(chain->height >> 1, 1u);
+            size_t   levelPixels  = size_t(w1) * h1;
+            size_t   columnPixels = size_t(w1) * chain->height;
+            __m128  *scratch = (__m128 *)malloc(sizeof(__m128) * (2 * levelPixels + columnPixels + chain->width));
+            if (scratch == nullptr) return false;
+            __m128 *columnScratch = scratch + 2 * levelPixels;
+            __m128 *rowScratch    = columnScratch + columnPixels;
+            __m128 *src = nullptr, *dst = scratch, *next = scratch + levelPixels;
+
+            bool bResult = true;
+            for (uint32_t i = 1; i < chain->levelCount && bResult; i++) {
+                uint32_t srcWidth  = math::max(chain->width >> (i - 1), 1u);
+                uint32_t srcHeight = math::max(chain->height >> (i - 1), 1u);
+                uint32_t dstWidth  = math::max(chain->width >> i, 1u);
+                uint32_t dstHeight = math::max(chain->height >> i, 1u);
+                bResult = mipResample(src, (i == 1) ? pixels : nullptr, srcWidth, srcHeight, dst, dstWidth, dstHeight,
+                    options, rowScratch, columnScratch);
+                mipFloatToBytes(dst, dstWidth * dstHeight, options, pixels + chain->levelOffset[i]);
+                src = dst;
+                std::swap(dst, next);
+            }
+            free(scratch);
+            return bResult;
+        }
+
+        static void mipWriteFooter(mip_chain_t *chain, const mip_options_t &options)
+        {
+            image_cache_footer_t footer = {};
+            footer.contentHash          = chain->contentHash;
+            footer.width                = chain->width;
+            footer.height               = chain->height;
+            footer.levelCount           = chain->levelCount;
+            footer.version              = IMAGE_CACHE_VERSION;
+            footer.options              = mipOptionsKey(options);
+            footer.magic                = IMAGE_CACHE_MAGIC;
+            memcpy((uint8_t *)chain->pixels + mipChainBytes(*chain) - sizeof(footer), &footer, sizeof(footer));
+        }
+
+        bool generateMips(const loaded_image_t &image, mip_chain_t *out, const mip_options_t *options)
+        {
+            const mip_options_t defaults = {};
+            if (options == nullptr) options = &defaults;
+            *out = {};
+            if (image.pixelPointer == nullptr || image.width == 0 || image.height == 0) return false;
+            out->width  = image.width;
+            out->height = image.height;
+            mipChainLayout(out);
+            out->pixels = (uint32_t *)malloc(mipChainBytes(*out));
+            if (out->pixels == nullptr) {
+                *out = {};
+                return false;
+            }
+            memcpy(out->pixels, image.pixelPointer, size_t(image.width) * image.height * sizeof(uint32_t));
+            if (!mipGenerateLevels(out, *options)) {
+                freeMipChain(out);
+                return false;
+            }
+            mipWriteFooter(out, *options);
+            return true;
+        }
+
+        // ----------- [SECTION] Decoding and the cache -----------
+
+        static bool imageDecode(
+            const void *data, size_t size, uint64_t contentHash, const mip_options_t &options, mip_chain_t *out)
+        {
+            *out = {};
+            if (data == nullptr || size == 0 || size > INT32_MAX) return false;
+            // NOTE(Noah): the flip is set on every decoding thread, so that this does not depend on
+            // initModuleGlobals having run, nor race with it.
+            stbi_set_flip_vertically_on_load_thread(1);
+            int      w, h, n;
+            stbi_uc *pixels = stbi_load_from_memory((const stbi_uc *)data, int(size), &w, &h, &n, 4);
+            if (pixels == nullptr) return false;
+            out->width  = uint32_t(w);
+            out->height = uint32_t(h);
+            mipChainLayout(out);
+            // NOTE(Noah): level 0 is already where it goes, so the block from stb_image only grows to fit the mips.
+            void *block = realloc(pixels, mipChainBytes(*out));
+            if (block == nullptr) {
+                stbi_image_free(pixels);
+                *out = {};
+                return false;
+            }
+            out->pixels      = (uint32_t *)block;
+            out->contentHash = contentHash;
+            if (!mipGenerateLevels(out, options)) {
+                freeMipChain(out);
+                return false;
+            }
+            mipWriteFooter(out, options);
+            return true;
+        }
+
+        // takes a mapped cache file as the chain if it is whole, and is for contentHash and options.
+        static bool imageFromCache(
+            loaded_file_t file, uint64_t contentHash, const mip_options_t &options, mip_chain_t *out)
+        {
+            image_cache_footer_t footer;
+            if (file.contents == nullptr || size_t(file.contentSize) < sizeof(footer)) return false;
+            memcpy(&footer, (uint8_t *)file.contents + file.contentSize - sizeof(footer), sizeof(footer));
+            if (footer.magic != IMAGE_CACHE_MAGIC || footer.version != IMAGE_CACHE_VERSION ||
+                footer.contentHash != contentHash || footer.options != mipOptionsKey(options) || footer.width == 0 ||
+                footer.height == 0) {
+                return false;
+            }
+            mip_chain_t chain = {};
+            chain.width       = footer.width;
+            chain.height      = footer.height;
+            mipChainLayout(&chain);
+            if (chain.levelCount != footer.levelCount || mipChainBytes(chain) != size_t(file.contentSize)) return false;
+            chain.pixels      = (uint32_t *)file.contents;
+            chain.contentHash = contentHash;
+            chain.parentFile  = file;
+            *out              = chain;
+            return true;
+        }
+
+        static bool imageLoad(const char *path, const char *cacheDir, const mip_options_t &options, mip_chain_t *out)
+        {
+            *out               = {};
+            loaded_file_t file = vfs::mapEntireFile(path);
+            if (file.contents == nullptr) {
+                AELoggerError("could not load %s", path);
+                return false;
+            }
+            uint64_t contentHash = vfs::hashContents(file.contents, size_t(file.contentSize));
+
+            // NOTE(Noah): the cache is always on disk, never in an archive, so it goes straight to the platform.
+            char cachePath[512];
+            if (cacheDir != nullptr) {
+                snprintf(cachePath, sizeof(cachePath), "%s/%016llx-%03x.aetex", cacheDir,
+                    (unsigned long long)contentHash, mipOptionsKey(options));
+                if (EM->pfn.pathExists(cachePath)) {
+                    loaded_file_t cached = EM->pfn.mapEntireFile(cachePath);
+                    if (imageFromCache(cached, contentHash, options, out)) {
+                        vfs::unmapFile(file);
+                        return true;
+                    }
+                    // a stale or torn file, which is written again below.
+                    if (cached.contents) EM->pfn.unmapFile(cached);
+                }
+            }
+
+            bool bDecoded = imageDecode(file.contents, size_t(file.contentSize), contentHash, options, out);
+            vfs::unmapFile(file);
+            if (!bDecoded) {
+                AELoggerError("could not decode %s: %s", path, stbi_failure_reason());
+                return false;
+            }
+            size_t bytes = mipChainBytes(*out);
+            if (cacheDir != nullptr && bytes <= UINT32_MAX) {
+                // NOTE(Noah): a failed write only costs the next run a decode, and the platform logs it.
+                EM->pfn.writeEntireFile(cachePath, out->pixels, uint32_t(bytes));
+            }
+            return true;
+        }
+
+        bool decodeImage(const void *data, size_t size, mip_chain_t *out, const mip_options_t *options)
+        {
+            const mip_options_t defaults = {};
+            return imageDecode(data, size, vfs::hashContents(data, size), options ? *options : defaults, out);
+        }
+
+        uint32_t loadImages(const char *const *paths, uint32_t count, mip_chain_t *out, const char *cacheDir,
+            const mip_options_t *options)
+        {
+            const mip_options_t   defaults    = {};
+            std::atomic<uint32_t> loadedCount = 0;
+            jobs::parallelFor(count, 1, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    if (imageLoad(paths[i], cacheDir, options ? *options : defaults, &out[i])) {
+                        loadedCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+            return loadedCount.load();
+        }
+
+        void freeMipChain(mip_chain_t *chain)
+        {
+            if (chain->parentFile.contents) EM->pfn.unmapFile(chain->parentFile);
+            else free(chain->pixels);
+            *chain = {};
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
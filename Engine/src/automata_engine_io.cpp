@@ -2,6 +2,10 @@
 
 #include <automata_engine_utils.hpp>
 
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+
 #define STB_DS_IMPLEMENTATION
 #include "stb_ds.h"
 
@@ -69,7 +73,7 @@ namespace automata_engine {
       char SubFormat[16]; // GUID, including the data format code
     } wav_fmt_t;
 
-    void freeWav(loaded_wav_t wavFile) { EM->pfn.freeLoadedFile(wavFile.parentFile);
+    void freeWav(loaded_wav_t wavFile) { vfs::freeLoadedFile(wavFile.parentFile);
     }
     static wav_file_cursor LoadWav_ParseChunkAt(void *bytePointer, void *endOfFile) {
       wav_file_cursor result;
@@ -87,13 +91,17 @@ namespace automata_engine {
       void *result = fileCursor.cursor + sizeof(wav_chunk_header);
       return result;
     }
+    // NOTE(Noah): chunks are only padded to 2 bytes, so the headers are read with memcpy rather than in place.
+    static wav_chunk_header_t LoadWav_GetChunkHeader(wav_file_cursor fileCursor) {
+      wav_chunk_header_t result;
+      memcpy(&result, fileCursor.cursor, sizeof(result));
+      return result;
+    }
     static int LoadWav_GetChunkSize(wav_file_cursor fileCursor) {
-      wav_chunk_header *wavChunkHeader = (wav_chunk_header *)fileCursor.cursor;
-      return wavChunkHeader->chunkSize;	
+      return LoadWav_GetChunkHeader(fileCursor).chunkSize;
     }
     static wav_file_cursor LoadWav_NextChunk(wav_file_cursor fileCursor) {
-      wav_chunk_header_t *wavChunkHeader = (wav_chunk_header *)fileCursor.cursor;
-      int chunkSize = wavChunkHeader->chunkSize;
+      int chunkSize = LoadWav_GetChunkSize(fileCursor);
       if(chunkSize & 1) {
         chunkSize +=1 ;
       }
@@ -101,96 +109,344 @@ namespace automata_engine {
       return fileCursor;
     }
     static int LoadWav_GetType(wav_file_cursor fileCursor) {
-      wav_chunk_header_t *wavChunkHeader = (wav_chunk_header *)fileCursor.cursor;
-      int result = wavChunkHeader->chunkID;
-      return result;
+      return LoadWav_GetChunkHeader(fileCursor).chunkID;
+    }
+    // the sample format of a fmt chunk, if it is one that we take.
+    static bool LoadWav_GetPcmFormat(const wav_fmt *wavfmt, int fmtSize, pcm_format_t *formatOut) {
+      if (fmtSize < 16) return false;
+      int tag = uint16_t(wavfmt->wFormatTag);
+      // NOTE(Noah): WAVE_FORMAT_EXTENSIBLE keeps the real format tag in the first two bytes of the GUID.
+      if (tag == 0xFFFE) {
+        if (fmtSize < 40) return false;
+        tag = uint8_t(wavfmt->SubFormat[0]) | (uint8_t(wavfmt->SubFormat[1]) << 8);
+      }
+      if (tag == 3) { // IEEE float.
+        *formatOut = PCM_FORMAT_F32;
+        return wavfmt->wBitsPerSample == 32;
+      }
+      if (tag != 1) return false;
+      switch (wavfmt->wBitsPerSample) {
+        case 8: *formatOut = PCM_FORMAT_U8; return true;
+        case 16: *formatOut = PCM_FORMAT_S16; return true;
+        case 24: *formatOut = PCM_FORMAT_S24; return true;
+        case 32: *formatOut = PCM_FORMAT_S32; return true;
+        default: return false;
+      }
     }
-    // TODO(Noah): Use stb_vorbis for .ogg file parsing. Prob going to be better (compressed?)
-    // TODO(Noah): Think about failure cases for load file err.
+    static const uint32_t LoadWav_pcmFormatSizes[PCM_FORMAT_COUNT] = {1, 2, 3, 4, 4};
+
     loaded_wav_t loadWav(const char *fileName) {
       loaded_wav_t wavFile = {};
-        loaded_file_t fileResult = EM->pfn.readEntireFile(fileName);
-      wavFile.parentFile = fileResult;
-      if (fileResult.contentSize != 0 ) {
-        wav_header *wavHeader = (wav_header *)fileResult.contents;
-        assert(wavHeader->chunkID == Wav_ChunkID_RIFF);
-        assert(wavHeader->waveID == Wav_ChunkID_WAVE);
-        // NOTE(Noah): The end of file computation explained: We go ahead by the initial header size, 
+      loaded_file_t fileResult = vfs::readEntireFile(fileName);
+      if (fileResult.contentSize < int(sizeof(wav_header))) {
+        vfs::freeLoadedFile(fileResult);
+        return wavFile;
+      }
+      wav_header *wavHeader = (wav_header *)fileResult.contents;
+      char *endOfFile = (char *)fileResult.contents + fileResult.contentSize;
+      char *samples = 0;
+      int sampleDataSize = 0;
+      wav_fmt_t fmt = {};
+      int fmtSize = 0;
+      if (wavHeader->chunkID == Wav_ChunkID_RIFF && wavHeader->waveID == Wav_ChunkID_WAVE) {
+        // NOTE(Noah): The end of file computation explained: We go ahead by the initial header size,
         // then add wavHeader->fileSize, which excludes the 4-byte value after it, so we subtract 4 bytes.
-        short *samples = 0;
-        int channels = 0;
-        int sampleDataSize = 0;
-        for(    
-          wav_file_cursor fileCursor = LoadWav_ParseChunkAt(wavHeader + 1, 
-            (char *)(wavHeader + 1) + wavHeader->fileSize - 4);
+        char *endOfRiff = (char *)(wavHeader + 1) + wavHeader->fileSize - 4;
+        if (endOfRiff > endOfFile || endOfRiff < (char *)(wavHeader + 1)) endOfRiff = endOfFile;
+        for (
+          wav_file_cursor fileCursor = LoadWav_ParseChunkAt(wavHeader + 1, endOfRiff - sizeof(wav_chunk_header));
           LoadWav_IsFileCursorValid(fileCursor);
-          fileCursor = LoadWav_NextChunk(fileCursor) 
+          fileCursor = LoadWav_NextChunk(fileCursor)
         ) {
+          // the chunk sizes are not to be trusted, so clamp them to the file.
+          int chunkSize = LoadWav_GetChunkSize(fileCursor);
+          int room = int(endOfFile - (char *)LoadWav_GetChunkData(fileCursor));
+          if (chunkSize < 0 || chunkSize > room) chunkSize = room;
           switch(LoadWav_GetType(fileCursor)) {
             case Wav_ChunkID_fmt: {
-              wav_fmt *wavfmt = (wav_fmt *)LoadWav_GetChunkData(fileCursor);
-              assert(wavfmt->wFormatTag == 1);
-              assert(wavfmt->nSamplesPerSec == ENGINE_DESIRED_SAMPLES_PER_SECOND);
-              assert(wavfmt->wBitsPerSample == 16);
-              channels = wavfmt->nChannels;
+              // copied out, as the fields are not aligned in the file.
+              memcpy(&fmt, LoadWav_GetChunkData(fileCursor), math::min(size_t(chunkSize), sizeof(fmt)));
+              fmtSize = chunkSize;
             } break;
             case Wav_ChunkID_data: {
-              samples = (short *)LoadWav_GetChunkData(fileCursor);
-              sampleDataSize = LoadWav_GetChunkSize(fileCursor);
+              samples = (char *)LoadWav_GetChunkData(fileCursor);
+              sampleDataSize = chunkSize;
             } break;
             default:
             // do nothing I guess, lol.
             break;
           }
+          if (chunkSize != LoadWav_GetChunkSize(fileCursor)) break;
         }
-        assert((channels && samples && sampleDataSize));
-        wavFile.sampleCount = sampleDataSize / (channels * sizeof(short));
-        wavFile.channels = channels;
-        if (channels != 2) {
-            assert(!"Unsupported Channel type!");
-        } else {
-          wavFile.sampleData = samples;
-        }
+      }
+      pcm_format_t format;
+      if (!samples || !LoadWav_GetPcmFormat(&fmt, fmtSize, &format) || (fmt.nChannels != 1 && fmt.nChannels != 2) ||
+          uint32_t(fmt.nSamplesPerSec) != ENGINE_DESIRED_SAMPLES_PER_SECOND) {
+        AELoggerError("could not load %s, as it is not a mono or stereo .WAV at %u Hz in a format that we take",
+          fileName, ENGINE_DESIRED_SAMPLES_PER_SECOND);
+        vfs::freeLoadedFile(fileResult);
+        return wavFile;
+      }
+      int channels = fmt.nChannels;
+      wavFile.sampleCount = sampleDataSize / (channels * LoadWav_pcmFormatSizes[format]);
+      wavFile.channels = 2;
+      if (format == PCM_FORMAT_S16 && channels == 2) {
+        // already as the voices take it, so the samples are used right where they are in the file.
+        wavFile.parentFile = fileResult;
+        wavFile.sampleData = (short *)samples;
+      } else {
+        // NOTE(Noah): the converted samples stand in for the file, so that freeWav frees them.
+        short *converted = (short *)malloc(math::max(size_t(wavFile.sampleCount) * 2 * sizeof(short), size_t(1)));
+        convertPcm(samples, format, channels, wavFile.sampleCount, converted);
+        vfs::freeLoadedFile(fileResult);
+        vfs::_trackHeapFile(converted);
+        wavFile.parentFile.fileName = fileName;
+        wavFile.parentFile.contents = converted;
+        wavFile.parentFile.contentSize = wavFile.sampleCount * 2 * sizeof(short);
+        wavFile.sampleData = converted;
       }
       return wavFile;
     }
 
-    loaded_image_t loadBMP(const char *path) {
-      loaded_image_t bitmap = {};
-      // bitmap.scale = 1;
-      loaded_file_t fileResult = EM->pfn.readEntireFile(path);
-      if (fileResult.contentSize != 0) {
-        bitmap_header_t *header = (bitmap_header *)fileResult.contents;
-        if (header->BitsPerPixel == 32) {
-          uint32_t imgSize = header->Height * header->Width * sizeof(uint32_t);
-            uint32_t *newData = (uint32_t *)EM->pfn.alloc(imgSize);
-          if (newData != nullptr) {
-            bitmap.pixelPointer = (unsigned int *) ((unsigned char *)fileResult.contents + header->BitmapOffset);
-            memcpy(newData, bitmap.pixelPointer, imgSize);
-            bitmap.pixelPointer = newData;
-            bitmap.height = header->Height;
-            bitmap.width = header->Width;
-            // Colors in .bmp are stored as ARGB (MSB -> LSB), i.e. 0xAARRGGBB
-            // below code to convert to 0xRRGGBBAA.
-            unsigned int *SourceDest = bitmap.pixelPointer;
-            for (uint32_t y = 0; y < bitmap.height; ++y) {
-              for (uint32_t x = 0; x < bitmap.width; ++x) {
-                unsigned int pixel_val = *SourceDest;
-                unsigned int R = (pixel_val >> 16) & 0x000000FF;
-                unsigned int G = (pixel_val >> 8) & 0x000000FF;
-                unsigned int B = (pixel_val >> 0) & 0x000000FF;
-                unsigned int A = (pixel_val >> 24) & 0x000000FF;
-                *SourceDest++ = (A << 24) | (B << 16) | (G << 8) | (R << 0);
-              }
+    // ----------- [SECTION] BMP -----------
+    enum {
+      BMP_BI_RGB = 0,
+      BMP_BI_BITFIELDS = 3,
+      BMP_BI_ALPHABITFIELDS = 6,
+    };
+    static constexpr uint32_t BMP_FILE_HEADER_SIZE = 14;
+    static constexpr uint8_t BMP_ZERO = 0x80;  // pshufb writes a zero for any index with the top bit set.
+
+    // NOTE(Noah): every format that we take comes down to one of three row kernels. 32 and 24 bpp rows are a
+    // byte shuffle from the source pixel to RGBA, with alphaFill OR'd over the top for files without an alpha.
+    // 8 bpp rows index the palette, which is converted to RGBA up front.
+    struct bmp_layout_t {
+      const uint8_t *pixels;
+      uint32_t width, height;
+      uint32_t stride;
+      uint32_t bpp;
+      bool bTopDown;
+      uint8_t shuffle[4];          // source byte of R, G, B and A within a pixel, or BMP_ZERO.
+      alignas(16) uint8_t shuffle16[16];  // shuffle for four pixels at once, as a pshufb mask.
+      uint32_t alphaFill;
+      uint32_t palette[256];
+    };
+
+    static uint32_t bmpRead32(const uint8_t *p) {
+      uint32_t v;
+      memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+    // NOTE(Noah): a mask is only taken when it covers one whole byte, which is what every writer that we know of
+    // puts out. this is what lets a BI_BITFIELDS file go through the same shuffle as a plain one.
+    static bool bmpMaskToByte(uint32_t mask, uint8_t *byteOut) {
+      for (uint8_t i = 0; i < 4; i++) {
+        if (mask == (0xFFu << (8 * i))) {
+          *byteOut = i;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static bool bmpParse(const uint8_t *data, size_t size, bmp_layout_t *l) {
+      if (size < BMP_FILE_HEADER_SIZE + 40) return false;
+      bitmap_header_t header = {};
+      memcpy(&header, data, BMP_FILE_HEADER_SIZE + 40);
+      if (header.FileType != 0x4D42 || header.size < 40 || header.Width <= 0 || header.Height == 0 ||
+          header.Height == INT32_MIN) {
+        return false;
+      }
+      l->width = (uint32_t)header.Width;
+      l->height = (uint32_t)(header.Height < 0 ? -header.Height : header.Height);
+      l->bTopDown = header.Height < 0;
+      l->bpp = header.BitsPerPixel;
+      // NOTE(Noah): keep width * height * 4 inside of a uint32_t, which is what EM->pfn.alloc takes.
+      if ((uint64_t)l->width * l->height > (UINT32_MAX / 4)) return false;
+      uint64_t stride = (((uint64_t)l->width * l->bpp + 31) / 32) * 4;
+      if ((uint64_t)header.BitmapOffset + stride * l->height > size) return false;
+      l->stride = (uint32_t)stride;
+      l->pixels = data + header.BitmapOffset;
+      l->alphaFill = 0;
+
+      uint64_t infoEnd = (uint64_t)BMP_FILE_HEADER_SIZE + header.size;
+      switch (l->bpp) {
+        case 32: {
+          if (header.biCompression == BMP_BI_RGB) {
+            // NOTE(Noah): stored as 0xAARRGGBB. the alpha is kept as is, as it always has been.
+            l->shuffle[0] = 2, l->shuffle[1] = 1, l->shuffle[2] = 0, l->shuffle[3] = 3;
+          } else if (header.biCompression == BMP_BI_BITFIELDS || header.biCompression == BMP_BI_ALPHABITFIELDS) {
+            // NOTE(Noah): the masks follow a 40 byte header, and are inside of any of the larger ones.
+            uint32_t maskCount = (header.size > 40 || header.biCompression == BMP_BI_ALPHABITFIELDS) ? 4 : 3;
+            uint64_t masksAt = BMP_FILE_HEADER_SIZE + 40;
+            if (masksAt + maskCount * 4 > size) return false;
+            uint32_t masks[4] = {};
+            for (uint32_t i = 0; i < maskCount; i++) masks[i] = bmpRead32(data + masksAt + i * 4);
+            for (uint32_t i = 0; i < 3; i++) {
+              if (!bmpMaskToByte(masks[i], &l->shuffle[i])) return false;
             }
-            EM->pfn.freeLoadedFile(fileResult);
+            if (masks[3] == 0) {
+              l->shuffle[3] = BMP_ZERO;
+              l->alphaFill = 0xFF000000;
+            } else if (!bmpMaskToByte(masks[3], &l->shuffle[3]) || (masks[3] & (masks[0] | masks[1] | masks[2]))) {
+              return false;
+            }
+            if ((masks[0] & masks[1]) || (masks[0] & masks[2]) || (masks[1] & masks[2])) return false;
           } else {
-            // AELoggerError("loadBMP failed to alloc.");
+            return false;
+          }
+          for (uint32_t i = 0; i < 16; i++) {
+            uint8_t s = l->shuffle[i & 3];
+            l->shuffle16[i] = (s == BMP_ZERO) ? BMP_ZERO : (uint8_t)((i & ~3u) + s);
+          }
+        } break;
+        case 24: {
+          if (header.biCompression != BMP_BI_RGB) return false;
+          l->shuffle[0] = 2, l->shuffle[1] = 1, l->shuffle[2] = 0, l->shuffle[3] = BMP_ZERO;
+          l->alphaFill = 0xFF000000;
+          for (uint32_t i = 0; i < 16; i++) {
+            uint8_t s = l->shuffle[i & 3];
+            l->shuffle16[i] = (s == BMP_ZERO) ? BMP_ZERO : (uint8_t)((i / 4) * 3 + s);
           }
+        } break;
+        case 8: {
+          if (header.biCompression != BMP_BI_RGB) return false;
+          uint32_t count = header.biClrUsed ? header.biClrUsed : 256;
+          if (count > 256 || infoEnd + count * 4 > header.BitmapOffset) return false;
+          // NOTE(Noah): the palette is BGRX. an index past the end of it reads as opaque black.
+          for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = (i < count) ? bmpRead32(data + infoEnd + i * 4) : 0;
+            l->palette[i] = 0xFF000000 | ((c & 0xFF) << 16) | (c & 0xFF00) | ((c >> 16) & 0xFF);
+          }
+        } break;
+        default:
+          return false;
+      }
+      return true;
+    }
+
+    static uint32_t bmpShufflePixel(uint32_t v, const bmp_layout_t &l) {
+      uint32_t result = l.alphaFill;
+      for (uint32_t c = 0; c < 4; c++) {
+        if (l.shuffle[c] != BMP_ZERO) result |= ((v >> (8 * l.shuffle[c])) & 0xFF) << (8 * c);
+      }
+      return result;
+    }
+
+    static void bmpDecodeRow32(const uint8_t *src, uint32_t *dst, const bmp_layout_t &l) {
+      uint32_t x = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+      const __m128i mask = _mm_load_si128((const __m128i *)l.shuffle16);
+      const __m128i fill = _mm_set1_epi32((int)l.alphaFill);
+#if defined(__AVX2__)
+      const __m256i mask8 = _mm256_broadcastsi128_si256(mask);
+      const __m256i fill8 = _mm256_set1_epi32((int)l.alphaFill);
+      for (; x + 8 <= l.width; x += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src + x * 4));
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, mask8), fill8);
+        _mm256_storeu_si256((__m256i *)(dst + x), v);
+      }
+#endif
+      for (; x + 4 <= l.width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x * 4));
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_shuffle_epi8(v, mask), fill));
+      }
+#else
+      // NOTE(Noah): without pshufb, only the usual BGRA / BGRX order gets a vector path. R and B trade places
+      // by swapping the 16-bit halves of each 0x00RR00BB.
+      if (l.shuffle[0] == 2 && l.shuffle[1] == 1 && l.shuffle[2] == 0) {
+        const __m128i rbMask = _mm_set1_epi32(0x00FF00FF);
+        const __m128i gaMask = _mm_set1_epi32((l.shuffle[3] == 3) ? (int)0xFF00FF00 : 0x0000FF00);
+        const __m128i fill = _mm_set1_epi32((int)l.alphaFill);
+        for (; x + 4 <= l.width; x += 4) {
+          __m128i v = _mm_loadu_si128((const __m128i *)(src + x * 4));
+          __m128i rb = _mm_and_si128(v, rbMask);
+          rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+          __m128i ga = _mm_and_si128(v, gaMask);
+          _mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_or_si128(rb, ga), fill));
+        }
+      }
+#endif
+      for (; x < l.width; x++) dst[x] = bmpShufflePixel(bmpRead32(src + x * 4), l);
+    }
+
+    static void bmpDecodeRow24(const uint8_t *src, uint32_t *dst, const bmp_layout_t &l) {
+      uint32_t x = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+      // NOTE(Noah): four pixels are 12 bytes, but the loads are 16 wide. the row stride bounds the overread,
+      // as the whole of every row, padding included, is known to be inside of the file.
+      const __m128i mask = _mm_load_si128((const __m128i *)l.shuffle16);
+      const __m128i fill = _mm_set1_epi32((int)l.alphaFill);
+#if defined(__AVX2__)
+      const __m256i mask8 = _mm256_broadcastsi128_si256(mask);
+      const __m256i fill8 = _mm256_set1_epi32((int)l.alphaFill);
+      for (; (x + 8) * 3 + 4 <= l.stride && x + 8 <= l.width; x += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(src + x * 3));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + x * 3 + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, mask8), fill8);
+        _mm256_storeu_si256((__m256i *)(dst + x), v);
+      }
+#endif
+      for (; (x + 4) * 3 + 4 <= l.stride && x + 4 <= l.width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x * 3));
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_shuffle_epi8(v, mask), fill));
+      }
+#endif
+      for (; x < l.width; x++) {
+        const uint8_t *p = src + x * 3;
+        dst[x] = l.alphaFill | ((uint32_t)p[2]) | ((uint32_t)p[1] << 8) | ((uint32_t)p[0] << 16);
+      }
+    }
+
+    static void bmpDecodeRow8(const uint8_t *src, uint32_t *dst, const bmp_layout_t &l) {
+      uint32_t x = 0;
+      for (; x + 4 <= l.width; x += 4) {
+        dst[x + 0] = l.palette[src[x + 0]];
+        dst[x + 1] = l.palette[src[x + 1]];
+        dst[x + 2] = l.palette[src[x + 2]];
+        dst[x + 3] = l.palette[src[x + 3]];
+      }
+      for (; x < l.width; x++) dst[x] = l.palette[src[x]];
+    }
+
+    bool decodeBMP(const void *data, size_t size, uint32_t *dst, uint32_t *widthOut, uint32_t *heightOut) {
+      bmp_layout_t l;
+      if (data == nullptr || !bmpParse((const uint8_t *)data, size, &l)) return false;
+      if (widthOut) *widthOut = l.width;
+      if (heightOut) *heightOut = l.height;
+      if (dst == nullptr) return true;
+      void (*decodeRow)(const uint8_t *, uint32_t *, const bmp_layout_t &) =
+        (l.bpp == 32) ? bmpDecodeRow32 : (l.bpp == 24) ? bmpDecodeRow24 : bmpDecodeRow8;
+      // NOTE(Noah): the image is bottom row first, as that is what the renderers upload. a top-down file is
+      // flipped here rather than in a second pass.
+      for (uint32_t y = 0; y < l.height; y++) {
+        uint32_t srcRow = l.bTopDown ? (l.height - 1 - y) : y;
+        decodeRow(l.pixels + (size_t)srcRow * l.stride, dst + (size_t)y * l.width, l);
+      }
+      return true;
+    }
+
+    loaded_image_t loadBMP(const char *path) {
+      loaded_image_t bitmap = {};
+      loaded_file_t file = vfs::mapEntireFile(path);
+      if (file.contents == nullptr) return bitmap;
+      uint32_t width, height;
+      if (decodeBMP(file.contents, file.contentSize, nullptr, &width, &height)) {
+        uint32_t *pixels = (uint32_t *)EM->pfn.alloc(width * height * sizeof(uint32_t));
+        if (pixels != nullptr) {
+          decodeBMP(file.contents, file.contentSize, pixels, &width, &height);
+          bitmap.pixelPointer = pixels;
+          bitmap.width = width;
+          bitmap.height = height;
         } else {
-          // AELoggerError("%s is %d bpp, not %d", path, header->BitsPerPixel, 32);
+          AELoggerError("loadBMP failed to alloc %ux%u pixels for %s", width, height, path);
         }
+      } else {
+        AELoggerError("could not load %s, as it is not an 8, 24 or 32 bpp .BMP", path);
       }
+      vfs::unmapFile(file);
       return bitmap;
     }
 
@@ -201,147 +457,700 @@ namespace automata_engine {
     
     void freeLoadedImage(loaded_image_t img) {
         EM->pfn.free(img.pixelPointer);
-        EM->pfn.freeLoadedFile(img.parentFile);
+        vfs::freeLoadedFile(img.parentFile);
     }
 
-    // TODO(Noah): We probably even want unit tests for this sort of thing.
-    //
-    // TODO(Noah): currently this does not work for any sort of OBJ that has no tex coords.
-    // for example the face format might look like: 375//363, and we cannot parse this.
-    //
-    // TODO(Noah): It's prob the case that we could parse OBJ files better. But, I just wanted
-    // to get something working ...
-    raw_model_t loadObj(const char *filePath) {
-        loaded_file_t loadedFile = EM->pfn.readEntireFile(filePath);
+    // NOTE(Noah): the OBJ loader below is a single forward pass over the file. there is a quick pass first that
+    // only looks at the start of each line (and counts the corners of faces) so that every array can be sized
+    // up front. the main pass then parses the numbers in place, with no tokenizing and no allocation, and
+    // triangulates faces as it goes. vertices are deduplicated at the very end by their (v, vt, vn) triple.
+    static constexpr uint32_t OBJ_ABSENT  = 0xFFFFFFFF;  // corner did not specify this attribute.
+    static constexpr uint32_t OBJ_INVALID = 0xFFFFFFFE;  // corner specified index 0, which OBJ does not allow.
+
+    struct obj_corner_t {
+      uint32_t v, vt, vn;
+    };
+
+    struct obj_counts_t {
+      uint32_t positions, uvs, normals;
+      uint32_t triangles;
+    };
+
+    static inline bool objIsLineEnd(char c) { return c == '\n' || c == '\r' || c == '#'; }
+
+    static inline const char *objNextLine(const char *p, const char *end) {
+      const char *nl = nc::str::findChar(p, end, '\n');
+      return (nl < end) ? nl + 1 : end;
+    }
+
+    static obj_counts_t objCount(const char *p, const char *end) {
+      obj_counts_t c = {};
+      while (p < end) {
+        p = nc::str::skipSpace(p, end);
+        if (end - p >= 2) {
+          if (p[0] == 'v') {
+            c.positions += nc::str::isSpace(p[1]);
+            c.uvs += (p[1] == 't');
+            c.normals += (p[1] == 'n');
+          } else if (p[0] == 'f' && nc::str::isSpace(p[1])) {
+            // a face with n corners becomes n - 2 triangles.
+            uint32_t corners = 0;
+            const char *q = p + 1;
+            while (q < end && !objIsLineEnd(*q)) {
+              q = nc::str::skipSpace(q, end);
+              if (q >= end || objIsLineEnd(*q)) break;
+              corners++;
+              while (q < end && !nc::str::isSpace(*q) && !objIsLineEnd(*q)) q++;
+            }
+            if (corners >= 3) c.triangles += corners - 2;
+            p = q;
+          }
+        }
+        p = objNextLine(p, end);
+      }
+      return c;
+    }
+
+    // parses an OBJ index and resolves it against the attribute count so far. positive indices are one-based,
+    // negative indices count back from the most recent element.
+    static const char *objParseIndex(const char *p, const char *end, uint32_t count, uint32_t *out) {
+      int64_t value;
+      p = nc::str::parseInt(p, end, &value);
+      if (value == 0) *out = OBJ_INVALID;
+      else if (value < 0) *out = (value >= -int64_t(count)) ? uint32_t(int64_t(count) + value) : OBJ_INVALID;
+      else *out = (value > 0xFFFFFFFF) ? OBJ_INVALID : uint32_t(value - 1);
+      return p;
+    }
+
+    template <uint32_t N>
+    static const char *objParseFloats(const char *p, const char *end, float *out) {
+      for (uint32_t i = 0; i < N; i++) {
+        p = nc::str::skipSpace(p, end);
+        if (p >= end || objIsLineEnd(*p)) {
+          out[i] = 0.f;
+          continue;
+        }
+        p = nc::str::parseFloat(p, end, &out[i]);
+      }
+      return p;
+    }
+
+    // the top bits come straight from the multiplies and the bottom bits have the top folded in, which is the
+    // shape ae::hash_map wants. the parallel loader buckets by the top of the bottom 32 bits.
+    static inline uint64_t objHashCorner(obj_corner_t c) {
+      uint64_t h = (uint64_t(c.v) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(c.vt) * 0xC2B2AE3D27D4EB4Full) ^
+                   (uint64_t(c.vn) * 0x165667B19E3779F9ull);
+      return h ^ (h >> 32);
+    }
+
+    static inline bool objCornerEqual(obj_corner_t a, obj_corner_t b) {
+      return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+    }
+
+    struct obj_corner_hasher_t {
+      static uint64_t hash(obj_corner_t c) { return objHashCorner(c); }
+      static bool     equal(obj_corner_t a, obj_corner_t b) { return objCornerEqual(a, b); }
+    };
+
+    // maps a (v, vt, vn) triple to the first corner or vertex that used it.
+    typedef ae::hash_map<obj_corner_t, uint32_t, obj_corner_hasher_t> obj_corner_map_t;
+
+    // where one range of the file writes its attributes and triangle corners. the bases are how many of each
+    // element come before this range in the file, which is what relative indices resolve against.
+    struct obj_parse_t {
+      float        *positions, *uvs, *normals;
+      obj_corner_t *corners;
+      obj_counts_t  base;
+      obj_counts_t  counts;  // how many of each this range holds, from objCount.
+      char          modelName[13];
+    };
+
+    static void objParseRange(const char *p, const char *end, obj_parse_t *dst) {
+      uint32_t positionCount = 0, uvCount = 0, normalCount = 0, cornerCount = 0;
+      float *positions = dst->positions + 3 * dst->base.positions;
+      float *uvs = dst->uvs + 2 * dst->base.uvs;
+      float *normals = dst->normals + 3 * dst->base.normals;
+      obj_corner_t *corners = dst->corners + 3 * dst->base.triangles;
+      while (p < end) {
+        p = nc::str::skipSpace(p, end);
+        if (end - p >= 2) {
+          if (p[0] == 'v' && nc::str::isSpace(p[1]) && positionCount < dst->counts.positions) {
+            p = objParseFloats<3>(p + 2, end, positions + 3 * positionCount++);
+          } else if (p[0] == 'v' && p[1] == 't' && uvCount < dst->counts.uvs) {
+            p = objParseFloats<2>(p + 2, end, uvs + 2 * uvCount++);
+          } else if (p[0] == 'v' && p[1] == 'n' && normalCount < dst->counts.normals) {
+            p = objParseFloats<3>(p + 2, end, normals + 3 * normalCount++);
+          } else if (p[0] == 'f' && nc::str::isSpace(p[1])) {
+            // triangulate as a fan around the first corner. this is exact for the convex polygons that
+            // exporters write out.
+            obj_corner_t first = {}, prev = {};
+            uint32_t faceCorners = 0;
+            p++;
+            while (true) {
+              p = nc::str::skipSpace(p, end);
+              if (p >= end || objIsLineEnd(*p)) break;
+              obj_corner_t c = { OBJ_INVALID, OBJ_ABSENT, OBJ_ABSENT };
+              p = objParseIndex(p, end, dst->base.positions + positionCount, &c.v);
+              if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/') p = objParseIndex(p, end, dst->base.uvs + uvCount, &c.vt);
+                if (p < end && *p == '/') p = objParseIndex(p + 1, end, dst->base.normals + normalCount, &c.vn);
+              }
+              // skip anything we could not make sense of, up to the next corner.
+              while (p < end && !nc::str::isSpace(*p) && !objIsLineEnd(*p)) p++;
+              if (faceCorners == 0) first = c;
+              else if (faceCorners >= 2 && cornerCount + 3 <= 3 * dst->counts.triangles) {
+                corners[cornerCount++] = first;
+                corners[cornerCount++] = prev;
+                corners[cornerCount++] = c;
+              }
+              prev = c;
+              faceCorners++;
+            }
+          } else if (p[0] == 'o' && nc::str::isSpace(p[1])) {
+            const char *name = nc::str::skipSpace(p + 2, end);
+            uint32_t nameLen = 0;
+            while (name + nameLen < end && nameLen < 12 && !objIsLineEnd(name[nameLen])) nameLen++;
+            memset(dst->modelName, 0, sizeof(dst->modelName));
+            memcpy(dst->modelName, name, nameLen);
+          }
+        }
+        p = objNextLine(p, end);
+      }
+      // the count pass and this pass agree on what a line is, so this only trips on a bug.
+      assert(cornerCount == 3 * dst->counts.triangles);
+    }
+
+    // a corner that is out of range drops its whole triangle.
+    static inline bool objIsTriangleValid(const obj_corner_t *tri, const obj_counts_t &totals) {
+      bool bValid = true;
+      for (uint32_t k = 0; k < 3; k++) {
+        bValid &= (tri[k].v < totals.positions) && (tri[k].vt == OBJ_ABSENT || tri[k].vt < totals.uvs) &&
+                  (tri[k].vn == OBJ_ABSENT || tri[k].vn < totals.normals);
+      }
+      return bValid;
+    }
+
+    static void objWriteVertices(
+      const obj_parse_t &parse, const obj_corner_t *uniques, uint32_t begin, uint32_t end, float *vertexData) {
+      for (uint32_t i = begin; i < end; i++) {
+        const obj_corner_t &c = uniques[i];
+        float *vert = vertexData + i * 8;
+        memcpy(vert, parse.positions + 3 * c.v, sizeof(float) * 3);
+        vert[3] = (c.vt == OBJ_ABSENT) ? 0.f : parse.uvs[2 * c.vt];
+        vert[4] = (c.vt == OBJ_ABSENT) ? 0.f : parse.uvs[2 * c.vt + 1];
+        vert[5] = (c.vn == OBJ_ABSENT) ? 0.f : parse.normals[3 * c.vn];
+        vert[6] = (c.vn == OBJ_ABSENT) ? 0.f : parse.normals[3 * c.vn + 1];
+        vert[7] = (c.vn == OBJ_ABSENT) ? 0.f : parse.normals[3 * c.vn + 2];
+      }
+    }
+
+    static void objAllocParse(obj_parse_t *parse, const obj_counts_t &totals) {
+      parse->positions = (float *)malloc(sizeof(float) * 3 * (totals.positions + 1));
+      parse->uvs = (float *)malloc(sizeof(float) * 2 * (totals.uvs + 1));
+      parse->normals = (float *)malloc(sizeof(float) * 3 * (totals.normals + 1));
+      parse->corners = (obj_corner_t *)malloc(sizeof(obj_corner_t) * 3 * (totals.triangles + 1));
+    }
+
+    static void objFreeParse(obj_parse_t *parse) {
+      free(parse->corners);
+      free(parse->normals);
+      free(parse->uvs);
+      free(parse->positions);
+    }
+
+    raw_model_t loadObjFromMemory(const char *data, size_t size) {
       // NOTE(Noah): init the rawModel to null is important because we are
       // depending on the modelName to have null-terminating char.
       raw_model_t rawModel = {};
-      if (loadedFile.contents != nullptr) {
-        float *uvData = nullptr; // stretchy buf
-        float *normalData = nullptr; // stretchy buf
-        char *line = (char *)loadedFile.contents;
-        uint32_t lineLen = 0;
-        uint32_t MAGIC_NUM = 0xFFFFFFFF;
-        struct { uint64_t key; uint32_t value; } *vertex_uv_pair_map = NULL;
-        // TODO(Noah): Current impl of this is very slow as we end up parsing all chars in the obj
-        // like three time. First we go forward to find the end line. Then we go through to delimit.
-        // and finally we parse the individual tokens to convert to an int. We could prob do better, yeah?
-        //
-        // It's interesting how this happened, too. We started with a top down approach. We abstracted first.
-        // If we just did the bottom up approach we might have came out with a faster algo, from the get go ...
-        uint32_t linesProcessed = 0;
-        while(nc::str::getLine(&line, &lineLen) != nc::str::NC_EOF) {
-          switch(line[0]) {
-            case 'o': {
-              line += 2; lineLen -= 2;
-              memcpy(rawModel.modelName, line, (lineLen > 12) ? 12 : lineLen);
-            } break;
-            case 'v': {
-              switch(line[1]) {
-                case ' ': {
-                  line += 2; lineLen -= 2;
-                  nc::str::splitFloat(line, lineLen, ' ', [&](float f, uint32_t index){
-                    if (index < 3)
-                      StretchyBufferPush(rawModel.vertexData, f);
-                  });
-                  // Ensure there are at least 5 more spaces in underlying buffer (2 for UV, 3 for normal).
-                  StretchyBuffer_MaybeGrow(rawModel.vertexData, 5);
-                  for (uint32_t i = 0; i < 5; i++) {
-                    *(uint32_t *)(rawModel.vertexData + StretchyBufferCount(rawModel.vertexData)) = MAGIC_NUM;
-                    StretchyBuffer_GetCount(rawModel.vertexData) += 1;
-                  }
-                } break;
-                case 't': {
-                  line += 3; lineLen -= 3;
-                  nc::str::splitFloat(line, lineLen, ' ', [&](float f, uint32_t index){
-                    if (index < 2)
-                      StretchyBufferPush(uvData, f);
-                  });
-                } break;
-                case 'n': {
-                  line += 3; lineLen -= 3;
-                  nc::str::splitFloat(line, lineLen, ' ', [&](float f, uint32_t index){
-                    if (index < 3)
-                      StretchyBufferPush(normalData, f);
-                  });
-                } break;
-              }
-            } break;
-            case 'f': { // face
-              line += 2; lineLen -= 2;
-              nc::str::split(line, lineLen, ' ', [&](char *token, uint32_t tokenIndex){
-                if (tokenIndex < 3) {
-                  uint32_t vIndex;
-                  uint32_t remapped_vIndex;
-                  nc::str::splitInt(token, -1, '/', [&](int num, uint32_t index) {  
-                    switch(index) {
-                      case 0: {
-                        vIndex = num - 1;
-                        remapped_vIndex = vIndex;
-                      } break;
-                      case 1: {
-                        uint32_t uvIndex = num - 1;
-                        uint64_t i_vertexUV = ((uint64_t)uvIndex << 32) | vIndex;
-                        if (stbds_hmgeti(vertex_uv_pair_map, i_vertexUV) == -1) {
-                          // not in hash map
-                          // pop hash map and get the data going
-                          if (*(uint32_t *)(rawModel.vertexData + vIndex * 8 + 3) != MAGIC_NUM) {
-                            // Dup vertex with new entry. Copy over pos and normal data.
-                            remapped_vIndex = StretchyBufferCount(rawModel.vertexData) / 8;
-                            StretchyBuffer_MaybeGrow(rawModel.vertexData, 8);
-                            StretchyBuffer_GetCount(rawModel.vertexData) += 8;
-                            memcpy((rawModel.vertexData + remapped_vIndex * 8), 
-                              (rawModel.vertexData + (vIndex) * 8), sizeof(float) * 8);
-                          }
-                          stbds_hmput(vertex_uv_pair_map, i_vertexUV, remapped_vIndex);
-                          // NOTE(Noah): each vertex is 8 floats (vertex stride),
-                          // Uv = 2 floats,
-                          // normal = 3 floats.
-                          memcpy((rawModel.vertexData + remapped_vIndex * 8 + 3), 
-                            (uvData + (uvIndex) * 2), sizeof(float) * 2);
-                        } else {
-                          // in hash map
-                          remapped_vIndex = stbds_hmget(vertex_uv_pair_map, i_vertexUV); 
-                        }
-                      } break;
-                      case 2: {
-                        memcpy((rawModel.vertexData + remapped_vIndex * 8 + 5), 
-                          (normalData + (num - 1) * 3), sizeof(float) * 3);
-                      }
-                    }
-                  });
-                  StretchyBufferPush(rawModel.indexData, remapped_vIndex);
-                }
-              });
-            } break;
-            case '#': // a comment in .obj format
-            default:
-            break;
+      if (data == nullptr || size == 0) return rawModel;
+      const char *end = data + size;
+
+      obj_parse_t parse = {};
+      parse.counts = objCount(data, end);
+      objAllocParse(&parse, parse.counts);
+      objParseRange(data, end, &parse);
+      memcpy(rawModel.modelName, parse.modelName, sizeof(rawModel.modelName));
+
+      // dedupe the corners into vertices, numbered in the order they are first used.
+      const uint32_t cornerCount = 3 * parse.counts.triangles;
+      obj_corner_map_t table;
+      table.reserve(cornerCount);
+      uint32_t *indices = (uint32_t *)malloc(sizeof(uint32_t) * (cornerCount + 1));
+      obj_corner_t *uniques = parse.corners;  // written behind the read cursor, so it can share storage.
+      uint32_t indexCount = 0, vertexCount = 0;
+      for (uint32_t t = 0; t < cornerCount; t += 3) {
+        if (!objIsTriangleValid(parse.corners + t, parse.counts)) continue;
+        for (uint32_t k = 0; k < 3; k++) {
+          obj_corner_t c = parse.corners[t + k];
+          bool bInserted;
+          indices[indexCount++] = table.findOrInsert(c, vertexCount, &bInserted);
+          if (bInserted) uniques[vertexCount++] = c;
+        }
+      }
+      table.reset();
+
+      if (vertexCount > 0) {
+        StretchyBufferInitWithCount(rawModel.vertexData, int(vertexCount * 8));
+        objWriteVertices(parse, uniques, 0, vertexCount, rawModel.vertexData);
+        StretchyBufferInitWithCount(rawModel.indexData, int(indexCount));
+        memcpy(rawModel.indexData, indices, sizeof(uint32_t) * indexCount);
+      }
+      free(indices);
+      objFreeParse(&parse);
+      return rawModel;
+    }
+
+    // NOTE(Noah): the parallel loader has to give exactly what the serial one does, whatever the thread count.
+    // so everything that affects the output is decided by the data: the file is split into fixed size chunks,
+    // and the corners into fixed size ranges. the job pool only changes who runs them.
+    //
+    // the dedupe works like so: corners are partitioned by their hash into buckets, keeping file order within
+    // each bucket. equal corners land in the same bucket, so each bucket can find, on its own, the first corner
+    // of every distinct triple. vertex ids are then a prefix sum over those first corners in file order, which
+    // is the same numbering the serial loader arrives at.
+    static constexpr uint32_t OBJ_BUCKET_BITS   = 8;
+    static constexpr uint32_t OBJ_BUCKET_COUNT  = 1 << OBJ_BUCKET_BITS;
+    static constexpr uint32_t OBJ_CORNER_GRAIN  = 3 * 16384;  // must be a multiple of 3 to keep triangles whole.
+
+    raw_model_t loadObjFromMemoryParallel(const char *data, size_t size, size_t chunkSize) {
+      raw_model_t rawModel = {};
+      if (data == nullptr || size == 0) return rawModel;
+      const char *end = data + size;
+      if (chunkSize == 0) chunkSize = OBJ_PARALLEL_CHUNK_SIZE;
+
+      // split into chunks that start at the beginning of a line.
+      uint32_t chunkCount = uint32_t((size + chunkSize - 1) / chunkSize);
+      const char **chunkStarts = (const char **)malloc(sizeof(const char *) * (chunkCount + 1));
+      chunkStarts[0] = data;
+      for (uint32_t i = 1; i < chunkCount; i++) {
+        const char *p = data + i * chunkSize;
+        chunkStarts[i] = (p <= chunkStarts[i - 1]) ? chunkStarts[i - 1] : objNextLine(p - 1, end);
+      }
+      chunkStarts[chunkCount] = end;
+
+      obj_parse_t *chunks = (obj_parse_t *)calloc(chunkCount, sizeof(obj_parse_t));
+      ae::jobs::parallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) chunks[i].counts = objCount(chunkStarts[i], chunkStarts[i + 1]);
+      });
+      obj_counts_t totals = {};
+      for (uint32_t i = 0; i < chunkCount; i++) {
+        chunks[i].base = totals;
+        totals.positions += chunks[i].counts.positions;
+        totals.uvs += chunks[i].counts.uvs;
+        totals.normals += chunks[i].counts.normals;
+        totals.triangles += chunks[i].counts.triangles;
+      }
+      obj_parse_t parse = {};
+      parse.counts = totals;
+      objAllocParse(&parse, totals);
+      ae::jobs::parallelFor(chunkCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+          chunks[i].positions = parse.positions;
+          chunks[i].uvs = parse.uvs;
+          chunks[i].normals = parse.normals;
+          chunks[i].corners = parse.corners;
+          objParseRange(chunkStarts[i], chunkStarts[i + 1], &chunks[i]);
+        }
+      });
+      for (uint32_t i = 0; i < chunkCount; i++) {
+        if (chunks[i].modelName[0]) memcpy(rawModel.modelName, chunks[i].modelName, sizeof(rawModel.modelName));
+      }
+      free(chunks);
+      free(chunkStarts);
+
+      const uint32_t cornerCount = 3 * totals.triangles;
+      const uint32_t rangeCount = (cornerCount + OBJ_CORNER_GRAIN - 1) / OBJ_CORNER_GRAIN;
+      uint32_t *bucketCounts = (uint32_t *)calloc(size_t(rangeCount) * OBJ_BUCKET_COUNT + 1, sizeof(uint32_t));
+      uint32_t *rangeIndexBase = (uint32_t *)calloc(rangeCount + 1, sizeof(uint32_t));
+      uint32_t *rangeVertexBase = (uint32_t *)calloc(rangeCount + 1, sizeof(uint32_t));
+      uint32_t *bucketed = (uint32_t *)malloc(sizeof(uint32_t) * (cornerCount + 1));
+      uint32_t *firstCorner = (uint32_t *)malloc(sizeof(uint32_t) * (cornerCount + 1));
+      auto cornerBucket = [](obj_corner_t c) { return uint32_t(objHashCorner(c)) >> (32 - OBJ_BUCKET_BITS); };
+      auto rangeEnd = [&](uint32_t r) { return (r + 1 < rangeCount) ? (r + 1) * OBJ_CORNER_GRAIN : cornerCount; };
+
+      // pass 1: count the valid corners of each range per bucket. invalid triangles are marked by pointing
+      // their first corner nowhere.
+      ae::jobs::parallelFor(rangeCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; r++) {
+          uint32_t *counts = bucketCounts + size_t(r) * OBJ_BUCKET_COUNT;
+          for (uint32_t t = r * OBJ_CORNER_GRAIN; t < rangeEnd(r); t += 3) {
+            bool bValid = objIsTriangleValid(parse.corners + t, totals);
+            for (uint32_t k = 0; k < 3; k++) {
+              firstCorner[t + k] = bValid ? 0 : OBJ_ABSENT;
+              if (bValid) counts[cornerBucket(parse.corners[t + k])]++;
+            }
+            rangeIndexBase[r] += bValid ? 3 : 0;
           }
-          line += lineLen;
-          linesProcessed++;
         }
-        //AELoggerLog("loadObj: %d lines processed", linesProcessed);
-        StretchyBufferFree(uvData);
-        StretchyBufferFree(normalData);
-        stbds_hmfree(vertex_uv_pair_map);
-        // debug scan on .obj        
-#if defined(_DEBUG)
-        for (uint32_t i = 0; i < StretchyBufferCount(rawModel.vertexData) / 8; i++) {
-          float uvX = rawModel.vertexData[i * 8 + 3];
-          float uvY = rawModel.vertexData[i * 8 + 4];
-          if (uvX < 0.0f || uvX > 1.0f) {
-            //AELoggerWarn("uvX out of bounds: %f", uvX);
+      });
+      // turn the counts into where each range writes within each bucket, bucket major.
+      uint32_t *bucketStarts = (uint32_t *)malloc(sizeof(uint32_t) * (OBJ_BUCKET_COUNT + 1));
+      uint32_t running = 0;
+      for (uint32_t b = 0; b < OBJ_BUCKET_COUNT; b++) {
+        bucketStarts[b] = running;
+        for (uint32_t r = 0; r < rangeCount; r++) {
+          uint32_t count = bucketCounts[size_t(r) * OBJ_BUCKET_COUNT + b];
+          bucketCounts[size_t(r) * OBJ_BUCKET_COUNT + b] = running;
+          running += count;
+        }
+      }
+      bucketStarts[OBJ_BUCKET_COUNT] = running;
+      const uint32_t validCornerCount = running;
+
+      // pass 2: scatter the corner indices into their buckets.
+      ae::jobs::parallelFor(rangeCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; r++) {
+          uint32_t *offsets = bucketCounts + size_t(r) * OBJ_BUCKET_COUNT;
+          for (uint32_t i = r * OBJ_CORNER_GRAIN; i < rangeEnd(r); i++) {
+            if (firstCorner[i] != OBJ_ABSENT) bucketed[offsets[cornerBucket(parse.corners[i])]++] = i;
           }
-          if (uvY < 0.0f || uvY > 1.0f) {
-            //AELoggerWarn("uvY out of bounds: %f", uvY);
+        }
+      });
+
+      // pass 3: within each bucket, point every corner at the first corner with the same triple.
+      ae::jobs::parallelFor(OBJ_BUCKET_COUNT, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t b = begin; b < end; b++) {
+          obj_corner_map_t table;
+          table.reserve(bucketStarts[b + 1] - bucketStarts[b]);
+          for (uint32_t j = bucketStarts[b]; j < bucketStarts[b + 1]; j++) {
+            uint32_t i = bucketed[j];
+            firstCorner[i] = table.findOrInsert(parse.corners[i], i);
           }
         }
-#endif
+      });
+
+      // pass 4: count the first corners per range, then prefix sum to get vertex ids. the bucketed array is
+      // no longer needed, so it holds the vertex id of each first corner.
+      uint32_t *vertexIds = bucketed;
+      ae::jobs::parallelFor(rangeCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; r++) {
+          for (uint32_t i = r * OBJ_CORNER_GRAIN; i < rangeEnd(r); i++) rangeVertexBase[r] += (firstCorner[i] == i);
+        }
+      });
+      uint32_t vertexCount = 0, indexCount = 0;
+      for (uint32_t r = 0; r < rangeCount; r++) {
+        uint32_t vertices = rangeVertexBase[r], indices = rangeIndexBase[r];
+        rangeVertexBase[r] = vertexCount;
+        rangeIndexBase[r] = indexCount;
+        vertexCount += vertices;
+        indexCount += indices;
+      }
+      assert(indexCount == validCornerCount);
+
+      if (vertexCount > 0) {
+        StretchyBufferInitWithCount(rawModel.vertexData, int(vertexCount * 8));
+        StretchyBufferInitWithCount(rawModel.indexData, int(indexCount));
+        obj_corner_t *uniques = (obj_corner_t *)malloc(sizeof(obj_corner_t) * vertexCount);
+        ae::jobs::parallelFor(rangeCount, 1, [&](uint32_t begin, uint32_t end) {
+          for (uint32_t r = begin; r < end; r++) {
+            uint32_t vertex = rangeVertexBase[r];
+            for (uint32_t i = r * OBJ_CORNER_GRAIN; i < rangeEnd(r); i++) {
+              if (firstCorner[i] != i) continue;
+              uniques[vertex] = parse.corners[i];
+              vertexIds[i] = vertex++;
+            }
+          }
+        });
+        // pass 5: write the indices. a first corner may be in an earlier range, hence the separate pass.
+        ae::jobs::parallelFor(rangeCount, 1, [&](uint32_t begin, uint32_t end) {
+          for (uint32_t r = begin; r < end; r++) {
+            uint32_t index = rangeIndexBase[r];
+            for (uint32_t i = r * OBJ_CORNER_GRAIN; i < rangeEnd(r); i++) {
+              if (firstCorner[i] != OBJ_ABSENT) rawModel.indexData[index++] = vertexIds[firstCorner[i]];
+            }
+          }
+        });
+        const uint32_t vertexGrain = 32768;
+        ae::jobs::parallelFor(vertexCount, vertexGrain, [&](uint32_t begin, uint32_t end) {
+          objWriteVertices(parse, uniques, begin, end, rawModel.vertexData);
+        });
+        free(uniques);
+      }
+
+      free(firstCorner);
+      free(bucketed);
+      free(rangeVertexBase);
+      free(rangeIndexBase);
+      free(bucketStarts);
+      free(bucketCounts);
+      objFreeParse(&parse);
+      return rawModel;
+    }
+
+    raw_model_t loadObj(const char *filePath, bool bParallel) {
+      loaded_file_t loadedFile = vfs::readEntireFile(filePath);
+      raw_model_t rawModel = {};
+      if (loadedFile.contents != nullptr) {
+        const char *data = (const char *)loadedFile.contents;
+        size_t size = size_t(loadedFile.contentSize);
+        rawModel = bParallel ? loadObjFromMemoryParallel(data, size) : loadObjFromMemory(data, size);
+        vfs::freeLoadedFile(loadedFile);
       } else {
         //AELoggerError("unable to open %s", filePath);
-      }     
+      }
       return rawModel;
     }
+
+    // NOTE(Noah): a .aemesh file is this header, then the vertex blob, then the index blob, then optionally the
+    // position only blob. each blob begins on a 64 byte boundary so that, once the file is mapped (which is page
+    // aligned), the data can be handed straight to the GPU or to SIMD code without any copy. everything is little
+    // endian.
+    static constexpr uint32_t AEMESH_MAGIC = RIFF_CODE('A', 'E', 'M', 'S');
+    static constexpr uint32_t AEMESH_BLOB_ALIGNMENT = 64;
+
+    struct aemesh_header_t {
+      uint32_t      magic;
+      uint32_t      version;
+      uint32_t      headerSize;
+      uint32_t      fileSize;
+      uint32_t      vertexCount;
+      uint32_t      indexCount;
+      uint32_t      vertexStride;
+      uint32_t      indexSize;
+      uint32_t      attribCount;
+      uint32_t      positionStride; // 0 when there is no position only blob.
+      mesh_attrib_t attribs[8];
+      float         boundsMin[3];
+      float         boundsMax[3];
+      float         positionScale[3];
+      float         positionOffset[3];
+      float         uvScale[2];
+      float         uvOffset[2];
+      uint64_t      vertexOffset;
+      uint64_t      indexOffset;
+      uint64_t      positionStreamOffset;
+      char          modelName[16];
+      uint32_t      reserved[4];
+    };
+    static_assert(sizeof(aemesh_header_t) == 192, "the .aemesh header must not change size within a version");
+
+    static inline uint64_t aemeshAlign(uint64_t offset) {
+      return (offset + AEMESH_BLOB_ALIGNMENT - 1) & ~uint64_t(AEMESH_BLOB_ALIGNMENT - 1);
+    }
+
+    // the byte size of an attribute in format. normals take 2 components when they are octahedral encoded.
+    static uint32_t aemeshAttribSize(uint8_t semantic, uint8_t format, uint8_t *componentCountOut) {
+      uint8_t componentCount = (semantic == MESH_ATTRIB_UV) ? 2 : 3;
+      if (semantic == MESH_ATTRIB_NORMAL && format != MESH_FORMAT_FLOAT32) componentCount = 2;
+      *componentCountOut = componentCount;
+      return componentCount * meshFormatSize(format);
+    }
+
+    // encode the attribute at floatOffset within each raw_model_t vertex into the packed format, then scatter it to
+    // dst, which has the given stride. dst2, if any, gets a second copy.
+    static void aemeshEncodeAttrib(const float *vertexData, uint32_t vertexCount, uint32_t floatOffset,
+      const mesh_attrib_t &attrib, const float *offset, const float *scale, uint8_t *dst, uint32_t stride,
+      uint8_t *dst2, uint32_t stride2) {
+      const uint32_t n = (attrib.semantic == MESH_ATTRIB_NORMAL) ? 3 : attrib.componentCount;
+      const uint32_t size = attrib.componentCount * meshFormatSize(attrib.format);
+      float gathered[QUANTIZE_BATCH * 3];
+      uint8_t packed[QUANTIZE_BATCH * 12];
+      for (uint32_t base = 0; base < vertexCount; base += QUANTIZE_BATCH) {
+        uint32_t count = math::min(QUANTIZE_BATCH, vertexCount - base);
+        for (uint32_t i = 0; i < count; i++) {
+          memcpy(gathered + i * n, vertexData + size_t(base + i) * 8 + floatOffset, n * sizeof(float));
+        }
+        if (attrib.semantic == MESH_ATTRIB_NORMAL && attrib.componentCount == 2) {
+          if (attrib.format == MESH_FORMAT_SNORM16) encodeOctahedral16(gathered, (int16_t *)packed, count);
+          else encodeOctahedral8(gathered, (int8_t *)packed, count);
+        } else if (attrib.format == MESH_FORMAT_FLOAT16) {
+          floatToHalf(gathered, (uint16_t *)packed, count * n);
+        } else if (attrib.format == MESH_FORMAT_UNORM16) {
+          quantizeUnorm16(gathered, (uint16_t *)packed, count, n, offset, scale);
+        } else {
+          memcpy(packed, gathered, count * size);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+          memcpy(dst + size_t(base + i) * stride + attrib.offset, packed + i * size, size);
+          if (dst2) memcpy(dst2 + size_t(base + i) * stride2, packed + i * size, size);
+        }
+      }
+    }
+
+    void *packMesh(raw_model_t model, uint32_t *sizeOut, mesh_quantization_t quantization) {
+      const uint32_t vertexCount = StretchyBufferCount(model.vertexData) / 8;
+      const uint32_t indexCount = StretchyBufferCount(model.indexData);
+      const mesh_quantization_t &q = quantization;
+      bool bValid = (q.positionFormat == MESH_FORMAT_FLOAT32 || q.positionFormat == MESH_FORMAT_FLOAT16 ||
+                     q.positionFormat == MESH_FORMAT_UNORM16) &&
+                    (q.uvFormat == MESH_FORMAT_FLOAT32 || q.uvFormat == MESH_FORMAT_FLOAT16 ||
+                     q.uvFormat == MESH_FORMAT_UNORM16) &&
+                    (q.normalFormat == MESH_FORMAT_FLOAT32 || q.normalFormat == MESH_FORMAT_SNORM16 ||
+                     q.normalFormat == MESH_FORMAT_SNORM8);
+      if (!bValid) return nullptr;
+
+      aemesh_header_t header = {};
+      header.magic = AEMESH_MAGIC;
+      header.version = AEMESH_VERSION;
+      header.headerSize = sizeof(aemesh_header_t);
+      header.vertexCount = vertexCount;
+      header.indexCount = indexCount;
+      // 16 bit indices can address vertices 0 through 65535.
+      header.indexSize = (q.bIndex16 && vertexCount <= 0x10000) ? sizeof(uint16_t) : sizeof(uint32_t);
+      header.attribCount = 3;
+      const uint8_t semantics[3] = { MESH_ATTRIB_POSITION, MESH_ATTRIB_UV, MESH_ATTRIB_NORMAL };
+      const uint8_t formats[3] = { q.positionFormat, q.uvFormat, q.normalFormat };
+      uint32_t offset = 0, positionSize = 0;
+      for (uint32_t i = 0; i < 3; i++) {
+        mesh_attrib_t &attrib = header.attribs[i];
+        attrib.semantic = semantics[i];
+        attrib.format = formats[i];
+        attrib.offset = uint8_t(offset);
+        uint32_t size = aemeshAttribSize(attrib.semantic, attrib.format, &attrib.componentCount);
+        if (attrib.semantic == MESH_ATTRIB_POSITION) positionSize = size;
+        offset += size;
+      }
+      // keep every vertex 4 byte aligned.
+      header.vertexStride = (offset + 3) & ~3u;
+      header.positionStride = q.bPositionStream ? positionSize : 0;
+
+      float uvMin[2] = {}, uvMax[2] = {};
+      for (uint32_t k = 0; k < 3; k++) {
+        header.boundsMin[k] = vertexCount ? INFINITY : 0.f;
+        header.boundsMax[k] = vertexCount ? -INFINITY : 0.f;
+      }
+      for (uint32_t k = 0; k < 2; k++) {
+        uvMin[k] = vertexCount ? INFINITY : 0.f;
+        uvMax[k] = vertexCount ? -INFINITY : 0.f;
+      }
+      for (uint32_t i = 0; i < vertexCount; i++) {
+        for (uint32_t k = 0; k < 3; k++) {
+          float f = model.vertexData[i * 8 + k];
+          header.boundsMin[k] = (f < header.boundsMin[k]) ? f : header.boundsMin[k];
+          header.boundsMax[k] = (f > header.boundsMax[k]) ? f : header.boundsMax[k];
+        }
+        for (uint32_t k = 0; k < 2; k++) {
+          float f = model.vertexData[i * 8 + 3 + k];
+          uvMin[k] = (f < uvMin[k]) ? f : uvMin[k];
+          uvMax[k] = (f > uvMax[k]) ? f : uvMax[k];
+        }
+      }
+      for (uint32_t k = 0; k < 3; k++) {
+        bool bUnorm = q.positionFormat == MESH_FORMAT_UNORM16;
+        header.positionOffset[k] = bUnorm ? header.boundsMin[k] : 0.f;
+        header.positionScale[k] = bUnorm ? header.boundsMax[k] - header.boundsMin[k] : 1.f;
+      }
+      for (uint32_t k = 0; k < 2; k++) {
+        bool bUnorm = q.uvFormat == MESH_FORMAT_UNORM16;
+        header.uvOffset[k] = bUnorm ? uvMin[k] : 0.f;
+        header.uvScale[k] = bUnorm ? uvMax[k] - uvMin[k] : 1.f;
+      }
+
+      header.vertexOffset = aemeshAlign(sizeof(aemesh_header_t));
+      header.indexOffset = aemeshAlign(header.vertexOffset + uint64_t(vertexCount) * header.vertexStride);
+      uint64_t fileSize = header.indexOffset + uint64_t(indexCount) * header.indexSize;
+      if (q.bPositionStream) {
+        header.positionStreamOffset = aemeshAlign(fileSize);
+        fileSize = header.positionStreamOffset + uint64_t(vertexCount) * header.positionStride;
+      }
+      if (fileSize > 0xFFFFFFFF) return nullptr;
+      header.fileSize = uint32_t(fileSize);
+      memcpy(header.modelName, model.modelName, sizeof(model.modelName));
+
+      uint8_t *file = (uint8_t *)calloc(1, size_t(fileSize));
+      if (file == nullptr) return nullptr;
+      memcpy(file, &header, sizeof(header));
+      uint8_t *vertices = file + header.vertexOffset;
+      uint8_t *positions = q.bPositionStream ? file + header.positionStreamOffset : nullptr;
+      aemeshEncodeAttrib(model.vertexData, vertexCount, 0, header.attribs[0], header.positionOffset,
+        header.positionScale, vertices, header.vertexStride, positions, header.positionStride);
+      aemeshEncodeAttrib(model.vertexData, vertexCount, 3, header.attribs[1], header.uvOffset, header.uvScale,
+        vertices, header.vertexStride, nullptr, 0);
+      aemeshEncodeAttrib(model.vertexData, vertexCount, 5, header.attribs[2], nullptr, nullptr, vertices,
+        header.vertexStride, nullptr, 0);
+      if (header.indexSize == sizeof(uint16_t)) {
+        uint16_t *indices = (uint16_t *)(file + header.indexOffset);
+        for (uint32_t i = 0; i < indexCount; i++) indices[i] = uint16_t(model.indexData[i]);
+      } else if (indexCount) {
+        memcpy(file + header.indexOffset, model.indexData, size_t(indexCount) * header.indexSize);
+      }
+      *sizeOut = header.fileSize;
+      return file;
+    }
+
+    void *packMesh(raw_model_t model, uint32_t *sizeOut) {
+      return packMesh(model, sizeOut, mesh_quantization_t());
+    }
+
+    bool writeMesh(const char *filePath, raw_model_t model) {
+      return writeMesh(filePath, model, mesh_quantization_t());
+    }
+
+    bool writeMesh(const char *filePath, raw_model_t model, mesh_quantization_t quantization) {
+      uint32_t size;
+      void *file = packMesh(model, &size, quantization);
+      if (file == nullptr) return false;
+      bool bResult = EM->pfn.writeEntireFile(filePath, file, size);
+      free(file);
+      return bResult;
+    }
+
+    loaded_mesh_t loadMeshFromMemory(const void *data, size_t size) {
+      loaded_mesh_t mesh = {};
+      if (data == nullptr || size < sizeof(aemesh_header_t)) return mesh;
+      const aemesh_header_t *header = (const aemesh_header_t *)data;
+      // check everything that the pointers below depend on, so that a bad file can never read out of bounds.
+      // blobs are checked against what is left after their offset, as offset + size could wrap.
+      auto fits = [&](uint64_t offset, uint64_t bytes) {
+        return offset <= header->fileSize && bytes <= header->fileSize - offset;
+      };
+      bool bValid = header->magic == AEMESH_MAGIC && header->version == AEMESH_VERSION &&
+                    header->headerSize == sizeof(aemesh_header_t) && header->fileSize <= size &&
+                    header->attribCount <= 8 && (header->indexSize == 2 || header->indexSize == 4) &&
+                    header->vertexStride > 0 && (header->vertexOffset % AEMESH_BLOB_ALIGNMENT) == 0 &&
+                    (header->indexOffset % AEMESH_BLOB_ALIGNMENT) == 0 &&
+                    (header->positionStreamOffset % AEMESH_BLOB_ALIGNMENT) == 0 &&
+                    fits(header->vertexOffset, uint64_t(header->vertexCount) * header->vertexStride) &&
+                    fits(header->indexOffset, uint64_t(header->indexCount) * header->indexSize) &&
+                    fits(header->positionStreamOffset, uint64_t(header->vertexCount) * header->positionStride);
+      for (uint32_t i = 0; bValid && i < header->attribCount; i++) {
+        const mesh_attrib_t &a = header->attribs[i];
+        // octahedral normals are the only attribute stored with fewer components than they decode to.
+        bool bOctahedral = a.semantic == MESH_ATTRIB_NORMAL && a.componentCount == 2;
+        bValid = a.semantic < MESH_ATTRIB_COUNT && a.format < MESH_FORMAT_COUNT && a.componentCount >= 1 &&
+                 a.componentCount <= 4 &&
+                 a.offset + a.componentCount * meshFormatSize(a.format) <= header->vertexStride &&
+                 (!bOctahedral || a.format == MESH_FORMAT_SNORM16 || a.format == MESH_FORMAT_SNORM8);
+      }
+      if (!bValid) return mesh;
+
+      memcpy(mesh.modelName, header->modelName, sizeof(mesh.modelName) - 1);
+      mesh.layout.stride = header->vertexStride;
+      mesh.layout.attribCount = header->attribCount;
+      memcpy(mesh.layout.attribs, header->attribs, sizeof(header->attribs));
+      mesh.vertexData = (const uint8_t *)data + header->vertexOffset;
+      mesh.vertexCount = header->vertexCount;
+      mesh.indexData = (const uint8_t *)data + header->indexOffset;
+      mesh.indexCount = header->indexCount;
+      mesh.indexSize = header->indexSize;
+      if (header->positionStride) {
+        mesh.positionData = (const uint8_t *)data + header->positionStreamOffset;
+        mesh.positionStride = header->positionStride;
+      }
+      memcpy(mesh.positionScale, header->positionScale, sizeof(mesh.positionScale));
+      memcpy(mesh.positionOffset, header->positionOffset, sizeof(mesh.positionOffset));
+      memcpy(mesh.uvScale, header->uvScale, sizeof(mesh.uvScale));
+      memcpy(mesh.uvOffset, header->uvOffset, sizeof(mesh.uvOffset));
+      mesh.bounds = math::aabb_t::fromLine(math::vec3_t(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]),
+        math::vec3_t(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]));
+      return mesh;
+    }
+
+    loaded_mesh_t loadMesh(const char *filePath) {
+      loaded_file_t file = vfs::mapEntireFile(filePath);
+      loaded_mesh_t mesh = loadMeshFromMemory(file.contents, size_t(file.contentSize));
+      if (mesh.vertexData == nullptr) {
+        //AELoggerError("%s is not a valid .aemesh", filePath);
+        vfs::unmapFile(file);
+        return mesh;
+      }
+      mesh.parentFile = file;
+      return mesh;
+    }
+
+    void freeMesh(loaded_mesh_t mesh) {
+      if (mesh.parentFile.contents) vfs::unmapFile(mesh.parentFile);
+    }
   }
-}
\ No newline at end of file
+}
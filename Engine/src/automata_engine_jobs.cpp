@@ -0,0 +1,162 @@
+#include <automata_engine.hpp>
+
+#include <thread>
+#include <condition_variable>
+
+// NOTE: the job pool is deliberately simple. there is a single queue guarded by a mutex,
+// which is plenty for the coarse-grained jobs that the library hands out (BVH subtrees,
+// parse chunks, image decodes, ...). if that ever shows up in a profile, we can go to
+// per-worker deques with stealing.
+
+namespace automata_engine {
+    namespace jobs {
+
+        struct job_t {
+            std::function<void()> fn;
+            job_counter_t        *counter;
+        };
+
+        static constexpr uint32_t MAX_WORKERS    = 64;
+        static constexpr uint32_t JOB_QUEUE_SIZE = 4096;  // must be pow2.
+
+        // NOTE: there is deliberately no destructor that joins the workers. in the game DLL it would run under the
+        // loader lock in FreeLibrary, which each exiting worker needs too. _close must be called explicitly.
+        struct job_pool_t {
+            std::mutex              mutex;
+            std::condition_variable cv;
+            std::thread             workers[MAX_WORKERS];
+            uint32_t                workerCount = 0;
+            bool                    bStarted    = false;
+            bool                    bRunning    = false;
+
+            // ring buffer of jobs.
+            job_t    queue[JOB_QUEUE_SIZE];
+            uint32_t head = 0;  // next to pop.
+            uint32_t tail = 0;  // next to push.
+        };
+        static job_pool_t s_pool;
+
+        static void runJob(job_t &job)
+        {
+            job.fn();
+            if (job.counter) job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        // caller must hold the lock.
+        static bool tryPopLocked(job_t *jobOut)
+        {
+            if (s_pool.head == s_pool.tail) return false;
+            job_t &slot = s_pool.queue[s_pool.head & (JOB_QUEUE_SIZE - 1)];
+            *jobOut     = std::move(slot);
+            slot.fn     = nullptr;
+            s_pool.head++;
+            return true;
+        }
+
+        static void workerMain()
+        {
+            for (;;) {
+                job_t job;
+                {
+                    std::unique_lock<std::mutex> lock(s_pool.mutex);
+                    s_pool.cv.wait(lock, [] { return !s_pool.bRunning || s_pool.head != s_pool.tail; });
+                    if (!tryPopLocked(&job)) {
+                        // only way to get here is the pool is shutting down and the queue is drained.
+                        return;
+                    }
+                }
+                runJob(job);
+            }
+        }
+
+        // caller must hold the lock.
+        static void startLocked()
+        {
+            if (s_pool.bStarted) return;
+            uint32_t hwThreads = std::thread::hardware_concurrency();
+            // leave one core for the thread that is submitting.
+            s_pool.workerCount = math::min(math::max(hwThreads, 2u) - 1u, MAX_WORKERS);
+            s_pool.bRunning    = true;
+            s_pool.bStarted    = true;
+            for (uint32_t i = 0; i < s_pool.workerCount; i++) { s_pool.workers[i] = std::thread(workerMain); }
+        }
+
+        uint32_t getWorkerCount()
+        {
+            std::lock_guard<std::mutex> lock(s_pool.mutex);
+            startLocked();
+            return s_pool.workerCount;
+        }
+
+        void submit(job_counter_t *counter, std::function<void()> fn)
+        {
+            if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+            job_t job = {std::move(fn), counter};
+            {
+                std::lock_guard<std::mutex> lock(s_pool.mutex);
+                startLocked();
+                if (s_pool.tail - s_pool.head < JOB_QUEUE_SIZE) {
+                    s_pool.queue[s_pool.tail & (JOB_QUEUE_SIZE - 1)] = std::move(job);
+                    s_pool.tail++;
+                    s_pool.cv.notify_one();
+                    return;
+                }
+            }
+            // the queue is full. rather than block, just do the work here.
+            runJob(job);
+        }
+
+        void wait(job_counter_t *counter)
+        {
+            while (counter->pending.load(std::memory_order_acquire) != 0) {
+                job_t job;
+                bool  bGotJob;
+                {
+                    std::lock_guard<std::mutex> lock(s_pool.mutex);
+                    bGotJob = tryPopLocked(&job);
+                }
+                if (bGotJob) {
+                    runJob(job);
+                } else {
+                    // the jobs that we are waiting on are in-flight on other workers.
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void parallelFor(uint32_t count, uint32_t grainSize, std::function<void(uint32_t, uint32_t)> fn)
+        {
+            if (count == 0) return;
+            if (grainSize == 0) grainSize = 1;
+            if (count <= grainSize) {
+                fn(0, count);
+                return;
+            }
+            job_counter_t counter;
+            // keep the first range for this thread so that it does useful work right away.
+            // NOTE: begin + grainSize can wrap when count is near UINT32_MAX, where count - begin cannot.
+            for (uint32_t begin = grainSize, end; begin < count; begin = end) {
+                end = begin + math::min(grainSize, count - begin);
+                submit(&counter, [=, &fn] { fn(begin, end); });
+            }
+            fn(0, grainSize);
+            wait(&counter);
+        }
+
+        void _close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(s_pool.mutex);
+                if (!s_pool.bStarted) return;
+                s_pool.bRunning = false;
+            }
+            s_pool.cv.notify_all();
+            for (uint32_t i = 0; i < s_pool.workerCount; i++) {
+                if (s_pool.workers[i].joinable()) s_pool.workers[i].join();
+            }
+            s_pool.workerCount = 0;
+            s_pool.bStarted    = false;
+        }
+
+    }  // namespace jobs
+}  // namespace automata_engine
@@ -0,0 +1,949 @@
+#include <automata_engine.hpp>
+
+#include <float.h>
+#include <string.h>
+
+#include <algorithm>
+
+// NOTE(Noah): the optimizer works on the raw_model_t vertex format (8 floats per vertex) and plain
+// uint32_t index lists. the usual order of operations is weld -> vertex cache -> (overdraw) -> fetch,
+// which is what optimizeMesh does. the vertex cache pass is Tipsify (Sander, Nehab and Barczak 2007),
+// which runs in linear time and gets close to the Forsyth results at a fraction of the cost.
+
+namespace automata_engine {
+    namespace io {
+
+        static constexpr uint32_t MESHOPT_VERTEX_FLOATS = 8;
+        static constexpr uint32_t MESHOPT_INVALID       = 0xFFFFFFFF;
+
+        static inline uint32_t meshoptHashVertex(const float *v)
+        {
+            uint32_t words[MESHOPT_VERTEX_FLOATS];
+            memcpy(words, v, sizeof(words));
+            uint32_t h = 2166136261u;
+            for (uint32_t i = 0; i < MESHOPT_VERTEX_FLOATS; i++) h = (h ^ words[i]) * 16777619u;
+            return h ^ (h >> 15);
+        }
+
+        uint32_t weldVertices(raw_model_t *model)
+        {
+            const uint32_t vertexCount = StretchyBufferCount(model->vertexData) / MESHOPT_VERTEX_FLOATS;
+            const uint32_t indexCount  = StretchyBufferCount(model->indexData);
+            if (vertexCount == 0) return 0;
+
+            uint32_t capacity = 16;
+            while (capacity < 2 * vertexCount) capacity <<= 1;
+            uint32_t *table = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+            uint32_t *remap = (uint32_t *)malloc(sizeof(uint32_t) * vertexCount);
+            memset(table, 0xFF, sizeof(uint32_t) * capacity);
+
+            // vertices are equal when they are bitwise equal. the surviving copy of each vertex is moved down to
+            // the next free spot, which is never ahead of the one being read.
+            float   *verts       = model->vertexData;
+            uint32_t uniqueCount = 0;
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                const float *v = verts + i * MESHOPT_VERTEX_FLOATS;
+                uint32_t     s = meshoptHashVertex(v) & (capacity - 1);
+                while (table[s] != MESHOPT_INVALID &&
+                       memcmp(verts + table[s] * MESHOPT_VERTEX_FLOATS, v, sizeof(float) * MESHOPT_VERTEX_FLOATS)) {
+                    s = (s + 1) & (capacity - 1);
+                }
+                if (table[s] == MESHOPT_INVALID) {
+                    table[s] = uniqueCount;
+                    memmove(verts + uniqueCount * MESHOPT_VERTEX_FLOATS, v, sizeof(float) * MESHOPT_VERTEX_FLOATS);
+                    uniqueCount++;
+                }
+                remap[i] = table[s];
+            }
+            for (uint32_t i = 0; i < indexCount; i++) model->indexData[i] = remap[model->indexData[i]];
+            StretchyBuffer_GetCount(model->vertexData) = int(uniqueCount * MESHOPT_VERTEX_FLOATS);
+
+            free(remap);
+            free(table);
+            return uniqueCount;
+        }
+
+        // vertex -> triangle adjacency in CSR form.
+        struct meshopt_adjacency_t {
+            uint32_t *offsets;    // vertexCount + 1
+            uint32_t *triangles;  // indexCount
+        };
+
+        static meshopt_adjacency_t meshoptBuildAdjacency(
+            const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount)
+        {
+            meshopt_adjacency_t adj;
+            adj.offsets   = (uint32_t *)calloc(vertexCount + 1, sizeof(uint32_t));
+            adj.triangles = (uint32_t *)malloc(sizeof(uint32_t) * (indexCount + 1));
+            for (uint32_t i = 0; i < indexCount; i++) adj.offsets[indices[i] + 1]++;
+            for (uint32_t v = 0; v < vertexCount; v++) adj.offsets[v + 1] += adj.offsets[v];
+            uint32_t *cursor = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            memcpy(cursor, adj.offsets, sizeof(uint32_t) * (vertexCount + 1));
+            for (uint32_t i = 0; i < indexCount; i++) adj.triangles[cursor[indices[i]]++] = i / 3;
+            free(cursor);
+            return adj;
+        }
+
+        static void meshoptFreeAdjacency(meshopt_adjacency_t adj)
+        {
+            free(adj.triangles);
+            free(adj.offsets);
+        }
+
+        // runs Tipsify. when clusterStartsOut is given, it receives the triangle index at which each cluster
+        // begins, where a new cluster begins whenever fanning had to restart away from the cache. these are the
+        // points where the triangle order may be changed without hurting the cache much.
+        static uint32_t meshoptTipsify(uint32_t *indices,
+            uint32_t                            indexCount,
+            uint32_t                            vertexCount,
+            uint32_t                            cacheSize,
+            uint32_t                           *clusterStartsOut)
+        {
+            const uint32_t      triangleCount = indexCount / 3;
+            meshopt_adjacency_t adj           = meshoptBuildAdjacency(indices, indexCount, vertexCount);
+
+            uint32_t *liveCount = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            uint32_t *cacheTime = (uint32_t *)calloc(vertexCount + 1, sizeof(uint32_t));
+            uint8_t  *emitted   = (uint8_t *)calloc(triangleCount + 1, 1);
+            uint32_t *deadEnd   = (uint32_t *)malloc(sizeof(uint32_t) * (indexCount + 1));
+            uint32_t *result    = (uint32_t *)malloc(sizeof(uint32_t) * (indexCount + 1));
+            // at most the three vertices of each triangle around the fanning vertex are candidates.
+            uint32_t *candidates = (uint32_t *)malloc(sizeof(uint32_t) * (indexCount + 1));
+            for (uint32_t v = 0; v < vertexCount; v++) liveCount[v] = adj.offsets[v + 1] - adj.offsets[v];
+
+            uint32_t deadEndCount = 0, resultCount = 0, clusterCount = 0;
+            uint32_t timestamp = cacheSize + 1;
+            uint32_t cursor    = 0;  // where to scan on from for a vertex with live triangles.
+            bool     bRestart  = true;
+
+            auto skipDeadEnd = [&]() -> uint32_t {
+                while (deadEndCount > 0) {
+                    uint32_t d = deadEnd[--deadEndCount];
+                    if (liveCount[d] > 0) {
+                        bRestart = (timestamp - cacheTime[d] > cacheSize);
+                        return d;
+                    }
+                }
+                bRestart = true;
+                while (cursor < vertexCount) {
+                    if (liveCount[cursor] > 0) return cursor++;
+                    cursor++;
+                }
+                return MESHOPT_INVALID;
+            };
+
+            uint32_t fanning = skipDeadEnd();
+            while (fanning != MESHOPT_INVALID) {
+                if (bRestart && clusterStartsOut) clusterStartsOut[clusterCount] = resultCount / 3;
+                clusterCount += bRestart;
+                bRestart = false;
+
+                uint32_t candidateCount = 0;
+                for (uint32_t a = adj.offsets[fanning]; a < adj.offsets[fanning + 1]; a++) {
+                    uint32_t t = adj.triangles[a];
+                    if (emitted[t]) continue;
+                    emitted[t] = 1;
+                    for (uint32_t k = 0; k < 3; k++) {
+                        uint32_t v                  = indices[t * 3 + k];
+                        result[resultCount++]       = v;
+                        deadEnd[deadEndCount++]     = v;
+                        candidates[candidateCount++] = v;
+                        liveCount[v]--;
+                        if (timestamp - cacheTime[v] > cacheSize) cacheTime[v] = timestamp++;
+                    }
+                }
+
+                // pick the candidate that will still be in the cache after its remaining triangles are emitted,
+                // preferring the one that entered the cache earliest.
+                uint32_t next = MESHOPT_INVALID;
+                int32_t  best = -1;
+                for (uint32_t c = 0; c < candidateCount; c++) {
+                    uint32_t v = candidates[c];
+                    if (liveCount[v] == 0) continue;
+                    int32_t priority = 0;
+                    if (timestamp - cacheTime[v] + 2 * liveCount[v] <= cacheSize) {
+                        priority = int32_t(timestamp - cacheTime[v]);
+                    }
+                    if (priority > best) {
+                        best = priority;
+                        next = v;
+                    }
+                }
+                fanning = (next != MESHOPT_INVALID) ? next : skipDeadEnd();
+            }
+            assert(resultCount == triangleCount * 3);
+            memcpy(indices, result, sizeof(uint32_t) * resultCount);
+
+            free(candidates);
+            free(result);
+            free(deadEnd);
+            free(emitted);
+            free(cacheTime);
+            free(liveCount);
+            meshoptFreeAdjacency(adj);
+            return clusterCount;
+        }
+
+        void optimizeVertexCache(uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            assert(indexCount % 3 == 0);
+            if (indexCount == 0) return;
+            meshoptTipsify(indices, indexCount, vertexCount, cacheSize, nullptr);
+        }
+
+        void optimizeOverdraw(uint32_t *indices,
+            uint32_t                    indexCount,
+            const float                *vertexData,
+            uint32_t                    vertexCount,
+            uint32_t                    cacheSize)
+        {
+            assert(indexCount % 3 == 0);
+            const uint32_t triangleCount = indexCount / 3;
+            if (triangleCount == 0) return;
+            uint32_t *clusterStarts = (uint32_t *)malloc(sizeof(uint32_t) * (triangleCount + 1));
+            uint32_t  clusterCount  = meshoptTipsify(indices, indexCount, vertexCount, cacheSize, clusterStarts);
+            clusterStarts[clusterCount] = triangleCount;
+
+            // NOTE(Noah): draw the clusters that face outwards first. those tend to occlude the rest of the mesh
+            // from most views, so the fragments behind them fail the depth test early. the score is how far the
+            // cluster sits along its own normal, measured from the center of the mesh.
+            float meshCenter[3] = {};
+            float meshArea      = 0.f;
+            struct cluster_t {
+                float    score;
+                uint32_t index;
+            } *clusters = (cluster_t *)malloc(sizeof(cluster_t) * clusterCount);
+            float *clusterData = (float *)calloc(size_t(clusterCount) * 7, sizeof(float));  // centroid, normal, area.
+            for (uint32_t c = 0; c < clusterCount; c++) {
+                float *data = clusterData + c * 7;
+                for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+                    const float *p0 = vertexData + indices[t * 3 + 0] * MESHOPT_VERTEX_FLOATS;
+                    const float *p1 = vertexData + indices[t * 3 + 1] * MESHOPT_VERTEX_FLOATS;
+                    const float *p2 = vertexData + indices[t * 3 + 2] * MESHOPT_VERTEX_FLOATS;
+                    float e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                    float e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                    // the cross product is the normal scaled by twice the area, which weights everything by area.
+                    float n[3]  = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2],
+                         e0[0] * e1[1] - e0[1] * e1[0]};
+                    float area  = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                    for (uint32_t k = 0; k < 3; k++) {
+                        data[k] += (p0[k] + p1[k] + p2[k]) * area / 3.f;
+                        data[3 + k] += n[k];
+                    }
+                    data[6] += area;
+                }
+                for (uint32_t k = 0; k < 3; k++) meshCenter[k] += data[k];
+                meshArea += data[6];
+            }
+            for (uint32_t k = 0; k < 3; k++) meshCenter[k] = (meshArea > 0.f) ? meshCenter[k] / meshArea : 0.f;
+            for (uint32_t c = 0; c < clusterCount; c++) {
+                const float *data = clusterData + c * 7;
+                float        score = 0.f;
+                if (data[6] > 0.f) {
+                    float len = sqrtf(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+                    for (uint32_t k = 0; k < 3; k++) {
+                        float d = data[k] / data[6] - meshCenter[k];
+                        score += (len > 0.f) ? d * data[3 + k] / len : 0.f;
+                    }
+                }
+                clusters[c] = {score, c};
+            }
+            std::stable_sort(clusters, clusters + clusterCount,
+                [](const cluster_t &a, const cluster_t &b) { return a.score > b.score; });
+
+            uint32_t *result = (uint32_t *)malloc(sizeof(uint32_t) * indexCount);
+            uint32_t  written = 0;
+            for (uint32_t c = 0; c < clusterCount; c++) {
+                uint32_t first = clusterStarts[clusters[c].index], last = clusterStarts[clusters[c].index + 1];
+                memcpy(result + written, indices + first * 3, sizeof(uint32_t) * 3 * (last - first));
+                written += 3 * (last - first);
+            }
+            memcpy(indices, result, sizeof(uint32_t) * indexCount);
+
+            free(result);
+            free(clusterData);
+            free(clusters);
+            free(clusterStarts);
+        }
+
+        uint32_t optimizeVertexFetch(raw_model_t *model)
+        {
+            const uint32_t vertexCount = StretchyBufferCount(model->vertexData) / MESHOPT_VERTEX_FLOATS;
+            const uint32_t indexCount  = StretchyBufferCount(model->indexData);
+            if (vertexCount == 0) return 0;
+
+            uint32_t *remap = (uint32_t *)malloc(sizeof(uint32_t) * vertexCount);
+            memset(remap, 0xFF, sizeof(uint32_t) * vertexCount);
+            float   *newVerts  = (float *)malloc(sizeof(float) * MESHOPT_VERTEX_FLOATS * vertexCount);
+            uint32_t usedCount = 0;
+            for (uint32_t i = 0; i < indexCount; i++) {
+                uint32_t v = model->indexData[i];
+                if (remap[v] == MESHOPT_INVALID) {
+                    memcpy(newVerts + usedCount * MESHOPT_VERTEX_FLOATS, model->vertexData + v * MESHOPT_VERTEX_FLOATS,
+                        sizeof(float) * MESHOPT_VERTEX_FLOATS);
+                    remap[v] = usedCount++;
+                }
+                model->indexData[i] = remap[v];
+            }
+            memcpy(model->vertexData, newVerts, sizeof(float) * MESHOPT_VERTEX_FLOATS * usedCount);
+            StretchyBuffer_GetCount(model->vertexData) = int(usedCount * MESHOPT_VERTEX_FLOATS);
+
+            free(newVerts);
+            free(remap);
+            return usedCount;
+        }
+
+        void optimizeMesh(raw_model_t *model, bool bOptimizeOverdraw)
+        {
+            uint32_t vertexCount = weldVertices(model);
+            uint32_t indexCount  = StretchyBufferCount(model->indexData);
+            if (bOptimizeOverdraw) {
+                optimizeOverdraw(model->indexData, indexCount, model->vertexData, vertexCount);
+            } else {
+                optimizeVertexCache(model->indexData, indexCount, vertexCount);
+            }
+            optimizeVertexFetch(model);
+        }
+
+        vertex_cache_stats_t analyzeVertexCache(
+            const uint32_t *indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            vertex_cache_stats_t stats = {};
+            if (indexCount < 3 || vertexCount == 0) return stats;
+            // a FIFO cache, like the post-transform caches of real GPUs. a vertex is in the cache when it was
+            // last inserted less than cacheSize insertions ago.
+            uint32_t *insertedAt = (uint32_t *)malloc(sizeof(uint32_t) * vertexCount);
+            uint8_t  *used       = (uint8_t *)calloc(vertexCount, 1);
+            uint32_t  insertions = 0, usedCount = 0;
+            for (uint32_t i = 0; i < indexCount; i++) {
+                uint32_t v = indices[i];
+                if (!used[v]) {
+                    used[v] = 1;
+                    usedCount++;
+                } else if (insertions - insertedAt[v] < cacheSize) {
+                    continue;
+                }
+                insertedAt[v] = insertions++;
+            }
+            stats.transformedVertices = insertions;
+            stats.acmr = float(insertions) / float(indexCount / 3);
+            stats.atvr = float(insertions) / float(usedCount);
+            free(used);
+            free(insertedAt);
+            return stats;
+        }
+
+        // NOTE(Noah): meshlets are built with a greedy scan over the triangles in their current order. so run the
+        // vertex cache pass first: it leaves triangles that share vertices next to each other, which is exactly
+        // what makes a meshlet fill up its triangle budget before its vertex budget.
+        static void meshoptFinishMeshlet(meshlet_set_t *set, const float *vertexData)
+        {
+            meshlet_t &m = set->meshlets[set->meshletCount++];
+
+            // bounding sphere around the center of the bounding box.
+            float bmin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, bmax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (uint32_t i = 0; i < m.vertexCount; i++) {
+                const float *p = vertexData + set->vertices[m.vertexOffset + i] * MESHOPT_VERTEX_FLOATS;
+                for (uint32_t k = 0; k < 3; k++) {
+                    bmin[k] = (p[k] < bmin[k]) ? p[k] : bmin[k];
+                    bmax[k] = (p[k] > bmax[k]) ? p[k] : bmax[k];
+                }
+            }
+            float radius2 = 0.f;
+            for (uint32_t k = 0; k < 3; k++) m.center[k] = (bmin[k] + bmax[k]) * 0.5f;
+            for (uint32_t i = 0; i < m.vertexCount; i++) {
+                const float *p  = vertexData + set->vertices[m.vertexOffset + i] * MESHOPT_VERTEX_FLOATS;
+                float        dx = p[0] - m.center[0], dy = p[1] - m.center[1], dz = p[2] - m.center[2];
+                float        d2 = dx * dx + dy * dy + dz * dz;
+                radius2         = (d2 > radius2) ? d2 : radius2;
+            }
+            m.radius = sqrtf(radius2);
+
+            // normal cone. the axis is the average of the unit triangle normals, and the cone must contain every
+            // one of those normals. if it cannot be made narrower than a half space, it never culls.
+            const uint8_t *tris    = set->triangles + m.triangleOffset * 3;
+            float          axis[3] = {};
+            auto triNormal = [&](uint32_t t, float *n) {
+                const float *p0 = vertexData + set->vertices[m.vertexOffset + tris[t * 3 + 0]] * MESHOPT_VERTEX_FLOATS;
+                const float *p1 = vertexData + set->vertices[m.vertexOffset + tris[t * 3 + 1]] * MESHOPT_VERTEX_FLOATS;
+                const float *p2 = vertexData + set->vertices[m.vertexOffset + tris[t * 3 + 2]] * MESHOPT_VERTEX_FLOATS;
+                float e0[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                float e1[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                n[0]        = e0[1] * e1[2] - e0[2] * e1[1];
+                n[1]        = e0[2] * e1[0] - e0[0] * e1[2];
+                n[2]        = e0[0] * e1[1] - e0[1] * e1[0];
+                float len   = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (len == 0.f) return false;
+                for (uint32_t k = 0; k < 3; k++) n[k] /= len;
+                return true;
+            };
+            for (uint32_t t = 0; t < m.triangleCount; t++) {
+                float n[3];
+                if (!triNormal(t, n)) continue;
+                for (uint32_t k = 0; k < 3; k++) axis[k] += n[k];
+            }
+            float axisLen = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            float minDot  = 1.f;
+            if (axisLen > 0.f) {
+                for (uint32_t k = 0; k < 3; k++) axis[k] /= axisLen;
+                for (uint32_t t = 0; t < m.triangleCount; t++) {
+                    float n[3];
+                    if (!triNormal(t, n)) continue;
+                    float d = n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2];
+                    minDot  = (d < minDot) ? d : minDot;
+                }
+            }
+            for (uint32_t k = 0; k < 3; k++) m.coneAxis[k] = axis[k];
+            // cutoff is the sine of the widest angle between the axis and a normal.
+            m.coneCutoff = (axisLen == 0.f || minDot <= 0.f) ? 1.f : sqrtf(1.f - minDot * minDot);
+        }
+
+        // NOTE(Noah): the local indices are wider while building than the byte they are stored in, so that a meshlet
+        // of 256 vertices still leaves a value free to mark a vertex that is not in it.
+        static constexpr uint16_t MESHOPT_NOT_LOCAL = 0xFFFF;
+
+        meshlet_set_t buildMeshlets(raw_model_t model, uint32_t maxVertices, uint32_t maxTriangles)
+        {
+            assert(maxVertices >= 3 && maxVertices <= 256 && maxTriangles >= 1);
+            const uint32_t vertexCount   = StretchyBufferCount(model.vertexData) / MESHOPT_VERTEX_FLOATS;
+            const uint32_t indexCount    = StretchyBufferCount(model.indexData);
+            const uint32_t triangleCount = indexCount / 3;
+
+            meshlet_set_t set = {};
+            if (triangleCount == 0) return set;
+            set.meshlets  = (meshlet_t *)malloc(sizeof(meshlet_t) * triangleCount);
+            set.vertices  = (uint32_t *)malloc(sizeof(uint32_t) * indexCount);
+            set.triangles = (uint8_t *)malloc(indexCount);
+
+            // the local index of each vertex in the meshlet being built, or MESHOPT_NOT_LOCAL.
+            uint16_t *local = (uint16_t *)malloc(sizeof(uint16_t) * vertexCount);
+            memset(local, 0xFF, sizeof(uint16_t) * vertexCount);
+            meshlet_t current = {};
+            for (uint32_t t = 0; t < triangleCount; t++) {
+                const uint32_t *tri      = model.indexData + t * 3;
+                uint32_t        newVerts = 0;
+                for (uint32_t k = 0; k < 3; k++) {
+                    bool bDuplicate = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+                    newVerts += (local[tri[k]] == MESHOPT_NOT_LOCAL) && !bDuplicate;
+                }
+                if (current.vertexCount + newVerts > maxVertices || current.triangleCount + 1 > maxTriangles) {
+                    set.meshlets[set.meshletCount] = current;
+                    meshoptFinishMeshlet(&set, model.vertexData);
+                    for (uint32_t i = 0; i < current.vertexCount; i++) {
+                        local[set.vertices[current.vertexOffset + i]] = MESHOPT_NOT_LOCAL;
+                    }
+                    current                = {};
+                    current.vertexOffset   = set.vertexCount;
+                    current.triangleOffset = set.triangleCount;
+                }
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (local[tri[k]] == MESHOPT_NOT_LOCAL) {
+                        local[tri[k]]                    = uint16_t(current.vertexCount++);
+                        set.vertices[set.vertexCount++] = tri[k];
+                    }
+                    set.triangles[set.triangleCount * 3 + k] = uint8_t(local[tri[k]]);
+                }
+                set.triangleCount++;
+                current.triangleCount++;
+            }
+            set.meshlets[set.meshletCount] = current;
+            meshoptFinishMeshlet(&set, model.vertexData);
+            free(local);
+            return set;
+        }
+
+        void freeMeshlets(meshlet_set_t set)
+        {
+            free(set.triangles);
+            free(set.vertices);
+            free(set.meshlets);
+        }
+
+        bool isMeshletBackfacing(const meshlet_t &meshlet, math::vec3_t cameraPos)
+        {
+            float d[3] = {meshlet.center[0] - cameraPos.x, meshlet.center[1] - cameraPos.y,
+                meshlet.center[2] - cameraPos.z};
+            float dist = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            float dp   = d[0] * meshlet.coneAxis[0] + d[1] * meshlet.coneAxis[1] + d[2] * meshlet.coneAxis[2];
+            return dp >= meshlet.coneCutoff * dist + meshlet.radius;
+        }
+
+        // NOTE(Noah): the simplifier is a quadric error metric simplifier (Garland and Heckbert 1997) that only does
+        // half edge collapses, i.e. a vertex is always collapsed onto one of its neighbours. so no new vertices are
+        // made, and every LOD indexes into the original vertex buffer. it runs in passes: each pass finds the
+        // cheapest collapse of every vertex, sorts them, and does as many as it can that do not touch each other.
+        // that keeps the whole thing close to O(n log n), which is what lets it run on large meshes at import time.
+        //
+        // attribute seams are found by welding the vertices by position. a position shared by exactly two vertices
+        // whose open edges pair up is a seam, and a seam vertex may only slide along the seam, with its twin on the
+        // other side sliding with it. open borders, and any position more tangled than that, are locked.
+        enum meshopt_vertex_kind_t : uint8_t {
+            MESHOPT_KIND_MANIFOLD = 0,
+            MESHOPT_KIND_SEAM,
+            MESHOPT_KIND_LOCKED
+        };
+
+        // marks a vertex with more than one open edge in some direction.
+        static constexpr uint32_t MESHOPT_MULTIPLE = 0xFFFFFFFE;
+
+        // how much a change of UV or normal costs, relative to a squared distance in a mesh scaled to a unit cube.
+        static constexpr float MESHOPT_ATTRIBUTE_WEIGHT = 0.01f;
+
+        // the plane quadric, Q(p) = p^T A p + 2 b.p + c, summed over the planes with weights w.
+        struct meshopt_quadric_t {
+            float a00, a11, a22, a01, a02, a12;
+            float b0, b1, b2, c;
+            float w;
+        };
+
+        static inline void meshoptQuadricAdd(meshopt_quadric_t &q, const meshopt_quadric_t &r)
+        {
+            q.a00 += r.a00, q.a11 += r.a11, q.a22 += r.a22, q.a01 += r.a01, q.a02 += r.a02, q.a12 += r.a12;
+            q.b0 += r.b0, q.b1 += r.b1, q.b2 += r.b2, q.c += r.c, q.w += r.w;
+        }
+
+        // the weighted mean squared distance of p from the planes of q.
+        static inline float meshoptQuadricError(const meshopt_quadric_t &q, const float *p)
+        {
+            float x = p[0], y = p[1], z = p[2];
+            float e = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+                      2.f * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z + q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+            return (q.w > 0.f) ? fabsf(e) / q.w : 0.f;
+        }
+
+        // a set of directed edges, keyed by (a << 32) | b.
+        struct meshopt_edge_table_t {
+            uint64_t *keys;
+            uint32_t  mask;
+        };
+
+        static inline uint32_t meshoptHashEdge(uint64_t key) { return uint32_t((key * 0x9E3779B97F4A7C15ull) >> 32); }
+
+        static meshopt_edge_table_t meshoptBuildEdgeTable(
+            const uint32_t *indices, uint32_t indexCount, const uint32_t *remap)
+        {
+            meshopt_edge_table_t table;
+            uint32_t             capacity = 16;
+            while (capacity < 2 * indexCount) capacity <<= 1;
+            table.mask = capacity - 1;
+            table.keys = (uint64_t *)malloc(sizeof(uint64_t) * capacity);
+            memset(table.keys, 0xFF, sizeof(uint64_t) * capacity);
+            for (uint32_t i = 0; i < indexCount; i++) {
+                uint32_t a   = remap[indices[i]];
+                uint32_t b   = remap[indices[(i % 3 == 2) ? i - 2 : i + 1]];
+                uint64_t key = (uint64_t(a) << 32) | b;
+                uint32_t s   = meshoptHashEdge(key) & table.mask;
+                while (table.keys[s] != ~0ull && table.keys[s] != key) s = (s + 1) & table.mask;
+                table.keys[s] = key;
+            }
+            return table;
+        }
+
+        static inline bool meshoptHasEdge(const meshopt_edge_table_t &table, uint32_t a, uint32_t b)
+        {
+            uint64_t key = (uint64_t(a) << 32) | b;
+            for (uint32_t s = meshoptHashEdge(key) & table.mask;; s = (s + 1) & table.mask) {
+                if (table.keys[s] == key) return true;
+                if (table.keys[s] == ~0ull) return false;
+            }
+        }
+
+        // the unnormalized normal of the triangle, i.e. twice its area in length.
+        static inline void meshoptTriangleNormal(const float *p0, const float *p1, const float *p2, float *n)
+        {
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            n[0]        = e1[1] * e2[2] - e1[2] * e2[1];
+            n[1]        = e1[2] * e2[0] - e1[0] * e2[2];
+            n[2]        = e1[0] * e2[1] - e1[1] * e2[0];
+        }
+
+        struct meshopt_simplifier_t {
+            const float       *vertexData;
+            uint32_t           vertexCount;
+            float             *positions;  // scaled into the unit cube.
+            float              scale;      // takes a distance in the unit cube back to the units of the mesh.
+            uint32_t          *posRemap;   // the first vertex with the same position.
+            uint32_t          *wedge;      // the next vertex with the same position, as a cycle.
+            uint32_t          *openOut;    // b for the open edge (v, b), i.e. the edge with no (b, v).
+            uint32_t          *openIn;     // a for the open edge (a, v).
+            uint8_t           *kind;
+            meshopt_quadric_t *quadrics;   // by posRemap.
+            uint32_t          *collapse;   // where each vertex went, or itself.
+            uint32_t          *indices;
+            uint32_t           indexCount;
+            float              error;  // the largest collapse error so far, squared, in the unit cube.
+        };
+
+        static meshopt_simplifier_t meshoptInitSimplifier(const float *vertexData, uint32_t vertexCount,
+            const uint32_t *indices, uint32_t indexCount)
+        {
+            meshopt_simplifier_t s = {};
+            s.vertexData  = vertexData;
+            s.vertexCount = vertexCount;
+            s.indexCount  = indexCount;
+            s.indices     = (uint32_t *)malloc(sizeof(uint32_t) * (indexCount + 1));
+            memcpy(s.indices, indices, sizeof(uint32_t) * indexCount);
+            s.positions = (float *)malloc(sizeof(float) * 3 * (vertexCount + 1));
+            s.posRemap  = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            s.wedge     = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            s.openOut   = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            s.openIn    = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            s.kind      = (uint8_t *)malloc(vertexCount + 1);
+            s.quadrics  = (meshopt_quadric_t *)calloc(vertexCount + 1, sizeof(meshopt_quadric_t));
+            s.collapse  = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+
+            // scale into the unit cube, so that the error is relative to the size of the mesh and so comparable
+            // with the change in UVs and normals.
+            float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    lo[k] = fminf(lo[k], vertexData[v * MESHOPT_VERTEX_FLOATS + k]);
+                    hi[k] = fmaxf(hi[k], vertexData[v * MESHOPT_VERTEX_FLOATS + k]);
+                }
+            }
+            s.scale = fmaxf(fmaxf(hi[0] - lo[0], hi[1] - lo[1]), hi[2] - lo[2]);
+            if (!(s.scale > 0.f)) s.scale = 1.f;
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    s.positions[v * 3 + k] = (vertexData[v * MESHOPT_VERTEX_FLOATS + k] - lo[k]) / s.scale;
+                }
+            }
+
+            // weld by position.
+            uint32_t capacity = 16;
+            while (capacity < 2 * vertexCount) capacity <<= 1;
+            uint32_t *table = (uint32_t *)malloc(sizeof(uint32_t) * capacity);
+            memset(table, 0xFF, sizeof(uint32_t) * capacity);
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                const float *p = vertexData + v * MESHOPT_VERTEX_FLOATS;
+                uint32_t     words[3];
+                memcpy(words, p, sizeof(words));
+                uint32_t h = ((words[0] * 73856093u) ^ (words[1] * 19349663u) ^ (words[2] * 83492791u));
+                uint32_t i = (h ^ (h >> 16)) & (capacity - 1);
+                while (table[i] != MESHOPT_INVALID &&
+                       memcmp(vertexData + table[i] * MESHOPT_VERTEX_FLOATS, p, sizeof(float) * 3)) {
+                    i = (i + 1) & (capacity - 1);
+                }
+                if (table[i] == MESHOPT_INVALID) table[i] = v;
+                uint32_t r    = table[i];
+                s.posRemap[v] = r;
+                s.wedge[v]    = v;
+                if (r != v) {
+                    s.wedge[v] = s.wedge[r];
+                    s.wedge[r] = v;
+                }
+                s.collapse[v] = v;
+                s.openOut[v] = s.openIn[v] = MESHOPT_INVALID;
+            }
+            free(table);
+
+            // find the open edges, both by vertex and by position. an edge that is open by vertex but not by
+            // position runs along a seam.
+            uint32_t *identity = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            for (uint32_t v = 0; v < vertexCount; v++) identity[v] = v;
+            meshopt_edge_table_t vertexEdges   = meshoptBuildEdgeTable(indices, indexCount, identity);
+            meshopt_edge_table_t positionEdges = meshoptBuildEdgeTable(indices, indexCount, s.posRemap);
+            uint8_t             *border        = (uint8_t *)calloc(vertexCount + 1, 1);
+            for (uint32_t i = 0; i < indexCount; i++) {
+                uint32_t a = indices[i], b = indices[(i % 3 == 2) ? i - 2 : i + 1];
+                if (!meshoptHasEdge(vertexEdges, b, a)) {
+                    s.openOut[a] = (s.openOut[a] == MESHOPT_INVALID || s.openOut[a] == b) ? b : MESHOPT_MULTIPLE;
+                    s.openIn[b]  = (s.openIn[b] == MESHOPT_INVALID || s.openIn[b] == a) ? a : MESHOPT_MULTIPLE;
+                }
+                if (!meshoptHasEdge(positionEdges, s.posRemap[b], s.posRemap[a])) {
+                    border[s.posRemap[a]] = border[s.posRemap[b]] = 1;
+                }
+            }
+            free(positionEdges.keys);
+            free(vertexEdges.keys);
+            free(identity);
+
+            auto isSingle = [](uint32_t e) { return e < MESHOPT_MULTIPLE; };
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                uint32_t twin = s.wedge[v];
+                if (border[s.posRemap[v]]) {
+                    s.kind[v] = MESHOPT_KIND_LOCKED;
+                } else if (twin == v) {
+                    bool bClosed = s.openOut[v] == MESHOPT_INVALID && s.openIn[v] == MESHOPT_INVALID;
+                    s.kind[v]    = bClosed ? MESHOPT_KIND_MANIFOLD : MESHOPT_KIND_LOCKED;
+                } else {
+                    bool bSeam = s.wedge[twin] == v && isSingle(s.openOut[v]) && isSingle(s.openIn[v]) &&
+                                 isSingle(s.openOut[twin]) && isSingle(s.openIn[twin]) && s.openOut[v] != s.openIn[v];
+                    s.kind[v]  = bSeam ? MESHOPT_KIND_SEAM : MESHOPT_KIND_LOCKED;
+                }
+            }
+            free(border);
+
+            // every triangle adds its plane to its corners, weighted by its area.
+            for (uint32_t i = 0; i < indexCount; i += 3) {
+                const float *p0 = s.positions + indices[i] * 3;
+                const float *p1 = s.positions + indices[i + 1] * 3;
+                const float *p2 = s.positions + indices[i + 2] * 3;
+                float        n[3];
+                meshoptTriangleNormal(p0, p1, p2, n);
+                float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (len == 0.f) continue;
+                n[0] /= len, n[1] /= len, n[2] /= len;
+                float             d    = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+                float             area = len * 0.5f;
+                meshopt_quadric_t q    = {area * n[0] * n[0], area * n[1] * n[1], area * n[2] * n[2],
+                       area * n[0] * n[1], area * n[0] * n[2], area * n[1] * n[2], area * d * n[0], area * d * n[1],
+                       area * d * n[2], area * d * d, area};
+                for (uint32_t k = 0; k < 3; k++) meshoptQuadricAdd(s.quadrics[s.posRemap[indices[i + k]]], q);
+            }
+            return s;
+        }
+
+        static void meshoptFreeSimplifier(meshopt_simplifier_t &s)
+        {
+            free(s.indices);
+            free(s.positions);
+            free(s.posRemap);
+            free(s.wedge);
+            free(s.openOut);
+            free(s.openIn);
+            free(s.kind);
+            free(s.quadrics);
+            free(s.collapse);
+        }
+
+        static inline float meshoptAttributeError(const meshopt_simplifier_t &s, uint32_t v, uint32_t t)
+        {
+            const float *a = s.vertexData + v * MESHOPT_VERTEX_FLOATS + 3;
+            const float *b = s.vertexData + t * MESHOPT_VERTEX_FLOATS + 3;
+            float        e = 0.f;
+            for (uint32_t k = 0; k < 5; k++) e += (a[k] - b[k]) * (a[k] - b[k]);
+            return e;
+        }
+
+        // the twin of t on the other side of the seam, for the collapse of seam vertex v onto t.
+        static inline uint32_t meshoptSeamTwinTarget(const meshopt_simplifier_t &s, uint32_t v, uint32_t t)
+        {
+            uint32_t twin   = s.wedge[v];
+            uint32_t target = (t == s.openOut[v]) ? s.openIn[twin] : s.openOut[twin];
+            bool     bValid = target < MESHOPT_MULTIPLE && s.posRemap[target] == s.posRemap[t] && target != twin;
+            return bValid ? target : MESHOPT_INVALID;
+        }
+
+        static inline float meshoptGeometricError(const meshopt_simplifier_t &s, uint32_t v, uint32_t t)
+        {
+            meshopt_quadric_t q = s.quadrics[s.posRemap[v]];
+            meshoptQuadricAdd(q, s.quadrics[s.posRemap[t]]);
+            return meshoptQuadricError(q, s.positions + t * 3);
+        }
+
+        // the cost of collapsing v onto t, or FLT_MAX if that is not allowed.
+        static float meshoptCollapseCost(const meshopt_simplifier_t &s, uint32_t v, uint32_t t)
+        {
+            if (s.posRemap[v] == s.posRemap[t]) return FLT_MAX;
+            float attrib = meshoptAttributeError(s, v, t);
+            if (s.kind[v] == MESHOPT_KIND_SEAM) {
+                if (t != s.openOut[v] && t != s.openIn[v]) return FLT_MAX;
+                uint32_t twinTarget = meshoptSeamTwinTarget(s, v, t);
+                if (twinTarget == MESHOPT_INVALID) return FLT_MAX;
+                attrib = 0.5f * (attrib + meshoptAttributeError(s, s.wedge[v], twinTarget));
+            } else if (s.kind[v] != MESHOPT_KIND_MANIFOLD) {
+                return FLT_MAX;
+            }
+            return meshoptGeometricError(s, v, t) + MESHOPT_ATTRIBUTE_WEIGHT * attrib;
+        }
+
+        // true when moving v onto t would fold over one of the triangles around v.
+        static bool meshoptHasFlips(
+            const meshopt_simplifier_t &s, const meshopt_adjacency_t &adj, uint32_t v, uint32_t t)
+        {
+            const float *pt = s.positions + t * 3;
+            for (uint32_t j = adj.offsets[v]; j < adj.offsets[v + 1]; j++) {
+                const uint32_t *tri = s.indices + adj.triangles[j] * 3;
+                if (tri[0] == t || tri[1] == t || tri[2] == t) continue;  // this one is removed by the collapse.
+                // rotate so that v comes first.
+                uint32_t     k  = (tri[0] == v) ? 0 : ((tri[1] == v) ? 1 : 2);
+                const float *p0 = s.positions + v * 3;
+                const float *p1 = s.positions + tri[(k + 1) % 3] * 3;
+                const float *p2 = s.positions + tri[(k + 2) % 3] * 3;
+                float        n0[3], n1[3];
+                meshoptTriangleNormal(p0, p1, p2, n0);
+                meshoptTriangleNormal(pt, p1, p2, n1);
+                float d     = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+                float l0    = n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2];
+                float l1    = n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2];
+                // more than about 75 degrees of turn counts as a flip, as does a triangle that ends up degenerate.
+                if (d <= 0.f || d * d < 0.0625f * l0 * l1) return true;
+            }
+            return false;
+        }
+
+        // after v collapses onto t along its open edge, the neighbour of v on the seam now leads to t.
+        static void meshoptRelinkSeam(meshopt_simplifier_t &s, uint32_t v, uint32_t t)
+        {
+            if (t == s.openOut[v]) {
+                uint32_t u = s.openIn[v];
+                if (u < MESHOPT_MULTIPLE) s.openOut[u] = t;
+                s.openIn[t] = u;
+            } else {
+                uint32_t u = s.openOut[v];
+                if (u < MESHOPT_MULTIPLE) s.openIn[u] = t;
+                s.openOut[t] = u;
+            }
+        }
+
+        struct meshopt_candidate_t {
+            float    cost;
+            uint32_t v;
+            uint32_t t;
+        };
+
+        // simplify until there are at most targetIndexCount indices, or the next collapse would cost more than
+        // maxError (squared, in the unit cube).
+        static void meshoptSimplify(meshopt_simplifier_t &s, uint32_t targetIndexCount, float maxError)
+        {
+            const uint32_t       vertexCount = s.vertexCount;
+            float               *bestCost    = (float *)malloc(sizeof(float) * (vertexCount + 1));
+            uint32_t            *bestTarget  = (uint32_t *)malloc(sizeof(uint32_t) * (vertexCount + 1));
+            uint8_t             *locked      = (uint8_t *)malloc(vertexCount + 1);
+            meshopt_candidate_t *candidates =
+                (meshopt_candidate_t *)malloc(sizeof(meshopt_candidate_t) * (vertexCount + 1));
+
+            while (s.indexCount > targetIndexCount) {
+                const uint32_t neededTriangles = (s.indexCount - targetIndexCount + 2) / 3;
+                for (uint32_t v = 0; v < vertexCount; v++) bestCost[v] = FLT_MAX;
+                for (uint32_t i = 0; i < s.indexCount; i++) {
+                    uint32_t a = s.indices[i], b = s.indices[(i % 3 == 2) ? i - 2 : i + 1];
+                    float    ab = meshoptCollapseCost(s, a, b), ba = meshoptCollapseCost(s, b, a);
+                    if (ab < bestCost[a]) bestCost[a] = ab, bestTarget[a] = b;
+                    if (ba < bestCost[b]) bestCost[b] = ba, bestTarget[b] = a;
+                }
+                uint32_t candidateCount = 0;
+                for (uint32_t v = 0; v < vertexCount; v++) {
+                    if (bestCost[v] < FLT_MAX && bestCost[v] <= maxError) {
+                        candidates[candidateCount++] = {bestCost[v], v, bestTarget[v]};
+                    }
+                }
+                if (candidateCount == 0) break;
+                std::sort(candidates, candidates + candidateCount,
+                    [](const meshopt_candidate_t &a, const meshopt_candidate_t &b) { return a.cost < b.cost; });
+
+                meshopt_adjacency_t adj = meshoptBuildAdjacency(s.indices, s.indexCount, vertexCount);
+                memset(locked, 0, vertexCount);
+                uint32_t removed = 0, collapses = 0;
+                for (uint32_t c = 0; c < candidateCount && removed < neededTriangles; c++) {
+                    uint32_t v = candidates[c].v, t = candidates[c].t;
+                    uint32_t twin = MESHOPT_INVALID, twinTarget = MESHOPT_INVALID;
+                    if (locked[v] || locked[t]) continue;
+                    if (s.kind[v] == MESHOPT_KIND_SEAM) {
+                        twin       = s.wedge[v];
+                        twinTarget = meshoptSeamTwinTarget(s, v, t);
+                        if (locked[twin] || locked[twinTarget]) continue;
+                        if (meshoptHasFlips(s, adj, twin, twinTarget)) continue;
+                    }
+                    if (meshoptHasFlips(s, adj, v, t)) continue;
+
+                    s.error = fmaxf(s.error, meshoptGeometricError(s, v, t));
+                    meshoptQuadricAdd(s.quadrics[s.posRemap[t]], s.quadrics[s.posRemap[v]]);
+                    s.collapse[v] = t;
+                    collapses++;
+                    // lock everything around the collapse for the rest of the pass, so that the flip test above
+                    // stays true. the triangles that had both ends of the edge are the ones that go away.
+                    uint32_t pairs[2][2] = {{v, t}, {twin, twinTarget}};
+                    for (uint32_t p = 0; p < ((twin != MESHOPT_INVALID) ? 2u : 1u); p++) {
+                        uint32_t from = pairs[p][0], to = pairs[p][1];
+                        for (uint32_t j = adj.offsets[from]; j < adj.offsets[from + 1]; j++) {
+                            const uint32_t *tri = s.indices + adj.triangles[j] * 3;
+                            locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+                            removed += (tri[0] == to || tri[1] == to || tri[2] == to);
+                        }
+                        locked[to] = 1;
+                    }
+                    if (twin != MESHOPT_INVALID) {
+                        s.collapse[twin] = twinTarget;
+                        meshoptRelinkSeam(s, v, t);
+                        meshoptRelinkSeam(s, twin, twinTarget);
+                    }
+                }
+                meshoptFreeAdjacency(adj);
+                if (collapses == 0) break;
+
+                // apply the collapses and drop the triangles that became degenerate.
+                uint32_t written = 0;
+                for (uint32_t i = 0; i < s.indexCount; i += 3) {
+                    uint32_t a = s.collapse[s.indices[i]];
+                    uint32_t b = s.collapse[s.indices[i + 1]];
+                    uint32_t c = s.collapse[s.indices[i + 2]];
+                    if (a == b || b == c || a == c) continue;
+                    s.indices[written++] = a, s.indices[written++] = b, s.indices[written++] = c;
+                }
+                s.indexCount = written;
+            }
+
+            free(candidates);
+            free(locked);
+            free(bestTarget);
+            free(bestCost);
+        }
+
+        uint32_t simplifyMesh(raw_model_t model, uint32_t targetIndexCount, uint32_t *indicesOut, float maxError,
+            float *errorOut)
+        {
+            const uint32_t       vertexCount = StretchyBufferCount(model.vertexData) / MESHOPT_VERTEX_FLOATS;
+            const uint32_t       indexCount  = StretchyBufferCount(model.indexData);
+            meshopt_simplifier_t s = meshoptInitSimplifier(model.vertexData, vertexCount, model.indexData, indexCount);
+            // FLT_MAX squares to infinity, which is no limit, as it should be.
+            meshoptSimplify(s, targetIndexCount, (maxError / s.scale) * (maxError / s.scale));
+            memcpy(indicesOut, s.indices, sizeof(uint32_t) * s.indexCount);
+            if (errorOut) *errorOut = sqrtf(s.error) * s.scale;
+            uint32_t result = s.indexCount;
+            meshoptFreeSimplifier(s);
+            return result;
+        }
+
+        mesh_lod_chain_t buildLodChain(raw_model_t model, const float *triangleRatios, uint32_t ratioCount)
+        {
+            const uint32_t   vertexCount = StretchyBufferCount(model.vertexData) / MESHOPT_VERTEX_FLOATS;
+            const uint32_t   indexCount  = StretchyBufferCount(model.indexData);
+            mesh_lod_chain_t chain       = {};
+            chain.lods    = (mesh_lod_t *)malloc(sizeof(mesh_lod_t) * (ratioCount + 1));
+            chain.indices = (uint32_t *)malloc(sizeof(uint32_t) * (size_t(indexCount) * (ratioCount + 1) + 1));
+            memcpy(chain.indices, model.indexData, sizeof(uint32_t) * indexCount);
+            chain.lods[0]    = {0, indexCount, 0.f};
+            chain.lodCount   = 1;
+            chain.indexCount = indexCount;
+
+            // each LOD carries on from the last, so the quadrics keep the error relative to the full detail mesh.
+            meshopt_simplifier_t s = meshoptInitSimplifier(model.vertexData, vertexCount, model.indexData, indexCount);
+            for (uint32_t i = 0; i < ratioCount; i++) {
+                uint32_t target = uint32_t(float(indexCount / 3) * triangleRatios[i]) * 3;
+                meshoptSimplify(s, target, FLT_MAX);
+                mesh_lod_t &lod = chain.lods[chain.lodCount++];
+                lod.indexOffset = chain.indexCount;
+                lod.indexCount  = s.indexCount;
+                lod.error       = sqrtf(s.error) * s.scale;
+                memcpy(chain.indices + chain.indexCount, s.indices, sizeof(uint32_t) * s.indexCount);
+                chain.indexCount += s.indexCount;
+            }
+            meshoptFreeSimplifier(s);
+            chain.indices = (uint32_t *)realloc(chain.indices, sizeof(uint32_t) * (chain.indexCount + 1));
+            return chain;
+        }
+
+        void freeLodChain(mesh_lod_chain_t chain)
+        {
+            free(chain.indices);
+            free(chain.lods);
+        }
+
+        uint32_t selectLod(
+            const mesh_lod_chain_t &chain, const math::camera_t &cam, float distance, float maxPixelError)
+        {
+            // the width of one pixel at that distance. camera_t::fov is the horizontal field of view in degrees.
+            float pixel = 2.f * distance * tanf(cam.fov * DEGREES_TO_RADIANS * 0.5f) / float(cam.width);
+            uint32_t lod = 0;
+            // the errors only grow down the chain, so take the last LOD that is still good enough.
+            for (uint32_t i = 1; i < chain.lodCount; i++) {
+                if (chain.lods[i].error <= maxPixelError * pixel) lod = i;
+            }
+            return lod;
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
@@ -0,0 +1,477 @@
+#include <automata_engine.hpp>
+
+#include <immintrin.h>
+
+namespace automata_engine {
+
+    mesh_quantization_t mesh_quantization_t::compact()
+    {
+        mesh_quantization_t q;
+        q.positionFormat  = MESH_FORMAT_UNORM16;
+        q.uvFormat        = MESH_FORMAT_UNORM16;
+        q.normalFormat    = MESH_FORMAT_SNORM16;
+        q.bIndex16        = true;
+        q.bPositionStream = true;
+        return q;
+    }
+
+    namespace io {
+
+        static uint32_t meshFormatSize(uint8_t format)
+        {
+            switch (format) {
+                case MESH_FORMAT_FLOAT32:
+                    return 4;
+                case MESH_FORMAT_FLOAT16:
+                case MESH_FORMAT_UNORM16:
+                case MESH_FORMAT_SNORM16:
+                    return 2;
+                case MESH_FORMAT_SNORM8:
+                    return 1;
+            }
+            return 0;
+        }
+
+        // NOTE(Noah): the half conversions are exact, i.e. round to nearest even with denormals, inf and nan all
+        // handled, so that the SIMD path and the scalar tail agree bit for bit.
+        static inline uint16_t floatToHalf1(float f)
+        {
+            uint32_t u;
+            memcpy(&u, &f, 4);
+            uint32_t sign = u & 0x80000000u;
+            u ^= sign;
+            uint32_t h;
+            if (u >= (143u << 23)) {
+                // too big for a half, so inf, or nan.
+                h = (u > (255u << 23)) ? 0x7E00 : 0x7C00;
+            } else if (u < (113u << 23)) {
+                // a half denormal. adding the magic number lets the FPU do the rounding for us.
+                const uint32_t magicBits = 126u << 23;
+                float          magic, fa;
+                memcpy(&magic, &magicBits, 4);
+                memcpy(&fa, &u, 4);
+                fa += magic;
+                memcpy(&u, &fa, 4);
+                h = u - magicBits;
+            } else {
+                uint32_t mantOdd = (u >> 13) & 1;
+                u += (uint32_t(15 - 127) << 23) + 0xFFF + mantOdd;
+                h = u >> 13;
+            }
+            return uint16_t(h | (sign >> 16));
+        }
+
+        static inline float halfToFloat1(uint16_t h)
+        {
+            uint32_t u   = uint32_t(h & 0x7FFF) << 13;
+            uint32_t exp = u & (0x7C00u << 13);
+            u += (127 - 15) << 23;
+            if (exp == (0x7C00u << 13)) {
+                u += (128 - 16) << 23;  // inf or nan.
+            } else if (exp == 0) {
+                // a denormal. renormalize it with the FPU.
+                const uint32_t magicBits = 113u << 23;
+                float          magic, f;
+                memcpy(&magic, &magicBits, 4);
+                u += 1 << 23;
+                memcpy(&f, &u, 4);
+                f -= magic;
+                memcpy(&u, &f, 4);
+            }
+            u |= uint32_t(h & 0x8000) << 16;
+            float f;
+            memcpy(&f, &u, 4);
+            return f;
+        }
+
+#if !defined(__F16C__)
+        // the same as floatToHalf1, four at a time. every branch is computed and the right one is selected.
+        static inline __m128i floatToHalf4(__m128 f)
+        {
+            __m128i u    = _mm_castps_si128(f);
+            __m128i sign = _mm_and_si128(u, _mm_set1_epi32(int(0x80000000u)));
+            u            = _mm_xor_si128(u, sign);
+
+            __m128i bInfNan = _mm_cmpgt_epi32(u, _mm_set1_epi32((143 << 23) - 1));
+            __m128i bNan    = _mm_cmpgt_epi32(u, _mm_set1_epi32(255 << 23));
+            __m128i infNan  = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(bNan, _mm_set1_epi32(0x200)));
+            __m128i bDenorm = _mm_cmplt_epi32(u, _mm_set1_epi32(113 << 23));
+            __m128i magic   = _mm_set1_epi32(126 << 23);
+            __m128i denorm  = _mm_sub_epi32(
+                _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_castsi128_ps(magic))), magic);
+            __m128i mantOdd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+            __m128i normal  = _mm_add_epi32(u, _mm_set1_epi32(int((uint32_t(15 - 127) << 23) + 0xFFF)));
+            normal          = _mm_srli_epi32(_mm_add_epi32(normal, mantOdd), 13);
+
+            __m128i h = _mm_or_si128(_mm_and_si128(bDenorm, denorm), _mm_andnot_si128(bDenorm, normal));
+            h         = _mm_or_si128(_mm_and_si128(bInfNan, infNan), _mm_andnot_si128(bInfNan, h));
+            return _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+        }
+
+        static inline __m128 halfToFloat4(__m128i h)
+        {
+            __m128i shiftedExp = _mm_set1_epi32(0x7C00 << 13);
+            __m128i u          = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+            __m128i exp        = _mm_and_si128(u, shiftedExp);
+            u                  = _mm_add_epi32(u, _mm_set1_epi32((127 - 15) << 23));
+
+            __m128i bInfNan = _mm_cmpeq_epi32(exp, shiftedExp);
+            __m128i bDenorm = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+            __m128i infNan  = _mm_add_epi32(u, _mm_set1_epi32((128 - 16) << 23));
+            __m128i magic   = _mm_set1_epi32(113 << 23);
+            __m128i denorm  = _mm_castps_si128(_mm_sub_ps(
+                _mm_castsi128_ps(_mm_add_epi32(u, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(magic)));
+
+            u = _mm_or_si128(_mm_and_si128(bInfNan, infNan), _mm_andnot_si128(bInfNan, u));
+            u = _mm_or_si128(_mm_and_si128(bDenorm, denorm), _mm_andnot_si128(bDenorm, u));
+            u = _mm_or_si128(u, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+            return _mm_castsi128_ps(u);
+        }
+#endif
+
+        void floatToHalf(const float *in, uint16_t *out, size_t count)
+        {
+            size_t i = 0;
+#if defined(__F16C__)
+            for (; i + 8 <= count; i += 8) {
+                __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128((__m128i *)(out + i), h);
+            }
+#else
+            for (; i + 8 <= count; i += 8) {
+                __m128i lo = floatToHalf4(_mm_loadu_ps(in + i));
+                __m128i hi = floatToHalf4(_mm_loadu_ps(in + i + 4));
+                // the halves are at most 0xFFFF, so offset them into the signed range for the saturating pack.
+                __m128i bias = _mm_set1_epi32(0x8000);
+                __m128i h    = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+                _mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(h, _mm_set1_epi16(short(0x8000))));
+            }
+#endif
+            for (; i < count; i++) out[i] = floatToHalf1(in[i]);
+        }
+
+        void halfToFloat(const uint16_t *in, float *out, size_t count)
+        {
+            size_t i = 0;
+#if defined(__F16C__)
+            for (; i + 8 <= count; i += 8) {
+                _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(in + i))));
+            }
+#else
+            for (; i + 8 <= count; i += 8) {
+                __m128i h = _mm_loadu_si128((const __m128i *)(in + i));
+                _mm_storeu_ps(out + i, halfToFloat4(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+                _mm_storeu_ps(out + i + 4, halfToFloat4(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+            }
+#endif
+            for (; i < count; i++) out[i] = halfToFloat1(in[i]);
+        }
+
+        // NOTE(Noah): the vectors are interleaved, so lane j of a 4 wide load holds component (i + j) % componentCount.
+        // the pattern repeats every 4 vectors, i.e. every 4 * componentCount floats, so we splat the per component
+        // constants into componentCount registers, one for each load within that period.
+        struct unorm16_consts_t {
+            __m128 offset[4];
+            __m128 scale[4];
+        };
+
+        static unorm16_consts_t splatUnorm16(
+            uint32_t componentCount, const float *offset, const float *scale, bool bInverse)
+        {
+            unorm16_consts_t c;
+            for (uint32_t v = 0; v < componentCount; v++) {
+                alignas(16) float o[4], s[4];
+                for (uint32_t j = 0; j < 4; j++) {
+                    uint32_t k = (v * 4 + j) % componentCount;
+                    o[j]       = offset[k];
+                    s[j]       = bInverse ? ((scale[k] != 0.f) ? 65535.f / scale[k] : 0.f) : scale[k] / 65535.f;
+                }
+                c.offset[v] = _mm_load_ps(o);
+                c.scale[v]  = _mm_load_ps(s);
+            }
+            return c;
+        }
+
+        void quantizeUnorm16(const float *in, uint16_t *out, size_t count, uint32_t componentCount,
+            const float *offset, const float *scale)
+        {
+            assert(componentCount >= 1 && componentCount <= 4);
+            const unorm16_consts_t c      = splatUnorm16(componentCount, offset, scale, true);
+            const size_t           n      = count * componentCount;
+            const size_t           period = 4 * componentCount;
+            const __m128           maxQ   = _mm_set1_ps(65535.f);
+            size_t                 i      = 0;
+            for (; i + period <= n; i += period) {
+                for (uint32_t v = 0; v < componentCount; v++) {
+                    __m128 q = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i + v * 4), c.offset[v]), c.scale[v]);
+                    q        = _mm_min_ps(_mm_max_ps(q, _mm_setzero_ps()), maxQ);
+                    // there is no unsigned saturating pack in SSE2, so bias into the signed range and back.
+                    __m128i qi = _mm_sub_epi32(_mm_cvtps_epi32(q), _mm_set1_epi32(0x8000));
+                    qi         = _mm_xor_si128(_mm_packs_epi32(qi, qi), _mm_set1_epi16(short(0x8000)));
+                    _mm_storel_epi64((__m128i *)(out + i + v * 4), qi);
+                }
+            }
+            for (; i < n; i++) {
+                uint32_t k   = uint32_t(i % componentCount);
+                float    inv = (scale[k] != 0.f) ? 65535.f / scale[k] : 0.f;
+                float    q   = (in[i] - offset[k]) * inv;
+                q            = (q < 0.f) ? 0.f : ((q > 65535.f) ? 65535.f : q);
+                out[i]       = uint16_t(nearbyintf(q));
+            }
+        }
+
+        void dequantizeUnorm16(const uint16_t *in, float *out, size_t count, uint32_t componentCount,
+            const float *offset, const float *scale)
+        {
+            assert(componentCount >= 1 && componentCount <= 4);
+            const unorm16_consts_t c      = splatUnorm16(componentCount, offset, scale, false);
+            const size_t           n      = count * componentCount;
+            const size_t           period = 4 * componentCount;
+            size_t                 i      = 0;
+            for (; i + period <= n; i += period) {
+                for (uint32_t v = 0; v < componentCount; v++) {
+                    __m128i q = _mm_loadl_epi64((const __m128i *)(in + i + v * 4));
+                    __m128  f = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q, _mm_setzero_si128()));
+                    _mm_storeu_ps(out + i + v * 4, _mm_add_ps(c.offset[v], _mm_mul_ps(f, c.scale[v])));
+                }
+            }
+            for (; i < n; i++) {
+                uint32_t k = uint32_t(i % componentCount);
+                out[i]     = offset[k] + float(in[i]) * (scale[k] / 65535.f);
+            }
+        }
+
+        // loads 4 xyz vectors, i.e. 12 floats, and transposes them to x, y and z registers.
+        static inline void loadXyz4(const float *p, __m128 &x, __m128 &y, __m128 &z)
+        {
+            __m128 a = _mm_loadu_ps(p);      // x0 y0 z0 x1
+            __m128 b = _mm_loadu_ps(p + 4);  // y1 z1 x2 y2
+            __m128 c = _mm_loadu_ps(p + 8);  // z2 x3 y3 z3
+            x        = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+                       _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+            y        = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                       _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            z        = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                       _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        }
+
+        static inline void storeXyz4(float *p, __m128 x, __m128 y, __m128 z)
+        {
+            __m128 xy01 = _mm_unpacklo_ps(x, y);  // x0 y0 x1 y1
+            __m128 xy23 = _mm_unpackhi_ps(x, y);  // x2 y2 x3 y3
+            __m128 z0x1 = _mm_shuffle_ps(z, xy01, _MM_SHUFFLE(2, 2, 0, 0));   // z0 z0 x1 x1
+            __m128 y1z1 = _mm_shuffle_ps(xy01, z, _MM_SHUFFLE(1, 1, 3, 3));   // y1 y1 z1 z1
+            __m128 z2x3 = _mm_shuffle_ps(z, xy23, _MM_SHUFFLE(2, 2, 2, 2));   // z2 z2 x3 x3
+            __m128 y3z3 = _mm_shuffle_ps(xy23, z, _MM_SHUFFLE(3, 3, 3, 3));   // y3 y3 z3 z3
+            _mm_storeu_ps(p, _mm_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+            _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+
+        // NOTE(Noah): octahedral encoding projects the normal onto the octahedron |x|+|y|+|z| = 1, then unfolds the
+        // lower half over the diagonals, so that the whole sphere maps onto the [-1,1] square. the error is spread
+        // evenly over the sphere, unlike with spherical coordinates.
+        static inline void octEncode4(__m128 x, __m128 y, __m128 z, __m128 &u, __m128 &v)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.f);
+            __m128       l1       = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)),
+                _mm_andnot_ps(signMask, z));
+            // a zero normal encodes as +z rather than nan.
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.f), _mm_max_ps(l1, _mm_set1_ps(1e-30f)));
+            __m128 px  = _mm_mul_ps(x, inv);
+            __m128 py  = _mm_mul_ps(y, inv);
+            // for z < 0, (x, y) = ((1 - |y|) * sign(x), (1 - |x|) * sign(y)).
+            __m128 one = _mm_set1_ps(1.f);
+            __m128 fx  = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, py)), _mm_and_ps(signMask, px));
+            __m128 fy  = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, px)), _mm_and_ps(signMask, py));
+            __m128 bLower = _mm_cmplt_ps(z, _mm_setzero_ps());
+            u             = _mm_or_ps(_mm_and_ps(bLower, fx), _mm_andnot_ps(bLower, px));
+            v             = _mm_or_ps(_mm_and_ps(bLower, fy), _mm_andnot_ps(bLower, py));
+        }
+
+        static inline void octDecode4(__m128 u, __m128 v, __m128 &x, __m128 &y, __m128 &z)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.f);
+            z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_andnot_ps(signMask, u)), _mm_andnot_ps(signMask, v));
+            // fold the lower half back. t is zero for the upper half.
+            __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+            x        = _mm_sub_ps(u, _mm_or_ps(t, _mm_and_ps(signMask, u)));
+            y        = _mm_sub_ps(v, _mm_or_ps(t, _mm_and_ps(signMask, v)));
+            __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            // rsqrt is good to 12 bits, and one newton step takes it to about 23. len2 is at least 1/3.
+            __m128 r   = _mm_rsqrt_ps(len2);
+            __m128 inv = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r),
+                _mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_mul_ps(len2, r), r)));
+            x           = _mm_mul_ps(x, inv);
+            y           = _mm_mul_ps(y, inv);
+            z           = _mm_mul_ps(z, inv);
+        }
+
+        // the tails go through the same 4 wide code, by way of a padded copy.
+        template <typename T, typename FN_pack>
+        static void encodeOctahedral(const float *normals, T *out, size_t count, float maxQ, FN_pack pack)
+        {
+            for (size_t i = 0; i < count; i += 4) {
+                const float *p = normals + i * 3;
+                alignas(16) float tmp[12] = {};
+                size_t            n       = (count - i < 4) ? count - i : 4;
+                if (n < 4) {
+                    memcpy(tmp, p, n * 3 * sizeof(float));
+                    p = tmp;
+                }
+                __m128 x, y, z, u, v;
+                loadXyz4(p, x, y, z);
+                octEncode4(x, y, z, u, v);
+                __m128i qu = _mm_cvtps_epi32(_mm_mul_ps(u, _mm_set1_ps(maxQ)));
+                __m128i qv = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(maxQ)));
+                // interleave to u0 v0 u1 v1 ...
+                alignas(16) T q[8];
+                pack(_mm_unpacklo_epi32(qu, qv), _mm_unpackhi_epi32(qu, qv), q);
+                memcpy(out + i * 2, q, n * 2 * sizeof(T));
+            }
+        }
+
+        template <typename T, typename FN_unpack>
+        static void decodeOctahedral(const T *in, float *normals, size_t count, float maxQ, FN_unpack unpack)
+        {
+            for (size_t i = 0; i < count; i += 4) {
+                size_t        n    = (count - i < 4) ? count - i : 4;
+                alignas(16) T q[8] = {};
+                const T      *p    = in + i * 2;
+                if (n < 4) {
+                    memcpy(q, p, n * 2 * sizeof(T));
+                    p = q;
+                }
+                __m128i lo, hi;
+                unpack(p, lo, hi);  // u0 v0 u1 v1, u2 v2 u3 v3 as int32.
+                __m128 a   = _mm_cvtepi32_ps(lo);
+                __m128 b   = _mm_cvtepi32_ps(hi);
+                __m128 inv = _mm_set1_ps(1.f / maxQ);
+                // snorm decodes with a clamp, since -maxQ - 1 is also representable.
+                __m128 u = _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), inv);
+                __m128 v = _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), inv);
+                u        = _mm_max_ps(u, _mm_set1_ps(-1.f));
+                v        = _mm_max_ps(v, _mm_set1_ps(-1.f));
+                __m128 x, y, z;
+                octDecode4(u, v, x, y, z);
+                if (n == 4) {
+                    storeXyz4(normals + i * 3, x, y, z);
+                } else {
+                    alignas(16) float tmp[12];
+                    storeXyz4(tmp, x, y, z);
+                    memcpy(normals + i * 3, tmp, n * 3 * sizeof(float));
+                }
+            }
+        }
+
+        void encodeOctahedral16(const float *normals, int16_t *out, size_t count)
+        {
+            encodeOctahedral(normals, out, count, 32767.f, [](__m128i lo, __m128i hi, int16_t *q) {
+                _mm_store_si128((__m128i *)q, _mm_packs_epi32(lo, hi));
+            });
+        }
+
+        void decodeOctahedral16(const int16_t *in, float *normals, size_t count)
+        {
+            decodeOctahedral(in, normals, count, 32767.f, [](const int16_t *q, __m128i &lo, __m128i &hi) {
+                __m128i s = _mm_loadu_si128((const __m128i *)q);
+                // sign extend by unpacking into the high half and shifting back down.
+                lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+                hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+            });
+        }
+
+        void encodeOctahedral8(const float *normals, int8_t *out, size_t count)
+        {
+            encodeOctahedral(normals, out, count, 127.f, [](__m128i lo, __m128i hi, int8_t *q) {
+                __m128i s = _mm_packs_epi32(lo, hi);
+                _mm_storel_epi64((__m128i *)q, _mm_packs_epi16(s, s));
+            });
+        }
+
+        void decodeOctahedral8(const int8_t *in, float *normals, size_t count)
+        {
+            decodeOctahedral(in, normals, count, 127.f, [](const int8_t *q, __m128i &lo, __m128i &hi) {
+                __m128i b = _mm_loadl_epi64((const __m128i *)q);
+                __m128i s = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+                lo        = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+                hi        = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+            });
+        }
+
+        // NOTE(Noah): the attributes are interleaved in the vertex, while the codecs above want them tightly packed.
+        // so we go through the mesh in batches that fit in L1, gathering an attribute, running the codec over the
+        // batch, then scattering the result.
+        static constexpr uint32_t QUANTIZE_BATCH = 256;
+
+        static void decodeAttribBatch(const mesh_attrib_t &attrib, const uint8_t *packed, uint32_t count,
+            const float *offset, const float *scale, float *out)
+        {
+            const uint32_t n = count * attrib.componentCount;
+            if (attrib.semantic == MESH_ATTRIB_NORMAL && attrib.componentCount == 2) {
+                if (attrib.format == MESH_FORMAT_SNORM16) decodeOctahedral16((const int16_t *)packed, out, count);
+                else decodeOctahedral8((const int8_t *)packed, out, count);
+                return;
+            }
+            switch (attrib.format) {
+                case MESH_FORMAT_FLOAT32:
+                    memcpy(out, packed, n * sizeof(float));
+                    break;
+                case MESH_FORMAT_FLOAT16:
+                    halfToFloat((const uint16_t *)packed, out, n);
+                    break;
+                case MESH_FORMAT_UNORM16:
+                    dequantizeUnorm16((const uint16_t *)packed, out, count, attrib.componentCount, offset, scale);
+                    break;
+                case MESH_FORMAT_SNORM16:
+                    for (uint32_t i = 0; i < n; i++) out[i] = math::max(((const int16_t *)packed)[i] / 32767.f, -1.f);
+                    break;
+                case MESH_FORMAT_SNORM8:
+                    for (uint32_t i = 0; i < n; i++) out[i] = math::max(((const int8_t *)packed)[i] / 127.f, -1.f);
+                    break;
+            }
+        }
+
+        raw_model_t dequantizeMesh(const loaded_mesh_t &mesh)
+        {
+            raw_model_t model = {};
+            memcpy(model.modelName, mesh.modelName, sizeof(model.modelName));
+            StretchyBufferInitWithCount(model.vertexData, mesh.vertexCount * 8);
+            StretchyBufferInitWithCount(model.indexData, mesh.indexCount);
+            memset(model.vertexData, 0, sizeof(float) * 8 * mesh.vertexCount);
+
+            const uint8_t *vertices = (const uint8_t *)mesh.vertexData;
+            const uint32_t stride   = mesh.layout.stride;
+            for (uint32_t a = 0; a < mesh.layout.attribCount; a++) {
+                const mesh_attrib_t &attrib = mesh.layout.attribs[a];
+                const uint32_t       size   = attrib.componentCount * meshFormatSize(attrib.format);
+                const bool           bPosition = attrib.semantic == MESH_ATTRIB_POSITION;
+                // the octahedral normal decodes to 3 floats.
+                const uint32_t outCount = (attrib.semantic == MESH_ATTRIB_NORMAL) ? 3 : attrib.componentCount;
+                const uint32_t dst      = bPosition ? 0 : ((attrib.semantic == MESH_ATTRIB_UV) ? 3 : 5);
+                const float   *offset   = bPosition ? mesh.positionOffset : mesh.uvOffset;
+                const float   *scale    = bPosition ? mesh.positionScale : mesh.uvScale;
+                uint8_t        packed[QUANTIZE_BATCH * 16];
+                float          decoded[QUANTIZE_BATCH * 4];
+                for (uint32_t base = 0; base < mesh.vertexCount; base += QUANTIZE_BATCH) {
+                    uint32_t count = math::min(QUANTIZE_BATCH, mesh.vertexCount - base);
+                    for (uint32_t i = 0; i < count; i++) {
+                        memcpy(packed + i * size, vertices + size_t(base + i) * stride + attrib.offset, size);
+                    }
+                    decodeAttribBatch(attrib, packed, count, offset, scale, decoded);
+                    for (uint32_t i = 0; i < count; i++) {
+                        memcpy(model.vertexData + size_t(base + i) * 8 + dst, decoded + i * outCount,
+                            math::min(outCount, 3u) * sizeof(float));
+                    }
+                }
+            }
+
+            for (uint32_t i = 0; i < mesh.indexCount; i++) {
+                model.indexData[i] = (mesh.indexSize == 2) ? ((const uint16_t *)mesh.indexData)[i]
+                                                           : ((const uint32_t *)mesh.indexData)[i];
+            }
+            return model;
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
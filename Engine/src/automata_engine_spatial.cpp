@@ -0,0 +1,426 @@
+#include <automata_engine.hpp>
+
+// NOTE(Noah): a spatial hash broadphase. the world is split into an infinite grid of cubic cells, and every box is
+// registered in each cell that it overlaps. two boxes can only overlap if they share a cell, so the pairs test is
+// local to each cell.
+//
+// the cell -> boxes index is an open-addressing hash table over the occupied cells, pointing into one flat array of
+// box handles that is sorted by cell (a counting sort). it is rebuilt from scratch when a query needs it and some
+// box has changed the set of cells that it covers. rebuilding is a couple of linear passes, which is cheaper than
+// keeping per-cell lists up to date when most of the boxes move every frame. a box that moves but stays within
+// the same cells does not invalidate the index at all.
+//
+// every array is kept at its high-water mark, so once the hash has seen its peak load it does not allocate.
+
+namespace automata_engine {
+    namespace math {
+
+        // boxes that span more cells than this are kept in a separate list and tested against everything. that
+        // keeps one huge box from flooding the table.
+        static constexpr uint32_t SPATIAL_HASH_MAX_CELLS_PER_BOX = 64;
+        static constexpr uint64_t SPATIAL_HASH_EMPTY_KEY         = ~uint64_t(0);
+        static constexpr int32_t  SPATIAL_HASH_COORD_BITS        = 21;
+        static constexpr int32_t  SPATIAL_HASH_COORD_MAX         = (1 << (SPATIAL_HASH_COORD_BITS - 1)) - 1;
+
+        struct spatial_cell_range_t {
+            int32_t min[3];
+            int32_t max[3];
+        };
+
+        struct spatial_slot_t {
+            uint64_t key;
+            uint32_t start;
+            uint32_t count;
+        };
+
+        struct spatial_hash_t {
+            float cellSize;
+            float invCellSize;
+
+            // per box, indexed by handle.
+            aabb_t               *boxes;
+            spatial_cell_range_t *ranges;
+            uint32_t             *flags;  // SPATIAL_FLAG_*. free handles are chained through ranges[h].min[0].
+            uint32_t              boxCapacity;
+            uint32_t              boxCount;  // high-water mark of handles.
+            uint32_t              freeHead;
+
+            // the cell index.
+            spatial_slot_t *slots;
+            uint32_t        slotCapacity;  // pow2.
+            uint32_t        slotShift;     // 64 - log2(slotCapacity).
+            uint32_t       *entries;       // box handles, grouped by cell.
+            uint32_t       *entrySlots;    // scratch: the slot of each entry, in build order.
+            uint32_t       *usedSlots;     // the occupied slots, so that nothing has to scan the whole table.
+            uint32_t        usedSlotCount;
+            uint32_t        entryCapacity;
+            uint32_t        entryCount;
+            uint32_t       *bigBoxes;  // handles of boxes that are not in the cell index.
+            uint32_t        bigBoxCount;
+            bool            bDirty;
+        };
+
+        enum {
+            SPATIAL_FLAG_ALIVE = 1 << 0,
+            SPATIAL_FLAG_BIG   = 1 << 1,
+        };
+
+        static inline int32_t spatialCoord(float v, float invCellSize)
+        {
+            float c = std::floor(v * invCellSize);
+            c       = max(min(c, float(SPATIAL_HASH_COORD_MAX)), float(-SPATIAL_HASH_COORD_MAX));
+            return int32_t(c);
+        }
+
+        static inline spatial_cell_range_t spatialRange(const spatial_hash_t *hash, const aabb_t &box)
+        {
+            spatial_cell_range_t r;
+            r.min[0] = spatialCoord(box.min.x, hash->invCellSize);
+            r.min[1] = spatialCoord(box.min.y, hash->invCellSize);
+            r.min[2] = spatialCoord(box.min.z, hash->invCellSize);
+            r.max[0] = spatialCoord(box.max.x, hash->invCellSize);
+            r.max[1] = spatialCoord(box.max.y, hash->invCellSize);
+            r.max[2] = spatialCoord(box.max.z, hash->invCellSize);
+            return r;
+        }
+
+        static inline uint64_t spatialRangeCellCount(const spatial_cell_range_t &r)
+        {
+            return uint64_t(r.max[0] - r.min[0] + 1) * uint64_t(r.max[1] - r.min[1] + 1) *
+                   uint64_t(r.max[2] - r.min[2] + 1);
+        }
+
+        static inline uint64_t spatialKey(int32_t x, int32_t y, int32_t z)
+        {
+            constexpr uint64_t mask = (uint64_t(1) << SPATIAL_HASH_COORD_BITS) - 1;
+            return (uint64_t(x) & mask) | ((uint64_t(y) & mask) << SPATIAL_HASH_COORD_BITS) |
+                   ((uint64_t(z) & mask) << (2 * SPATIAL_HASH_COORD_BITS));
+        }
+
+        static inline uint32_t spatialSlotOf(const spatial_hash_t *hash, uint64_t key)
+        {
+            // fibonacci hashing. the top bits are the best mixed.
+            return uint32_t((key * 0x9E3779B97F4A7C15ull) >> hash->slotShift);
+        }
+
+        static inline bool aabbOverlap(const aabb_t &a, const aabb_t &b)
+        {
+            return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+                   a.min.z <= b.max.z && a.max.z >= b.min.z;
+        }
+
+        // two ranges can share many cells. to report each overlap once, only the cell at the min corner of the
+        // shared region reports it.
+        static inline bool isReportingCell(
+            const spatial_cell_range_t &a, const spatial_cell_range_t &b, int32_t x, int32_t y, int32_t z)
+        {
+            return x == max(a.min[0], b.min[0]) && y == max(a.min[1], b.min[1]) && z == max(a.min[2], b.min[2]);
+        }
+
+        template <typename T>
+        static void growArray(T **arr, uint32_t oldCount, uint32_t newCount)
+        {
+            T *newArr = (T *)malloc(sizeof(T) * newCount);
+            if (*arr) {
+                memcpy(newArr, *arr, sizeof(T) * oldCount);
+                free(*arr);
+            }
+            *arr = newArr;
+        }
+
+        spatial_hash_t *createSpatialHash(float cellSize, uint32_t expectedBoxCount)
+        {
+            assert(cellSize > 0.f);
+            spatial_hash_t *hash = (spatial_hash_t *)calloc(1, sizeof(spatial_hash_t));
+            hash->cellSize       = cellSize;
+            hash->invCellSize    = 1.f / cellSize;
+            hash->freeHead       = SPATIAL_HASH_INVALID;
+            hash->boxCapacity    = max(expectedBoxCount, 64u);
+            hash->boxes          = (aabb_t *)malloc(sizeof(aabb_t) * hash->boxCapacity);
+            hash->ranges         = (spatial_cell_range_t *)malloc(sizeof(spatial_cell_range_t) * hash->boxCapacity);
+            hash->flags          = (uint32_t *)malloc(sizeof(uint32_t) * hash->boxCapacity);
+            hash->bigBoxes       = (uint32_t *)malloc(sizeof(uint32_t) * hash->boxCapacity);
+            return hash;
+        }
+
+        void destroySpatialHash(spatial_hash_t *hash)
+        {
+            if (!hash) return;
+            free(hash->boxes);
+            free(hash->ranges);
+            free(hash->flags);
+            free(hash->bigBoxes);
+            free(hash->slots);
+            free(hash->entries);
+            free(hash->entrySlots);
+            free(hash->usedSlots);
+            free(hash);
+        }
+
+        uint32_t spatialHashInsert(spatial_hash_t *hash, const aabb_t &box)
+        {
+            uint32_t handle;
+            if (hash->freeHead != SPATIAL_HASH_INVALID) {
+                handle         = hash->freeHead;
+                hash->freeHead = uint32_t(hash->ranges[handle].min[0]);
+            } else {
+                if (hash->boxCount == hash->boxCapacity) {
+                    uint32_t newCapacity = hash->boxCapacity * 2;
+                    growArray(&hash->boxes, hash->boxCount, newCapacity);
+                    growArray(&hash->ranges, hash->boxCount, newCapacity);
+                    growArray(&hash->flags, hash->boxCount, newCapacity);
+                    growArray(&hash->bigBoxes, hash->boxCount, newCapacity);
+                    hash->boxCapacity = newCapacity;
+                }
+                handle = hash->boxCount++;
+            }
+            hash->boxes[handle]  = box;
+            hash->ranges[handle] = spatialRange(hash, box);
+            hash->flags[handle]  = SPATIAL_FLAG_ALIVE;
+            hash->bDirty         = true;
+            return handle;
+        }
+
+        void spatialHashUpdate(spatial_hash_t *hash, uint32_t handle, const aabb_t &box)
+        {
+            assert(handle < hash->boxCount && (hash->flags[handle] & SPATIAL_FLAG_ALIVE));
+            hash->boxes[handle]          = box;
+            spatial_cell_range_t  range  = spatialRange(hash, box);
+            spatial_cell_range_t &oldRange = hash->ranges[handle];
+            if (memcmp(&range, &oldRange, sizeof(range)) != 0) {
+                oldRange     = range;
+                hash->bDirty = true;
+            }
+        }
+
+        void spatialHashRemove(spatial_hash_t *hash, uint32_t handle)
+        {
+            assert(handle < hash->boxCount && (hash->flags[handle] & SPATIAL_FLAG_ALIVE));
+            hash->flags[handle]         = 0;
+            hash->ranges[handle].min[0] = int32_t(hash->freeHead);
+            hash->freeHead              = handle;
+            hash->bDirty                = true;
+        }
+
+        static void spatialHashRebuild(spatial_hash_t *hash)
+        {
+            // pass 1: count the entries and set aside the big boxes.
+            uint64_t entryCount = 0;
+            hash->bigBoxCount   = 0;
+            for (uint32_t h = 0; h < hash->boxCount; h++) {
+                if (!(hash->flags[h] & SPATIAL_FLAG_ALIVE)) continue;
+                uint64_t cells = spatialRangeCellCount(hash->ranges[h]);
+                if (cells > SPATIAL_HASH_MAX_CELLS_PER_BOX) {
+                    hash->flags[h] |= SPATIAL_FLAG_BIG;
+                    hash->bigBoxes[hash->bigBoxCount++] = h;
+                } else {
+                    hash->flags[h] &= ~SPATIAL_FLAG_BIG;
+                    entryCount += cells;
+                }
+            }
+            assert(entryCount < 0xFFFFFFFF);
+
+            // only the slots of the last build can be in use. this must happen before usedSlots may be reallocated.
+            for (uint32_t i = 0; i < hash->usedSlotCount; i++) {
+                hash->slots[hash->usedSlots[i]].key = SPATIAL_HASH_EMPTY_KEY;
+            }
+
+            if (entryCount > hash->entryCapacity) {
+                uint32_t newCapacity = max(uint32_t(entryCount), hash->entryCapacity * 2);
+                free(hash->entries);
+                free(hash->entrySlots);
+                free(hash->usedSlots);
+                hash->entries       = (uint32_t *)malloc(sizeof(uint32_t) * newCapacity);
+                hash->entrySlots    = (uint32_t *)malloc(sizeof(uint32_t) * newCapacity);
+                hash->usedSlots     = (uint32_t *)malloc(sizeof(uint32_t) * newCapacity);
+                hash->entryCapacity = newCapacity;
+            }
+            // keep the table at most half full. there are at most entryCount distinct cells.
+            uint32_t wantSlots = 64;
+            uint32_t wantShift = 64 - 6;
+            while (wantSlots < entryCount * 2) {
+                wantSlots *= 2;
+                wantShift--;
+            }
+            if (wantSlots > hash->slotCapacity) {
+                free(hash->slots);
+                hash->slots        = (spatial_slot_t *)malloc(sizeof(spatial_slot_t) * wantSlots);
+                hash->slotCapacity = wantSlots;
+                hash->slotShift    = wantShift;
+                for (uint32_t s = 0; s < hash->slotCapacity; s++) hash->slots[s].key = SPATIAL_HASH_EMPTY_KEY;
+            }
+            hash->usedSlotCount = 0;
+
+            // pass 2: find or insert the slot of every entry and count the entries per cell.
+            const uint32_t slotMask = hash->slotCapacity - 1;
+            uint32_t       e        = 0;
+            for (uint32_t h = 0; h < hash->boxCount; h++) {
+                if ((hash->flags[h] & (SPATIAL_FLAG_ALIVE | SPATIAL_FLAG_BIG)) != SPATIAL_FLAG_ALIVE) continue;
+                const spatial_cell_range_t &r = hash->ranges[h];
+                for (int32_t z = r.min[2]; z <= r.max[2]; z++) {
+                    for (int32_t y = r.min[1]; y <= r.max[1]; y++) {
+                        for (int32_t x = r.min[0]; x <= r.max[0]; x++) {
+                            uint64_t key = spatialKey(x, y, z);
+                            uint32_t s   = spatialSlotOf(hash, key);
+                            while (hash->slots[s].key != key && hash->slots[s].key != SPATIAL_HASH_EMPTY_KEY) {
+                                s = (s + 1) & slotMask;
+                            }
+                            if (hash->slots[s].key == SPATIAL_HASH_EMPTY_KEY) {
+                                hash->slots[s].key                      = key;
+                                hash->slots[s].count                    = 0;
+                                hash->usedSlots[hash->usedSlotCount++] = s;
+                            }
+                            hash->slots[s].count++;
+                            hash->entrySlots[e++] = s;
+                        }
+                    }
+                }
+            }
+
+            // pass 3: prefix sum, then scatter the handles in the same order as pass 2.
+            uint32_t running = 0;
+            for (uint32_t i = 0; i < hash->usedSlotCount; i++) {
+                spatial_slot_t &slot = hash->slots[hash->usedSlots[i]];
+                slot.start           = running;
+                running += slot.count;
+                slot.count = 0;
+            }
+            e = 0;
+            for (uint32_t h = 0; h < hash->boxCount; h++) {
+                if ((hash->flags[h] & (SPATIAL_FLAG_ALIVE | SPATIAL_FLAG_BIG)) != SPATIAL_FLAG_ALIVE) continue;
+                uint64_t cells = spatialRangeCellCount(hash->ranges[h]);
+                for (uint64_t c = 0; c < cells; c++) {
+                    spatial_slot_t &slot                      = hash->slots[hash->entrySlots[e++]];
+                    hash->entries[slot.start + slot.count++] = h;
+                }
+            }
+            hash->entryCount = e;
+            hash->bDirty     = false;
+        }
+
+        static inline void spatialDecodeKey(uint64_t key, int32_t *x, int32_t *y, int32_t *z)
+        {
+            // sign extend each 21 bit field.
+            constexpr int32_t shift = 32 - SPATIAL_HASH_COORD_BITS;
+            *x = int32_t(uint32_t(key) << shift) >> shift;
+            *y = int32_t(uint32_t(key >> SPATIAL_HASH_COORD_BITS) << shift) >> shift;
+            *z = int32_t(uint32_t(key >> (2 * SPATIAL_HASH_COORD_BITS)) << shift) >> shift;
+        }
+
+        uint32_t spatialHashFindPairs(spatial_hash_t *hash, spatial_pair_t *pairsOut, uint32_t maxPairsOut)
+        {
+            if (hash->bDirty) spatialHashRebuild(hash);
+            uint32_t found  = 0;
+            auto     report = [&](uint32_t a, uint32_t b) {
+                if (found < maxPairsOut) pairsOut[found] = {min(a, b), max(a, b)};
+                found++;
+            };
+
+            for (uint32_t u = 0; u < hash->usedSlotCount; u++) {
+                const spatial_slot_t &slot = hash->slots[hash->usedSlots[u]];
+                if (slot.count < 2) continue;
+                int32_t x, y, z;
+                spatialDecodeKey(slot.key, &x, &y, &z);
+                const uint32_t *cell = hash->entries + slot.start;
+                for (uint32_t i = 0; i < slot.count; i++) {
+                    const uint32_t              a      = cell[i];
+                    const spatial_cell_range_t &ra     = hash->ranges[a];
+                    const aabb_t               &boxA   = hash->boxes[a];
+                    for (uint32_t j = i + 1; j < slot.count; j++) {
+                        const uint32_t b = cell[j];
+                        if (!isReportingCell(ra, hash->ranges[b], x, y, z)) continue;
+                        if (aabbOverlap(boxA, hash->boxes[b])) report(a, b);
+                    }
+                }
+            }
+
+            // the big boxes are not in the table, so test them against everything.
+            for (uint32_t i = 0; i < hash->bigBoxCount; i++) {
+                const uint32_t a = hash->bigBoxes[i];
+                for (uint32_t b = 0; b < hash->boxCount; b++) {
+                    if (!(hash->flags[b] & SPATIAL_FLAG_ALIVE) || b == a) continue;
+                    // a pair of two big boxes is seen twice. only report it from the lower handle.
+                    if ((hash->flags[b] & SPATIAL_FLAG_BIG) && b < a) continue;
+                    if (aabbOverlap(hash->boxes[a], hash->boxes[b])) report(a, b);
+                }
+            }
+            return found;
+        }
+
+        // visit every box that may overlap the query range, exactly once.
+        template <typename FN_visit>
+        static void spatialHashVisit(spatial_hash_t *hash, const spatial_cell_range_t &q, FN_visit visit)
+        {
+            if (hash->bDirty) spatialHashRebuild(hash);
+            for (uint32_t i = 0; i < hash->bigBoxCount; i++) visit(hash->bigBoxes[i]);
+            if (hash->entryCount == 0) return;
+            auto visitSlot = [&](const spatial_slot_t &slot, int32_t x, int32_t y, int32_t z) {
+                for (uint32_t i = 0; i < slot.count; i++) {
+                    uint32_t h = hash->entries[slot.start + i];
+                    if (isReportingCell(q, hash->ranges[h], x, y, z)) visit(h);
+                }
+            };
+
+            // NOTE(Noah): a query that is large next to the cell size covers more cells than the table holds, so
+            // it is cheaper to go over the occupied cells and keep the ones inside the range.
+            if (spatialRangeCellCount(q) > hash->usedSlotCount) {
+                for (uint32_t u = 0; u < hash->usedSlotCount; u++) {
+                    const spatial_slot_t &slot = hash->slots[hash->usedSlots[u]];
+                    int32_t               x, y, z;
+                    spatialDecodeKey(slot.key, &x, &y, &z);
+                    if (x < q.min[0] || x > q.max[0] || y < q.min[1] || y > q.max[1] || z < q.min[2] || z > q.max[2]) {
+                        continue;
+                    }
+                    visitSlot(slot, x, y, z);
+                }
+                return;
+            }
+
+            const uint32_t slotMask = hash->slotCapacity - 1;
+            for (int32_t z = q.min[2]; z <= q.max[2]; z++) {
+                for (int32_t y = q.min[1]; y <= q.max[1]; y++) {
+                    for (int32_t x = q.min[0]; x <= q.max[0]; x++) {
+                        uint64_t key = spatialKey(x, y, z);
+                        uint32_t s   = spatialSlotOf(hash, key);
+                        while (hash->slots[s].key != key && hash->slots[s].key != SPATIAL_HASH_EMPTY_KEY) {
+                            s = (s + 1) & slotMask;
+                        }
+                        if (hash->slots[s].key == key) visitSlot(hash->slots[s], x, y, z);
+                    }
+                }
+            }
+        }
+
+        uint32_t spatialHashQueryBox(
+            spatial_hash_t *hash, const aabb_t &box, uint32_t *handlesOut, uint32_t maxHandlesOut)
+        {
+            uint32_t found = 0;
+            spatialHashVisit(hash, spatialRange(hash, box), [&](uint32_t h) {
+                if (!aabbOverlap(box, hash->boxes[h])) return;
+                if (found < maxHandlesOut) handlesOut[found] = h;
+                found++;
+            });
+            return found;
+        }
+
+        uint32_t spatialHashQuerySphere(
+            spatial_hash_t *hash, const vec3_t &center, float radius, uint32_t *handlesOut, uint32_t maxHandlesOut)
+        {
+            const aabb_t bounds = aabb_t::make(center, vec3_t(radius, radius, radius));
+            const float  r2     = radius * radius;
+            uint32_t     found  = 0;
+            spatialHashVisit(hash, spatialRange(hash, bounds), [&](uint32_t h) {
+                // squared distance from the center to the closest point on the box.
+                const aabb_t &b  = hash->boxes[h];
+                float         dx = max(max(b.min.x - center.x, 0.f), center.x - b.max.x);
+                float         dy = max(max(b.min.y - center.y, 0.f), center.y - b.max.y);
+                float         dz = max(max(b.min.z - center.z, 0.f), center.z - b.max.z);
+                if (dx * dx + dy * dy + dz * dz > r2) return;
+                if (found < maxHandlesOut) handlesOut[found] = h;
+                found++;
+            });
+            return found;
+        }
+
+    }  // namespace math
+}  // namespace automata_engine
@@ -0,0 +1,632 @@
+#include <automata_engine.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace automata_engine {
+    namespace io {
+
+        // ----------- [SECTION] Blocks -----------
+        // NOTE(Noah): every format here works on 4x4 blocks of pixels, which are kept as RGBA bytes, pixel i at row
+        // i / 4 and column i % 4. the blocks of an image are row-major in the same order as its rows, so bottom block
+        // row first, which is the order that the GPU expects them in along with the uncompressed rows.
+        typedef uint8_t block_pixels_t[16][4];
+
+        static uint32_t blockBytes(block_format_t format) { return (format == BLOCK_FORMAT_BC1) ? 8 : 16; }
+
+        size_t blockCompressedSize(block_format_t format, uint32_t width, uint32_t height)
+        {
+            return size_t((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+        }
+
+        // a block that hangs off of the edge of the image repeats its last row and column.
+        static void blockFetch(
+            const uint32_t *pixels, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, block_pixels_t block)
+        {
+            for (uint32_t y = 0; y < 4; y++) {
+                const uint32_t *row = pixels + size_t(math::min(by * 4 + y, height - 1)) * width;
+                for (uint32_t x = 0; x < 4; x++) memcpy(block[y * 4 + x], &row[math::min(bx * 4 + x, width - 1)], 4);
+            }
+        }
+
+        static void blockStore(
+            const block_pixels_t block, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint32_t *pixels)
+        {
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++) {
+                uint32_t *row = pixels + size_t(by * 4 + y) * width;
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++) memcpy(&row[bx * 4 + x], block[y * 4 + x], 4);
+            }
+        }
+
+        static inline float blockClamp(float v) { return (v < 0.0f) ? 0.0f : ((v > 255.0f) ? 255.0f : v); }
+
+        // the corners of the bounding box of the first channelCount channels, as the two ends of its diagonal that
+        // runs the way that the colours do. channels that fall as the widest one rises are flipped.
+        static void blockBoundingBox(const block_pixels_t block, uint32_t channelCount, float lo[4], float hi[4])
+        {
+            float    mean[4] = {};
+            uint32_t widest  = 0;
+            for (uint32_t c = 0; c < channelCount; c++) {
+                lo[c] = 255.0f, hi[c] = 0.0f;
+                for (uint32_t i = 0; i < 16; i++) {
+                    lo[c] = math::min(lo[c], float(block[i][c]));
+                    hi[c] = math::max(hi[c], float(block[i][c]));
+                    mean[c] += float(block[i][c]) * (1.0f / 16.0f);
+                }
+                if (hi[c] - lo[c] > hi[widest] - lo[widest]) widest = c;
+            }
+            for (uint32_t c = 0; c < channelCount; c++) {
+                float cov = 0.0f;
+                for (uint32_t i = 0; i < 16; i++) {
+                    cov += (float(block[i][c]) - mean[c]) * (float(block[i][widest]) - mean[widest]);
+                }
+                if (cov < 0.0f) std::swap(lo[c], hi[c]);
+            }
+        }
+
+        // the ends of the line through the mean along the principal axis of the block, found by power iteration on
+        // the covariance, that just take in every pixel.
+        static void blockPrincipalEnds(const block_pixels_t block, uint32_t channelCount, float lo[4], float hi[4])
+        {
+            float mean[4] = {}, cov[4][4] = {};
+            for (uint32_t i = 0; i < 16; i++) {
+                for (uint32_t c = 0; c < channelCount; c++) mean[c] += float(block[i][c]) * (1.0f / 16.0f);
+            }
+            for (uint32_t i = 0; i < 16; i++) {
+                for (uint32_t a = 0; a < channelCount; a++) {
+                    for (uint32_t b = 0; b < channelCount; b++) {
+                        cov[a][b] += (float(block[i][a]) - mean[a]) * (float(block[i][b]) - mean[b]);
+                    }
+                }
+            }
+            // NOTE(Noah): starting from the column of the channel with the most variance cannot start orthogonal to
+            // the principal axis, unless the block is a single colour, in which case the axis does not matter.
+            uint32_t widest = 0;
+            for (uint32_t c = 1; c < channelCount; c++) widest = (cov[c][c] > cov[widest][widest]) ? c : widest;
+            float axis[4] = {};
+            for (uint32_t c = 0; c < channelCount; c++) axis[c] = cov[c][widest];
+            for (uint32_t iteration = 0; iteration < 8; iteration++) {
+                float next[4] = {}, largest = 0.0f;
+                for (uint32_t a = 0; a < channelCount; a++) {
+                    for (uint32_t b = 0; b < channelCount; b++) next[a] += cov[a][b] * axis[b];
+                    largest = math::max(largest, fabsf(next[a]));
+                }
+                if (largest == 0.0f) break;
+                for (uint32_t c = 0; c < channelCount; c++) axis[c] = next[c] / largest;
+            }
+            float length = 0.0f;
+            for (uint32_t c = 0; c < channelCount; c++) length += axis[c] * axis[c];
+            length = sqrtf(length);
+            if (length > 0.0f) {
+                for (uint32_t c = 0; c < channelCount; c++) axis[c] /= length;
+            }
+            float tMin = 0.0f, tMax = 0.0f;
+            for (uint32_t i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (uint32_t c = 0; c < channelCount; c++) t += (float(block[i][c]) - mean[c]) * axis[c];
+                tMin = math::min(tMin, t), tMax = math::max(tMax, t);
+            }
+            for (uint32_t c = 0; c < channelCount; c++) {
+                lo[c] = blockClamp(mean[c] + tMin * axis[c]);
+                hi[c] = blockClamp(mean[c] + tMax * axis[c]);
+            }
+        }
+
+        // the ends a and b that best fit the block by least squares, when pixel i is a + weight[i] * (b - a).
+        // @returns false if the weights are all the same, so that there is no single best fit.
+        static bool blockFitEnds(
+            const block_pixels_t block, const float weight[16], uint32_t channelCount, float a[4], float b[4])
+        {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+            for (uint32_t i = 0; i < 16; i++) {
+                float t = weight[i], s = 1.0f - t;
+                aa += s * s, ab += s * t, bb += t * t;
+                for (uint32_t c = 0; c < channelCount; c++) ax[c] += s * block[i][c], bx[c] += t * block[i][c];
+            }
+            float det = aa * bb - ab * ab;
+            if (fabsf(det) < 1e-6f) return false;
+            for (uint32_t c = 0; c < channelCount; c++) {
+                a[c] = blockClamp((ax[c] * bb - bx[c] * ab) / det);
+                b[c] = blockClamp((bx[c] * aa - ax[c] * ab) / det);
+            }
+            return true;
+        }
+
+        // the nearest palette entry for each pixel, over the channels [firstChannel, firstChannel + channelCount).
+        // @returns the total squared error.
+        static uint32_t blockPickIndices(const block_pixels_t block, const int (*palette)[4], uint32_t paletteSize,
+            uint32_t firstChannel, uint32_t channelCount, uint8_t indices[16])
+        {
+            uint32_t total = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                uint32_t best = UINT32_MAX;
+                for (uint32_t k = 0; k < paletteSize; k++) {
+                    uint32_t error = 0;
+                    for (uint32_t c = firstChannel; c < firstChannel + channelCount; c++) {
+                        int d = palette[k][c] - int(block[i][c]);
+                        error += uint32_t(d * d);
+                    }
+                    if (error < best) best = error, indices[i] = uint8_t(k);
+                }
+                total += best;
+            }
+            return total;
+        }
+
+        // ----------- [SECTION] BC1 -----------
+        // NOTE(Noah): two RGB565 colours, then 2 bits a pixel. with c0 > c1 the palette is c0, c1 and the two colours
+        // a third of the way in between, which is the only mode written here. BC1 from this encoder is opaque, and
+        // BC3 uses the same block for its colour, where the other mode does not exist.
+        static const float BC1_WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+        static uint16_t bc1Pack565(const float c[3])
+        {
+            uint32_t r = uint32_t(c[0] * (31.0f / 255.0f) + 0.5f);
+            uint32_t g = uint32_t(c[1] * (63.0f / 255.0f) + 0.5f);
+            uint32_t b = uint32_t(c[2] * (31.0f / 255.0f) + 0.5f);
+            return uint16_t((r << 11) | (g << 5) | b);
+        }
+
+        static void bc1Unpack565(uint16_t v, int out[4])
+        {
+            uint32_t r = v >> 11, g = (v >> 5) & 63, b = v & 31;
+            out[0] = int((r << 3) | (r >> 2)), out[1] = int((g << 2) | (g >> 4)), out[2] = int((b << 3) | (b >> 2));
+            out[3] = 255;
+        }
+
+        static void bc1Palette(uint16_t c0, uint16_t c1, bool bFourColors, int palette[4][4])
+        {
+            bc1Unpack565(c0, palette[0]);
+            bc1Unpack565(c1, palette[1]);
+            for (uint32_t c = 0; c < 3; c++) {
+                if (bFourColors) {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                } else {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+            palette[2][3] = 255;
+            palette[3][3] = bFourColors ? 255 : 0;
+        }
+
+        // quantizes a pair of ends, in the order that makes for 4 colours, and picks the indices.
+        // @returns the squared error.
+        static uint32_t bc1Try(const block_pixels_t block, const float e0[4], const float e1[4], uint16_t *c0Out,
+            uint16_t *c1Out, uint8_t indices[16])
+        {
+            uint16_t c0 = bc1Pack565(e0), c1 = bc1Pack565(e1);
+            if (c0 < c1) std::swap(c0, c1);
+            // a block of a single colour, once quantized. 4 colours need c0 > c1, which costs the least in blue.
+            if (c0 == c1) {
+                if (c1 & 31) c1--;
+                else c0++;
+            }
+            int palette[4][4];
+            bc1Palette(c0, c1, true, palette);
+            *c0Out = c0, *c1Out = c1;
+            return blockPickIndices(block, palette, 4, 0, 3, indices);
+        }
+
+        static void bc1EncodeColor(const block_pixels_t block, block_quality_t quality, uint8_t *out)
+        {
+            float    lo[4], hi[4];
+            uint16_t c0, c1;
+            uint8_t  indices[16];
+            blockBoundingBox(block, 3, lo, hi);
+            uint32_t error = bc1Try(block, hi, lo, &c0, &c1, indices);
+            if (quality != BLOCK_QUALITY_FAST) {
+                uint16_t pc0, pc1;
+                uint8_t  principal[16];
+                blockPrincipalEnds(block, 3, lo, hi);
+                uint32_t principalError = bc1Try(block, hi, lo, &pc0, &pc1, principal);
+                if (principalError < error) {
+                    error = principalError, c0 = pc0, c1 = pc1;
+                    memcpy(indices, principal, 16);
+                }
+            }
+            // NOTE(Noah): each refinement fits the ends to the indices that they picked, and stops once that does
+            // not help, so more quality never makes a block worse.
+            uint32_t refinements = (quality == BLOCK_QUALITY_HIGH) ? 4 : ((quality == BLOCK_QUALITY_NORMAL) ? 1 : 0);
+            for (uint32_t r = 0; r < refinements && error > 0; r++) {
+                float weight[16], a[4], b[4];
+                for (uint32_t i = 0; i < 16; i++) weight[i] = BC1_WEIGHTS[indices[i]];
+                if (!blockFitEnds(block, weight, 3, a, b)) break;
+                uint16_t rc0, rc1;
+                uint8_t  refined[16];
+                uint32_t refinedError = bc1Try(block, a, b, &rc0, &rc1, refined);
+                if (refinedError >= error) break;
+                error = refinedError, c0 = rc0, c1 = rc1;
+                memcpy(indices, refined, 16);
+            }
+            uint32_t bits = 0;
+            for (uint32_t i = 0; i < 16; i++) bits |= uint32_t(indices[i]) << (2 * i);
+            memcpy(out, &c0, 2);
+            memcpy(out + 2, &c1, 2);
+            memcpy(out + 4, &bits, 4);
+        }
+
+        static void bc1DecodeColor(const uint8_t *src, bool bFourColorsOnly, block_pixels_t block)
+        {
+            uint16_t c0, c1;
+            uint32_t bits;
+            memcpy(&c0, src, 2);
+            memcpy(&c1, src + 2, 2);
+            memcpy(&bits, src + 4, 4);
+            int palette[4][4];
+            bc1Palette(c0, c1, bFourColorsOnly || c0 > c1, palette);
+            for (uint32_t i = 0; i < 16; i++) {
+                const int *p = palette[(bits >> (2 * i)) & 3];
+                for (uint32_t c = 0; c < 4; c++) block[i][c] = uint8_t(p[c]);
+            }
+        }
+
+        // ----------- [SECTION] BC3 -----------
+        // NOTE(Noah): an alpha block, i.e. two 8-bit alphas and then 3 bits a pixel, and a BC1 block for colour. with
+        // a0 > a1 the palette is the two ends and 6 alphas evenly in between. otherwise it is the ends, 4 in between,
+        // and then 0 and 255, which suits blocks with a few fully clear or opaque pixels among the rest.
+        static void bc3AlphaPalette(uint8_t a0, uint8_t a1, int palette[8][4])
+        {
+            palette[0][3] = a0, palette[1][3] = a1;
+            if (a0 > a1) {
+                for (int i = 1; i < 7; i++) palette[i + 1][3] = ((7 - i) * a0 + i * a1) / 7;
+            } else {
+                for (int i = 1; i < 5; i++) palette[i + 1][3] = ((5 - i) * a0 + i * a1) / 5;
+                palette[6][3] = 0, palette[7][3] = 255;
+            }
+        }
+
+        static uint32_t bc3TryAlpha(const block_pixels_t block, int a0, int a1, uint8_t indices[16])
+        {
+            int palette[8][4];
+            bc3AlphaPalette(uint8_t(a0), uint8_t(a1), palette);
+            return blockPickIndices(block, palette, 8, 3, 1, indices);
+        }
+
+        static void bc3EncodeAlpha(const block_pixels_t block, block_quality_t quality, uint8_t *out)
+        {
+            int lo = 255, hi = 0, innerLo = 255, innerHi = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                int a = block[i][3];
+                lo = math::min(lo, a), hi = math::max(hi, a);
+                if (a != 0 && a != 255) innerLo = math::min(innerLo, a), innerHi = math::max(innerHi, a);
+            }
+            uint8_t  indices[16], candidate[16];
+            int      a0 = hi, a1 = lo;
+            uint32_t error = bc3TryAlpha(block, a0, a1, indices);
+            auto     consider = [&](int c0, int c1) {
+                uint32_t candidateError = bc3TryAlpha(block, c0, c1, candidate);
+                if (candidateError < error) {
+                    error = candidateError, a0 = c0, a1 = c1;
+                    memcpy(indices, candidate, 16);
+                }
+            };
+            if (quality != BLOCK_QUALITY_FAST && error > 0) {
+                // the 6 alpha mode, spanning only the pixels that 0 and 255 do not already cover.
+                if (innerLo <= innerHi) consider(innerLo, innerHi);
+                else consider(0, 255);
+            }
+            if (quality == BLOCK_QUALITY_HIGH && error > 0) {
+                // nudging the ends in can bring the in between alphas closer to where the pixels are.
+                for (int d0 = -2; d0 <= 2; d0++) {
+                    for (int d1 = -2; d1 <= 2; d1++) {
+                        int c0 = math::min(math::max(hi + d0, 0), 255), c1 = math::min(math::max(lo + d1, 0), 255);
+                        if (c0 > c1) consider(c0, c1);
+                    }
+                }
+            }
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < 16; i++) bits |= uint64_t(indices[i]) << (3 * i);
+            out[0] = uint8_t(a0), out[1] = uint8_t(a1);
+            for (uint32_t i = 0; i < 6; i++) out[2 + i] = uint8_t(bits >> (8 * i));
+        }
+
+        static void bc3DecodeAlpha(const uint8_t *src, block_pixels_t block)
+        {
+            int palette[8][4];
+            bc3AlphaPalette(src[0], src[1], palette);
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < 6; i++) bits |= uint64_t(src[2 + i]) << (8 * i);
+            for (uint32_t i = 0; i < 16; i++) block[i][3] = uint8_t(palette[(bits >> (3 * i)) & 7][3]);
+        }
+
+        // ----------- [SECTION] BC7 -----------
+        // NOTE(Noah): only mode 6 is written, which is a single RGBA line with 7 bits a channel and a p-bit for each
+        // end, i.e. a shared low bit, and 4 bits a pixel. it is the one mode that handles alpha and colour together
+        // with no partitions, and it is already well past BC1 and BC3 in quality.
+        static const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        struct bc7_bits_t {
+            uint64_t word[2];
+            uint32_t pos;
+
+            void put(uint32_t value, uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; i++, pos++) word[pos >> 6] |= uint64_t((value >> i) & 1) << (pos & 63);
+            }
+
+            uint32_t get(uint32_t count)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < count; i++, pos++) value |= uint32_t((word[pos >> 6] >> (pos & 63)) & 1) << i;
+                return value;
+            }
+        };
+
+        // an end, as 7 bits a channel with the p-bit as the low bit of each.
+        static void bc7QuantizeEnd(const float e[4], uint32_t pBit, uint8_t out[4])
+        {
+            for (uint32_t c = 0; c < 4; c++) {
+                int v  = int((e[c] - float(pBit)) * 0.5f + 0.5f);
+                out[c] = uint8_t((math::min(math::max(v, 0), 127) << 1) | int(pBit));
+            }
+        }
+
+        static void bc7Palette(const uint8_t e0[4], const uint8_t e1[4], int palette[16][4])
+        {
+            for (uint32_t k = 0; k < 16; k++) {
+                for (uint32_t c = 0; c < 4; c++) {
+                    palette[k][c] = ((64 - BC7_WEIGHTS4[k]) * e0[c] + BC7_WEIGHTS4[k] * e1[c] + 32) >> 6;
+                }
+            }
+        }
+
+        // NOTE(Noah): the palette is a line, so the nearest entry is at most one off of the projection of the pixel
+        // onto it, which saves checking all 16.
+        static uint32_t bc7PickIndices(const block_pixels_t block, const uint8_t e0[4], const uint8_t e1[4],
+            const int palette[16][4], uint8_t indices[16])
+        {
+            int d[4], lengthSq = 0;
+            for (uint32_t c = 0; c < 4; c++) d[c] = int(e1[c]) - int(e0[c]), lengthSq += d[c] * d[c];
+            uint32_t total = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                int dot = 0;
+                for (uint32_t c = 0; c < 4; c++) dot += (int(block[i][c]) - int(e0[c])) * d[c];
+                int k = (lengthSq > 0) ? int((float(dot) / float(lengthSq)) * 15.0f + 0.5f) : 0;
+                k     = math::min(math::max(k, 0), 15);
+
+                uint32_t best = UINT32_MAX;
+                for (int j = math::max(k - 1, 0); j <= math::min(k + 1, 15); j++) {
+                    uint32_t error = 0;
+                    for (uint32_t c = 0; c < 4; c++) {
+                        int e = palette[j][c] - int(block[i][c]);
+                        error += uint32_t(e * e);
+                    }
+                    if (error < best) best = error, indices[i] = uint8_t(j);
+                }
+                total += best;
+            }
+            return total;
+        }
+
+        struct bc7_candidate_t {
+            uint8_t  e0[4], e1[4];
+            uint8_t  indices[16];
+            uint32_t error;
+        };
+
+        // quantizes the ends with every pair of p-bits, or only with the p-bit that suits each end on its own.
+        static void bc7Try(const block_pixels_t block, const float e0[4], const float e1[4], bool bEveryPBit,
+            bc7_candidate_t *best)
+        {
+            uint32_t pFirst[2] = {0, 0}, pCount = bEveryPBit ? 2 : 1;
+            if (!bEveryPBit) {
+                const float *ends[2] = {e0, e1};
+                for (uint32_t e = 0; e < 2; e++) {
+                    float error[2] = {};
+                    for (uint32_t p = 0; p < 2; p++) {
+                        uint8_t q[4];
+                        bc7QuantizeEnd(ends[e], p, q);
+                        for (uint32_t c = 0; c < 4; c++) {
+                            error[p] += (float(q[c]) - ends[e][c]) * (float(q[c]) - ends[e][c]);
+                        }
+                    }
+                    pFirst[e] = (error[1] < error[0]) ? 1 : 0;
+                }
+            }
+            for (uint32_t p0 = pFirst[0]; p0 < pFirst[0] + pCount; p0++) {
+                for (uint32_t p1 = pFirst[1]; p1 < pFirst[1] + pCount; p1++) {
+                    bc7_candidate_t candidate;
+                    int             palette[16][4];
+                    bc7QuantizeEnd(e0, p0, candidate.e0);
+                    bc7QuantizeEnd(e1, p1, candidate.e1);
+                    bc7Palette(candidate.e0, candidate.e1, palette);
+                    candidate.error = bc7PickIndices(block, candidate.e0, candidate.e1, palette, candidate.indices);
+                    if (candidate.error < best->error) *best = candidate;
+                }
+            }
+        }
+
+        // tries the ends from the bounding box, and from the principal axis too, then refines the best so far by
+        // fitting the ends to its indices. best is only ever replaced by a better candidate.
+        static void bc7Search(const block_pixels_t block, bool bPrincipal, bool bEveryPBit, uint32_t refinements,
+            bc7_candidate_t *best)
+        {
+            float lo[4], hi[4];
+            blockBoundingBox(block, 4, lo, hi);
+            bc7Try(block, lo, hi, bEveryPBit, best);
+            if (bPrincipal) {
+                blockPrincipalEnds(block, 4, lo, hi);
+                bc7Try(block, lo, hi, bEveryPBit, best);
+            }
+            for (uint32_t r = 0; r < refinements && best->error > 0; r++) {
+                float weight[16], a[4], b[4];
+                for (uint32_t i = 0; i < 16; i++) weight[i] = float(BC7_WEIGHTS4[best->indices[i]]) * (1.0f / 64.0f);
+                if (!blockFitEnds(block, weight, 4, a, b)) break;
+                uint32_t error = best->error;
+                bc7Try(block, a, b, true, best);
+                if (best->error >= error) break;
+            }
+        }
+
+        static void bc7Encode(const block_pixels_t block, block_quality_t quality, uint8_t *out)
+        {
+            bc7_candidate_t best = {};
+            best.error           = UINT32_MAX;
+            if (quality == BLOCK_QUALITY_FAST) bc7Search(block, false, false, 0, &best);
+            else bc7Search(block, true, false, 1, &best);
+            // NOTE(Noah): the high quality search starts over from the normal result, so that it is never worse.
+            if (quality == BLOCK_QUALITY_HIGH) bc7Search(block, true, true, 4, &best);
+            // the first index is stored with only 3 bits, so its top bit must be 0. swapping the ends flips it.
+            if (best.indices[0] & 8) {
+                for (uint32_t c = 0; c < 4; c++) std::swap(best.e0[c], best.e1[c]);
+                for (uint32_t i = 0; i < 16; i++) best.indices[i] = uint8_t(15 - best.indices[i]);
+            }
+            bc7_bits_t bits = {};
+            bits.put(1 << 6, 7);
+            for (uint32_t c = 0; c < 4; c++) {
+                bits.put(best.e0[c] >> 1, 7);
+                bits.put(best.e1[c] >> 1, 7);
+            }
+            bits.put(best.e0[0] & 1, 1);
+            bits.put(best.e1[0] & 1, 1);
+            for (uint32_t i = 0; i < 16; i++) bits.put(best.indices[i], (i == 0) ? 3 : 4);
+            memcpy(out, bits.word, 16);
+        }
+
+        static bool bc7Decode(const uint8_t *src, block_pixels_t block)
+        {
+            bc7_bits_t bits = {};
+            memcpy(bits.word, src, 16);
+            if (bits.get(7) != (1 << 6)) return false;
+            uint8_t e0[4], e1[4];
+            for (uint32_t c = 0; c < 4; c++) {
+                e0[c] = uint8_t(bits.get(7) << 1);
+                e1[c] = uint8_t(bits.get(7) << 1);
+            }
+            uint32_t p0 = bits.get(1), p1 = bits.get(1);
+            for (uint32_t c = 0; c < 4; c++) e0[c] |= uint8_t(p0), e1[c] |= uint8_t(p1);
+            int palette[16][4];
+            bc7Palette(e0, e1, palette);
+            for (uint32_t i = 0; i < 16; i++) {
+                const int *p = palette[bits.get((i == 0) ? 3 : 4)];
+                for (uint32_t c = 0; c < 4; c++) block[i][c] = uint8_t(p[c]);
+            }
+            return true;
+        }
+
+        // ----------- [SECTION] Images -----------
+
+        static void blockEncode(
+            const block_pixels_t block, block_format_t format, block_quality_t quality, uint8_t *out)
+        {
+            switch (format) {
+                case BLOCK_FORMAT_BC1:
+                    bc1EncodeColor(block, quality, out);
+                    break;
+                case BLOCK_FORMAT_BC3:
+                    bc3EncodeAlpha(block, quality, out);
+                    bc1EncodeColor(block, quality, out + 8);
+                    break;
+                case BLOCK_FORMAT_BC7:
+                    bc7Encode(block, quality, out);
+                    break;
+            }
+        }
+
+        static bool blockDecode(const uint8_t *src, block_format_t format, block_pixels_t block)
+        {
+            switch (format) {
+                case BLOCK_FORMAT_BC1:
+                    bc1DecodeColor(src, false, block);
+                    return true;
+                case BLOCK_FORMAT_BC3:
+                    bc1DecodeColor(src + 8, true, block);
+                    bc3DecodeAlpha(src, block);
+                    return true;
+                case BLOCK_FORMAT_BC7:
+                    return bc7Decode(src, block);
+            }
+            return false;
+        }
+
+        // lays out and encodes levelCount levels, which are found in pixels at levelOffset.
+        static bool blockCompressLevels(const uint32_t *pixels, const uint32_t *levelOffset, uint32_t levelCount,
+            uint32_t width, uint32_t height, block_format_t format, block_quality_t quality, compressed_image_t *out)
+        {
+            *out = {};
+            if (pixels == nullptr || width == 0 || height == 0 || levelCount == 0) return false;
+            out->width      = width;
+            out->height     = height;
+            out->levelCount = levelCount;
+            out->format     = format;
+            for (uint32_t level = 0; level < levelCount; level++) {
+                out->levelOffset[level] = out->size;
+                out->size += blockCompressedSize(
+                    format, math::max(width >> level, 1u), math::max(height >> level, 1u));
+            }
+            out->blocks = malloc(out->size);
+            if (out->blocks == nullptr) {
+                *out = {};
+                return false;
+            }
+            // NOTE(Noah): the blocks are all independent, so each job takes a row of blocks of some level. the first
+            // level is by far the largest, and its rows alone are plenty to keep the pool busy.
+            uint32_t rowCount = 0;
+            for (uint32_t level = 0; level < levelCount; level++) {
+                rowCount += (math::max(height >> level, 1u) + 3) / 4;
+            }
+            uint32_t bytes = blockBytes(format);
+            jobs::parallelFor(rowCount, 1, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t row = begin; row < end; row++) {
+                    uint32_t level = 0, by = row;
+                    while (by >= (math::max(height >> level, 1u) + 3) / 4) {
+                        by -= (math::max(height >> level, 1u) + 3) / 4;
+                        level++;
+                    }
+                    uint32_t levelWidth  = math::max(width >> level, 1u);
+                    uint32_t levelHeight = math::max(height >> level, 1u);
+                    uint32_t blockWidth  = (levelWidth + 3) / 4;
+                    uint8_t *dst = (uint8_t *)out->blocks + out->levelOffset[level] + size_t(by) * blockWidth * bytes;
+                    for (uint32_t bx = 0; bx < blockWidth; bx++) {
+                        block_pixels_t block;
+                        blockFetch(pixels + levelOffset[level], levelWidth, levelHeight, bx, by, block);
+                        blockEncode(block, format, quality, dst + size_t(bx) * bytes);
+                    }
+                }
+            });
+            return true;
+        }
+
+        bool compressImage(
+            const loaded_image_t &image, block_format_t format, block_quality_t quality, compressed_image_t *out)
+        {
+            const uint32_t levelOffset = 0;
+            return blockCompressLevels(
+                image.pixelPointer, &levelOffset, 1, image.width, image.height, format, quality, out);
+        }
+
+        bool compressMipChain(
+            const mip_chain_t &chain, block_format_t format, block_quality_t quality, compressed_image_t *out)
+        {
+            return blockCompressLevels(
+                chain.pixels, chain.levelOffset, chain.levelCount, chain.width, chain.height, format, quality, out);
+        }
+
+        bool decompressImage(const compressed_image_t &image, uint32_t level, uint32_t *dst)
+        {
+            if (image.blocks == nullptr || level >= image.levelCount) return false;
+            uint32_t       width  = math::max(image.width >> level, 1u);
+            uint32_t       height = math::max(image.height >> level, 1u);
+            uint32_t       bytes  = blockBytes(image.format);
+            const uint8_t *src    = (const uint8_t *)image.blocks + image.levelOffset[level];
+            for (uint32_t by = 0; by < (height + 3) / 4; by++) {
+                for (uint32_t bx = 0; bx < (width + 3) / 4; bx++, src += bytes) {
+                    block_pixels_t block;
+                    if (!blockDecode(src, image.format, block)) return false;
+                    blockStore(block, width, height, bx, by, dst);
+                }
+            }
+            return true;
+        }
+
+        void freeCompressedImage(compressed_image_t *image)
+        {
+            free(image->blocks);
+            *image = {};
+        }
+
+    }  // namespace io
+}  // namespace automata_engine
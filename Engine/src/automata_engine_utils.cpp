@@ -89,4 +89,124 @@ namespace automata_engine {
         }
         return "<unknown GAME_KEY>";
     }
-}  // namespace automata_engine
\ No newline at end of file
+
+    // ----------- [SECTION] Allocators -----------
+
+    static inline size_t alignUp16(size_t x) { return (x + 15) & ~size_t(15); }
+
+    void arenaInit(arena_t *arena, void *memory, size_t size)
+    {
+        // the base is aligned so that every offset handed out is too.
+        uint8_t *base = (uint8_t *)alignUp16(size_t(memory));
+        arena->base   = base;
+        arena->size   = (size > size_t(base - (uint8_t *)memory)) ? size - size_t(base - (uint8_t *)memory) : 0;
+        arena->used   = 0;
+        arena->last   = 0;
+    }
+
+    void *arenaAlloc(arena_t *arena, size_t bytes)
+    {
+        if (bytes > arena->size - arena->used) return nullptr;
+        arena->last = arena->used;
+        arena->used = alignUp16(arena->used + bytes);
+        if (arena->used > arena->size) arena->used = arena->size;
+        return arena->base + arena->last;
+    }
+
+    void arenaReset(arena_t *arena)
+    {
+        arena->used = 0;
+        arena->last = 0;
+    }
+
+    static void *arenaRealloc(void *user, void *ptr, size_t oldBytes, size_t newBytes)
+    {
+        arena_t *arena = (arena_t *)user;
+        bool bInArena = ptr >= arena->base && ptr < arena->base + arena->size;
+        if (ptr != nullptr && !bInArena) {
+            if (newBytes == 0) {
+                free(ptr);
+                return nullptr;
+            }
+            return realloc(ptr, newBytes);
+        }
+        bool bLast = ptr != nullptr && (uint8_t *)ptr == arena->base + arena->last;
+        // the most recent block can be resized in place, and given back when freed.
+        if (bLast) {
+            arena->used = arena->last;
+            if (newBytes == 0) return nullptr;
+            if (newBytes <= arena->size - arena->last) {
+                arena->used = alignUp16(arena->last + newBytes);
+                return ptr;
+            }
+        } else if (newBytes == 0) {
+            return nullptr;
+        } else if (ptr != nullptr && newBytes <= oldBytes) {
+            return ptr;
+        }
+        void *block = arenaAlloc(arena, newBytes);
+        if (block == nullptr) block = malloc(newBytes);
+        // even when ptr was given back above, nothing has written over it yet.
+        if (block != nullptr && ptr != nullptr) memmove(block, ptr, (oldBytes < newBytes) ? oldBytes : newBytes);
+        return block;
+    }
+
+    allocator_t arenaAllocator(arena_t *arena) { return allocator_t{arenaRealloc, arena}; }
+
+    void poolInit(pool_t *pool, void *memory, size_t size, size_t blockSize)
+    {
+        uint8_t *base    = (uint8_t *)alignUp16(size_t(memory));
+        size_t   skipped = size_t(base - (uint8_t *)memory);
+        pool->base       = base;
+        pool->blockSize  = alignUp16((blockSize > sizeof(void *)) ? blockSize : sizeof(void *));
+        pool->blockCount = (size > skipped) ? (size - skipped) / pool->blockSize : 0;
+        pool->freeList   = nullptr;
+        // thread the free list through the blocks, first block first.
+        for (size_t i = pool->blockCount; i-- > 0;) {
+            void *block     = base + i * pool->blockSize;
+            *(void **)block = pool->freeList;
+            pool->freeList  = block;
+        }
+    }
+
+    void *poolAlloc(pool_t *pool)
+    {
+        void *block = pool->freeList;
+        if (block != nullptr) pool->freeList = *(void **)block;
+        return block;
+    }
+
+    void poolFree(pool_t *pool, void *block)
+    {
+        *(void **)block = pool->freeList;
+        pool->freeList  = block;
+    }
+
+    static void *poolRealloc(void *user, void *ptr, size_t oldBytes, size_t newBytes)
+    {
+        pool_t *pool     = (pool_t *)user;
+        bool    bInPool  = ptr >= pool->base && ptr < pool->base + pool->blockCount * pool->blockSize;
+        if (ptr != nullptr && !bInPool) {
+            if (newBytes == 0) {
+                free(ptr);
+                return nullptr;
+            }
+            return realloc(ptr, newBytes);
+        }
+        if (newBytes == 0) {
+            if (ptr != nullptr) poolFree(pool, ptr);
+            return nullptr;
+        }
+        // a block grows in place for free until it is full.
+        if (ptr != nullptr && newBytes <= pool->blockSize) return ptr;
+        void *block = (newBytes <= pool->blockSize) ? poolAlloc(pool) : nullptr;
+        if (block == nullptr) block = malloc(newBytes);
+        if (block != nullptr && ptr != nullptr) {
+            memcpy(block, ptr, (oldBytes < newBytes) ? oldBytes : newBytes);
+            poolFree(pool, ptr);
+        }
+        return block;
+    }
+
+    allocator_t poolAllocator(pool_t *pool) { return allocator_t{poolRealloc, pool}; }
+}  // namespace automata_engine
@@ -204,6 +204,19 @@ namespace automata_engine {
             return createImage_dumb(device, heapIdx, imageInfo, imageOut, memOut);
         }
 
+        VkFormat blockFormatToVkFormat(io::block_format_t format)
+        {
+            switch (format) {
+                case io::BLOCK_FORMAT_BC1:
+                    return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+                case io::BLOCK_FORMAT_BC3:
+                    return VK_FORMAT_BC3_UNORM_BLOCK;
+                case io::BLOCK_FORMAT_BC7:
+                    return VK_FORMAT_BC7_UNORM_BLOCK;
+            }
+            return VK_FORMAT_UNDEFINED;
+        }
+
         size_t createUploadBufferDumb(VkDevice device,
             size_t                             size,
             uint32_t                           heapIdx,
@@ -0,0 +1,336 @@
+#include <automata_engine.hpp>
+
+#include <float.h>
+#include <immintrin.h>
+
+// NOTE(Noah): this is the Amanatides & Woo "A Fast Voxel Traversal Algorithm for Ray Tracing". rather than test the
+// ray against every cube in the world, we walk the grid cells that the ray passes through, in order, and stop at the
+// first occupied one. each step is a compare and an add, so the cost scales with the length of the ray.
+//
+// face indices match doesRayIntersectWithAABB2: 0 front(-z), 1 back(+z), 2 left(-x), 3 right(+x), 4 top(+y),
+// 5 bottom(-y). a ray stepping in +x enters a cell through its left face, etc.
+
+namespace automata_engine {
+    namespace math {
+
+        static constexpr int VOXEL_FACE_NONE = -1;
+
+        // face that a ray stepping along axis in direction step enters a cell through.
+        static inline int voxelEntryFace(int axis, int step)
+        {
+            constexpr int faces[3][2] = {
+                {3, 2},  // x: stepping -x enters the right face, +x the left face.
+                {4, 5},  // y: stepping -y enters the top face, +y the bottom face.
+                {1, 0},  // z: stepping -z enters the back face, +z the front face.
+            };
+            return faces[axis][step > 0];
+        }
+
+        voxel_grid_t makeVoxelGrid(vec3_t origin, float cellSize, uint32_t dimX, uint32_t dimY, uint32_t dimZ)
+        {
+            voxel_grid_t grid = {};
+            grid.origin       = origin;
+            grid.cellSize     = cellSize;
+            grid.dimX         = dimX;
+            grid.dimY         = dimY;
+            grid.dimZ         = dimZ;
+            size_t cellCount  = size_t(dimX) * dimY * dimZ;
+            grid.occupancy    = (uint64_t *)calloc((cellCount + 63) / 64, sizeof(uint64_t));
+            return grid;
+        }
+
+        void freeVoxelGrid(voxel_grid_t grid)
+        {
+            free(grid.occupancy);
+        }
+
+        static inline size_t voxelIndex(const voxel_grid_t &grid, uint32_t x, uint32_t y, uint32_t z)
+        {
+            return size_t(x) + size_t(grid.dimX) * (size_t(y) + size_t(grid.dimY) * z);
+        }
+
+        void setVoxel(voxel_grid_t *grid, uint32_t x, uint32_t y, uint32_t z, bool bOccupied)
+        {
+            assert(x < grid->dimX && y < grid->dimY && z < grid->dimZ);
+            size_t   idx = voxelIndex(*grid, x, y, z);
+            uint64_t bit = uint64_t(1) << (idx & 63);
+            if (bOccupied) {
+                grid->occupancy[idx >> 6] |= bit;
+            } else {
+                grid->occupancy[idx >> 6] &= ~bit;
+            }
+        }
+
+        bool getVoxel(const voxel_grid_t &grid, uint32_t x, uint32_t y, uint32_t z)
+        {
+            assert(x < grid.dimX && y < grid.dimY && z < grid.dimZ);
+            size_t idx = voxelIndex(grid, x, y, z);
+            return (grid.occupancy[idx >> 6] >> (idx & 63)) & 1;
+        }
+
+        // the per-ray DDA state. everything is in grid space, where a cell is 1 unit wide. t is unchanged by the
+        // transform to grid space, so it is still in units of the (world space) ray direction.
+        struct voxel_dda_t {
+            int32_t cell[3];
+            int32_t step[3];
+            float   tNext[3];   // t at which the ray crosses the next cell boundary, per axis.
+            float   tDelta[3];  // t to cross one whole cell, per axis.
+            float   t;          // t at which the ray entered the current cell.
+            float   tLimit;     // stop walking past this.
+            int     face;
+        };
+
+        // set up the walk. for a bounded grid, the ray is first clipped to the grid bounds.
+        // returns false when the ray misses the grid entirely.
+        static bool voxelDdaSetup(const vec3_t &gridOrigin,
+            float                              cellSize,
+            const int32_t                     *dims,  // nullptr for an unbounded grid.
+            const vec3_t                      &rayOrigin,
+            const vec3_t                      &rayDir,
+            float                              tMax,
+            voxel_dda_t                       *dda)
+        {
+            const float invCell = 1.f / cellSize;
+            float       p[3]    = {(rayOrigin.x - gridOrigin.x) * invCell,
+                          (rayOrigin.y - gridOrigin.y) * invCell,
+                          (rayOrigin.z - gridOrigin.z) * invCell};
+            float       d[3]    = {rayDir.x * invCell, rayDir.y * invCell, rayDir.z * invCell};
+
+            float tEnter    = 0.f;
+            float tExit     = tMax;
+            int   enterAxis = -1;
+            if (dims) {
+                for (int a = 0; a < 3; a++) {
+                    if (d[a] == 0.f) {
+                        if (p[a] < 0.f || p[a] > float(dims[a])) return false;
+                        continue;
+                    }
+                    float t0 = (0.f - p[a]) / d[a];
+                    float t1 = (float(dims[a]) - p[a]) / d[a];
+                    if (t0 > t1) {
+                        float tmp = t0;
+                        t0        = t1;
+                        t1        = tmp;
+                    }
+                    if (t0 > tEnter) {
+                        tEnter    = t0;
+                        enterAxis = a;
+                    }
+                    tExit = min(tExit, t1);
+                }
+                if (tEnter > tExit) return false;
+            }
+
+            for (int a = 0; a < 3; a++) {
+                dda->step[a] = (d[a] > 0.f) ? 1 : ((d[a] < 0.f) ? -1 : 0);
+                float pos    = p[a] + d[a] * tEnter;
+                int   cell   = int(std::floor(pos));
+                if (dims) cell = max(0, min(cell, dims[a] - 1));
+                // NOTE: the clip above already put us on the boundary of the entry axis, but floating point error
+                // can land on either side of it. snap to the first cell inside.
+                if (a == enterAxis) cell = (dda->step[a] > 0) ? 0 : dims[a] - 1;
+                dda->cell[a] = cell;
+                if (dda->step[a] == 0) {
+                    dda->tNext[a]  = FLT_MAX;
+                    dda->tDelta[a] = FLT_MAX;
+                } else {
+                    float boundary = float(cell + (dda->step[a] > 0 ? 1 : 0));
+                    dda->tNext[a]  = (boundary - p[a]) / d[a];
+                    dda->tDelta[a] = abs(1.f / d[a]);
+                }
+            }
+            dda->t      = tEnter;
+            dda->tLimit = tExit;
+            dda->face   = (enterAxis >= 0) ? voxelEntryFace(enterAxis, dda->step[enterAxis]) : VOXEL_FACE_NONE;
+            return true;
+        }
+
+        // advance to the next cell. returns false once the ray has gone past tLimit.
+        static inline bool voxelDdaStep(voxel_dda_t *dda)
+        {
+            int axis = (dda->tNext[0] <= dda->tNext[1]) ? ((dda->tNext[0] <= dda->tNext[2]) ? 0 : 2)
+                                                        : ((dda->tNext[1] <= dda->tNext[2]) ? 1 : 2);
+            dda->t = dda->tNext[axis];
+            if (dda->t > dda->tLimit) return false;
+            dda->cell[axis] += dda->step[axis];
+            dda->tNext[axis] += dda->tDelta[axis];
+            dda->face = voxelEntryFace(axis, dda->step[axis]);
+            return true;
+        }
+
+        static inline void voxelDdaHit(const voxel_dda_t &dda, voxel_hit_t *hitOut)
+        {
+            if (!hitOut) return;
+            hitOut->x          = dda.cell[0];
+            hitOut->y          = dda.cell[1];
+            hitOut->z          = dda.cell[2];
+            hitOut->faceHitIdx = dda.face;
+            hitOut->t          = dda.t;
+        }
+
+        bool voxelRaycast(
+            const voxel_grid_t &grid, const vec3_t &rayOrigin, const vec3_t &rayDir, float tMax, voxel_hit_t *hitOut)
+        {
+            assert(rayDir.x != 0.f || rayDir.y != 0.f || rayDir.z != 0.f);
+            const int32_t dims[3] = {int32_t(grid.dimX), int32_t(grid.dimY), int32_t(grid.dimZ)};
+            voxel_dda_t   dda;
+            if (!voxelDdaSetup(grid.origin, grid.cellSize, dims, rayOrigin, rayDir, tMax, &dda)) return false;
+            do {
+                // the clip guarantees that every visited cell is inside the grid, save for floating point error at
+                // the exit boundary.
+                if (uint32_t(dda.cell[0]) >= grid.dimX || uint32_t(dda.cell[1]) >= grid.dimY ||
+                    uint32_t(dda.cell[2]) >= grid.dimZ)
+                    break;
+                if (getVoxel(grid, dda.cell[0], dda.cell[1], dda.cell[2])) {
+                    voxelDdaHit(dda, hitOut);
+                    return true;
+                }
+            } while (voxelDdaStep(&dda));
+            return false;
+        }
+
+        bool voxelRaycast(const vec3_t                               &gridOrigin,
+            float                                                     cellSize,
+            const vec3_t                                             &rayOrigin,
+            const vec3_t                                             &rayDir,
+            float                                                     tMax,
+            std::function<bool(int32_t x, int32_t y, int32_t z)> isOccupied,
+            voxel_hit_t                                              *hitOut)
+        {
+            assert(rayDir.x != 0.f || rayDir.y != 0.f || rayDir.z != 0.f);
+            voxel_dda_t dda;
+            voxelDdaSetup(gridOrigin, cellSize, nullptr, rayOrigin, rayDir, tMax, &dda);
+            do {
+                if (isOccupied(dda.cell[0], dda.cell[1], dda.cell[2])) {
+                    voxelDdaHit(dda, hitOut);
+                    return true;
+                }
+            } while (voxelDdaStep(&dda));
+            return false;
+        }
+
+        // NOTE: the batch version walks four rays at once, one per SSE lane. the setup (clip to the grid) is done
+        // per ray, then all four take their steps in lock-step with masks, and lanes retire as they hit or leave.
+        // the occupancy lookup is a gather, which SSE does not have, so it is done per lane. everything else in the
+        // step is branch-free.
+        uint32_t voxelRaycastBatch(const voxel_grid_t &grid,
+            const vec3_t                             *rayOrigins,
+            const vec3_t                             *rayDirs,
+            uint32_t                                  rayCount,
+            float                                     tMax,
+            voxel_hit_t                              *hitsOut)
+        {
+            const int32_t dims[3]  = {int32_t(grid.dimX), int32_t(grid.dimY), int32_t(grid.dimZ)};
+            const __m128i dimX     = _mm_set1_epi32(dims[0]);
+            const __m128i dimY     = _mm_set1_epi32(dims[1]);
+            const __m128i dimZ     = _mm_set1_epi32(dims[2]);
+            const __m128i minusOne = _mm_set1_epi32(-1);
+            uint32_t      hitCount = 0;
+
+            for (uint32_t base = 0; base < rayCount; base += 4) {
+                alignas(16) int32_t cell[3][4], step[3][4], face[4];
+                alignas(16) float   tNext[3][4], tDelta[3][4], t[4], tLimit[4];
+                alignas(16) int32_t active[4];
+
+                for (uint32_t lane = 0; lane < 4; lane++) {
+                    voxel_dda_t dda = {};
+                    bool        bOk = (base + lane < rayCount) && voxelDdaSetup(grid.origin,
+                                                                           grid.cellSize,
+                                                                           dims,
+                                                                           rayOrigins[base + lane],
+                                                                           rayDirs[base + lane],
+                                                                           tMax,
+                                                                           &dda);
+                    active[lane]    = bOk ? -1 : 0;
+                    for (int a = 0; a < 3; a++) {
+                        cell[a][lane]   = dda.cell[a];
+                        step[a][lane]   = dda.step[a];
+                        tNext[a][lane]  = dda.tNext[a];
+                        tDelta[a][lane] = dda.tDelta[a];
+                    }
+                    t[lane]      = dda.t;
+                    tLimit[lane] = dda.tLimit;
+                    face[lane]   = dda.face;
+                    if (base + lane < rayCount) {
+                        hitsOut[base + lane]            = {};
+                        hitsOut[base + lane].faceHitIdx = VOXEL_FACE_NONE;
+                        hitsOut[base + lane].t          = INFINITY;
+                    }
+                }
+
+                __m128i cx = _mm_load_si128((__m128i *)cell[0]), cy = _mm_load_si128((__m128i *)cell[1]),
+                        cz = _mm_load_si128((__m128i *)cell[2]);
+                __m128i sx = _mm_load_si128((__m128i *)step[0]), sy = _mm_load_si128((__m128i *)step[1]),
+                        sz = _mm_load_si128((__m128i *)step[2]);
+                __m128  nx = _mm_load_ps(tNext[0]), ny = _mm_load_ps(tNext[1]), nz = _mm_load_ps(tNext[2]);
+                __m128  dx = _mm_load_ps(tDelta[0]), dy = _mm_load_ps(tDelta[1]), dz = _mm_load_ps(tDelta[2]);
+                __m128  tv = _mm_load_ps(t), limit = _mm_load_ps(tLimit);
+                __m128i fv = _mm_load_si128((__m128i *)face);
+                // the face a lane enters through when it steps along each axis. this is fixed per ray.
+                __m128i faceX = _mm_sub_epi32(_mm_set1_epi32(2), _mm_cmplt_epi32(sx, _mm_setzero_si128()));  // 2 or 3
+                __m128i faceY = _mm_sub_epi32(_mm_set1_epi32(5), _mm_andnot_si128(_mm_cmpgt_epi32(sy, _mm_setzero_si128()),
+                                                                     _mm_set1_epi32(1)));  // 5 or 4
+                __m128i faceZ = _mm_andnot_si128(_mm_cmpgt_epi32(sz, _mm_setzero_si128()), _mm_set1_epi32(1));  // 0 or 1
+                __m128i act   = _mm_load_si128((__m128i *)active);
+
+                while (_mm_movemask_epi8(act)) {
+                    // retire lanes that walked out of the grid.
+                    __m128i inside = _mm_and_si128(
+                        _mm_and_si128(_mm_cmpgt_epi32(cx, minusOne), _mm_cmplt_epi32(cx, dimX)),
+                        _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(cy, minusOne), _mm_cmplt_epi32(cy, dimY)),
+                            _mm_and_si128(_mm_cmpgt_epi32(cz, minusOne), _mm_cmplt_epi32(cz, dimZ))));
+                    act = _mm_and_si128(act, inside);
+
+                    // occupancy gather.
+                    alignas(16) int32_t ax[4], ay[4], az[4], aa[4];
+                    _mm_store_si128((__m128i *)ax, cx);
+                    _mm_store_si128((__m128i *)ay, cy);
+                    _mm_store_si128((__m128i *)az, cz);
+                    _mm_store_si128((__m128i *)aa, act);
+                    alignas(16) int32_t hit[4];
+                    for (uint32_t lane = 0; lane < 4; lane++) {
+                        hit[lane] = (aa[lane] && getVoxel(grid, ax[lane], ay[lane], az[lane])) ? -1 : 0;
+                    }
+                    __m128i hitMask = _mm_load_si128((__m128i *)hit);
+                    if (_mm_movemask_epi8(hitMask)) {
+                        alignas(16) float   ts[4];
+                        alignas(16) int32_t fs[4];
+                        _mm_store_ps(ts, tv);
+                        _mm_store_si128((__m128i *)fs, fv);
+                        for (uint32_t lane = 0; lane < 4; lane++) {
+                            if (!hit[lane]) continue;
+                            voxel_hit_t &h = hitsOut[base + lane];
+                            h.x            = ax[lane];
+                            h.y            = ay[lane];
+                            h.z            = az[lane];
+                            h.faceHitIdx   = fs[lane];
+                            h.t            = ts[lane];
+                            hitCount++;
+                        }
+                        act = _mm_andnot_si128(hitMask, act);
+                    }
+
+                    // step every lane along the axis with the nearest boundary.
+                    __m128  mX  = _mm_and_ps(_mm_cmple_ps(nx, ny), _mm_cmple_ps(nx, nz));
+                    __m128  mY  = _mm_andnot_ps(mX, _mm_cmple_ps(ny, nz));
+                    __m128  mZ  = _mm_andnot_ps(_mm_or_ps(mX, mY), _mm_castsi128_ps(minusOne));
+                    __m128i iX  = _mm_castps_si128(mX);
+                    __m128i iY  = _mm_castps_si128(mY);
+                    __m128i iZ  = _mm_castps_si128(mZ);
+                    tv          = _mm_or_ps(_mm_or_ps(_mm_and_ps(mX, nx), _mm_and_ps(mY, ny)), _mm_and_ps(mZ, nz));
+                    act         = _mm_andnot_si128(_mm_castps_si128(_mm_cmpgt_ps(tv, limit)), act);
+                    cx          = _mm_add_epi32(cx, _mm_and_si128(iX, sx));
+                    cy          = _mm_add_epi32(cy, _mm_and_si128(iY, sy));
+                    cz          = _mm_add_epi32(cz, _mm_and_si128(iZ, sz));
+                    nx          = _mm_add_ps(nx, _mm_and_ps(mX, dx));
+                    ny          = _mm_add_ps(ny, _mm_and_ps(mY, dy));
+                    nz          = _mm_add_ps(nz, _mm_and_ps(mZ, dz));
+                    fv = _mm_or_si128(_mm_or_si128(_mm_and_si128(iX, faceX), _mm_and_si128(iY, faceY)),
+                        _mm_and_si128(iZ, faceZ));
+                }
+            }
+            return hitCount;
+        }
+
+    }  // namespace math
+}  // namespace automata_engine
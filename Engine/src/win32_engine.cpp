@@ -264,6 +264,181 @@ ae::loaded_file_t Platform_readEntireFile(const char *fileName)
 	return fileResult;
 }
 
+ae::loaded_file_t Platform_mapEntireFile(const char *fileName)
+{
+    ae::loaded_file_t fileResult = {};
+    fileResult.fileName = fileName;
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        LogLastError(GetLastError(), "Could not open file");
+        return fileResult;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0) {
+        assert(fileSize.QuadPart <= 0x7FFFFFFF);
+        // NOTE(Noah): the view keeps the mapping alive, so both handles can be closed right away.
+        HANDLE mapping = CreateFileMappingA(fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+        if (mapping != NULL) {
+            fileResult.contents = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (fileResult.contents) {
+                fileResult.contentSize = (int)fileSize.QuadPart;
+            } else {
+                LogLastError(GetLastError(), "Could not map view of file");
+            }
+            CloseHandle(mapping);
+        } else {
+            LogLastError(GetLastError(), "Could not create file mapping");
+        }
+    } else {
+        AELoggerError("Could not map file %s as it is empty or its size is unknown", fileName);
+    }
+    CloseHandle(fileHandle);
+    return fileResult;
+}
+
+void Platform_unmapFile(ae::loaded_file_t file)
+{
+    if (file.contents)
+        UnmapViewOfFile(file.contents);
+}
+
+intptr_t Platform_openFile(const char *fileName, uint64_t *sizeOut)
+{
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        LogLastError(GetLastError(), "Could not open file");
+        return 0;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        LogLastError(GetLastError(), "Could not get the size of file");
+        CloseHandle(fileHandle);
+        return 0;
+    }
+    *sizeOut = uint64_t(fileSize.QuadPart);
+    return (intptr_t)fileHandle;
+}
+
+uint32_t Platform_readFileAt(intptr_t file, uint64_t offset, void *dst, uint32_t size)
+{
+    // NOTE(Noah): the offset goes in the OVERLAPPED, so reads do not share a file pointer and may run at once.
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = DWORD(offset);
+    overlapped.OffsetHigh = DWORD(offset >> 32);
+    DWORD bytesRead       = 0;
+    if (!ReadFile((HANDLE)file, dst, size, &bytesRead, &overlapped) && GetLastError() != ERROR_HANDLE_EOF) {
+        LogLastError(GetLastError(), "Could not read file");
+    }
+    return bytesRead;
+}
+
+void Platform_closeFile(intptr_t file)
+{
+    CloseHandle((HANDLE)file);
+}
+
+// ----------- file watching -----------
+// NOTE(Noah): each watched directory gets a thread that blocks on ReadDirectoryChangesW. the threads push the
+// changed paths into a ring that the engine drains once per frame via pollFileChange. the threads live for as
+// long as the process, as there is no way to unwatch.
+#include <mutex>
+#include <thread>
+
+static constexpr uint32_t FILE_CHANGE_RING_SIZE = 256;
+
+static struct {
+    std::mutex mutex;
+    char       paths[FILE_CHANGE_RING_SIZE][MAX_PATH];
+    uint32_t   head  = 0;  // next to pop.
+    uint32_t   count = 0;
+    char      *watched[64];
+    uint32_t   watchedCount = 0;
+} g_fileChanges;
+
+static void Win32PushFileChange(const char *path)
+{
+    std::lock_guard<std::mutex> lock(g_fileChanges.mutex);
+    // an editor will often write the same file several times on save, so skip what is already queued.
+    for (uint32_t i = 0; i < g_fileChanges.count; i++) {
+        if (_stricmp(g_fileChanges.paths[(g_fileChanges.head + i) % FILE_CHANGE_RING_SIZE], path) == 0) return;
+    }
+    if (g_fileChanges.count == FILE_CHANGE_RING_SIZE) {
+        AELoggerWarn("dropped the change to %s, as too many changes are queued", path);
+        return;
+    }
+    uint32_t tail = (g_fileChanges.head + g_fileChanges.count++) % FILE_CHANGE_RING_SIZE;
+    strncpy_s(g_fileChanges.paths[tail], MAX_PATH, path, _TRUNCATE);
+}
+
+static void Win32WatchDirectoryThread(HANDLE dirHandle, std::string dirPath)
+{
+    alignas(DWORD) char buffer[32 * 1024];
+    DWORD bytesReturned;
+    while (ReadDirectoryChangesW(dirHandle, buffer, sizeof(buffer), TRUE,
+                                 FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME |
+                                     FILE_NOTIFY_CHANGE_SIZE,
+                                 &bytesReturned, NULL, NULL)) {
+        // NOTE(Noah): zero bytes means the buffer overflowed and the changes are lost.
+        if (bytesReturned == 0) {
+            AELoggerWarn("lost file changes in %s", dirPath.c_str());
+            continue;
+        }
+        for (FILE_NOTIFY_INFORMATION *info = (FILE_NOTIFY_INFORMATION *)buffer;;
+             info = (FILE_NOTIFY_INFORMATION *)((char *)info + info->NextEntryOffset)) {
+            if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED ||
+                info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                char name[MAX_PATH];
+                int  nameLength = WideCharToMultiByte(CP_UTF8, 0, info->FileName,
+                    info->FileNameLength / sizeof(WCHAR), name, sizeof(name) - 1, NULL, NULL);
+                if (nameLength > 0) {
+                    name[nameLength] = 0;
+                    std::string path = dirPath + "\\" + name;
+                    Win32PushFileChange(path.c_str());
+                }
+            }
+            if (info->NextEntryOffset == 0) break;
+        }
+    }
+    LogLastError(GetLastError(), "Stopped watching a directory for changes");
+    CloseHandle(dirHandle);
+}
+
+bool Platform_watchDirectory(const char *dirPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_fileChanges.mutex);
+        for (uint32_t i = 0; i < g_fileChanges.watchedCount; i++) {
+            if (_stricmp(g_fileChanges.watched[i], dirPath) == 0) return true;
+        }
+        if (g_fileChanges.watchedCount == _countof(g_fileChanges.watched)) {
+            AELoggerError("Could not watch %s as too many directories are watched", dirPath);
+            return false;
+        }
+    }
+    HANDLE dirHandle = CreateFileA(dirPath, FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (dirHandle == INVALID_HANDLE_VALUE) {
+        LogLastError(GetLastError(), "Could not open the directory to watch");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_fileChanges.mutex);
+        g_fileChanges.watched[g_fileChanges.watchedCount++] = _strdup(dirPath);
+    }
+    std::thread(Win32WatchDirectoryThread, dirHandle, std::string(dirPath)).detach();
+    return true;
+}
+
+bool Platform_pollFileChange(char *pathOut, uint32_t pathSize)
+{
+    std::lock_guard<std::mutex> lock(g_fileChanges.mutex);
+    if (g_fileChanges.count == 0) return false;
+    strncpy_s(pathOut, pathSize, g_fileChanges.paths[g_fileChanges.head], _TRUNCATE);
+    g_fileChanges.head = (g_fileChanges.head + 1) % FILE_CHANGE_RING_SIZE;
+    g_fileChanges.count--;
+    return true;
+}
+
 static bool g_isImGuiInitialized = false;
 #if !defined(AUTOMATA_ENGINE_DISABLE_IMGUI)
 #include "imgui.h"
@@ -1903,8 +2078,8 @@ typedef struct {
 
 static XAUDIO2_BUFFER g_xa2Buffer = {0};
 
-/// stretchy buffer.
-static win32_voice_t* g_ppSourceVoices = nullptr;
+// indexed by voice handle.
+static ae::array<win32_voice_t> g_sourceVoices;
 
 // Xaudio2 callbacks.
 
@@ -1922,21 +2097,21 @@ __declspec(selectany) XAPO_REGISTRATION_PROPERTIES AutomataXAPO::m_regProps = {
 
 // TODO(Noah): What happens if there is no buffer to play?? -_-
 void Platform_voicePlayBuffer(intptr_t voiceHandle) {
-    auto pSourceVoice = (IXAudio2SourceVoice *)g_ppSourceVoices[voiceHandle].voice;
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
     if (pSourceVoice != nullptr) {
         pSourceVoice->Start( 0 );
     }
 }
 
 void automata_engine::platform::voiceStopBuffer(intptr_t voiceHandle) {
-    auto pSourceVoice = (IXAudio2SourceVoice *)g_ppSourceVoices[voiceHandle].voice;
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
     if (pSourceVoice != nullptr) {
         pSourceVoice->Stop( 0 );
     }
 }
 
 void automata_engine::platform::voiceSetBufferVolume(intptr_t voiceHandle, float volume) {
-    auto pSourceVoice = (IXAudio2SourceVoice *)g_ppSourceVoices[voiceHandle].voice;
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
     if (pSourceVoice != nullptr) {
         pSourceVoice->SetVolume( volume );
     }
@@ -1965,7 +2140,7 @@ static IXAudio2* g_pXAudio2 = nullptr;
 // when voice creation fails.
 intptr_t Platform_createVoice() {
 
-    uint32_t newVoiceIdx = StretchyBufferCount(g_ppSourceVoices);
+    uint32_t newVoiceIdx = uint32_t(g_sourceVoices.count);
     IXAudio2SourceVoice* newVoice = nullptr;
     
     auto voiceCallback = new ae::IXAudio2VoiceCallback(newVoiceIdx); 
@@ -2005,7 +2180,7 @@ intptr_t Platform_createVoice() {
     }
 
     win32_voice_t w32NewVoice = {newVoice, voiceCallback, atoXAPO};
-    StretchyBufferPush(g_ppSourceVoices, w32NewVoice);
+    g_sourceVoices.push(w32NewVoice);
     return (intptr_t)newVoiceIdx;
 }
 
@@ -2031,7 +2206,7 @@ intptr_t Platform_createVoice() {
 // compilation. i.e. file might not exist and shader could have syntax errs.
 // in these cases, the game has to deal with such errors.
 static bool Platform_voiceSubmitBuffer2(intptr_t voiceHandle, void *data, uint32_t size, bool shouldLoop) {
-    auto pSourceVoice = (IXAudio2SourceVoice *)g_ppSourceVoices[voiceHandle].voice;
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
     if (pSourceVoice != nullptr) {
         if (FAILED(pSourceVoice->Stop(0))) { return false; }
         if (FAILED(pSourceVoice->FlushSourceBuffers())) { return false; }
@@ -2051,6 +2226,23 @@ static bool Platform_voiceSubmitBuffer2(intptr_t voiceHandle, void *data, uint32
     return !FAILED(pSourceVoice->SubmitSourceBuffer(&g_xa2Buffer));
 }
 
+static bool Platform_voiceQueueBuffer(intptr_t voiceHandle, const void *data, uint32_t size) {
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
+    if (pSourceVoice == nullptr) return false;
+    XAUDIO2_BUFFER buffer = {};
+    buffer.AudioBytes = size;
+    buffer.pAudioData = (const BYTE *)data;
+    return !FAILED(pSourceVoice->SubmitSourceBuffer(&buffer));
+}
+
+static uint32_t Platform_voiceGetQueuedBufferCount(intptr_t voiceHandle) {
+    auto pSourceVoice = (IXAudio2SourceVoice *)g_sourceVoices[voiceHandle].voice;
+    if (pSourceVoice == nullptr) return 0;
+    XAUDIO2_VOICE_STATE state;
+    pSourceVoice->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+    return state.BuffersQueued;
+}
+
 bool automata_engine::platform::voiceSubmitBuffer(intptr_t voiceHandle, void *data, uint32_t size, bool shouldLoop) {
     return Platform_voiceSubmitBuffer2(voiceHandle, data, size, shouldLoop);
 }
@@ -2201,7 +2393,7 @@ struct Win32CachedMonitorData
 
 unsigned int g_monitorCount = 0;
 
-Win32CachedMonitorData *g_cachedMonitorData = nullptr; // stretchy buffer.
+ae::array<Win32CachedMonitorData> g_cachedMonitorData;
 
 static BOOL CALLBACK Win32MonitorEnumProc(HMONITOR hMon, HDC hdc, LPRECT lprcMonitor, LPARAM pData)
 {
@@ -2209,7 +2401,7 @@ static BOOL CALLBACK Win32MonitorEnumProc(HMONITOR hMon, HDC hdc, LPRECT lprcMon
         .hmon = hMon, .rect = *lprcMonitor
     };
 
-    StretchyBufferPush(g_cachedMonitorData, monData);
+    g_cachedMonitorData.push(monData);
 
     g_monitorCount++;
 
@@ -2669,10 +2861,21 @@ int CALLBACK WinMain(HINSTANCE instance,
     ae::EM->pfn.readEntireFile      = Platform_readEntireFile;
     ae::EM->pfn.writeEntireFile     = Platform_writeEntireFile;
     ae::EM->pfn.freeLoadedFile      = Platform_freeLoadedFile;
+    ae::EM->pfn.mapEntireFile       = Platform_mapEntireFile;
+    ae::EM->pfn.unmapFile           = Platform_unmapFile;
+    ae::EM->pfn.watchDirectory      = Platform_watchDirectory;
+    ae::EM->pfn.pollFileChange      = Platform_pollFileChange;
+    ae::EM->pfn.openFile            = Platform_openFile;
+    ae::EM->pfn.readFileAt          = Platform_readFileAt;
+    ae::EM->pfn.closeFile           = Platform_closeFile;
+    ae::EM->pfn.pathExists          = ae::platform::pathExists;
     ae::EM->pfn.setAdditionalLogger = Platform_setAdditionalLogger;
     ae::EM->pfn.voicePlayBuffer     = Platform_voicePlayBuffer;
     ae::EM->pfn.voiceSubmitBuffer   = Platform_voiceSubmitBuffer;
     ae::EM->pfn.createVoice         = Platform_createVoice;
+    ae::EM->pfn.voiceQueueBuffer    = Platform_voiceQueueBuffer;
+
+    ae::EM->pfn.voiceGetQueuedBufferCount = Platform_voiceGetQueuedBufferCount;
     ae::EM->pfn.getGpuInfos         = Platform_getGpuInfos;
     ae::EM->pfn.freeGpuInfos        = Platform_freeGpuInfos;
 
@@ -3235,17 +3438,18 @@ int CALLBACK WinMain(HINSTANCE instance,
         Win32ResizeBackbuffer(&g_ncBackbuffer, 0, 0);
 
         // before kill Xaudio2, stop all audio and flush, for all voices.
-        for (uint32_t i = 0; i < StretchyBufferCount(g_ppSourceVoices); i++) {
-            if (g_ppSourceVoices[i].voice != nullptr) {
+        for (uint32_t i = 0; i < g_sourceVoices.count; i++) {
+            if (g_sourceVoices[i].voice != nullptr) {
                 // wait for audio thread to finish.
-                g_ppSourceVoices[i].voice->DestroyVoice();
-                delete g_ppSourceVoices[i].callback;
-                delete g_ppSourceVoices[i].xapo;
+                g_sourceVoices[i].voice->DestroyVoice();
+                delete g_sourceVoices[i].callback;
+                delete g_sourceVoices[i].xapo;
             }
         }
+        g_sourceVoices.reset();
 
         // destory the cached monitor data.
-        StretchyBufferFree(g_cachedMonitorData);
+        g_cachedMonitorData.reset();
 
         // Free XAudio2 resources.
         if (g_pXAudio2 != nullptr) { g_pXAudio2->Release(); }
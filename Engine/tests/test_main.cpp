@@ -1,7 +1,29 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch.hpp>
 
 #include <automata_engine.hpp>
+#include <stb_ds.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// the job pool is not joined by a static destructor, so stop it once the run is over, as shutdownModuleGlobals would.
+struct job_pool_listener_t : Catch::TestEventListenerBase {
+    using TestEventListenerBase::TestEventListenerBase;
+    void testRunEnded(Catch::TestRunStats const &) override { ae::jobs::_close(); }
+};
+CATCH_REGISTER_LISTENER(job_pool_listener_t)
 
 unsigned int Factorial( unsigned int number ) {
     return number <= 1 ? number : Factorial(number-1)*number;
@@ -146,6 +168,3316 @@ TEST_CASE( "signed angle", "[ae::math]" ) {
     REQUIRE(abs(ang)>halfPi);
 }
 
+TEST_CASE("BVH queries match brute force", "[ae::math]") {
+    using namespace ae::math;
+    utils::Seed(1337);
+    constexpr uint32_t boxCount = 2000;
+    aabb_t *boxes = (aabb_t *)malloc(sizeof(aabb_t) * boxCount);
+    for (uint32_t i = 0; i < boxCount; i++) {
+        vec3_t p = { utils::RandomFloat(-50, 50), utils::RandomFloat(-50, 50), utils::RandomFloat(-50, 50) };
+        vec3_t s = { utils::RandomFloat(0.1f, 2), utils::RandomFloat(0.1f, 2), utils::RandomFloat(0.1f, 2) };
+        boxes[i] = aabb_t::fromLine(p, p + s);
+    }
+
+    // brute force closest hit, using the same entry distance convention as the BVH.
+    auto bruteClosest = [&](vec3_t o, vec3_t d, float tMax, float *tOut) -> uint32_t {
+        uint32_t best = BVH_INVALID;
+        float bestT = tMax;
+        for (uint32_t i = 0; i < boxCount; i++) {
+            float t0 = 0, t1 = bestT;
+            bool bHit = true;
+            for (int a = 0; a < 3 && bHit; a++) {
+                float lo = ((&boxes[i].min.x)[a] - (&o.x)[a]) / (&d.x)[a];
+                float hi = ((&boxes[i].max.x)[a] - (&o.x)[a]) / (&d.x)[a];
+                if (lo > hi) { float tmp = lo; lo = hi; hi = tmp; }
+                t0 = max(t0, lo);
+                t1 = min(t1, hi);
+                bHit = t0 <= t1;
+            }
+            if (bHit && t0 <= bestT) { best = i; bestT = t0; }
+        }
+        *tOut = bestT;
+        return best;
+    };
+
+    auto checkRays = [&](bvh_t &bvh) {
+        for (uint32_t r = 0; r < 500; r++) {
+            vec3_t o = { utils::RandomFloat(-80, 80), utils::RandomFloat(-80, 80), utils::RandomFloat(-80, 80) };
+            vec3_t d = normalize(vec3_t(utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1)));
+            float bruteT;
+            uint32_t brute = bruteClosest(o, d, 1000.f, &bruteT);
+            bvh_hit_t hit;
+            bool bHit = bvhClosestHit(bvh, o, d, 1000.f, &hit);
+            REQUIRE( bHit == (brute != BVH_INVALID) );
+            REQUIRE( bvhAnyHit(bvh, o, d, 1000.f) == bHit );
+            if (bHit) REQUIRE( hit.t == Approx(bruteT).margin(1e-4f) );
+        }
+    };
+
+    bvh_t bvh = buildBvh(boxes, boxCount);
+    REQUIRE( bvh.primCount == boxCount );
+    checkRays(bvh);
+
+    SECTION( "overlap reports every overlapping box" ) {
+        uint32_t prims[boxCount];
+        for (uint32_t q = 0; q < 100; q++) {
+            vec3_t p = { utils::RandomFloat(-50, 50), utils::RandomFloat(-50, 50), utils::RandomFloat(-50, 50) };
+            aabb_t query = aabb_t::fromLine(p, p + vec3_t(8, 8, 8));
+            uint32_t expected = 0;
+            for (uint32_t i = 0; i < boxCount; i++) {
+                const aabb_t &b = boxes[i];
+                expected += (b.min.x <= query.max.x && b.max.x >= query.min.x && b.min.y <= query.max.y &&
+                             b.max.y >= query.min.y && b.min.z <= query.max.z && b.max.z >= query.min.z);
+            }
+            REQUIRE( bvhOverlap(bvh, query, prims, boxCount) == expected );
+        }
+    }
+    SECTION( "refit after boxes move" ) {
+        for (uint32_t i = 0; i < boxCount; i++) {
+            vec3_t delta = { utils::RandomFloat(-5, 5), utils::RandomFloat(-5, 5), utils::RandomFloat(-5, 5) };
+            boxes[i] = aabb_t::fromLine(boxes[i].min + delta, boxes[i].max + delta);
+        }
+        refitBvh(&bvh, boxes);
+        checkRays(bvh);
+    }
+
+    freeBvh(bvh);
+    free(boxes);
+}
+
+TEST_CASE("BVH parallel build", "[ae::math]") {
+    using namespace ae::math;
+    utils::Seed(4242);
+    // well above BVH_PARALLEL_THRESHOLD so that subtrees are built on the job pool.
+    std::vector<aabb_t> boxes(100000);
+    for (aabb_t &box : boxes) {
+        vec3_t p = { utils::RandomFloat(-100, 100), utils::RandomFloat(-100, 100), utils::RandomFloat(-100, 100) };
+        box = aabb_t::fromLine(p, p + vec3_t(1, 1, 1));
+    }
+    bvh_t bvh = buildBvh(boxes.data(), uint32_t(boxes.size()));
+    std::vector<uint32_t> prims(boxes.size());
+    std::vector<uint8_t> seen(boxes.size(), 0);
+    REQUIRE( bvhOverlap(bvh, bvh.bounds, prims.data(), uint32_t(prims.size())) == boxes.size() );
+    for (uint32_t p : prims) seen[p]++;
+    REQUIRE( std::count(seen.begin(), seen.end(), 1) == int64_t(boxes.size()) );
+    for (uint32_t q = 0; q < 50; q++) {
+        vec3_t p = { utils::RandomFloat(-100, 100), utils::RandomFloat(-100, 100), utils::RandomFloat(-100, 100) };
+        aabb_t query = aabb_t::fromLine(p, p + vec3_t(10, 10, 10));
+        uint32_t expected = 0;
+        for (const aabb_t &b : boxes) {
+            expected += (b.min.x <= query.max.x && b.max.x >= query.min.x && b.min.y <= query.max.y &&
+                         b.max.y >= query.min.y && b.min.z <= query.max.z && b.max.z >= query.min.z);
+        }
+        REQUIRE( bvhOverlap(bvh, query, prims.data(), uint32_t(prims.size())) == expected );
+    }
+    freeBvh(bvh);
+}
+
+TEST_CASE("BVH over triangles", "[ae::math]") {
+    using namespace ae::math;
+    // a unit quad in the z=0 plane made of two triangles.
+    ae::raw_model_t model = {};
+    float verts[] = {
+        0, 0, 0, 0, 0, 0, 0, 1,
+        1, 0, 0, 0, 0, 0, 0, 1,
+        1, 1, 0, 0, 0, 0, 0, 1,
+        0, 1, 0, 0, 0, 0, 0, 1,
+    };
+    for (float f : verts) StretchyBufferPush(model.vertexData, f);
+    uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+    for (uint32_t i : indices) StretchyBufferPush(model.indexData, i);
+
+    bvh_t bvh = buildBvh(model);
+    bvh_hit_t hit;
+    REQUIRE( bvhClosestHit(bvh, vec3_t(0.75f, 0.25f, -1), vec3_t(0, 0, 1), 10.f, &hit) );
+    REQUIRE( hit.primIndex == 0 );
+    REQUIRE( hit.t == Approx(1.f) );
+    REQUIRE( bvhClosestHit(bvh, vec3_t(0.25f, 0.75f, 2), vec3_t(0, 0, -1), 10.f, &hit) );
+    REQUIRE( hit.primIndex == 1 );
+    REQUIRE( hit.t == Approx(2.f) );
+    REQUIRE( !bvhAnyHit(bvh, vec3_t(2, 2, -1), vec3_t(0, 0, 1), 10.f) );
+    REQUIRE( !bvhAnyHit(bvh, vec3_t(0.5f, 0.5f, -1), vec3_t(0, 0, 1), 0.5f) );
+
+    // move the quad and refit.
+    for (uint32_t v = 0; v < 4; v++) model.vertexData[8 * v + 2] = 5.f;
+    refitBvh(&bvh, model);
+    REQUIRE( bvhClosestHit(bvh, vec3_t(0.75f, 0.25f, -1), vec3_t(0, 0, 1), 10.f, &hit) );
+    REQUIRE( hit.t == Approx(6.f) );
+
+    freeBvh(bvh);
+    StretchyBufferFree(model.vertexData);
+    StretchyBufferFree(model.indexData);
+}
+
+TEST_CASE("parallelFor covers the range once", "[ae::jobs]") {
+    for (uint32_t count : {1u, 1000u, 4096u, 100001u}) {
+        std::vector<std::atomic<uint32_t>> hits(count);
+        ae::jobs::parallelFor(count, 64, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) hits[i]++;
+        });
+        REQUIRE( std::all_of(hits.begin(), hits.end(), [](const std::atomic<uint32_t> &h) { return h == 1; }) );
+    }
+    // ranges near the top of uint32_t, where begin + grainSize wraps. nothing is touched, only the ranges counted.
+    std::atomic<uint64_t> covered = 0;
+    std::atomic<uint32_t> ranges  = 0;
+    ae::jobs::parallelFor(UINT32_MAX, 0x60000000u, [&](uint32_t begin, uint32_t end) {
+        covered += end - begin;
+        ranges++;
+    });
+    REQUIRE( covered == UINT32_MAX );
+    REQUIRE( ranges == 3 );
+}
+
+TEST_CASE("frustum culling", "[ae::math]") {
+    using namespace ae::math;
+    camera_t cam = {};
+    cam.trans.scale = vec3_t(1, 1, 1);
+    cam.fov = 90.f;
+    cam.nearPlane = 0.1f;
+    cam.farPlane = 100.f;
+    cam.width = cam.height = 100;
+
+    // the camera looks down -z. at z=-10, a 90 degree fov spans x and y in [-10, 10].
+    float ox[] = { 0,   0,    0,    20,   9.5f, 0,     0,     -10.5f };
+    float oy[] = { 0,   0,    0,    0,    0,    -9.5f, 0,     0      };
+    float oz[] = { -10, 10,   -200, -10,  -10,  -10,   -0.05f, -10   };
+    float hd[] = { 1,   1,    1,    1,    0.1f, 0.1f,  0.01f, 1      };
+    bool expected[] = { true, false, false, false, true, true, false, true };
+    constexpr uint32_t count = _countof(ox);
+
+    aabb_soa_t boxes = { ox, oy, oz, hd, hd, hd, count };
+    sphere_soa_t spheres = { ox, oy, oz, hd, count };
+
+    for (bool forVk : { false, true }) {
+        frustum_t f = buildFrustum(cam, forVk);
+        uint32_t bits;
+        frustumCullAabbs(f, boxes, 0, count, &bits);
+        uint32_t sphereBits;
+        frustumCullSpheres(f, spheres, 0, count, &sphereBits);
+        for (uint32_t i = 0; i < count; i++) {
+            REQUIRE( bool(bits & (1 << i)) == expected[i] );
+            REQUIRE( bool(sphereBits & (1 << i)) == expected[i] );
+        }
+        uint32_t indices[count];
+        uint32_t visible = frustumCullAabbsCompact(f, boxes, 0, count, indices);
+        REQUIRE( visible == 4 );
+        REQUIRE( indices[0] == 0 );
+        REQUIRE( indices[1] == 4 );
+        REQUIRE( indices[2] == 5 );
+        REQUIRE( indices[3] == 7 );
+        REQUIRE( frustumCullSpheresCompact(f, spheres, 0, count, indices) == 4 );
+    }
+
+    SECTION( "split across the job pool" ) {
+        constexpr uint32_t n = 10000;
+        static float x[n], y[n], z[n], h[n];
+        utils::Seed(42);
+        for (uint32_t i = 0; i < n; i++) {
+            x[i] = utils::RandomFloat(-50, 50);
+            y[i] = utils::RandomFloat(-50, 50);
+            z[i] = utils::RandomFloat(-150, 50);
+            h[i] = utils::RandomFloat(0.1f, 3);
+        }
+        aabb_soa_t many = { x, y, z, h, h, h, n };
+        frustum_t f = buildFrustum(cam);
+        static uint32_t serialBits[(n + 31) / 32], parallelBits[(n + 31) / 32];
+        frustumCullAabbs(f, many, 0, n, serialBits);
+        ae::jobs::parallelFor(n, 32 * 16, [&](uint32_t begin, uint32_t end) {
+            frustumCullAabbs(f, many, begin, end, parallelBits);
+        });
+        REQUIRE( memcmp(serialBits, parallelBits, sizeof(serialBits)) == 0 );
+        static uint32_t indices[n];
+        uint32_t visible = frustumCullAabbsCompact(f, many, 0, n, indices);
+        uint32_t popCount = 0;
+        for (uint32_t i = 0; i < n; i++) popCount += (serialBits[i / 32] >> (i % 32)) & 1;
+        REQUIRE( visible == popCount );
+        for (uint32_t i = 0; i < visible; i++) REQUIRE( (serialBits[indices[i] / 32] >> (indices[i] % 32)) & 1 );
+    }
+}
+
+namespace utils {
+    // distance between a float result and a double reference, in units of the ulp of the reference.
+    double UlpError(float value, double reference) {
+        float mag = (float)std::fabs(reference);
+        double ulp = (mag < FLT_MIN) ? std::ldexp(1.0, -149) : std::ldexp(1.0, std::ilogb(mag) - 23);
+        return std::fabs((double)value - reference) / ulp;
+    }
+
+    template <typename FN_approx, typename FN_ref>
+    double MaxUlpError(FN_approx approx, FN_ref ref, float lo, float hi, double minMagnitude = 0.0) {
+        constexpr int steps = 200000;
+        double maxErr = 0.0;
+        for (int i = 0; i <= steps; i++) {
+            float x = lo + (hi - lo) * (float)i / (float)steps;
+            double r = ref((double)x);
+            if (std::fabs(r) < minMagnitude) continue;
+            maxErr = (std::max)(maxErr, UlpError(approx(x), r));
+        }
+        return maxErr;
+    }
+}
+
+TEST_CASE("approx transcendentals are within their documented error", "[ae::math::approx]") {
+    namespace fast = ae::math::fast;
+    namespace accurate = ae::math::accurate;
+    auto refSin = [](double x) { return std::sin(x); };
+    auto refCos = [](double x) { return std::cos(x); };
+    auto refRsqrt = [](double x) { return 1.0 / std::sqrt(x); };
+    auto refExp2 = [](double x) { return std::exp2(x); };
+    auto refLog2 = [](double x) { return std::log2(x); };
+
+    REQUIRE( utils::MaxUlpError([](float x) { return fast::sin(x); }, refSin, -8192, 8192, 1e-3) <= 32 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::sin(x); }, refSin, -8192, 8192, 1e-3) <= 2 );
+    REQUIRE( utils::MaxUlpError([](float x) { return fast::cos(x); }, refCos, -8192, 8192, 1e-3) <= 32 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::cos(x); }, refCos, -8192, 8192, 1e-3) <= 2 );
+    REQUIRE( utils::MaxUlpError([](float x) { return fast::rsqrt(x); }, refRsqrt, 1e-6f, 1e6f) <= 4 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::rsqrt(x); }, refRsqrt, 1e-6f, 1e6f) <= 2 );
+    REQUIRE( utils::MaxUlpError([](float x) { return fast::exp2(x); }, refExp2, -126, 127) <= 48 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::exp2(x); }, refExp2, -126, 127) <= 2 );
+    REQUIRE( utils::MaxUlpError([](float x) { return fast::log2(x); }, refLog2, 0.25f, 4, 1.0 / 1024) <= 1024 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::log2(x); }, refLog2, 0.25f, 4, 1.0 / 1024) <= 2 );
+    REQUIRE( utils::MaxUlpError([](float x) { return accurate::log2(x); }, refLog2, 1e-30f, 1e30f, 1.0 / 1024) <= 2 );
+
+    // sweep atan2 around the circle at a range of radii.
+    double fastAtan2Err = 0, accurateAtan2Err = 0;
+    for (int i = 0; i < 200000; i++) {
+        double angle = -PI + 2.0 * PI * i / 200000.0;
+        double radius = 0.001 + (i % 997);
+        float y = (float)(radius * std::sin(angle));
+        float x = (float)(radius * std::cos(angle));
+        double ref = std::atan2((double)y, (double)x);
+        fastAtan2Err = (std::max)(fastAtan2Err, utils::UlpError(fast::atan2(y, x), ref));
+        accurateAtan2Err = (std::max)(accurateAtan2Err, utils::UlpError(accurate::atan2(y, x), ref));
+    }
+    REQUIRE( fastAtan2Err <= 512 );
+    REQUIRE( accurateAtan2Err <= 4 );
+
+    SECTION( "special values" ) {
+        REQUIRE( accurate::log2(0.f) == -INFINITY );
+        REQUIRE( std::isnan(accurate::log2(-1.f)) );
+        REQUIRE( accurate::log2(INFINITY) == INFINITY );
+        REQUIRE( accurate::exp2(-200.f) == 0.f );
+        REQUIRE( accurate::exp2(200.f) == INFINITY );
+        REQUIRE( accurate::atan2(0.f, 0.f) == 0.f );
+        REQUIRE( accurate::atan2(0.f, -1.f) == Approx(PI) );
+        REQUIRE( accurate::atan2(-0.f, -1.f) == Approx(-PI) );
+    }
+
+    SECTION( "scalar, SIMD and array paths agree exactly" ) {
+        constexpr uint32_t count = 37; // not a multiple of the SIMD width, to exercise the tail.
+        float in[count], in2[count], out[count];
+        for (uint32_t i = 0; i < count; i++) {
+            in[i] = 0.37f * (float)i - 5.f;
+            in2[i] = 1.1f * (float)i + 0.5f;
+        }
+        accurate::sin(in, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == accurate::sin(in[i]) );
+        fast::cos(in, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == fast::cos(in[i]) );
+        accurate::exp2(in, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == accurate::exp2(in[i]) );
+        fast::log2(in2, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == fast::log2(in2[i]) );
+        accurate::rsqrt(in2, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == accurate::rsqrt(in2[i]) );
+        accurate::atan2(in, in2, out, count);
+        for (uint32_t i = 0; i < count; i++) REQUIRE( out[i] == accurate::atan2(in[i], in2[i]) );
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, fast::sin(_mm_loadu_ps(in)));
+        for (uint32_t i = 0; i < 4; i++) REQUIRE( lanes[i] == fast::sin(in[i]) );
+    }
+}
+
+TEST_CASE("approx transcendentals vs CRT", "[!benchmark][ae::math::approx]") {
+    constexpr uint32_t count = 1 << 16;
+    static float in[count], inPos[count], out[count];
+    for (uint32_t i = 0; i < count; i++) {
+        in[i] = utils::RandomFloat(-100, 100);
+        inPos[i] = utils::RandomFloat(0.001f, 1000);
+    }
+
+    BENCHMARK("sin CRT") { for (uint32_t i = 0; i < count; i++) out[i] = std::sin(in[i]); return out[0]; };
+    BENCHMARK("sin fast") { ae::math::fast::sin(in, out, count); return out[0]; };
+    BENCHMARK("sin accurate") { ae::math::accurate::sin(in, out, count); return out[0]; };
+    BENCHMARK("atan2 CRT") { for (uint32_t i = 0; i < count; i++) out[i] = std::atan2(in[i], inPos[i]); return out[0]; };
+    BENCHMARK("atan2 fast") { ae::math::fast::atan2(in, inPos, out, count); return out[0]; };
+    BENCHMARK("atan2 accurate") { ae::math::accurate::atan2(in, inPos, out, count); return out[0]; };
+    BENCHMARK("rsqrt CRT") { for (uint32_t i = 0; i < count; i++) out[i] = 1.f / std::sqrt(inPos[i]); return out[0]; };
+    BENCHMARK("rsqrt fast") { ae::math::fast::rsqrt(inPos, out, count); return out[0]; };
+    BENCHMARK("rsqrt accurate") { ae::math::accurate::rsqrt(inPos, out, count); return out[0]; };
+    BENCHMARK("exp2 CRT") { for (uint32_t i = 0; i < count; i++) out[i] = std::exp2(in[i]); return out[0]; };
+    BENCHMARK("exp2 fast") { ae::math::fast::exp2(in, out, count); return out[0]; };
+    BENCHMARK("exp2 accurate") { ae::math::accurate::exp2(in, out, count); return out[0]; };
+    BENCHMARK("log2 CRT") { for (uint32_t i = 0; i < count; i++) out[i] = std::log2(inPos[i]); return out[0]; };
+    BENCHMARK("log2 fast") { ae::math::fast::log2(inPos, out, count); return out[0]; };
+    BENCHMARK("log2 accurate") { ae::math::accurate::log2(inPos, out, count); return out[0]; };
+}
+
+TEST_CASE("voxel grid DDA raycast", "[ae::math]") {
+    using namespace ae::math;
+    utils::Seed(7);
+    constexpr uint32_t dim = 24;
+    voxel_grid_t grid = makeVoxelGrid(vec3_t(-6, -6, -6), 0.5f, dim, dim, dim);
+    for (uint32_t z = 0; z < dim; z++)
+        for (uint32_t y = 0; y < dim; y++)
+            for (uint32_t x = 0; x < dim; x++)
+                if (utils::RandomUINT32(0, 99) < 3) setVoxel(&grid, x, y, z, true);
+
+    SECTION( "hits the expected face of a single voxel" ) {
+        voxel_grid_t one = makeVoxelGrid(vec3_t(0, 0, 0), 1.f, 4, 4, 4);
+        setVoxel(&one, 2, 1, 1, true);
+        voxel_hit_t hit;
+        REQUIRE( voxelRaycast(one, vec3_t(-3, 1.5f, 1.5f), vec3_t(1, 0, 0), 100.f, &hit) );
+        REQUIRE( (hit.x == 2 && hit.y == 1 && hit.z == 1) );
+        REQUIRE( hit.faceHitIdx == 2 ); // left.
+        REQUIRE( hit.t == Approx(5.f) );
+        REQUIRE( voxelRaycast(one, vec3_t(2.5f, 1.5f, 10), vec3_t(0, 0, -2), 100.f, &hit) );
+        REQUIRE( hit.faceHitIdx == 1 ); // back.
+        REQUIRE( hit.t == Approx(4.f) );
+        REQUIRE( voxelRaycast(one, vec3_t(2.5f, 3.5f, 1.5f), vec3_t(0, -1, 0), 100.f, &hit) );
+        REQUIRE( hit.faceHitIdx == 4 ); // top.
+        REQUIRE( !voxelRaycast(one, vec3_t(-3, 1.5f, 1.5f), vec3_t(1, 0, 0), 4.f, &hit) );
+        REQUIRE( voxelRaycast(one, vec3_t(2.5f, 1.5f, 1.5f), vec3_t(1, 0, 0), 100.f, &hit) );
+        REQUIRE( hit.faceHitIdx == -1 ); // started inside.
+        freeVoxelGrid(one);
+    }
+
+    SECTION( "matches brute force, callback and batch variants" ) {
+        constexpr uint32_t rayCount = 301;
+        vec3_t origins[rayCount], dirs[rayCount];
+        voxel_hit_t hits[rayCount];
+        for (uint32_t r = 0; r < rayCount; r++) {
+            origins[r] = vec3_t(utils::RandomFloat(-10, 10), utils::RandomFloat(-10, 10), utils::RandomFloat(-10, 10));
+            dirs[r] = vec3_t(utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1));
+        }
+        uint32_t batchHits = voxelRaycastBatch(grid, origins, dirs, rayCount, 50.f, hits);
+        uint32_t scalarHits = 0;
+        for (uint32_t r = 0; r < rayCount; r++) {
+            // brute force: the nearest occupied cell by slab test.
+            float bestT = INFINITY;
+            for (uint32_t z = 0; z < dim; z++)
+                for (uint32_t y = 0; y < dim; y++)
+                    for (uint32_t x = 0; x < dim; x++) {
+                        if (!getVoxel(grid, x, y, z)) continue;
+                        vec3_t lo = grid.origin + vec3_t(float(x), float(y), float(z)) * grid.cellSize;
+                        float t0 = 0.f, t1 = 50.f;
+                        for (int a = 0; a < 3; a++) {
+                            float ta = (lo[a] - origins[r][a]) / dirs[r][a];
+                            float tb = (lo[a] + grid.cellSize - origins[r][a]) / dirs[r][a];
+                            t0 = max(t0, min(ta, tb));
+                            t1 = min(t1, max(ta, tb));
+                        }
+                        if (t0 <= t1) bestT = min(bestT, t0);
+                    }
+
+            voxel_hit_t hit;
+            bool bHit = voxelRaycast(grid, origins[r], dirs[r], 50.f, &hit);
+            scalarHits += bHit;
+            REQUIRE( bHit == (bestT != INFINITY) );
+            if (!bHit) {
+                REQUIRE( hits[r].t == INFINITY );
+                continue;
+            }
+            REQUIRE( hit.t == Approx(bestT).margin(1e-4) );
+            REQUIRE( getVoxel(grid, hit.x, hit.y, hit.z) );
+            REQUIRE( (hits[r].x == hit.x && hits[r].y == hit.y && hits[r].z == hit.z) );
+            REQUIRE( hits[r].faceHitIdx == hit.faceHitIdx );
+            REQUIRE( hits[r].t == hit.t );
+
+            voxel_hit_t cbHit;
+            REQUIRE( voxelRaycast(grid.origin, grid.cellSize, origins[r], dirs[r], 50.f,
+                [&](int32_t x, int32_t y, int32_t z) {
+                    return x >= 0 && y >= 0 && z >= 0 && x < int32_t(dim) && y < int32_t(dim) && z < int32_t(dim) &&
+                           getVoxel(grid, x, y, z);
+                }, &cbHit) );
+            REQUIRE( cbHit.t == Approx(hit.t).margin(1e-4) );
+        }
+        REQUIRE( batchHits == scalarHits );
+    }
+
+    freeVoxelGrid(grid);
+}
+
+TEST_CASE("spatial hash broadphase", "[ae::math]") {
+    using namespace ae::math;
+    utils::Seed(99);
+    constexpr uint32_t boxCount = 1500;
+    aabb_t boxes[boxCount];
+    auto randomBox = [](float spread) {
+        vec3_t p = { utils::RandomFloat(-spread, spread), utils::RandomFloat(-spread, spread), utils::RandomFloat(-spread, spread) };
+        vec3_t s = { utils::RandomFloat(0.1f, 1.5f), utils::RandomFloat(0.1f, 1.5f), utils::RandomFloat(0.1f, 1.5f) };
+        return aabb_t::fromLine(p, p + s);
+    };
+    spatial_hash_t *hash = createSpatialHash(1.f, boxCount);
+    uint32_t handles[boxCount];
+    for (uint32_t i = 0; i < boxCount; i++) {
+        // one in a hundred boxes is huge, to go down the big box path.
+        boxes[i] = (i % 100 == 0) ? aabb_t::make({ 0, 0, 0 }, { 8, 3, 8 }) : randomBox(20);
+        handles[i] = spatialHashInsert(hash, boxes[i]);
+    }
+
+    auto overlap = [](const aabb_t &a, const aabb_t &b) {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+               a.min.z <= b.max.z && a.max.z >= b.min.z;
+    };
+    auto checkPairs = [&](const bool *alive) {
+        std::vector<uint64_t> expected;
+        for (uint32_t i = 0; i < boxCount; i++)
+            for (uint32_t j = i + 1; j < boxCount; j++)
+                if (alive[i] && alive[j] && overlap(boxes[i], boxes[j]))
+                    expected.push_back((uint64_t(min(handles[i], handles[j])) << 32) | max(handles[i], handles[j]));
+        std::vector<spatial_pair_t> pairs(expected.size() + 1);
+        REQUIRE( spatialHashFindPairs(hash, pairs.data(), uint32_t(pairs.size())) == expected.size() );
+        std::vector<uint64_t> got;
+        for (size_t i = 0; i < expected.size(); i++) {
+            REQUIRE( pairs[i].a < pairs[i].b );
+            got.push_back((uint64_t(pairs[i].a) << 32) | pairs[i].b);
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(got.begin(), got.end());
+        REQUIRE( got == expected );
+    };
+
+    bool alive[boxCount];
+    for (uint32_t i = 0; i < boxCount; i++) alive[i] = true;
+    checkPairs(alive);
+
+    SECTION( "after moving and removing boxes" ) {
+        for (uint32_t i = 0; i < boxCount; i++) {
+            if (i % 7 == 0) {
+                spatialHashRemove(hash, handles[i]);
+                alive[i] = false;
+            } else if (i % 100 != 0) {
+                vec3_t d = { utils::RandomFloat(-0.5f, 0.5f), 0, utils::RandomFloat(-0.5f, 0.5f) };
+                boxes[i] = aabb_t::fromLine(boxes[i].min + d, boxes[i].max + d);
+                spatialHashUpdate(hash, handles[i], boxes[i]);
+            }
+        }
+        checkPairs(alive);
+
+        // growing the boxes pushes the cell entry count past what the hash has room for.
+        for (uint32_t i = 0; i < boxCount; i += 3) {
+            if (!alive[i] || i % 100 == 0) continue;
+            boxes[i] = aabb_t::fromLine(boxes[i].min, boxes[i].max + vec3_t(1, 1, 1));
+            spatialHashUpdate(hash, handles[i], boxes[i]);
+        }
+        checkPairs(alive);
+    }
+
+    SECTION( "box and sphere queries" ) {
+        static uint32_t found[boxCount];
+        for (uint32_t q = 0; q < 50; q++) {
+            aabb_t query = randomBox(20);
+            uint32_t expected = 0;
+            for (uint32_t i = 0; i < boxCount; i++) expected += overlap(query, boxes[i]);
+            REQUIRE( spatialHashQueryBox(hash, query, found, boxCount) == expected );
+
+            vec3_t c = query.origin;
+            float r = 2.5f;
+            expected = 0;
+            for (uint32_t i = 0; i < boxCount; i++) {
+                float dx = max(max(boxes[i].min.x - c.x, 0.f), c.x - boxes[i].max.x);
+                float dy = max(max(boxes[i].min.y - c.y, 0.f), c.y - boxes[i].max.y);
+                float dz = max(max(boxes[i].min.z - c.z, 0.f), c.z - boxes[i].max.z);
+                expected += (dx * dx + dy * dy + dz * dz <= r * r);
+            }
+            REQUIRE( spatialHashQuerySphere(hash, c, r, found, boxCount) == expected );
+        }
+
+        // queries that cover far more cells than are occupied, up to the whole coordinate range.
+        for (float r : {12.f, 30.f, 1e7f}) {
+            vec3_t c = {3, -2, 1};
+            uint32_t expected = 0;
+            for (uint32_t i = 0; i < boxCount; i++) {
+                float dx = max(max(boxes[i].min.x - c.x, 0.f), c.x - boxes[i].max.x);
+                float dy = max(max(boxes[i].min.y - c.y, 0.f), c.y - boxes[i].max.y);
+                float dz = max(max(boxes[i].min.z - c.z, 0.f), c.z - boxes[i].max.z);
+                expected += (dx * dx + dy * dy + dz * dz <= r * r);
+            }
+            REQUIRE( spatialHashQuerySphere(hash, c, r, found, boxCount) == expected );
+            REQUIRE( spatialHashQueryBox(hash, aabb_t::make(c, vec3_t(r, r, r)), found, boxCount) >= expected );
+        }
+    }
+
+    destroySpatialHash(hash);
+}
+
+TEST_CASE("nc::str toolkit", "[nc::str]") {
+    using nc::str::view_t;
+
+    SECTION( "scans match a byte at a time" ) {
+        // long enough to go through the 32 and 16 byte loops and the scalar tail, from every start offset.
+        std::string text(300, 'a');
+        for (uint32_t i = 0; i < text.size(); i++) text[i] = "ab,\n\r"[utils::RandomUINT32(0, 4)];
+        const char *data = text.data(), *end = data + text.size();
+        for (uint32_t start = 0; start < 64; start++) {
+            for (uint32_t length = 0; start + length <= text.size(); length += 7) {
+                const char *p = data + start, *q = p + length;
+                const char *comma = p, *eol = p;
+                while (comma < q && *comma != ',') comma++;
+                while (eol < q && *eol != '\n' && *eol != '\r') eol++;
+                REQUIRE( nc::str::findChar(p, q, ',') == comma );
+                REQUIRE( nc::str::findLineEnd(p, q) == eol );
+            }
+        }
+        REQUIRE( nc::str::findChar(end, end, ',') == end );
+
+        // enough bytes that the per-lane counts have to be flushed.
+        std::string big(20000 + 13, 'x');
+        size_t expected = 0;
+        for (auto &c : big) expected += (c = (utils::RandomUINT32(0, 3) == 0) ? ',' : 'x') == ',';
+        REQUIRE( nc::str::countChar(big.data(), big.data() + big.size(), ',') == expected );
+        std::string all(5000, ',');
+        REQUIRE( nc::str::countChar(all.data(), all.data() + all.size(), ',') == all.size() );
+    }
+
+    SECTION( "lines and tokens" ) {
+        const char *text = "\r\na,1\r\n\r\nbb,,2,\nccc";
+        const char *cursor = text, *end = text + strlen(text);
+        std::vector<std::string> lines;
+        view_t line;
+        while (nc::str::nextLine(&cursor, end, &line)) lines.emplace_back(line.data, line.length);
+        REQUIRE( lines == std::vector<std::string>{"a,1", "bb,,2,", "ccc"} );
+        REQUIRE( cursor == end );
+
+        std::vector<std::string> tokens;
+        nc::str::forEachToken(view_t{"bb,,2,", 6}, ',', [&](view_t token, uint32_t index) {
+            REQUIRE( index == tokens.size() );
+            tokens.emplace_back(token.data, token.length);
+        });
+        REQUIRE( tokens == std::vector<std::string>{"bb", "", "2"} );
+        REQUIRE( (view_t{"bb,", 2} == "bb") );
+        REQUIRE( !(view_t{"bb,", 2} == "bb,") );
+
+        tokens.clear();
+        nc::str::forEachWord(view_t{"  f 1/2/3\t\t4//5 6 ", 18}, [&](view_t word, uint32_t) {
+            tokens.emplace_back(word.data, word.length);
+        });
+        REQUIRE( tokens == std::vector<std::string>{"f", "1/2/3", "4//5", "6"} );
+
+        std::vector<int64_t> ints;
+        nc::str::forEachInt(view_t{"4, -5,x,+6", 10}, ',', [&](int64_t v, uint32_t) { ints.push_back(v); });
+        REQUIRE( ints == std::vector<int64_t>{4, -5, 0, 6} );
+        std::vector<float> floats;
+        nc::str::forEachFloat(view_t{"0.5 -2e1 .25", 12}, ' ', [&](float v, uint32_t) { floats.push_back(v); });
+        REQUIRE( floats == std::vector<float>{0.5f, -20.f, 0.25f} );
+    }
+
+    SECTION( "integers" ) {
+        auto parse = [](const char *s, int64_t *v) { return int(nc::str::parseInt(s, s + strlen(s), v) - s); };
+        int64_t v;
+        REQUIRE( parse("-42x", &v) == 3 );
+        REQUIRE( v == -42 );
+        REQUIRE( parse("+7", &v) == 2 );
+        REQUIRE( v == 7 );
+        REQUIRE( parse("-x", &v) == 0 );
+        REQUIRE( v == 0 );
+        REQUIRE( parse("99999999999999999999999", &v) == 23 );
+        REQUIRE( v == INT64_MAX );
+        REQUIRE( parse("-99999999999999999999999", &v) == 24 );
+        REQUIRE( v == INT64_MIN );
+        // right at the edges, where saturating a digit early would go wrong.
+        REQUIRE( (parse("9223372036854775800", &v) == 19 && v == INT64_MAX - 7) );
+        REQUIRE( (parse("9223372036854775807", &v) == 19 && v == INT64_MAX) );
+        REQUIRE( (parse("9223372036854775808", &v) == 19 && v == INT64_MAX) );
+        REQUIRE( (parse("-9223372036854775801", &v) == 20 && v == INT64_MIN + 7) );
+        REQUIRE( (parse("-9223372036854775808", &v) == 20 && v == INT64_MIN) );
+        REQUIRE( (parse("-9223372036854775809", &v) == 20 && v == INT64_MIN) );
+    }
+
+    SECTION( "floats round the same as strtof" ) {
+        auto check = [](const std::string &s) {
+            float v = -1.f;
+            const char *end = nc::str::parseFloat(s.data(), s.data() + s.size(), &v);
+            char *expectedEnd;
+            float expected = strtof(s.c_str(), &expectedEnd);
+            INFO( s );
+            REQUIRE( end - s.data() == expectedEnd - s.c_str() );
+            if (std::isnan(expected)) REQUIRE( std::isnan(v) );
+            else REQUIRE( memcmp(&v, &expected, sizeof(float)) == 0 );
+        };
+        for (const char *s : {"0", "-0", "+1.5", ".5", "5.", "1e3", "1E-3", "2e", "1e+", "inf", "-infinity", "nan",
+                              "1e39", "-1e39", "1e-50", "1e-40", "3.4028235e38", "1.17549435e-38", "123456789012",
+                              "0.1", "1.00000017881393432", "1.00000005960464478", "16777217", "x", "-", "."}) {
+            check(s);
+        }
+        // hex floats are not taken, so only the 0 is.
+        const char *hexText = "0x1p3";
+        float hex = -1.f;
+        REQUIRE( nc::str::parseFloat(hexText, hexText + 5, &hex) == hexText + 1 );
+        REQUIRE( hex == 0.f );
+        for (uint32_t i = 0; i < 100000; i++) {
+            std::string s = (utils::RandomUINT32(0, 1) ? "-" : "");
+            uint32_t digits = utils::RandomUINT32(1, 20), point = utils::RandomUINT32(0, digits);
+            for (uint32_t d = 0; d < digits; d++) {
+                if (d == point) s += '.';
+                s += char('0' + utils::RandomUINT32(0, 9));
+            }
+            if (utils::RandomUINT32(0, 2) == 0) s += "e" + std::to_string(int(utils::RandomUINT32(0, 60)) - 30);
+            check(s);
+        }
+    }
+
+    SECTION( "older null-terminated functions" ) {
+        char text[] = "1,-2,,3.5\nlast";
+        char *line = text;
+        uint32_t lineLen = 0;
+        REQUIRE( nc::str::getLine(&line, &lineLen) == nc::str::NC_EOL );
+        REQUIRE( lineLen == 9 );
+        std::vector<std::string> tokens;
+        nc::str::split(line, int32_t(lineLen), ',', [&](char *token, uint32_t) { tokens.push_back(token); });
+        REQUIRE( tokens == std::vector<std::string>{"1", "-2", "", "3.5"} );
+        std::vector<int> ints;
+        nc::str::splitInt(line, int32_t(lineLen), ',', [&](int v, uint32_t) { ints.push_back(v); });
+        REQUIRE( ints == std::vector<int>{1, -2, 0, 3} );
+        std::vector<float> floats;
+        nc::str::splitFloat(line, int32_t(lineLen), ',', [&](float v, uint32_t) { floats.push_back(v); });
+        REQUIRE( floats == std::vector<float>{1.f, -2.f, 0.f, 3.5f} );
+        REQUIRE( strcmp(text, "1,-2,,3.5\nlast") == 0 );  // the text was not written to.
+
+        // n delimiters always give n + 1 tokens, so a trailing delimiter ends with an empty one.
+        char trailing[] = "4,5,";
+        tokens.clear();
+        nc::str::split(trailing, -1, ',', [&](char *token, uint32_t) { tokens.push_back(token); });
+        REQUIRE( tokens == std::vector<std::string>{"4", "5", ""} );
+        ints.clear();
+        nc::str::splitInt(trailing, -1, ',', [&](int v, uint32_t) { ints.push_back(v); });
+        REQUIRE( ints == std::vector<int>{4, 5, 0} );
+        floats.clear();
+        nc::str::splitFloat(trailing, -1, ',', [&](float v, uint32_t index) { floats.push_back(v + index); });
+        REQUIRE( floats == std::vector<float>{4.f, 6.f, 2.f} );
+        tokens.clear();
+        nc::str::split(trailing, 0, ',', [&](char *token, uint32_t) { tokens.push_back(token); });
+        REQUIRE( tokens == std::vector<std::string>{""} );
+
+        line += lineLen;
+        REQUIRE( nc::str::getLine(&line, &lineLen) == nc::str::NC_EOL );
+        REQUIRE( lineLen == 4 );
+        line += lineLen;
+        REQUIRE( nc::str::getLine(&line, &lineLen) == nc::str::NC_EOF );
+
+        // the token buffer is per thread, so threads can split at the same time.
+        std::string longLine;
+        for (uint32_t i = 0; i < 1000; i++) longLine += std::string(i % 300, char('a' + i % 26)) + ",";
+        std::atomic<uint32_t> bad = 0;
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; t++) {
+            threads.emplace_back([&]() {
+                std::string copy = longLine;
+                nc::str::split(copy.data(), -1, ',', [&](char *token, uint32_t index) {
+                    // the trailing comma gives one more, empty, token.
+                    if (index == 1000) bad += token[0] != 0;
+                    else bad += (strlen(token) != index % 300) || (index % 300 && token[0] != char('a' + index % 26));
+                });
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        REQUIRE( bad == 0 );
+    }
+}
+
+// the byte at a time getLine and splitFloat that nc::str had before, to measure the toolkit against.
+namespace legacy_str {
+    static void getLine(char **pLine, uint32_t *pLineLen) {
+        uint32_t lineLen = 0;
+        while (nc::str::isEOL((*pLine)[0])) *pLine += 1;
+        while (!nc::str::isEOLOrEOF((*pLine)[lineLen])) lineLen++;
+        *pLineLen = lineLen;
+    }
+    static void splitFloat(char *line, int32_t lineLen, char delimiter, std::function<void(float, uint32_t)> f) {
+        static char funBuffer[256];
+        std::function<void(char *, uint32_t)> g = [=](char *token, uint32_t index) { f(float(atof(token)), index); };
+        uint32_t index = 0;
+        char *base = line;
+        for (int32_t i = 0; i < lineLen; i++) {
+            if (line[i] == delimiter) {
+                line[i] = 0;
+                g(base, index++);
+                base = line + i + 1;
+                line[i] = delimiter;
+            }
+        }
+        if (base - line <= lineLen) {
+            uint32_t lastTokenLen = uint32_t(lineLen - (base - line));
+            memcpy(funBuffer, base, lastTokenLen);
+            funBuffer[lastTokenLen] = 0;
+            g(funBuffer, index);
+        }
+    }
+}
+
+TEST_CASE("nc::str throughput", "[nc::str][!benchmark]") {
+    // about a megabyte of OBJ-like lines of floats.
+    std::string text;
+    for (uint32_t i = 0; i < 40000; i++) {
+        text += std::to_string(utils::RandomFloat(-10, 10)) + "," + std::to_string(utils::RandomFloat(-10, 10)) +
+                "," + std::to_string(utils::RandomFloat(-10, 10)) + "\r\n";
+    }
+    std::string legacyText = text;  // getLine wants it mutable.
+
+    BENCHMARK("byte at a time getLine + splitFloat") {
+        float sum = 0.f;
+        char *line = legacyText.data();
+        uint32_t lineLen = 0;
+        for (legacy_str::getLine(&line, &lineLen); *line; line += lineLen, legacy_str::getLine(&line, &lineLen)) {
+            legacy_str::splitFloat(line, int32_t(lineLen), ',', [&](float v, uint32_t) { sum += v; });
+        }
+        return sum;
+    };
+    BENCHMARK("getLine + splitFloat") {
+        float sum = 0.f;
+        char *line = legacyText.data();
+        uint32_t lineLen = 0;
+        while (nc::str::getLine(&line, &lineLen) == nc::str::NC_EOL) {
+            nc::str::splitFloat(line, int32_t(lineLen), ',', [&](float v, uint32_t) { sum += v; });
+            line += lineLen;
+        }
+        return sum;
+    };
+    BENCHMARK("nextLine + forEachFloat") {
+        float sum = 0.f;
+        const char *cursor = text.data(), *end = cursor + text.size();
+        nc::str::view_t line;
+        while (nc::str::nextLine(&cursor, end, &line)) {
+            nc::str::forEachFloat(line, ',', [&](float v, uint32_t) { sum += v; });
+        }
+        return sum;
+    };
+    BENCHMARK("strtof") {
+        float sum = 0.f;
+        for (const char *p = text.data(); *p;) {
+            char *next;
+            sum += strtof(p, &next);
+            p = next + 1 + (*next == '\r');
+        }
+        return sum;
+    };
+    BENCHMARK("parseFloat") {
+        float sum = 0.f;
+        for (const char *p = text.data(), *end = p + text.size(); p < end;) {
+            float v;
+            const char *next = nc::str::parseFloat(p, end, &v);
+            sum += v;
+            p = next + 1 + (*next == '\r');
+        }
+        return sum;
+    };
+    BENCHMARK("memchr lines") {
+        size_t lines = 0;
+        for (const char *p = text.data(), *end = p + text.size(); p < end; lines++) {
+            const char *nl = (const char *)memchr(p, '\n', end - p);
+            p = nl ? nl + 1 : end;
+        }
+        return lines;
+    };
+    BENCHMARK("countChar lines") { return nc::str::countChar(text.data(), text.data() + text.size(), '\n'); };
+}
+
+// counts how many are alive, to catch leaked or doubly destroyed items.
+struct array_tracked_t {
+    static int alive;
+    std::string value;
+    array_tracked_t(std::string v = "") : value(std::move(v)) { alive++; }
+    array_tracked_t(const array_tracked_t &o) : value(o.value) { alive++; }
+    array_tracked_t(array_tracked_t &&o) : value(std::move(o.value)) { alive++; }
+    array_tracked_t &operator=(array_tracked_t &&o) = default;
+    ~array_tracked_t() { alive--; }
+};
+int array_tracked_t::alive = 0;
+
+TEST_CASE("ae::array", "[ae::array]") {
+    auto isInline = [](const auto &a) {
+        return (const uint8_t *)a.data >= (const uint8_t *)&a && (const uint8_t *)a.data < (const uint8_t *)(&a + 1);
+    };
+
+    SECTION( "push, reserve and resize" ) {
+        ae::array<uint32_t> a;
+        REQUIRE( a.data == nullptr );
+        for (uint32_t i = 0; i < 10000; i++) a.push(i * 3);
+        REQUIRE( a.count == 10000 );
+        for (uint32_t i = 0; i < 10000; i++) REQUIRE( a[i] == i * 3 );
+        a.reserve(50000);
+        const uint32_t *before = a.data;
+        for (uint32_t i = 0; i < 40000; i++) a.push(i);
+        REQUIRE( a.data == before );
+        REQUIRE( a.capacity == 50000 );
+
+        a.resize(4);
+        REQUIRE( (a.count == 4 && a.back() == 9) );
+        a.resize(6);
+        REQUIRE( (a[4] == 0 && a[5] == 0) );
+        a.removeSwap(1);
+        REQUIRE( (a.count == 5 && a[1] == 0) );
+        uint32_t *tail = a.extend(3);
+        tail[0] = 7, tail[1] = 8, tail[2] = 9;
+        const uint32_t more[] = {10, 11};
+        a.append(more, 2);
+        REQUIRE( (a.count == 10 && a[7] == 9 && a[9] == 11) );
+
+        // pushing an item of the array itself, right when the array has to grow.
+        ae::array<uint32_t> b;
+        b.push(42);
+        while (b.count < b.capacity) b.push(1);
+        b.push(b[0]);
+        REQUIRE( b.back() == 42 );
+
+        a.reset();
+        REQUIRE( (a.data == nullptr && a.count == 0 && a.capacity == 0) );
+    }
+
+    SECTION( "inline items" ) {
+        ae::array<uint32_t, 8> a;
+        for (uint32_t i = 0; i < 8; i++) a.push(i);
+        REQUIRE( isInline(a) );
+        a.push(8);
+        REQUIRE( !isInline(a) );
+        for (uint32_t i = 0; i < 9; i++) REQUIRE( a[i] == i );
+
+        ae::array<uint32_t, 8> small;
+        small.push(5);
+        ae::array<uint32_t, 8> moved = std::move(small);
+        REQUIRE( (isInline(moved) && moved.count == 1 && moved[0] == 5 && small.count == 0) );
+        ae::array<uint32_t, 8> movedBig = std::move(a);
+        REQUIRE( (!isInline(movedBig) && movedBig.count == 9 && isInline(a) && a.count == 0) );
+    }
+
+    SECTION( "items with constructors and destructors" ) {
+        {
+            ae::array<array_tracked_t, 2> a;
+            for (uint32_t i = 0; i < 100; i++) a.emplace(std::string(40, char('a' + i % 26)));
+            REQUIRE( array_tracked_t::alive == 100 );
+            a.push(a[3]);
+            REQUIRE( a.back().value == std::string(40, 'd') );
+            a.removeSwap(0);
+            REQUIRE( a[0].value == std::string(40, 'd') );
+            a.pop();
+            a.resize(10);
+            REQUIRE( array_tracked_t::alive == 10 );
+            ae::array<array_tracked_t, 2> b = std::move(a);
+            REQUIRE( array_tracked_t::alive == 10 );
+            REQUIRE( b[9].value == std::string(40, 'j') );
+        }
+        REQUIRE( array_tracked_t::alive == 0 );
+
+        // arrays of arrays grow with realloc, and must keep their inner blocks.
+        ae::array<ae::array<uint32_t>> nested;
+        for (uint32_t i = 0; i < 100; i++) {
+            nested.emplace();
+            for (uint32_t j = 0; j <= i; j++) nested.back().push(j);
+        }
+        for (uint32_t i = 0; i < 100; i++) REQUIRE( (nested[i].count == i + 1 && nested[i][i] == i) );
+    }
+
+    SECTION( "arena" ) {
+        static uint8_t memory[4096 + 8];
+        ae::arena_t arena;
+        ae::arenaInit(&arena, memory + 3, 4096);
+        REQUIRE( size_t(arena.base) % 16 == 0 );
+        {
+            ae::array<uint32_t> a(ae::arenaAllocator(&arena));
+            a.push(1);
+            REQUIRE( ((uint8_t *)a.data >= arena.base && (uint8_t *)a.data < arena.base + arena.size) );
+            // the only block in the arena grows in place.
+            const uint32_t *first = a.data;
+            for (uint32_t i = 0; i < 500; i++) a.push(i);
+            REQUIRE( a.data == first );
+            // until it no longer fits, and moves to the heap.
+            for (uint32_t i = 0; i < 1000; i++) a.push(i);
+            REQUIRE( !((uint8_t *)a.data >= arena.base && (uint8_t *)a.data < arena.base + arena.size) );
+            REQUIRE( (a.count == 1501 && a[1500] == 999 && a[500] == 499) );
+            REQUIRE( arena.used == 0 );  // the block was given back when it moved.
+        }
+        ae::array<uint64_t> b(ae::arenaAllocator(&arena)), c(ae::arenaAllocator(&arena));
+        b.resize(10);
+        c.resize(10);
+        b.resize(20);  // not the latest block any more, so it is copied.
+        REQUIRE( ((uint8_t *)b.data > (uint8_t *)c.data) );
+        ae::arenaReset(&arena);
+        REQUIRE( arena.size == 4096 - 13 );
+        REQUIRE( ae::arenaAlloc(&arena, arena.size + 1) == nullptr );
+        REQUIRE( ae::arenaAlloc(&arena, arena.size) == arena.base );
+        b.data = nullptr, b.count = b.capacity = 0;  // the arena has been reset under them.
+        c.data = nullptr, c.count = c.capacity = 0;
+    }
+
+    SECTION( "pool" ) {
+        static uint8_t memory[64 * 16];
+        ae::pool_t pool;
+        ae::poolInit(&pool, memory, sizeof(memory), 60);
+        REQUIRE( (pool.blockSize == 64 && pool.blockCount == 16) );
+        auto inPool = [&](const void *p) {
+            return (const uint8_t *)p >= pool.base && (const uint8_t *)p < pool.base + 64 * 16;
+        };
+        {
+            ae::array<ae::array<uint32_t>> arrays;
+            for (uint32_t i = 0; i < 20; i++) {
+                arrays.emplace(ae::poolAllocator(&pool));
+                for (uint32_t j = 0; j < 16; j++) arrays[i].push(i);
+            }
+            // 16 blocks, so the last four are on the heap.
+            for (uint32_t i = 0; i < 20; i++) REQUIRE( inPool(arrays[i].data) == (i < 16) );
+            arrays[0].push(0);  // 17 items no longer fit in a block.
+            REQUIRE( !inPool(arrays[0].data) );
+            REQUIRE( ae::poolAlloc(&pool) == memory );  // so its block went back to the pool.
+            ae::poolFree(&pool, memory);
+        }
+        uint32_t freeBlocks = 0;
+        for (void *b = pool.freeList; b; b = *(void **)b) freeBlocks++;
+        REQUIRE( freeBlocks == 16 );
+    }
+
+    SECTION( "stretchy buffer shims" ) {
+        uint32_t *sb = nullptr;
+        for (uint32_t i = 0; i < 100; i++) StretchyBufferPush(sb, i);
+        ae::array<uint32_t> a = ae::arrayFromStretchyBuffer(sb);
+        REQUIRE( sb == nullptr );
+        REQUIRE( (a.count == 100 && a[99] == 99) );
+        uint32_t *back = ae::arrayToStretchyBuffer(a);
+        REQUIRE( (StretchyBufferCount(back) == 100 && back[42] == 42) );
+        StretchyBufferFree(back);
+        REQUIRE( back == nullptr );
+        StretchyBufferFree(back);  // freeing twice is now harmless.
+    }
+}
+
+TEST_CASE("ae::array throughput", "[ae::array][!benchmark]") {
+    constexpr uint32_t count = 1 << 20;
+    static uint8_t arenaMemory[count * sizeof(uint32_t) * 2];
+
+    BENCHMARK("StretchyBufferPush 1M") {
+        uint32_t *sb = nullptr;
+        for (uint32_t i = 0; i < count; i++) StretchyBufferPush(sb, i);
+        uint32_t last = sb[count - 1];
+        StretchyBufferFree(sb);
+        return last;
+    };
+    BENCHMARK("array push 1M") {
+        ae::array<uint32_t> a;
+        for (uint32_t i = 0; i < count; i++) a.push(i);
+        return a.back();
+    };
+    BENCHMARK("array push 1M reserved") {
+        ae::array<uint32_t> a;
+        a.reserve(count);
+        for (uint32_t i = 0; i < count; i++) a.push(i);
+        return a.back();
+    };
+    BENCHMARK("array push 1M arena") {
+        ae::arena_t arena;
+        ae::arenaInit(&arena, arenaMemory, sizeof(arenaMemory));
+        ae::array<uint32_t> a(ae::arenaAllocator(&arena));
+        for (uint32_t i = 0; i < count; i++) a.push(i);
+        return a.back();
+    };
+    BENCHMARK("std::vector push_back 1M") {
+        std::vector<uint32_t> v;
+        for (uint32_t i = 0; i < count; i++) v.push_back(i);
+        return v.back();
+    };
+
+    // lots of little arrays, like the attribute lists of a scene's meshes.
+    constexpr uint32_t arrayCount = 1 << 14;
+    static uint8_t poolMemory[arrayCount * 64 + 16];
+    BENCHMARK("16k stretchy buffers of 6") {
+        static uint32_t *sbs[arrayCount];
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < arrayCount; i++) {
+            sbs[i] = nullptr;
+            for (uint32_t j = 0; j < 6; j++) StretchyBufferPush(sbs[i], j);
+        }
+        for (uint32_t i = 0; i < arrayCount; i++) sum += sbs[i][5], StretchyBufferFree(sbs[i]);
+        return sum;
+    };
+    BENCHMARK("16k arrays of 6") {
+        ae::array<ae::array<uint32_t>> arrays;
+        arrays.reserve(arrayCount);
+        for (uint32_t i = 0; i < arrayCount; i++) {
+            ae::array<uint32_t> &a = arrays.emplace();
+            for (uint32_t j = 0; j < 6; j++) a.push(j);
+        }
+        return arrays[arrayCount - 1][5];
+    };
+    BENCHMARK("16k arrays of 6, inline") {
+        ae::array<ae::array<uint32_t, 8>> arrays;
+        arrays.reserve(arrayCount);
+        for (uint32_t i = 0; i < arrayCount; i++) {
+            ae::array<uint32_t, 8> &a = arrays.emplace();
+            for (uint32_t j = 0; j < 6; j++) a.push(j);
+        }
+        return arrays[arrayCount - 1][5];
+    };
+    BENCHMARK("16k arrays of 6, pool") {
+        ae::pool_t pool;
+        ae::poolInit(&pool, poolMemory, sizeof(poolMemory), 64);
+        ae::array<ae::array<uint32_t>> arrays;
+        arrays.reserve(arrayCount);
+        for (uint32_t i = 0; i < arrayCount; i++) {
+            ae::array<uint32_t> &a = arrays.emplace(ae::poolAllocator(&pool));
+            for (uint32_t j = 0; j < 6; j++) a.push(j);
+        }
+        return arrays[arrayCount - 1][5];
+    };
+}
+
+TEST_CASE("ae::hash_map", "[ae::hash_map]") {
+    SECTION( "matches std::unordered_map under random inserts and removes" ) {
+        ae::hash_map<uint64_t, uint32_t> map;
+        std::unordered_map<uint64_t, uint32_t> reference;
+        for (uint32_t i = 0; i < 200000; i++) {
+            uint64_t key = utils::RandomUINT32(0, 4095);
+            switch (utils::RandomUINT32(0, 2)) {
+                case 0: {
+                    bool bInserted;
+                    uint32_t &value = map.findOrInsert(key, i, &bInserted);
+                    auto result = reference.insert({key, i});
+                    REQUIRE( bInserted == result.second );
+                    REQUIRE( value == result.first->second );
+                } break;
+                case 1:
+                    REQUIRE( map.remove(key) == (reference.erase(key) == 1) );
+                    break;
+                case 2: {
+                    const uint32_t *value = map.find(key);
+                    auto it = reference.find(key);
+                    REQUIRE( (value != nullptr) == (it != reference.end()) );
+                    if (value) REQUIRE( *value == it->second );
+                } break;
+            }
+            REQUIRE( map.size() == reference.size() );
+        }
+        size_t visited = 0;
+        map.forEach([&](uint64_t key, uint32_t &value) {
+            visited++;
+            REQUIRE( reference.at(key) == value );
+        });
+        REQUIRE( visited == reference.size() );
+    }
+
+    SECTION( "reserve, tombstones and rehash" ) {
+        ae::hash_map<uint32_t, uint32_t> map;
+        map.reserve(1000);
+        const size_t capacity = map.capacity;
+        const int8_t *ctrl = map.ctrl;
+        for (uint32_t i = 0; i < 1000; i++) map[i] = i * 2;
+        REQUIRE( (map.ctrl == ctrl && map.capacity == capacity) );
+
+        // churning keys through a full table reuses the tombstones rather than growing.
+        for (uint32_t round = 0; round < 50; round++) {
+            for (uint32_t i = 0; i < 1000; i++) REQUIRE( map.remove(round * 1000 + i) );
+            for (uint32_t i = 0; i < 1000; i++) map[(round + 1) * 1000 + i] = i;
+        }
+        REQUIRE( (map.size() == 1000 && map.capacity == capacity) );
+        REQUIRE( (map.contains(50999) && !map.contains(49999)) );
+
+        for (uint32_t i = 51000; i < 100000; i++) map[i] = i;
+        REQUIRE( map.capacity > capacity );
+        for (uint32_t i = 50000; i < 99000; i++) map.remove(i);
+        map.rehash(0);
+        REQUIRE( (map.size() == 1000 && map.capacity == capacity) );
+        for (uint32_t i = 99000; i < 100000; i++) REQUIRE( *map.find(i) == i );
+
+        map.clear();
+        REQUIRE( (map.empty() && !map.contains(99000) && map.capacity == capacity) );
+        map.reset();
+        REQUIRE( (map.ctrl == nullptr && map.capacity == 0 && map.find(1) == nullptr) );
+    }
+
+    SECTION( "string keys" ) {
+        const char *names[] = {"pong", "raytracer", "ray", "raytracer_gpu", "blocks"};
+        ae::hash_map<const char *, uint32_t, ae::string_hasher_t> map;
+        for (uint32_t i = 0; i < 5; i++) map[names[i]] = i;
+        std::string lookup = "ray";
+        REQUIRE( *map.find(lookup.c_str()) == 2 );
+        lookup += "tracer";
+        REQUIRE( *map.find(lookup.c_str()) == 1 );
+        REQUIRE( map.find("raytrace") == nullptr );
+    }
+
+    SECTION( "struct keys and non-trivial values" ) {
+        struct key_t {
+            uint32_t a, b;
+        };
+        array_tracked_t::alive = 0;
+        {
+            ae::hash_map<key_t, array_tracked_t> map;
+            for (uint32_t i = 0; i < 1000; i++) map.findOrInsert({i, i + 1}, array_tracked_t(std::to_string(i)));
+            REQUIRE( array_tracked_t::alive == 1000 );
+            REQUIRE( map.find({10, 11})->value == "10" );
+            REQUIRE( map.find({10, 12}) == nullptr );
+            for (uint32_t i = 0; i < 500; i++) map.remove({i, i + 1});
+            REQUIRE( array_tracked_t::alive == 500 );
+
+            ae::hash_map<key_t, array_tracked_t> moved = std::move(map);
+            REQUIRE( (map.empty() && moved.size() == 500 && moved.find({999, 1000})->value == "999") );
+        }
+        REQUIRE( array_tracked_t::alive == 0 );
+    }
+
+    SECTION( "arena storage" ) {
+        static uint8_t memory[1 << 16];
+        ae::arena_t arena;
+        ae::arenaInit(&arena, memory, sizeof(memory));
+        ae::hash_map<uint32_t, uint32_t> map(ae::arenaAllocator(&arena));
+        map.reserve(1000);
+        for (uint32_t i = 0; i < 1000; i++) map[i * 7919] = i;
+        REQUIRE( ((uint8_t *)map.ctrl >= memory && (uint8_t *)map.ctrl < memory + sizeof(memory)) );
+        for (uint32_t i = 0; i < 1000; i++) REQUIRE( *map.find(i * 7919) == i );
+    }
+}
+
+TEST_CASE("ae::hash_map throughput", "[ae::hash_map][!benchmark]") {
+    constexpr uint32_t count = 1 << 20;
+    std::vector<uint64_t> keys(count), misses(count);
+    for (uint32_t i = 0; i < count; i++) {
+        keys[i] = (uint64_t(utils::RandomUINT32(0, 0x7FFF)) << 30) ^ (uint64_t(i) << 8);
+        misses[i] = keys[i] | 1;
+    }
+
+    BENCHMARK("stb_ds hmput 1M") {
+        struct { uint64_t key; uint32_t value; } *hm = nullptr;
+        for (uint32_t i = 0; i < count; i++) hmput(hm, keys[i], i);
+        size_t size = hmlen(hm);
+        hmfree(hm);
+        return size;
+    };
+    BENCHMARK("std::unordered_map insert 1M") {
+        std::unordered_map<uint64_t, uint32_t> map;
+        for (uint32_t i = 0; i < count; i++) map.insert({keys[i], i});
+        return map.size();
+    };
+    BENCHMARK("hash_map insert 1M") {
+        ae::hash_map<uint64_t, uint32_t> map;
+        for (uint32_t i = 0; i < count; i++) map.findOrInsert(keys[i], i);
+        return map.size();
+    };
+    BENCHMARK("hash_map insert 1M reserved") {
+        ae::hash_map<uint64_t, uint32_t> map;
+        map.reserve(count);
+        for (uint32_t i = 0; i < count; i++) map.findOrInsert(keys[i], i);
+        return map.size();
+    };
+
+    struct { uint64_t key; uint32_t value; } *hm = nullptr;
+    std::unordered_map<uint64_t, uint32_t> reference;
+    ae::hash_map<uint64_t, uint32_t> map;
+    for (uint32_t i = 0; i < count; i++) {
+        hmput(hm, keys[i], i);
+        reference.insert({keys[i], i});
+        map.findOrInsert(keys[i], i);
+    }
+    BENCHMARK("stb_ds hmgeti 1M hits + 1M misses") {
+        size_t found = 0;
+        for (uint32_t i = 0; i < count; i++) found += (hmgeti(hm, keys[i]) >= 0) + (hmgeti(hm, misses[i]) >= 0);
+        return found;
+    };
+    BENCHMARK("std::unordered_map find 1M hits + 1M misses") {
+        size_t found = 0;
+        for (uint32_t i = 0; i < count; i++) found += reference.count(keys[i]) + reference.count(misses[i]);
+        return found;
+    };
+    BENCHMARK("hash_map find 1M hits + 1M misses") {
+        size_t found = 0;
+        for (uint32_t i = 0; i < count; i++) found += map.contains(keys[i]) + map.contains(misses[i]);
+        return found;
+    };
+    hmfree(hm);
+}
+
+TEST_CASE("obj loader", "[ae::io]") {
+    auto load = [](const char *text) { return ae::io::loadObjFromMemory(text, strlen(text)); };
+    auto vertexCount = [](const ae::raw_model_t &m) { return StretchyBufferCount(m.vertexData) / 8; };
+    // returns the vertex that the index-th index refers to.
+    auto vertex = [](const ae::raw_model_t &m, uint32_t index) { return m.vertexData + m.indexData[index] * 8; };
+
+    SECTION( "positions only, with a quad" ) {
+        ae::raw_model_t m = load("o Quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n");
+        REQUIRE( std::string(m.modelName) == "Quad" );
+        REQUIRE( vertexCount(m) == 4 );
+        REQUIRE( StretchyBufferCount(m.indexData) == 6 );
+        const uint32_t expected[6] = { 0, 1, 2, 0, 2, 3 };
+        for (uint32_t i = 0; i < 6; i++) REQUIRE( m.indexData[i] == expected[i] );
+        REQUIRE( vertex(m, 2)[0] == 1.f );
+        REQUIRE( vertex(m, 2)[1] == 1.f );
+        for (uint32_t k = 3; k < 8; k++) REQUIRE( vertex(m, 2)[k] == 0.f );
+        ae::io::freeObj(m);
+    }
+
+    SECTION( "all face forms, CRLF and comments" ) {
+        ae::raw_model_t m = load(
+            "# comment\r\nv -1.5 2e1 .25\r\nv 1 2 3 0.5 0.5 0.5\r\nv 4 5 6\r\n"
+            "vt 0.25 0.75\r\nvt 1 0\r\nvn 0 0 1\r\nvn 0 1 0\r\n"
+            "s off\r\nusemtl none\r\n"
+            "f 1/1 2/2 3/1\r\n"
+            "f 1//1 2//2 3//1 # trailing comment\r\n"
+            "f 1/2/2 2/1/1 3/2/1\r\n"
+            "f 1/1 2/2 3/1");
+        REQUIRE( StretchyBufferCount(m.indexData) == 12 );
+        // the last face repeats the first, so it dedupes onto the same vertices.
+        for (uint32_t i = 0; i < 3; i++) REQUIRE( m.indexData[9 + i] == m.indexData[i] );
+        REQUIRE( vertexCount(m) == 9 );
+        float *v = vertex(m, 0);
+        REQUIRE( (v[0] == -1.5f && v[1] == 20.f && v[2] == 0.25f) );
+        REQUIRE( (v[3] == 0.25f && v[4] == 0.75f) );
+        REQUIRE( (v[5] == 0.f && v[6] == 0.f && v[7] == 0.f) );
+        v = vertex(m, 4);
+        REQUIRE( (v[0] == 1.f && v[1] == 2.f && v[2] == 3.f) );
+        REQUIRE( (v[3] == 0.f && v[4] == 0.f) );
+        REQUIRE( (v[5] == 0.f && v[6] == 1.f && v[7] == 0.f) );
+        v = vertex(m, 8);
+        REQUIRE( (v[0] == 4.f && v[3] == 1.f && v[4] == 0.f && v[7] == 1.f) );
+        ae::io::freeObj(m);
+    }
+
+    SECTION( "negative indices and invalid faces" ) {
+        ae::raw_model_t m = load(
+            "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\n"
+            "v 5 5 5\nf -1 -2 -3\n"
+            "f 1 2 9\nf 0 1 2\nf 1 2\n");
+        REQUIRE( StretchyBufferCount(m.indexData) == 6 );
+        REQUIRE( vertex(m, 3)[0] == 5.f );
+        REQUIRE( vertex(m, 4)[1] == 1.f );
+        ae::io::freeObj(m);
+    }
+
+    SECTION( "floats parse the same as the CRT" ) {
+        utils::Seed(31);
+        std::string text;
+        std::vector<float> expected;
+        char buf[64];
+        for (uint32_t i = 0; i < 3000; i++) {
+            float f = utils::RandomFloat(-1000.f, 1000.f) * std::pow(10.f, float(int(utils::RandomUINT32(0, 12)) - 8));
+            snprintf(buf, sizeof(buf), (i % 3 == 0) ? "%.9g" : ((i % 3 == 1) ? "%f" : "%.6e"), f);
+            expected.push_back(strtof(buf, nullptr));
+            text += (i % 3 == 0) ? "v " : " ";
+            text += buf;
+            if (i % 3 == 2) text += "\n";
+        }
+        text += "f 1 2 3\n";
+        for (uint32_t i = 4; i <= 1000; i++) text += "f 1 2 " + std::to_string(i) + "\n";
+        ae::raw_model_t m = ae::io::loadObjFromMemory(text.data(), text.size());
+        REQUIRE( vertexCount(m) == 1000 );
+        for (uint32_t i = 0; i < uint32_t(StretchyBufferCount(m.indexData)); i++) {
+            uint32_t pos = (i % 3 == 2) ? (i / 3 + 2) : (i % 3);
+            for (uint32_t k = 0; k < 3; k++) REQUIRE( vertex(m, i)[k] == expected[pos * 3 + k] );
+        }
+        ae::io::freeObj(m);
+    }
+}
+
+TEST_CASE("parallel obj loader matches serial", "[ae::io]") {
+    utils::Seed(32);
+    // a random mesh, with every face form, relative and bad indices, and attributes declared between faces.
+    std::string text = "o First\n";
+    uint32_t positions = 0, uvs = 0, normals = 0;
+    char buf[128];
+    for (uint32_t i = 0; i < 30000; i++) {
+        uint32_t kind = utils::RandomUINT32(0, 9);
+        if (kind < 3 || positions < 3) {
+            snprintf(buf, sizeof(buf), "v %f %f %f\n", utils::RandomFloat(-9, 9), utils::RandomFloat(-9, 9), utils::RandomFloat(-9, 9));
+            positions++;
+        } else if (kind == 3) {
+            snprintf(buf, sizeof(buf), "vt %f %f\n", utils::RandomFloat(0, 1), utils::RandomFloat(0, 1));
+            uvs++;
+        } else if (kind == 4) {
+            snprintf(buf, sizeof(buf), "vn %f %f %f\r\n", utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1), utils::RandomFloat(-1, 1));
+            normals++;
+        } else {
+            std::string face = "f";
+            uint32_t form = utils::RandomUINT32(0, 3), corners = utils::RandomUINT32(3, 6);
+            // pick from a small window so that corners repeat and dedupe.
+            auto pick = [](uint32_t count) {
+                int32_t i = int32_t(utils::RandomUINT32(1, std::min(count, 8u)));
+                return (utils::RandomUINT32(0, 1) == 0) ? std::to_string(-i) : std::to_string(count + 1 - i);
+            };
+            for (uint32_t c = 0; c < corners; c++) {
+                face += " " + pick(positions);
+                if (form == 1 && uvs) face += "/" + pick(uvs);
+                if (form == 2 && normals) face += "//" + pick(normals);
+                if (form == 3 && uvs && normals) face += "/" + pick(uvs) + "/" + pick(normals);
+            }
+            if (utils::RandomUINT32(0, 200) == 0) face += " 999999";
+            snprintf(buf, sizeof(buf), "%s\n", face.c_str());
+        }
+        text += buf;
+        if (i == 20000) text += "o Second\n";
+    }
+
+    ae::raw_model_t serial = ae::io::loadObjFromMemory(text.data(), text.size());
+    REQUIRE( StretchyBufferCount(serial.indexData) > 100000 );
+    for (size_t chunkSize : { size_t(1), size_t(100), size_t(4096), size_t(60000), size_t(0) }) {
+        ae::raw_model_t parallel = ae::io::loadObjFromMemoryParallel(text.data(), text.size(), chunkSize);
+        REQUIRE( std::string(parallel.modelName) == "Second" );
+        REQUIRE( StretchyBufferCount(parallel.vertexData) == StretchyBufferCount(serial.vertexData) );
+        REQUIRE( StretchyBufferCount(parallel.indexData) == StretchyBufferCount(serial.indexData) );
+        REQUIRE( memcmp(parallel.vertexData, serial.vertexData, sizeof(float) * StretchyBufferCount(serial.vertexData)) == 0 );
+        REQUIRE( memcmp(parallel.indexData, serial.indexData, sizeof(uint32_t) * StretchyBufferCount(serial.indexData)) == 0 );
+        ae::io::freeObj(parallel);
+    }
+    ae::io::freeObj(serial);
+}
+
+TEST_CASE("aemesh pack and load", "[ae::io]") {
+    const char *obj = "o Tri\nv -1 0 2\nv 1 3 0\nv 0 -2 1\nvt 0 1\nvn 0 0 1\nf 1/1/1 2/1/1 3/1/1\nf 3/1/1 2/1/1 1/1/1\n";
+    ae::raw_model_t model = ae::io::loadObjFromMemory(obj, strlen(obj));
+    REQUIRE( StretchyBufferCount(model.indexData) == 6 );
+    uint32_t size = 0;
+    void *file = ae::io::packMesh(model, &size);
+    REQUIRE( file != nullptr );
+
+    SECTION( "the loaded mesh points into the file and matches the model" ) {
+        ae::loaded_mesh_t mesh = ae::io::loadMeshFromMemory(file, size);
+        REQUIRE( mesh.vertexData != nullptr );
+        REQUIRE( std::string(mesh.modelName) == "Tri" );
+        REQUIRE( (mesh.vertexData > file && (uint8_t *)mesh.vertexData < (uint8_t *)file + size) );
+        REQUIRE( (uintptr_t(mesh.vertexData) - uintptr_t(file)) % 64 == 0 );
+        REQUIRE( (uintptr_t(mesh.indexData) - uintptr_t(file)) % 64 == 0 );
+        REQUIRE( mesh.vertexCount == 3 );
+        REQUIRE( mesh.indexCount == 6 );
+        REQUIRE( mesh.indexSize == 4 );
+        REQUIRE( mesh.layout.stride == 32 );
+        REQUIRE( mesh.layout.attribCount == 3 );
+        REQUIRE( mesh.layout.attribs[2].semantic == ae::MESH_ATTRIB_NORMAL );
+        REQUIRE( mesh.layout.attribs[2].offset == 20 );
+        REQUIRE( memcmp(mesh.vertexData, model.vertexData, 3 * 32) == 0 );
+        REQUIRE( memcmp(mesh.indexData, model.indexData, 6 * 4) == 0 );
+        REQUIRE( mesh.bounds.min.x == -1.f );
+        REQUIRE( mesh.bounds.max.y == 3.f );
+        REQUIRE( mesh.bounds.min.z == 0.f );
+        REQUIRE( mesh.bounds.max.z == 2.f );
+    }
+
+    SECTION( "bad files are rejected" ) {
+        REQUIRE( ae::io::loadMeshFromMemory(file, size - 1).vertexData == nullptr );
+        REQUIRE( ae::io::loadMeshFromMemory(file, 64).vertexData == nullptr );
+        std::vector<uint8_t> bad((uint8_t *)file, (uint8_t *)file + size);
+        bad[4] = 99; // version.
+        REQUIRE( ae::io::loadMeshFromMemory(bad.data(), size).vertexData == nullptr );
+        bad[4] = uint8_t(ae::io::AEMESH_VERSION);
+        REQUIRE( ae::io::loadMeshFromMemory(bad.data(), size).vertexData != nullptr );
+        bad[20] = 0xFF; // index count, now past the end of the file.
+        REQUIRE( ae::io::loadMeshFromMemory(bad.data(), size).vertexData == nullptr );
+        bad[20] = 6;
+        // a vertex offset so large that adding the size of the vertices wraps around to inside the file.
+        const uint64_t vertexOffset = ~uint64_t(0) - 63;
+        memcpy(bad.data() + 136, &vertexOffset, sizeof(vertexOffset));
+        REQUIRE( ae::io::loadMeshFromMemory(bad.data(), size).vertexData == nullptr );
+    }
+
+    free(file);
+    ae::io::freeObj(model);
+}
+
+// a .glb with the given JSON and binary chunks, each padded to 4 bytes as the format asks.
+static std::vector<uint8_t> makeTestGlb(std::string json, std::vector<uint8_t> bin) {
+    while (json.size() % 4) json += ' ';
+    while (bin.size() % 4) bin.push_back(0);
+    std::vector<uint8_t> file;
+    auto put32 = [&](uint32_t v) { file.insert(file.end(), (uint8_t *)&v, (uint8_t *)&v + 4); };
+    put32(0x46546C67), put32(2), put32(uint32_t(20 + json.size() + (bin.empty() ? 0 : 8 + bin.size())));
+    put32(uint32_t(json.size())), put32(0x4E4F534A);
+    file.insert(file.end(), json.begin(), json.end());
+    if (!bin.empty()) {
+        put32(uint32_t(bin.size())), put32(0x004E4942);
+        file.insert(file.end(), bin.begin(), bin.end());
+    }
+    return file;
+}
+
+TEST_CASE("glb loader", "[ae::io]") {
+    // one triangle: float positions and normals, and then UVs as normalized bytes interleaved with a pad, and
+    // 16-bit indices.
+    std::vector<uint8_t> bin;
+    auto putFloats = [&](std::initializer_list<float> values) {
+        for (float v : values) bin.insert(bin.end(), (uint8_t *)&v, (uint8_t *)&v + 4);
+    };
+    putFloats({0, 0, 0, 1, 0, 0, 0, 1, 0});  // positions, 36 bytes at 0.
+    putFloats({0, 0, 1, 0, 0, 1, 0, 0, 1});  // normals, 36 bytes at 36.
+    const uint8_t uvs[12] = {0, 0, 7, 7, 255, 0, 7, 7, 0, 255, 7, 7};  // UVs, 12 bytes at 72, stride 4.
+    bin.insert(bin.end(), uvs, uvs + 12);
+    const uint16_t indices[3] = {0, 1, 2};  // indices, 6 bytes at 84.
+    bin.insert(bin.end(), (uint8_t *)indices, (uint8_t *)indices + 6);
+
+    std::string json = R"({
+        "asset": {"version": "2.0"},
+        "scene": 0,
+        "scenes": [{"nodes": [0]}],
+        "nodes": [
+            {"name": "root", "translation": [1, 2, 3], "children": [1], "mesh": 0},
+            {"scale": [2, 2, 2], "rotation": [0, 0, 0.7071068, 0.7071068], "mesh": 0}
+        ],
+        "meshes": [{"name": "triangle", "primitives": [
+            {"attributes": {"POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2}, "indices": 3, "material": 5}
+        ]}],
+        "buffers": [{"byteLength": 90}],
+        "bufferViews": [
+            {"buffer": 0, "byteOffset": 0, "byteLength": 72},
+            {"buffer": 0, "byteOffset": 72, "byteLength": 12, "byteStride": 4},
+            {"buffer": 0, "byteOffset": 84, "byteLength": 6}
+        ],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0]},
+            {"bufferView": 0, "byteOffset": 36, "componentType": 5126, "count": 3, "type": "VEC3"},
+            {"bufferView": 1, "componentType": 5121, "normalized": true, "count": 3, "type": "VEC2"},
+            {"bufferView": 2, "componentType": 5123, "count": 3, "type": "SCALAR"},
+            {"bufferView": 2, "componentType": 5123, "count": 4, "type": "SCALAR"},
+            {"componentType": 5126, "count": 3, "type": "VEC3"}
+        ]
+    })";
+    std::vector<uint8_t> file = makeTestGlb(json, bin);
+
+    ae::gltf_model_t model;
+    REQUIRE(ae::io::loadGlbFromMemory(file.data(), file.size(), &model));
+    REQUIRE(model.accessorCount == 6);
+    REQUIRE(model.meshCount == 1);
+    REQUIRE(std::string(model.meshes[0].name) == "triangle");
+    REQUIRE(model.primitiveCount == 1);
+    REQUIRE(model.nodeCount == 2);
+    REQUIRE(model.rootCount == 1);
+    REQUIRE(model.roots[0] == 0);
+    REQUIRE(model.nodes[0].childCount == 1);
+    REQUIRE(model.children[model.nodes[0].firstChild] == 1);
+
+    SECTION("accessors are spans into the binary chunk") {
+        const ae::gltf_primitive_t &primitive = model.primitives[0];
+        REQUIRE(primitive.position.data == model.binary);
+        REQUIRE(primitive.normal.data == model.binary + 36);
+        REQUIRE(primitive.uv.stride == 4);
+        REQUIRE(primitive.uv.bNormalized);
+        REQUIRE(primitive.material == 5);
+        REQUIRE(primitive.mode == ae::io::GLTF_MODE_TRIANGLES);
+        REQUIRE(primitive.position.at<ae::math::vec3_t>(1).x == 1.0f);
+        REQUIRE(primitive.indices.at<uint16_t>(2) == 2);
+        REQUIRE(model.binary >= file.data());
+        REQUIRE(model.binary + model.binarySize <= file.data() + file.size());
+        // one that reaches past its view, and one with no view at all.
+        REQUIRE(model.accessors[4].data == nullptr);
+        REQUIRE(model.accessors[5].data == nullptr);
+
+        float uv[6];
+        REQUIRE(ae::io::readAccessorFloats(primitive.uv, uv, 2) == 3);
+        REQUIRE(uv[2] == 1.0f);
+        REQUIRE(uv[5] == 1.0f);
+        uint32_t index[3];
+        REQUIRE(ae::io::readAccessorIndices(primitive.indices, index) == 3);
+        REQUIRE(index[2] == 2);
+        REQUIRE(ae::io::readAccessorIndices(primitive.position, index) == 0);
+    }
+
+    SECTION("accessors need not be aligned") {
+        // a byte of padding puts both index views at odd offsets.
+        std::vector<uint8_t> odd(1, 0);
+        const uint32_t wide[3] = {7, 8, 9};
+        odd.insert(odd.end(), (const uint8_t *)indices, (const uint8_t *)indices + 6);
+        odd.insert(odd.end(), (const uint8_t *)wide, (const uint8_t *)wide + 12);
+        std::string oddJson = R"({"asset": {"version": "2.0"}, "buffers": [{"byteLength": 19}], "bufferViews": [)"
+                              R"({"buffer": 0, "byteOffset": 1, "byteLength": 6},)"
+                              R"({"buffer": 0, "byteOffset": 7, "byteLength": 12}], "accessors": [)"
+                              R"({"bufferView": 0, "componentType": 5123, "count": 3, "type": "SCALAR"},)"
+                              R"({"bufferView": 1, "componentType": 5125, "count": 3, "type": "SCALAR"}]})";
+        std::vector<uint8_t> oddFile = makeTestGlb(oddJson, odd);
+        ae::gltf_model_t oddModel;
+        REQUIRE(ae::io::loadGlbFromMemory(oddFile.data(), oddFile.size(), &oddModel));
+        uint32_t index[3];
+        REQUIRE(ae::io::readAccessorIndices(oddModel.accessors[0], index) == 3);
+        REQUIRE((index[0] == 0 && index[1] == 1 && index[2] == 2));
+        REQUIRE(ae::io::readAccessorIndices(oddModel.accessors[1], index) == 3);
+        REQUIRE((index[0] == 7 && index[1] == 8 && index[2] == 9));
+        float values[3];
+        REQUIRE(ae::io::readAccessorFloats(oddModel.accessors[1], values, 1) == 3);
+        REQUIRE(values[2] == 9.0f);
+        REQUIRE(oddModel.accessors[0].at<uint16_t>(1) == 1);
+        ae::io::freeGlb(&oddModel);
+    }
+
+    SECTION("conversion walks the scene") {
+        ae::raw_model_t raw = ae::io::glbToRawModel(model);
+        REQUIRE(std::string(raw.modelName) == "triangle");
+        REQUIRE(StretchyBufferCount(raw.vertexData) == 6 * 8);
+        REQUIRE(StretchyBufferCount(raw.indexData) == 6);
+        const float *v = raw.vertexData;
+        // the root is only translated. V is flipped.
+        REQUIRE(v[8 + 0] == Approx(2.0f));
+        REQUIRE(v[8 + 1] == Approx(2.0f));
+        REQUIRE(v[8 + 2] == Approx(3.0f));
+        REQUIRE(v[8 + 3] == Approx(1.0f));
+        REQUIRE(v[8 + 4] == Approx(1.0f));
+        REQUIRE(v[16 + 4] == Approx(0.0f));
+        REQUIRE(v[7] == Approx(1.0f));
+        // the child is scaled by 2 and turned a quarter about Z, so +X goes to +Y, under the root's translation.
+        const float *child = v + 3 * 8;
+        REQUIRE(child[8 + 0] == Approx(1.0f).margin(1e-5));
+        REQUIRE(child[8 + 1] == Approx(4.0f));
+        REQUIRE(child[8 + 2] == Approx(3.0f));
+        REQUIRE(child[5] == Approx(0.0f).margin(1e-5));
+        REQUIRE(child[7] == Approx(1.0f));
+        REQUIRE(raw.indexData[3] == 3);
+        REQUIRE(raw.indexData[5] == 5);
+        ae::io::freeObj(raw);
+    }
+
+    SECTION("a file with no scene converts every primitive as is") {
+        std::string noScene = json;
+        noScene.replace(noScene.find("\"scene\": 0,"), 11, "");
+        noScene.replace(noScene.find("\"scenes\": [{\"nodes\": [0]}],"), 27, "");
+        std::vector<uint8_t> other = makeTestGlb(noScene, bin);
+        ae::gltf_model_t library;
+        REQUIRE(ae::io::loadGlbFromMemory(other.data(), other.size(), &library));
+        REQUIRE(library.rootCount == 0);
+        ae::raw_model_t raw = ae::io::glbToRawModel(library);
+        REQUIRE(StretchyBufferCount(raw.vertexData) == 3 * 8);
+        REQUIRE(raw.vertexData[8] == 1.0f);
+        ae::io::freeObj(raw);
+        ae::io::freeGlb(&library);
+    }
+
+    SECTION("bad files are rejected") {
+        ae::gltf_model_t bad;
+        REQUIRE_FALSE(ae::io::loadGlbFromMemory(file.data(), 12, &bad));
+        REQUIRE_FALSE(ae::io::loadGlbFromMemory(file.data(), file.size() - 8, &bad));
+        for (const char *text : {"{\"a\": [1, 2,]}", "{\"a\" 1}", "[1, 2]", "{\"a\": tru}", "{\"a\": \"b}"}) {
+            std::vector<uint8_t> broken = makeTestGlb(text, bin);
+            REQUIRE_FALSE(ae::io::loadGlbFromMemory(broken.data(), broken.size(), &bad));
+        }
+        std::string deep(1000, '[');
+        std::vector<uint8_t> broken = makeTestGlb("{\"a\": " + deep + std::string(1000, ']') + "}", bin);
+        REQUIRE_FALSE(ae::io::loadGlbFromMemory(broken.data(), broken.size(), &bad));
+        REQUIRE(bad.block == nullptr);
+
+        // a total length under the header's own size, with a JSON chunk that claims to be much longer.
+        std::vector<uint8_t> tiny(file.begin(), file.begin() + 20);
+        const uint32_t lengths[2] = {0, 4096};
+        memcpy(tiny.data() + 8, lengths, sizeof(lengths));
+        REQUIRE_FALSE(ae::io::loadGlbFromMemory(tiny.data(), tiny.size(), &bad));
+
+        // a chain of nodes that each list the next one twice has 2^64 paths to its end.
+        std::string shared = R"({"scenes": [{"nodes": [0]}], "nodes": [)";
+        for (uint32_t i = 1; i <= 64; i++) {
+            shared += "{\"children\": [" + std::to_string(i) + ", " + std::to_string(i) + "]},";
+        }
+        shared += "{}]}";
+        broken = makeTestGlb(shared, bin);
+        REQUIRE_FALSE(ae::io::loadGlbFromMemory(broken.data(), broken.size(), &bad));
+        REQUIRE(bad.block == nullptr);
+    }
+
+    SECTION("loading from the vfs") {
+        ae::archive_source_t source = {"res/models/triangle.glb", file.data(), file.size()};
+        size_t size = 0;
+        void *archive = ae::io::packArchive(&source, 1, &size);
+        REQUIRE(ae::vfs::mountArchiveFromMemory(archive, size));
+        ae::gltf_model_t loaded = ae::io::loadGlb("res/models/triangle.glb");
+        REQUIRE(loaded.primitiveCount == 1);
+        REQUIRE(loaded.primitives[0].position.count == 3);
+        ae::io::freeGlb(&loaded);
+        REQUIRE(loaded.block == nullptr);
+        ae::vfs::unmountArchives();
+        free(archive);
+    }
+    ae::io::freeGlb(&model);
+}
+
+TEST_CASE("glb loader throughput", "[ae::io][!benchmark]") {
+    // a scene of many small meshes, one node each, which is the case where parsing could outweigh the I/O.
+    const uint32_t meshCount = 20000;
+    std::vector<uint8_t> bin(36 + 6);
+    const float positions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+    const uint16_t indices[3] = {0, 1, 2};
+    memcpy(bin.data(), positions, 36);
+    memcpy(bin.data() + 36, indices, 6);
+    std::string json = R"({"asset": {"version": "2.0"}, "buffers": [{"byteLength": 42}], "bufferViews": [)"
+                       R"({"buffer": 0, "byteLength": 36}, {"buffer": 0, "byteOffset": 36, "byteLength": 6}],)"
+                       R"("accessors": [{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},)"
+                       R"({"bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR"}], "meshes": [)";
+    for (uint32_t i = 0; i < meshCount; i++) {
+        json += std::string(i ? "," : "") + R"({"primitives": [{"attributes": {"POSITION": 0}, "indices": 1}]})";
+    }
+    json += R"(], "nodes": [)";
+    std::string roots;
+    for (uint32_t i = 0; i < meshCount; i++) {
+        json += std::string(i ? "," : "") + "{\"mesh\": " + std::to_string(i) + ", \"translation\": [" +
+                std::to_string(i) + ", 0, 0]}";
+        roots += std::string(i ? "," : "") + std::to_string(i);
+    }
+    json += R"(], "scenes": [{"nodes": [)" + roots + "]}]}";
+    std::vector<uint8_t> file = makeTestGlb(json, bin);
+
+    BENCHMARK("parse") {
+        ae::gltf_model_t model;
+        ae::io::loadGlbFromMemory(file.data(), file.size(), &model);
+        uint32_t count = model.nodeCount;
+        ae::io::freeGlb(&model);
+        return count;
+    };
+    ae::gltf_model_t model;
+    REQUIRE(ae::io::loadGlbFromMemory(file.data(), file.size(), &model));
+    BENCHMARK("convert to raw_model_t") {
+        ae::raw_model_t raw = ae::io::glbToRawModel(model);
+        uint32_t count = StretchyBufferCount(raw.indexData);
+        ae::io::freeObj(raw);
+        return count;
+    };
+    ae::io::freeGlb(&model);
+}
+
+TEST_CASE("quantized vertex formats", "[ae::io]") {
+    utils::Seed(35);
+    auto randomUnit = []() {
+        ae::math::vec3_t v;
+        do {
+            v = ae::math::vec3_t(utils::RandomFloat(-1.f, 1.f), utils::RandomFloat(-1.f, 1.f),
+                utils::RandomFloat(-1.f, 1.f));
+        } while (ae::math::magnitude(v) < 0.1f || ae::math::magnitude(v) > 1.f);
+        return ae::math::normalize(v);
+    };
+
+    SECTION( "half floats convert exactly" ) {
+        const float in[] = { 1.f, -2.f, 65504.f, 65520.f, 1e-8f, 5.9604645e-8f, 1.f + 1.f / 2048.f,
+            1.f + 3.f / 2048.f, INFINITY, -0.f, 6.1035156e-5f };
+        const uint16_t expected[] = { 0x3C00, 0xC000, 0x7BFF, 0x7C00, 0x0000, 0x0001, 0x3C00, 0x3C02, 0x7C00, 0x8000,
+            0x0400 };
+        constexpr size_t count = sizeof(in) / sizeof(in[0]);
+        uint16_t out[count];
+        ae::io::floatToHalf(in, out, count);
+        for (size_t i = 0; i < count; i++) REQUIRE( out[i] == expected[i] );
+
+        // every half goes to float and back unchanged, bar the nans, which stay nans.
+        std::vector<uint16_t> halves(65536), back(65536);
+        std::vector<float>    floats(65536);
+        for (uint32_t i = 0; i < 65536; i++) halves[i] = uint16_t(i);
+        ae::io::halfToFloat(halves.data(), floats.data(), 65536);
+        ae::io::floatToHalf(floats.data(), back.data(), 65536);
+        for (uint32_t i = 0; i < 65536; i++) {
+            bool bNan = (i & 0x7C00) == 0x7C00 && (i & 0x3FF) != 0;
+            if (bNan) REQUIRE( std::isnan(floats[i]) );
+            else REQUIRE( back[i] == halves[i] );
+        }
+    }
+
+    SECTION( "octahedral normals round trip" ) {
+        constexpr uint32_t count = 1001; // not a multiple of 4, for the tail.
+        std::vector<float> normals(count * 3), decoded(count * 3);
+        for (uint32_t i = 0; i < count; i++) {
+            ae::math::vec3_t n = randomUnit();
+            memcpy(&normals[i * 3], &n, sizeof(float) * 3);
+        }
+        // the axes and the octahedron's seams are the edge cases.
+        const float axes[] = { 0, 0, 1, 0, 0, -1, 1, 0, 0, -1, 0, 0, 0, -1, 0, 0.7071068f, 0, -0.7071068f };
+        memcpy(normals.data(), axes, sizeof(axes));
+
+        std::vector<int16_t> q16(count * 2);
+        std::vector<int8_t>  q8(count * 2);
+        ae::io::encodeOctahedral16(normals.data(), q16.data(), count);
+        ae::io::decodeOctahedral16(q16.data(), decoded.data(), count);
+        float minDot16 = 1.f;
+        for (uint32_t i = 0; i < count * 3; i += 3) {
+            minDot16 = std::min(minDot16,
+                normals[i] * decoded[i] + normals[i + 1] * decoded[i + 1] + normals[i + 2] * decoded[i + 2]);
+        }
+        ae::io::encodeOctahedral8(normals.data(), q8.data(), count);
+        ae::io::decodeOctahedral8(q8.data(), decoded.data(), count);
+        float minDot8 = 1.f;
+        for (uint32_t i = 0; i < count * 3; i += 3) {
+            float len = std::sqrt(decoded[i] * decoded[i] + decoded[i + 1] * decoded[i + 1] + decoded[i + 2] * decoded[i + 2]);
+            REQUIRE( len == Approx(1.f).margin(1e-5f) );
+            minDot8 = std::min(minDot8,
+                normals[i] * decoded[i] + normals[i + 1] * decoded[i + 1] + normals[i + 2] * decoded[i + 2]);
+        }
+        // about 0.1 and 1.5 degrees.
+        REQUIRE( minDot16 > 0.999999f );
+        REQUIRE( minDot8 > 0.9996f );
+    }
+
+    SECTION( "unorm16 is within half a step" ) {
+        constexpr uint32_t count = 99;
+        const float offset[3] = { -4.f, 10.f, 0.f }, scale[3] = { 8.f, 0.5f, 0.f };
+        std::vector<float> in(count * 3), out(count * 3);
+        for (uint32_t i = 0; i < count * 3; i++) in[i] = offset[i % 3] + utils::RandomFloat(0.f, 1.f) * scale[i % 3];
+        std::vector<uint16_t> q(count * 3);
+        ae::io::quantizeUnorm16(in.data(), q.data(), count, 3, offset, scale);
+        ae::io::dequantizeUnorm16(q.data(), out.data(), count, 3, offset, scale);
+        for (uint32_t i = 0; i < count * 3; i++) {
+            REQUIRE( std::abs(out[i] - in[i]) <= scale[i % 3] / 65535.f * 0.5f + 1e-6f );
+        }
+    }
+
+    SECTION( "compact meshes are smaller and decode close to the original" ) {
+        // a bumpy grid with UVs outside of [0,1].
+        constexpr uint32_t dim = 64;
+        ae::raw_model_t model = {};
+        StretchyBufferInitWithCount(model.vertexData, (dim + 1) * (dim + 1) * 8);
+        for (uint32_t y = 0, v = 0; y <= dim; y++) {
+            for (uint32_t x = 0; x <= dim; x++, v++) {
+                ae::math::vec3_t n = randomUnit();
+                float vertex[8] = { float(x) * 0.5f, std::sin(x * 0.3f) * 3.f, -float(y), x / 16.f, -2.f + y / 8.f,
+                    n.x, n.y, n.z };
+                memcpy(&model.vertexData[v * 8], vertex, sizeof(vertex));
+            }
+        }
+        for (uint32_t y = 0; y < dim; y++) {
+            for (uint32_t x = 0; x < dim; x++) {
+                uint32_t a = y * (dim + 1) + x, b = a + 1, c = a + dim + 1, d = c + 1;
+                for (uint32_t i : { a, c, b, b, c, d }) StretchyBufferPush(model.indexData, i);
+            }
+        }
+        const uint32_t vertexCount = (dim + 1) * (dim + 1);
+
+        ae::mesh_quantization_t compact = ae::mesh_quantization_t::compact();
+        ae::mesh_quantization_t compact8 = compact;
+        compact8.normalFormat = ae::MESH_FORMAT_SNORM8;
+        ae::mesh_quantization_t half = {};
+        half.positionFormat = ae::MESH_FORMAT_FLOAT16;
+        half.uvFormat = ae::MESH_FORMAT_FLOAT16;
+
+        uint32_t fullSize, compactSize, compact8Size, halfSize;
+        void *full = ae::io::packMesh(model, &fullSize);
+        void *packed = ae::io::packMesh(model, &compactSize, compact);
+        void *packed8 = ae::io::packMesh(model, &compact8Size, compact8);
+        void *packedHalf = ae::io::packMesh(model, &halfSize, half);
+        ae::loaded_mesh_t mesh = ae::io::loadMeshFromMemory(packed, compactSize);
+        ae::loaded_mesh_t mesh8 = ae::io::loadMeshFromMemory(packed8, compact8Size);
+        ae::loaded_mesh_t meshHalf = ae::io::loadMeshFromMemory(packedHalf, halfSize);
+        REQUIRE( ae::io::loadMeshFromMemory(full, fullSize).positionData == nullptr );
+        REQUIRE( mesh.vertexData != nullptr );
+        REQUIRE( mesh8.vertexData != nullptr );
+        REQUIRE( meshHalf.vertexData != nullptr );
+
+        REQUIRE( mesh.layout.stride == 16 );
+        REQUIRE( mesh8.layout.stride == 12 );
+        REQUIRE( meshHalf.layout.stride == 24 );
+        REQUIRE( mesh.indexSize == 2 );
+        REQUIRE( meshHalf.indexSize == 4 );
+        REQUIRE( mesh.positionStride == 6 );
+        REQUIRE( mesh.layout.attribs[2].componentCount == 2 );
+        // the vertices and indices take half the memory, or less with 8 bit normals.
+        REQUIRE( uint64_t(mesh.layout.stride) * 2 <= 32 );
+        REQUIRE( uint64_t(mesh8.layout.stride) * 8 <= 32 * 3 );
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            REQUIRE( memcmp((const uint8_t *)mesh.positionData + i * 6, (const uint8_t *)mesh.vertexData + i * 16, 6) == 0 );
+        }
+
+        for (ae::loaded_mesh_t *m : { &mesh, &mesh8, &meshHalf }) {
+            ae::raw_model_t decoded = ae::io::dequantizeMesh(*m);
+            REQUIRE( StretchyBufferCount(decoded.vertexData) == vertexCount * 8 );
+            REQUIRE( StretchyBufferCount(decoded.indexData) == StretchyBufferCount(model.indexData) );
+            REQUIRE( memcmp(decoded.indexData, model.indexData, sizeof(uint32_t) * StretchyBufferCount(model.indexData)) == 0 );
+            float maxPosError = 0.f, maxUvError = 0.f, minNormalDot = 1.f;
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                const float *a = &model.vertexData[i * 8], *b = &decoded.vertexData[i * 8];
+                for (uint32_t k = 0; k < 3; k++) maxPosError = std::max(maxPosError, std::abs(a[k] - b[k]));
+                for (uint32_t k = 3; k < 5; k++) maxUvError = std::max(maxUvError, std::abs(a[k] - b[k]));
+                minNormalDot = std::min(minNormalDot, a[5] * b[5] + a[6] * b[6] + a[7] * b[7]);
+            }
+            if (m == &meshHalf) {
+                // half floats have 11 bits of precision, and the grid goes out to 64.
+                REQUIRE( maxPosError <= 64.f / 2048.f );
+                REQUIRE( maxUvError <= 8.f / 2048.f );
+                REQUIRE( minNormalDot > 0.99999f );
+            } else {
+                // half a step of the largest extent, which is the 64 units in z.
+                REQUIRE( maxPosError <= 64.f / 65535.f * 0.5f + 1e-5f );
+                REQUIRE( maxUvError <= 8.f / 65535.f * 0.5f + 1e-5f );
+                REQUIRE( minNormalDot > ((m == &mesh) ? 0.999999f : 0.9996f) );
+            }
+            ae::io::freeObj(decoded);
+        }
+
+        free(full);
+        free(packed);
+        free(packed8);
+        free(packedHalf);
+        ae::io::freeObj(model);
+    }
+}
+
+TEST_CASE("quantized vertex formats throughput", "[ae::io][!benchmark]") {
+    constexpr uint32_t count = 1 << 16;
+    std::vector<float> normals(count * 3), floats(count * 3);
+    for (uint32_t i = 0; i < count * 3; i++) normals[i] = utils::RandomFloat(-1.f, 1.f);
+    std::vector<int16_t>  oct(count * 2);
+    std::vector<uint16_t> halves(count * 3);
+    BENCHMARK("encodeOctahedral16, 64K normals") {
+        ae::io::encodeOctahedral16(normals.data(), oct.data(), count);
+        return oct[count - 1];
+    };
+    BENCHMARK("decodeOctahedral16, 64K normals") {
+        ae::io::decodeOctahedral16(oct.data(), floats.data(), count);
+        return floats[count - 1];
+    };
+    BENCHMARK("floatToHalf, 192K floats") {
+        ae::io::floatToHalf(normals.data(), halves.data(), count * 3);
+        return halves[count - 1];
+    };
+    BENCHMARK("halfToFloat, 192K halves") {
+        ae::io::halfToFloat(halves.data(), floats.data(), count * 3);
+        return floats[count - 1];
+    };
+}
+
+TEST_CASE("mesh optimizer", "[ae::io]") {
+    utils::Seed(34);
+    // a bumpy grid, with the triangles shuffled and every vertex written out once per triangle corner, which is
+    // about as bad as a mesh can come in.
+    constexpr uint32_t dim = 48;
+    auto gridPos = [](uint32_t x, uint32_t y) {
+        return ae::math::vec3_t(float(x), std::sin(x * 0.3f) * std::cos(y * 0.2f) * 3.f, float(y));
+    };
+    std::vector<uint32_t> tris;
+    for (uint32_t y = 0; y < dim; y++) {
+        for (uint32_t x = 0; x < dim; x++) {
+            uint32_t a = y * (dim + 1) + x, b = a + 1, c = a + dim + 1, d = c + 1;
+            tris.insert(tris.end(), { a, c, b, b, c, d });
+        }
+    }
+    for (uint32_t t = tris.size() / 3 - 1; t > 0; t--) {
+        uint32_t o = utils::RandomUINT32(0, t);
+        for (uint32_t k = 0; k < 3; k++) std::swap(tris[t * 3 + k], tris[o * 3 + k]);
+    }
+    ae::raw_model_t model = {};
+    for (uint32_t i = 0; i < tris.size(); i++) {
+        uint32_t x = tris[i] % (dim + 1), y = tris[i] / (dim + 1);
+        ae::math::vec3_t p = gridPos(x, y);
+        for (float f : { p.x, p.y, p.z, float(x) / dim, float(y) / dim, 0.f, 1.f, 0.f }) StretchyBufferPush(model.vertexData, f);
+        StretchyBufferPush(model.indexData, i);
+    }
+    const uint32_t indexCount = StretchyBufferCount(model.indexData);
+
+    // the triangles of a mesh as a sorted list of positions, rotated so that winding is kept.
+    auto triangleSet = [](const ae::raw_model_t &m) {
+        std::vector<std::array<float, 9>> set;
+        for (uint32_t t = 0; t < uint32_t(StretchyBufferCount(m.indexData)) / 3; t++) {
+            uint32_t i[3] = { m.indexData[t * 3], m.indexData[t * 3 + 1], m.indexData[t * 3 + 2] };
+            std::array<float, 9> best = {};
+            for (uint32_t r = 0; r < 3; r++) {
+                std::array<float, 9> tri;
+                for (uint32_t k = 0; k < 3; k++)
+                    for (uint32_t c = 0; c < 3; c++) tri[k * 3 + c] = m.vertexData[i[(k + r) % 3] * 8 + c];
+                if (r == 0 || tri < best) best = tri;
+            }
+            set.push_back(best);
+        }
+        std::sort(set.begin(), set.end());
+        return set;
+    };
+    const auto original = triangleSet(model);
+
+    REQUIRE( ae::io::weldVertices(&model) == (dim + 1) * (dim + 1) );
+    REQUIRE( uint32_t(StretchyBufferCount(model.indexData)) == indexCount );
+    REQUIRE( triangleSet(model) == original );
+    const uint32_t vertexCount = (dim + 1) * (dim + 1);
+    ae::vertex_cache_stats_t before = ae::io::analyzeVertexCache(model.indexData, indexCount, vertexCount);
+    REQUIRE( before.acmr > 2.f );
+
+    SECTION( "vertex cache and fetch ordering" ) {
+        ae::io::optimizeVertexCache(model.indexData, indexCount, vertexCount);
+        REQUIRE( triangleSet(model) == original );
+        ae::vertex_cache_stats_t after = ae::io::analyzeVertexCache(model.indexData, indexCount, vertexCount);
+        REQUIRE( after.acmr < 0.8f );
+        REQUIRE( after.atvr < 1.6f );
+
+        REQUIRE( ae::io::optimizeVertexFetch(&model) == vertexCount );
+        REQUIRE( triangleSet(model) == original );
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < indexCount; i++) {
+            REQUIRE( model.indexData[i] <= next );
+            if (model.indexData[i] == next) next++;
+        }
+        ae::vertex_cache_stats_t fetched = ae::io::analyzeVertexCache(model.indexData, indexCount, vertexCount);
+        REQUIRE( fetched.acmr == after.acmr );
+    }
+
+    SECTION( "overdraw keeps most of the cache benefit" ) {
+        ae::io::optimizeOverdraw(model.indexData, indexCount, model.vertexData, vertexCount);
+        REQUIRE( triangleSet(model) == original );
+        REQUIRE( ae::io::analyzeVertexCache(model.indexData, indexCount, vertexCount).acmr < 1.f );
+    }
+
+    SECTION( "meshlets" ) {
+        ae::io::optimizeMesh(&model);
+        ae::meshlet_set_t set = ae::io::buildMeshlets(model, 64, 124);
+        REQUIRE( set.triangleCount == indexCount / 3 );
+        uint32_t covered = 0;
+        for (uint32_t m = 0; m < set.meshletCount; m++) {
+            const ae::meshlet_t &meshlet = set.meshlets[m];
+            REQUIRE( meshlet.vertexCount <= 64 );
+            REQUIRE( meshlet.triangleCount <= 124 );
+            REQUIRE( meshlet.triangleOffset == covered );
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                uint32_t tri = meshlet.triangleOffset + t;
+                for (uint32_t k = 0; k < 3; k++) {
+                    uint8_t local = set.triangles[tri * 3 + k];
+                    REQUIRE( local < meshlet.vertexCount );
+                    REQUIRE( set.vertices[meshlet.vertexOffset + local] == model.indexData[tri * 3 + k] );
+                    // every vertex is inside the bounding sphere.
+                    const float *p = model.vertexData + model.indexData[tri * 3 + k] * 8;
+                    float dx = p[0] - meshlet.center[0], dy = p[1] - meshlet.center[1], dz = p[2] - meshlet.center[2];
+                    REQUIRE( std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.radius * 1.0001f + 1e-5f );
+                }
+            }
+            covered += meshlet.triangleCount;
+
+            // a meshlet is only ever culled when every one of its triangles faces away from the camera.
+            for (uint32_t c = 0; c < 20; c++) {
+                ae::math::vec3_t cam = { utils::RandomFloat(-40, 90), utils::RandomFloat(-60, 60), utils::RandomFloat(-40, 90) };
+                if (!ae::io::isMeshletBackfacing(meshlet, cam)) continue;
+                for (uint32_t t = meshlet.triangleOffset; t < meshlet.triangleOffset + meshlet.triangleCount; t++) {
+                    const float *p0 = model.vertexData + model.indexData[t * 3] * 8;
+                    const float *p1 = model.vertexData + model.indexData[t * 3 + 1] * 8;
+                    const float *p2 = model.vertexData + model.indexData[t * 3 + 2] * 8;
+                    ae::math::vec3_t e0 = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                    ae::math::vec3_t e1 = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+                    ae::math::vec3_t n = { e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x };
+                    REQUIRE( (p0[0] - cam.x) * n.x + (p0[1] - cam.y) * n.y + (p0[2] - cam.z) * n.z >= 0.f );
+                }
+            }
+        }
+        REQUIRE( covered == set.triangleCount );
+        ae::io::freeMeshlets(set);
+    }
+
+    ae::io::freeObj(model);
+}
+
+TEST_CASE("meshlets of 256 vertices", "[ae::io]") {
+    // 85 triangles of fresh vertices fill 255 slots, then a degenerate one takes the 256th vertex twice.
+    ae::raw_model_t model = {};
+    for (uint32_t v = 0; v < 256; v++) {
+        float vertex[8] = { float(v % 16), float(v / 16), 0.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+        for (float f : vertex) StretchyBufferPush(model.vertexData, f);
+    }
+    for (uint32_t i = 0; i < 255; i++) StretchyBufferPush(model.indexData, i);
+    for (uint32_t i : { 0u, 255u, 255u }) StretchyBufferPush(model.indexData, i);
+
+    ae::meshlet_set_t set = ae::io::buildMeshlets(model, 256, 256);
+    REQUIRE( set.meshletCount == 1 );
+    REQUIRE( set.meshlets[0].vertexCount == 256 );
+    for (uint32_t i = 0; i < set.triangleCount * 3; i++) {
+        REQUIRE( set.vertices[set.meshlets[0].vertexOffset + set.triangles[i]] == model.indexData[i] );
+    }
+    ae::io::freeMeshlets(set);
+    ae::io::freeObj(model);
+}
+
+TEST_CASE("mesh simplification and LODs", "[ae::io]") {
+    SECTION( "a UV sphere keeps its seam and stays closed" ) {
+        // the seam is the column of vertices at u = 0 and u = 1, which share positions but not UVs.
+        constexpr uint32_t rings = 32, segments = 64;
+        ae::raw_model_t model = {};
+        auto pushVertex = [&](float theta, float phi, float u, float v) {
+            float p[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+            // the same position must be bit for bit the same, whatever the angle it came from.
+            if (u == 1.f) p[0] = std::sin(theta), p[2] = 0.f;
+            if (theta == 0.f || theta == PI) p[0] = p[2] = 0.f, p[1] = (theta == 0.f) ? 1.f : -1.f;
+            float vertex[8] = { p[0], p[1], p[2], u, v, p[0], p[1], p[2] };
+            for (float f : vertex) StretchyBufferPush(model.vertexData, f);
+        };
+        for (uint32_t r = 0; r <= rings; r++) {
+            for (uint32_t s = 0; s <= segments; s++) {
+                float theta = PI * r / rings, u = float(s) / segments;
+                pushVertex((r == 0) ? 0.f : ((r == rings) ? PI : theta), 2.f * PI * u, u, float(r) / rings);
+            }
+        }
+        for (uint32_t r = 0; r < rings; r++) {
+            for (uint32_t s = 0; s < segments; s++) {
+                uint32_t a = r * (segments + 1) + s, b = a + 1, c = a + segments + 1, d = c + 1;
+                if (r != 0) for (uint32_t i : { a, b, c }) StretchyBufferPush(model.indexData, i);
+                if (r != rings - 1) for (uint32_t i : { b, d, c }) StretchyBufferPush(model.indexData, i);
+            }
+        }
+        const uint32_t vertexCount = StretchyBufferCount(model.vertexData) / 8;
+        const uint32_t triangleCount = StretchyBufferCount(model.indexData) / 3;
+
+        // the poles are all one position. so are the seam vertices, which the loop above made bitwise equal.
+        std::map<std::array<float, 3>, uint32_t> positionIds;
+        std::vector<uint32_t> positionOf(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            std::array<float, 3> p = { model.vertexData[v * 8], model.vertexData[v * 8 + 1], model.vertexData[v * 8 + 2] };
+            positionOf[v] = positionIds.emplace(p, uint32_t(positionIds.size())).first->second;
+        }
+
+        const float ratios[] = { 0.5f, 0.25f, 0.1f };
+        ae::mesh_lod_chain_t chain = ae::io::buildLodChain(model, ratios, 3);
+        REQUIRE( chain.lodCount == 4 );
+        REQUIRE( chain.lods[0].indexCount == triangleCount * 3 );
+        REQUIRE( chain.lods[0].error == 0.f );
+        for (uint32_t i = 1; i < chain.lodCount; i++) {
+            const ae::mesh_lod_t &lod = chain.lods[i];
+            REQUIRE( lod.indexCount <= uint32_t(triangleCount * ratios[i - 1]) * 3 );
+            REQUIRE( lod.indexCount >= uint32_t(triangleCount * ratios[i - 1]) * 3 - 12 );
+            REQUIRE( lod.error >= chain.lods[i - 1].error );
+            REQUIRE( lod.error < 0.1f );
+            REQUIRE( lod.indexOffset + lod.indexCount <= chain.indexCount );
+
+            std::map<std::pair<uint32_t, uint32_t>, int> edges;
+            for (uint32_t t = 0; t < lod.indexCount; t += 3) {
+                const uint32_t *tri = chain.indices + lod.indexOffset + t;
+                float uMin = 1.f, uMax = 0.f;
+                for (uint32_t k = 0; k < 3; k++) {
+                    REQUIRE( tri[k] < vertexCount );
+                    REQUIRE( tri[k] != tri[(k + 1) % 3] );
+                    // poles excepted, since they are one position with many UVs.
+                    float y = model.vertexData[tri[k] * 8 + 1];
+                    if (std::abs(y) == 1.f) continue;
+                    uMin = std::min(uMin, model.vertexData[tri[k] * 8 + 3]);
+                    uMax = std::max(uMax, model.vertexData[tri[k] * 8 + 3]);
+                }
+                // a triangle that reached across the seam would take its UVs from both sides of it.
+                REQUIRE( uMax - uMin < 0.5f );
+                for (uint32_t k = 0; k < 3; k++) edges[{ positionOf[tri[k]], positionOf[tri[(k + 1) % 3]] }]++;
+            }
+            // closed and consistently wound, by position.
+            for (auto &e : edges) {
+                REQUIRE( e.second == 1 );
+                REQUIRE( edges.count({ e.first.second, e.first.first }) == 1 );
+            }
+        }
+
+        // a pixel is 0.002 units at a distance of 1 and 2 units at 1000.
+        ae::math::camera_t cam = {};
+        cam.fov = 90.f;
+        cam.width = cam.height = 1000;
+        REQUIRE( ae::io::selectLod(chain, cam, 0.001f) == 0 );
+        REQUIRE( ae::io::selectLod(chain, cam, 1000.f) == 3 );
+        for (float distance = 1.f; distance < 1000.f; distance *= 1.5f) {
+            uint32_t lod = ae::io::selectLod(chain, cam, distance);
+            REQUIRE( chain.lods[lod].error <= 2.f * distance / 1000.f );
+            REQUIRE( lod >= ae::io::selectLod(chain, cam, distance / 1.5f) );
+        }
+
+        ae::io::freeLodChain(chain);
+        ae::io::freeObj(model);
+    }
+
+    SECTION( "open borders are locked and the error limit holds" ) {
+        constexpr uint32_t dim = 40;
+        ae::raw_model_t model = {};
+        for (uint32_t y = 0; y <= dim; y++) {
+            for (uint32_t x = 0; x <= dim; x++) {
+                float vertex[8] = { float(x), std::sin(x * 0.4f) * std::cos(y * 0.3f), float(y), x / float(dim),
+                    y / float(dim), 0.f, 1.f, 0.f };
+                for (float f : vertex) StretchyBufferPush(model.vertexData, f);
+            }
+        }
+        for (uint32_t y = 0; y < dim; y++) {
+            for (uint32_t x = 0; x < dim; x++) {
+                uint32_t a = y * (dim + 1) + x, b = a + 1, c = a + dim + 1, d = c + 1;
+                for (uint32_t i : { a, c, b, b, c, d }) StretchyBufferPush(model.indexData, i);
+            }
+        }
+        const uint32_t indexCount = StretchyBufferCount(model.indexData);
+        std::vector<uint32_t> indices(indexCount);
+
+        float error = -1.f;
+        uint32_t count = ae::io::simplifyMesh(model, indexCount / 10, indices.data(), FLT_MAX, &error);
+        REQUIRE( count <= indexCount / 10 );
+        REQUIRE( error > 0.f );
+        std::vector<bool> used((dim + 1) * (dim + 1));
+        for (uint32_t i = 0; i < count; i++) used[indices[i]] = true;
+        for (uint32_t y = 0; y <= dim; y++) {
+            for (uint32_t x = 0; x <= dim; x++) {
+                if (x == 0 || y == 0 || x == dim || y == dim) REQUIRE( used[y * (dim + 1) + x] );
+            }
+        }
+
+        float limitedError = -1.f;
+        uint32_t limited = ae::io::simplifyMesh(model, indexCount / 10, indices.data(), error * 0.25f, &limitedError);
+        REQUIRE( limited > count );
+        REQUIRE( limitedError <= error * 0.25f );
+        ae::io::freeObj(model);
+    }
+}
+
+TEST_CASE("mesh simplification throughput", "[ae::io][!benchmark]") {
+    constexpr uint32_t dim = 256;
+    ae::raw_model_t model = {};
+    for (uint32_t y = 0; y <= dim; y++) {
+        for (uint32_t x = 0; x <= dim; x++) {
+            float vertex[8] = { float(x), std::sin(x * 0.05f) * std::cos(y * 0.07f) * 10.f, float(y), x / float(dim),
+                y / float(dim), 0.f, 1.f, 0.f };
+            for (float f : vertex) StretchyBufferPush(model.vertexData, f);
+        }
+    }
+    for (uint32_t y = 0; y < dim; y++) {
+        for (uint32_t x = 0; x < dim; x++) {
+            uint32_t a = y * (dim + 1) + x, b = a + 1, c = a + dim + 1, d = c + 1;
+            for (uint32_t i : { a, c, b, b, c, d }) StretchyBufferPush(model.indexData, i);
+        }
+    }
+    const float ratios[] = { 0.5f, 0.25f, 0.1f, 0.05f };
+    BENCHMARK("buildLodChain, 131K triangles, 4 LODs") {
+        ae::mesh_lod_chain_t chain = ae::io::buildLodChain(model, ratios, 4);
+        uint32_t lodCount = chain.lodCount;
+        ae::io::freeLodChain(chain);
+        return lodCount;
+    };
+    ae::io::freeObj(model);
+}
+
+TEST_CASE("lz4 block codec", "[ae::io]") {
+    utils::Seed(37);
+
+    SECTION( "decodes a hand made block" ) {
+        // 'a', then a match of 5 at offset 1, then the last literals.
+        const uint8_t block[] = {0x11, 'a', 0x01, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f'};
+        char out[11];
+        REQUIRE( ae::io::lz4Decompress(block, sizeof(block), out, sizeof(out)) );
+        REQUIRE( std::string(out, sizeof(out)) == "aaaaaabcdef" );
+        REQUIRE( !ae::io::lz4Decompress(block, sizeof(block), out, sizeof(out) - 1) );
+    }
+
+    SECTION( "round trips" ) {
+        std::vector<std::vector<uint8_t>> inputs;
+        for (uint32_t size = 0; size < 40; size++) inputs.push_back(std::vector<uint8_t>(size, 'x'));
+        std::vector<uint8_t> random(100000), text, zeros(1 << 20, 0), mixed;
+        for (uint8_t &b : random) b = uint8_t(utils::RandomUINT32(0, 255));
+        while (text.size() < 200000) {
+            std::string line = "v " + std::to_string(utils::RandomUINT32(0, 99)) + ".5 1.0 -0." +
+                               std::to_string(utils::RandomUINT32(0, 9)) + "\n";
+            text.insert(text.end(), line.begin(), line.end());
+        }
+        for (uint32_t i = 0; i < 300000; i++) mixed.push_back(i % 7 ? uint8_t(i / 1000) : uint8_t(i));
+        inputs.push_back(random);
+        inputs.push_back(text);
+        inputs.push_back(zeros);
+        inputs.push_back(mixed);
+        for (const std::vector<uint8_t> &in : inputs) {
+            std::vector<uint8_t> packed(ae::io::lz4CompressBound(in.size()));
+            size_t packedSize = ae::io::lz4Compress(in.data(), in.size(), packed.data(), packed.size());
+            REQUIRE( packedSize > 0 );
+            std::vector<uint8_t> out(in.size() + 1);
+            REQUIRE( ae::io::lz4Decompress(packed.data(), packedSize, out.data(), in.size()) );
+            REQUIRE( std::equal(in.begin(), in.end(), out.begin()) );
+            // the size must match exactly.
+            REQUIRE( !ae::io::lz4Decompress(packed.data(), packedSize, out.data(), in.size() + 1) );
+        }
+        std::vector<uint8_t> packed(ae::io::lz4CompressBound(zeros.size()));
+        REQUIRE( ae::io::lz4Compress(zeros.data(), zeros.size(), packed.data(), packed.size()) < zeros.size() / 200 );
+        REQUIRE( ae::io::lz4Compress(text.data(), text.size(), packed.data(), packed.size()) < text.size() / 2 );
+        REQUIRE( ae::io::lz4Compress(random.data(), random.size(), packed.data(), 1000) == 0 );
+    }
+
+    SECTION( "corrupt blocks fail without reading or writing out of bounds" ) {
+        std::vector<uint8_t> in;
+        for (uint32_t i = 0; i < 20000; i++) in.push_back(uint8_t((i * i) >> 9));
+        std::vector<uint8_t> packed(ae::io::lz4CompressBound(in.size()));
+        packed.resize(ae::io::lz4Compress(in.data(), in.size(), packed.data(), packed.size()));
+        std::vector<uint8_t> out(in.size());
+        for (uint32_t i = 0; i < 2000; i++) {
+            std::vector<uint8_t> bad = packed;
+            bad[utils::RandomUINT32(0, uint32_t(bad.size() - 1))] = uint8_t(utils::RandomUINT32(0, 255));
+            bad.resize(utils::RandomUINT32(uint32_t(bad.size() / 2), uint32_t(bad.size())));
+            // heap copies, so that a sanitizer catches any overrun.
+            std::vector<uint8_t> exact(bad);
+            ae::io::lz4Decompress(exact.data(), exact.size(), out.data(), out.size());
+        }
+    }
+}
+
+TEST_CASE("packed archive and vfs", "[ae::io]") {
+    utils::Seed(37);
+    std::string text;
+    while (text.size() < 50000) text += "vt 0." + std::to_string(utils::RandomUINT32(0, 999)) + " 0.5\n";
+    std::vector<uint8_t> noise(9000);
+    for (uint8_t &b : noise) b = uint8_t(utils::RandomUINT32(0, 255));
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < 100; i++) names.push_back("res/gen/file" + std::to_string(i) + ".txt");
+
+    std::vector<ae::archive_source_t> sources = {
+        {"res\\text.obj", text.data(), text.size()},
+        {"res\\noise.bin", noise.data(), noise.size()},
+        {"res/empty", nullptr, 0},
+    };
+    for (const std::string &name : names) sources.push_back({name.c_str(), name.data(), name.size()});
+    size_t size = 0;
+    void *archive = ae::io::packArchive(sources.data(), uint32_t(sources.size()), &size);
+    REQUIRE( archive != nullptr );
+    REQUIRE( size % ae::io::AEPAK_ALIGNMENT == 0 );
+    REQUIRE( ae::vfs::mountArchiveFromMemory(archive, size) );
+
+    SECTION( "paths hash the same whatever the case and slashes" ) {
+        REQUIRE( ae::vfs::hashPath("res\\Text.OBJ") == ae::vfs::hashPath("./res//text.obj") );
+        REQUIRE( ae::vfs::hashPath("res/text.obj") != ae::vfs::hashPath("res/text.ob") );
+        REQUIRE( ae::vfs::hashPath("") != 0 );
+    }
+
+    SECTION( "files read back the same" ) {
+        ae::loaded_file_t file = ae::vfs::readEntireFile("RES/TEXT.OBJ");
+        REQUIRE( size_t(file.contentSize) == text.size() );
+        REQUIRE( memcmp(file.contents, text.data(), text.size()) == 0 );
+        // a read is a private copy, so it can be written to.
+        ((char *)file.contents)[0] = '#';
+        ae::vfs::freeLoadedFile(file);
+        for (const std::string &name : names) {
+            ae::loaded_file_t f = ae::vfs::readEntireFile(name.c_str());
+            REQUIRE( std::string((char *)f.contents, f.contentSize) == name );
+            ae::vfs::freeLoadedFile(f);
+        }
+        ae::loaded_file_t empty = ae::vfs::readEntireFile("res/empty");
+        REQUIRE( (empty.contents == nullptr && empty.contentSize == 0) );
+    }
+
+    SECTION( "uncompressed files map without a copy, compressed ones decompress" ) {
+        ae::loaded_file_t noiseFile = ae::vfs::mapEntireFile("res/noise.bin");
+        REQUIRE( (noiseFile.contents > archive && (uint8_t *)noiseFile.contents < (uint8_t *)archive + size) );
+        REQUIRE( (uintptr_t(noiseFile.contents) - uintptr_t(archive)) % ae::io::AEPAK_ALIGNMENT == 0 );
+        REQUIRE( memcmp(noiseFile.contents, noise.data(), noise.size()) == 0 );
+        ae::loaded_file_t textFile = ae::vfs::mapEntireFile("res/text.obj");
+        REQUIRE( (textFile.contents < archive || (uint8_t *)textFile.contents >= (uint8_t *)archive + size) );
+        REQUIRE( memcmp(textFile.contents, text.data(), text.size()) == 0 );
+        // mapping the same entry twice gives the same pointer, which has to survive the first unmap.
+        ae::loaded_file_t again = ae::vfs::mapEntireFile("res/noise.bin");
+        REQUIRE( again.contents == noiseFile.contents );
+        ae::vfs::unmapFile(noiseFile);
+        ae::vfs::unmapFile(again);
+        ae::vfs::unmapFile(textFile);
+        size_t storedSize = 0;
+        void *stored = ae::io::packArchive(sources.data(), uint32_t(sources.size()), &storedSize, false);
+        REQUIRE( storedSize >= size + text.size() / 2 );
+        free(stored);
+    }
+
+    SECTION( "archives mounted later are searched first" ) {
+        const char *patched = "patched";
+        ae::archive_source_t patch = {"res/gen/file7.txt", patched, strlen(patched)};
+        size_t patchSize = 0;
+        void *patchArchive = ae::io::packArchive(&patch, 1, &patchSize, false);
+        REQUIRE( ae::vfs::mountArchiveFromMemory(patchArchive, patchSize) );
+        ae::loaded_file_t f = ae::vfs::readEntireFile("res/gen/file7.txt");
+        REQUIRE( std::string((char *)f.contents, f.contentSize) == "patched" );
+        ae::vfs::freeLoadedFile(f);
+        f = ae::vfs::readEntireFile("res/gen/file8.txt");
+        REQUIRE( std::string((char *)f.contents, f.contentSize) == names[8] );
+        ae::vfs::freeLoadedFile(f);
+        ae::vfs::unmountArchives();
+        free(patchArchive);
+    }
+
+    SECTION( "bad archives are rejected" ) {
+        REQUIRE( !ae::vfs::mountArchiveFromMemory(archive, size - 1) );
+        REQUIRE( !ae::vfs::mountArchiveFromMemory(archive, 32) );
+        std::vector<uint8_t> bad((uint8_t *)archive, (uint8_t *)archive + size);
+        bad[4] = 99; // version.
+        REQUIRE( !ae::vfs::mountArchiveFromMemory(bad.data(), size) );
+        bad[4] = uint8_t(ae::io::AEPAK_VERSION);
+        bad[16] = 3; // slot count, no longer a power of two.
+        REQUIRE( !ae::vfs::mountArchiveFromMemory(bad.data(), size) );
+
+        // an entry whose offset is so large that adding its size wraps around to inside the file.
+        bad.assign((uint8_t *)archive, (uint8_t *)archive + size);
+        uint64_t tocOffset;
+        memcpy(&tocOffset, bad.data() + 24, sizeof(tocOffset));
+        uint8_t *slot = bad.data() + tocOffset;
+        auto storedSize = [](const uint8_t *slot) {
+            uint32_t result;
+            memcpy(&result, slot + 20, sizeof(result));
+            return result;
+        };
+        while (storedSize(slot) < ae::io::AEPAK_ALIGNMENT) slot += 32;
+        const uint64_t offset = ~uint64_t(0) - ae::io::AEPAK_ALIGNMENT + 1;
+        memcpy(slot + 8, &offset, sizeof(offset));
+        REQUIRE( !ae::vfs::mountArchiveFromMemory(bad.data(), size) );
+    }
+
+    ae::vfs::unmountArchives();
+    free(archive);
+}
+
+TEST_CASE("asset cache", "[ae::assets]") {
+    // the assets come from an archive in memory, so that the test does not depend on files on disk.
+    std::vector<std::string> objs, names;
+    for (uint32_t i = 0; i < 4; i++) {
+        std::string obj = "o Model" + std::to_string(i) + "\n";
+        for (uint32_t v = 0; v < 30 * (i + 1); v++) obj += "v " + std::to_string(v) + " 0 " + std::to_string(i) + "\n";
+        for (uint32_t f = 1; f + 2 <= 30 * (i + 1); f++) {
+            obj += "f " + std::to_string(f) + " " + std::to_string(f + 1) + " " + std::to_string(f + 2) + "\n";
+        }
+        objs.push_back(obj);
+        names.push_back("res/model" + std::to_string(i) + ".obj");
+    }
+    uint32_t wav[11 + 64] = {};
+    const uint32_t wavHeader[11] = {0x46464952, 36 + 256, 0x45564157, 0x20746D66, 16, 0x00020001, 44100,
+        44100 * 4, 0x00100004, 0x61746164, 256};
+    memcpy(wav, wavHeader, sizeof(wavHeader));
+    std::vector<ae::archive_source_t> sources;
+    for (uint32_t i = 0; i < 4; i++) sources.push_back({names[i].c_str(), objs[i].data(), objs[i].size()});
+    sources.push_back({"res/sound.wav", wav, sizeof(wav)});
+    size_t size = 0;
+    void *archive = ae::io::packArchive(sources.data(), uint32_t(sources.size()), &size);
+    REQUIRE( ae::vfs::mountArchiveFromMemory(archive, size) );
+    const ae::assets::asset_usage_t before = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+    auto loadsSince = [&before]() {
+        return ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).loadCount - before.loadCount;
+    };
+
+    SECTION( "loads are deduplicated and reference counted" ) {
+        ae::assets::model_handle_t a = ae::assets::load<ae::raw_model_t>("res/model0.obj");
+        ae::assets::model_handle_t b = ae::assets::load<ae::raw_model_t>("RES\\Model0.obj");
+        REQUIRE( a.isValid() );
+        REQUIRE( a == b );
+        const ae::raw_model_t *model = ae::assets::get(a);
+        REQUIRE( model != nullptr );
+        REQUIRE( std::string(model->modelName) == "Model0" );
+        REQUIRE( loadsSince() == 1 );
+        ae::assets::asset_usage_t usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+        REQUIRE( usage.assetCount == 1 );
+        REQUIRE( usage.bytes == size_t(StretchyBufferCount(model->vertexData) + StretchyBufferCount(model->indexData)) * 4 );
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_SOUND).assetCount == 0 );
+
+        ae::assets::model_handle_t c = ae::assets::acquire(a);
+        REQUIRE( c == a );
+        ae::assets::release(a);
+        ae::assets::release(b);
+        REQUIRE( ae::assets::get(c) == model );
+        ae::assets::release(c);
+        // no budget, so the last release frees it, and the handles go stale.
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).assetCount == 0 );
+        REQUIRE( ae::assets::get(a) == nullptr );
+        REQUIRE( !ae::assets::acquire(a).isValid() );
+        ae::assets::release(a);
+        ae::assets::model_handle_t d = ae::assets::load<ae::raw_model_t>("res/model0.obj");
+        REQUIRE( !(d == a) );
+        REQUIRE( loadsSince() == 2 );
+        ae::assets::release(d);
+    }
+
+    SECTION( "types are kept apart" ) {
+        ae::assets::sound_handle_t sound = ae::assets::load<ae::loaded_wav_t>("res/sound.wav");
+        REQUIRE( ae::assets::get(sound) != nullptr );
+        REQUIRE( ae::assets::get(sound)->sampleCount == 64 );
+        ae::assets::asset_usage_t usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_SOUND);
+        REQUIRE( usage.assetCount == 1 );
+        REQUIRE( usage.bytes == sizeof(wav) );
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).assetCount == 0 );
+        ae::assets::release(sound);
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_SOUND).assetCount == 0 );
+    }
+
+    SECTION( "unreferenced assets are evicted least recently used first" ) {
+        size_t bytes[4];
+        for (uint32_t i = 0; i < 4; i++) {
+            ae::assets::model_handle_t h = ae::assets::load<ae::raw_model_t>(names[i].c_str());
+            bytes[i] = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).bytes;
+            ae::assets::release(h);
+        }
+        REQUIRE( loadsSince() == 4 );
+        // room for models 0, 1 and 2, but not 3 as well.
+        ae::assets::setMemoryBudget(bytes[0] + bytes[1] + bytes[2]);
+        for (uint32_t i = 0; i < 3; i++) ae::assets::release(ae::assets::load<ae::raw_model_t>(names[i].c_str()));
+        REQUIRE( loadsSince() == 7 );
+        ae::assets::asset_usage_t usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+        REQUIRE( usage.assetCount == 3 );
+        REQUIRE( usage.cachedCount == 3 );
+        // touch model 0, so that model 1 is now the least recently used.
+        ae::assets::release(ae::assets::load<ae::raw_model_t>(names[0].c_str()));
+        REQUIRE( loadsSince() == 7 );
+        ae::assets::model_handle_t held = ae::assets::load<ae::raw_model_t>(names[3].c_str());
+        usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+        REQUIRE( usage.bytes <= bytes[0] + bytes[1] + bytes[2] );
+        REQUIRE( usage.cachedCount == 1 );
+        ae::assets::release(ae::assets::load<ae::raw_model_t>(names[0].c_str()));
+        REQUIRE( loadsSince() == 8 );
+        ae::assets::release(ae::assets::load<ae::raw_model_t>(names[1].c_str()));
+        REQUIRE( loadsSince() == 9 );
+        // a referenced asset is never evicted, even when it alone is over the budget.
+        ae::assets::setMemoryBudget(1);
+        REQUIRE( ae::assets::get(held) != nullptr );
+        usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+        REQUIRE( (usage.assetCount == 1 && usage.cachedCount == 0) );
+        ae::assets::release(held);
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).assetCount == 0 );
+        ae::assets::setMemoryBudget(0);
+    }
+
+    SECTION( "concurrent loads of the same asset share one load" ) {
+        const uint32_t threadCount = 8;
+        std::vector<ae::assets::model_handle_t> handles(threadCount * 4);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t i = 0; i < 4; i++) {
+                    uint32_t m = (i + t) % 4;
+                    handles[t * 4 + m] = ae::assets::load<ae::raw_model_t>(names[m].c_str());
+                }
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+        REQUIRE( loadsSince() == 4 );
+        for (uint32_t t = 0; t < threadCount; t++) {
+            for (uint32_t m = 0; m < 4; m++) REQUIRE( handles[t * 4 + m] == handles[m] );
+        }
+        for (ae::assets::model_handle_t h : handles) ae::assets::release(h);
+        REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).assetCount == 0 );
+    }
+
+    ae::vfs::unmountArchives();
+    free(archive);
+}
+
+// a listener that takes itself off as it is called.
+static void oneShotReloadListener(const char *, void *user) {
+    (*(int *)user)++;
+    ae::assets::removeReloadListener(oneShotReloadListener, user);
+}
+
+TEST_CASE("asset hot reload", "[ae::assets]") {
+    // a second archive mounted over the first stands in for the file changing on disk.
+    std::string v1 = "o Before\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+    std::string v2 = "o After\nv 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 2 4 3\n";
+    ae::archive_source_t source = {"res/reload.obj", v1.data(), v1.size()};
+    size_t size1 = 0, size2 = 0;
+    void *archive1 = ae::io::packArchive(&source, 1, &size1);
+    source.data = v2.data();
+    source.size = v2.size();
+    void *archive2 = ae::io::packArchive(&source, 1, &size2);
+    REQUIRE( ae::vfs::mountArchiveFromMemory(archive1, size1) );
+
+    ae::assets::model_handle_t handle = ae::assets::load<ae::raw_model_t>("res/reload.obj");
+    REQUIRE( handle.isValid() );
+    REQUIRE( std::string(ae::assets::get(handle)->modelName) == "Before" );
+    const uint32_t version = ae::assets::getVersion(handle);
+
+    std::vector<std::string> heard;
+    ae::assets::PFN_onFileChanged listener = [](const char *path, void *user) {
+        ((std::vector<std::string> *)user)->push_back(path);
+    };
+    int oneShotCalls = 0;
+    ae::assets::addReloadListener(oneShotReloadListener, &oneShotCalls);
+    ae::assets::addReloadListener(listener, &heard);
+    ae::assets::setReloadDebounce(0.0f);
+    REQUIRE( ae::vfs::mountArchiveFromMemory(archive2, size2) );
+    ae::assets::notifyFileChanged("res/reload.obj");
+    ae::assets::notifyFileChanged("./res/reload.obj");  // the same file, so a single reload.
+    for (uint32_t i = 0; i < 1000 && ae::assets::getVersion(handle) == version; i++) {
+        ae::assets::update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE( ae::assets::getVersion(handle) == version + 1 );
+    const ae::raw_model_t *model = ae::assets::get(handle);
+    REQUIRE( std::string(model->modelName) == "After" );
+    REQUIRE( StretchyBufferCount(model->indexData) == 6 );
+    REQUIRE( heard.size() == 1 );
+    REQUIRE( heard[0] == "res/reload.obj" );
+    REQUIRE( oneShotCalls == 1 );
+    ae::assets::asset_usage_t usage = ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL);
+    REQUIRE( usage.bytes == size_t(StretchyBufferCount(model->vertexData) + StretchyBufferCount(model->indexData)) * 4 );
+
+    ae::assets::release(handle);
+    REQUIRE( ae::assets::getUsage(ae::assets::ASSET_TYPE_MODEL).assetCount == 0 );
+    ae::assets::removeReloadListener(listener, &heard);
+    ae::assets::setReloadDebounce(ae::assets::HOT_RELOAD_DEBOUNCE_SECONDS);
+    ae::vfs::unmountArchives();
+    free(archive1);
+    free(archive2);
+}
+
+// make a .WAV at 44100 Hz, with a junk chunk before the data as real files often have. formatTag is 1 for integer
+// PCM and 3 for float, and with bExtensible it goes in the GUID of a WAVE_FORMAT_EXTENSIBLE fmt chunk instead.
+static std::vector<uint8_t> makeTestWav(uint16_t formatTag, uint16_t channels, uint16_t bits, const void *data,
+    size_t dataBytes, bool bExtensible = false) {
+    std::vector<uint8_t> wav;
+    auto put32 = [&wav](uint32_t v) { for (int i = 0; i < 4; i++) wav.push_back(uint8_t(v >> (i * 8))); };
+    auto put16 = [&wav](uint16_t v) { wav.push_back(uint8_t(v)); wav.push_back(uint8_t(v >> 8)); };
+    uint32_t fmtBytes = bExtensible ? 40 : 16;
+    put32(0x46464952); put32(uint32_t(4 + 8 + fmtBytes + 14 + 8 + dataBytes + (dataBytes & 1))); put32(0x45564157);
+    put32(0x20746D66); put32(fmtBytes);
+    put16(bExtensible ? 0xFFFE : formatTag); put16(channels); put32(44100);
+    put32(44100 * channels * bits / 8); put16(channels * bits / 8); put16(bits);
+    if (bExtensible) {
+        put16(22); put16(bits); put32(channels == 2 ? 3 : 4);
+        put32(formatTag); put32(0x00100000); put32(0xAA000080); put32(0x719B3800);
+    }
+    put32(0x4B4E554A); put32(5);
+    for (int i = 0; i < 6; i++) wav.push_back(0);  // 5 bytes, and the pad byte.
+    put32(0x61746164); put32(uint32_t(dataBytes));
+    wav.insert(wav.end(), (const uint8_t *)data, (const uint8_t *)data + dataBytes);
+    if (dataBytes & 1) wav.push_back(0);
+    return wav;
+}
+
+TEST_CASE("audio stream", "[ae::io]") {
+    const uint32_t frameCount = 10007;
+    std::vector<short> mono(frameCount), stereo(frameCount * 2);
+    for (uint32_t i = 0; i < frameCount; i++) {
+        mono[i] = short(i * 7);
+        stereo[i * 2 + 0] = short(i);
+        stereo[i * 2 + 1] = short(-int(i));
+    }
+    std::vector<uint8_t> monoWav = makeTestWav(1, 1, 16, mono.data(), mono.size() * 2);
+    std::vector<uint8_t> stereoWav = makeTestWav(1, 2, 16, stereo.data(), stereo.size() * 2);
+    ae::archive_source_t sources[2] = {{"mono.wav", monoWav.data(), monoWav.size()},
+        {"stereo.wav", stereoWav.data(), stereoWav.size()}};
+    size_t size = 0;
+    void *archive = ae::io::packArchive(sources, 2, &size);
+    REQUIRE( ae::vfs::mountArchiveFromMemory(archive, size) );
+    // the samples of frame i, as they come out of the stream.
+    auto expected = [&](bool bMono, uint32_t i, uint32_t channel) {
+        return bMono ? mono[i] : stereo[i * 2 + channel];
+    };
+
+    for (bool bMono : {true, false}) {
+        SECTION( bMono ? "mono is widened to stereo" : "stereo" ) {
+            ae::io::audio_stream_t *stream = ae::io::openAudioStream(bMono ? "mono.wav" : "stereo.wav", 1000);
+            REQUIRE( stream != nullptr );
+            REQUIRE( ae::io::getAudioStreamFrameCount(stream) == frameCount );
+            // reads that do not line up with the blocks.
+            std::vector<short> out;
+            short chunk[333 * 2];
+            for (uint32_t n; (n = ae::io::readAudioStream(stream, chunk, 333)) > 0;) {
+                out.insert(out.end(), chunk, chunk + n * 2);
+            }
+            REQUIRE( out.size() == frameCount * 2 );
+            bool bSame = true;
+            for (uint32_t i = 0; i < frameCount; i++) {
+                bSame &= out[i * 2] == expected(bMono, i, 0) && out[i * 2 + 1] == expected(bMono, i, 1);
+            }
+            REQUIRE( bSame );
+            REQUIRE( ae::io::readAudioStream(stream, chunk, 1) == 0 );
+            // the memory does not depend on the length of the file.
+            ae::audio_stream_stats_t stats = ae::io::getAudioStreamStats(stream);
+            REQUIRE( stats.framesDecoded == frameCount );
+            REQUIRE( stats.residentBytes < 1000 * 4 * ae::io::AUDIO_STREAM_BLOCK_COUNT * 2 );
+            REQUIRE( stats.mappedBytes == 0 );
+            ae::io::closeAudioStream(stream);
+        }
+    }
+
+    SECTION( "looping goes back to the start" ) {
+        ae::io::audio_stream_t *stream = ae::io::openAudioStream("stereo.wav", 4096, true);
+        REQUIRE( stream != nullptr );
+        std::vector<short> out(frameCount * 3 * 2);
+        REQUIRE( ae::io::readAudioStream(stream, out.data(), frameCount * 3) == frameCount * 3 );
+        bool bSame = true;
+        for (uint32_t i = 0; i < frameCount * 3; i++) bSame &= out[i * 2 + 1] == expected(false, i % frameCount, 1);
+        REQUIRE( bSame );
+        ae::io::closeAudioStream(stream);
+    }
+
+    SECTION( "closing with reads in flight" ) {
+        ae::io::audio_stream_t *stream = ae::io::openAudioStream("mono.wav", 64);
+        REQUIRE( stream != nullptr );
+        ae::io::closeAudioStream(stream);
+    }
+
+    ae::vfs::unmountArchives();
+    free(archive);
+}
+
+// what convertPcm should make of one sample, written out the slow way.
+static short referencePcmSample(ae::io::pcm_format_t format, const uint8_t *p) {
+    switch (format) {
+        case ae::io::PCM_FORMAT_U8: return short((int(p[0]) - 128) * 256);
+        case ae::io::PCM_FORMAT_S16: return short(p[0] | (p[1] << 8));
+        case ae::io::PCM_FORMAT_S24: return short(int32_t(uint32_t(p[0] << 8 | p[1] << 16 | p[2] << 24)) >> 16);
+        case ae::io::PCM_FORMAT_S32: return short(int32_t(uint32_t(p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24)) >> 16);
+        default: {
+            float f;
+            memcpy(&f, p, 4);
+            if (std::isnan(f)) return -32768;
+            return short(std::nearbyint(std::min(std::max(f * 32767.f, -32768.f), 32767.f)));
+        }
+    }
+}
+
+TEST_CASE("pcm conversion", "[ae::io]") {
+    const uint32_t sizes[ae::io::PCM_FORMAT_COUNT] = {1, 2, 3, 4, 4};
+    utils::Seed(__LINE__);
+    for (uint32_t format = 0; format < ae::io::PCM_FORMAT_COUNT; format++) {
+        const uint32_t size = sizes[format];
+        // enough for the largest count below, in stereo.
+        std::vector<uint8_t> src(1003 * 2 * size);
+        for (uint8_t &b : src) b = uint8_t(utils::RandomUINT32(0, 255));
+        if (format == ae::io::PCM_FORMAT_F32) {
+            const float specials[] = {0.f, 1.f, -1.f, 2.f, -2.f, 1e20f, -1e20f, NAN, INFINITY, -INFINITY, 0.5f};
+            for (uint32_t i = 0; i < src.size() / 4; i++) {
+                float f = (i < 11) ? specials[i] : utils::RandomFloat(-1.2f, 1.2f);
+                memcpy(&src[i * 4], &f, 4);
+            }
+        }
+        for (uint32_t channels = 1; channels <= 2; channels++) {
+            // counts about the 8 samples that the kernels do at once, so that the tails are covered too.
+            for (uint32_t frameCount : {1u, 7u, 8u, 9u, 15u, 16u, 17u, 1003u}) {
+                std::vector<short> dst(frameCount * 2 + 1, 0x1234);
+                ae::io::convertPcm(src.data(), ae::io::pcm_format_t(format), channels, frameCount, dst.data());
+                bool bSame = dst[frameCount * 2] == 0x1234;
+                for (uint32_t i = 0; i < frameCount; i++) {
+                    for (uint32_t c = 0; c < 2; c++) {
+                        uint32_t sample = i * channels + (channels == 2 ? c : 0);
+                        bSame &= dst[i * 2 + c] == referencePcmSample(ae::io::pcm_format_t(format), &src[sample * size]);
+                    }
+                }
+                INFO( "format " << format << ", channels " << channels << ", frames " << frameCount );
+                REQUIRE( bSame );
+            }
+        }
+    }
+
+    SECTION( "loadWav takes every format" ) {
+        std::vector<uint8_t> s24(301 * 3), f32(301 * 2 * 4);
+        for (uint8_t &b : s24) b = uint8_t(utils::RandomUINT32(0, 255));
+        for (uint32_t i = 0; i < 301 * 2; i++) {
+            float f = utils::RandomFloat(-1.f, 1.f);
+            memcpy(&f32[i * 4], &f, 4);
+        }
+        std::vector<uint8_t> monoWav = makeTestWav(1, 1, 24, s24.data(), s24.size());
+        std::vector<uint8_t> floatWav = makeTestWav(3, 2, 32, f32.data(), f32.size(), true);
+        ae::archive_source_t sources[2] = {{"mono24.wav", monoWav.data(), monoWav.size()},
+            {"float.wav", floatWav.data(), floatWav.size()}};
+        size_t archiveSize = 0;
+        void *archive = ae::io::packArchive(sources, 2, &archiveSize);
+        REQUIRE( ae::vfs::mountArchiveFromMemory(archive, archiveSize) );
+
+        std::vector<short> expected(301 * 2);
+        ae::loaded_wav_t wav = ae::io::loadWav("mono24.wav");
+        REQUIRE( wav.sampleData != nullptr );
+        REQUIRE( (wav.sampleCount == 301 && wav.channels == 2) );
+        ae::io::convertPcm(s24.data(), ae::io::PCM_FORMAT_S24, 1, 301, expected.data());
+        REQUIRE( memcmp(wav.sampleData, expected.data(), expected.size() * 2) == 0 );
+        ae::io::freeWav(wav);
+
+        wav = ae::io::loadWav("float.wav");
+        REQUIRE( wav.sampleData != nullptr );
+        REQUIRE( (wav.sampleCount == 301 && wav.channels == 2) );
+        ae::io::convertPcm(f32.data(), ae::io::PCM_FORMAT_F32, 2, 301, expected.data());
+        REQUIRE( memcmp(wav.sampleData, expected.data(), expected.size() * 2) == 0 );
+        ae::io::freeWav(wav);
+
+        // and the stream, which converts a block at a time.
+        ae::io::audio_stream_t *stream = ae::io::openAudioStream("mono24.wav", 64);
+        REQUIRE( stream != nullptr );
+        std::vector<short> streamed(301 * 2);
+        REQUIRE( ae::io::readAudioStream(stream, streamed.data(), 400) == 301 );
+        ae::io::convertPcm(s24.data(), ae::io::PCM_FORMAT_S24, 1, 301, expected.data());
+        REQUIRE( streamed == expected );
+        ae::io::closeAudioStream(stream);
+
+        ae::vfs::unmountArchives();
+        free(archive);
+    }
+}
+
+TEST_CASE("pcm conversion throughput", "[ae::io][!benchmark]") {
+    // a second of stereo at 44100 Hz is 88200 samples, so this is about 12 seconds of audio.
+    constexpr uint32_t frameCount = 1 << 19;
+    static uint8_t src[frameCount * 2 * 4];
+    static short dst[frameCount * 2];
+    utils::Seed(__LINE__);
+    for (uint32_t i = 0; i < frameCount * 2; i++) {
+        float f = utils::RandomFloat(-1.f, 1.f);
+        memcpy(&src[i * 4], &f, 4);
+    }
+    const char *names[ae::io::PCM_FORMAT_COUNT] = {"u8", "s16", "s24", "s32", "f32"};
+    for (uint32_t format = 0; format < ae::io::PCM_FORMAT_COUNT; format++) {
+        for (uint32_t channels = 1; channels <= 2; channels++) {
+            std::string name = std::string(names[format]) + (channels == 1 ? " mono" : " stereo") + " to s16 stereo";
+            BENCHMARK(name.c_str()) {
+                ae::io::convertPcm(src, ae::io::pcm_format_t(format), channels, frameCount, dst);
+                return dst[0];
+            };
+        }
+    }
+}
+
+// builds a .BMP with a 40 byte header, or a larger one when headerSize says so. writePixel fills in one pixel in
+// the file's own format, with y counting up from the bottom row whichever way the rows are stored.
+static std::vector<uint8_t> makeTestBmp(uint32_t width, uint32_t height, bool bTopDown, uint16_t bpp,
+    uint32_t compression, const std::vector<uint8_t> &extra, uint32_t clrUsed,
+    const std::function<void(uint32_t x, uint32_t y, uint8_t *p)> &writePixel, uint32_t headerSize = 40) {
+    std::vector<uint8_t> bmp;
+    auto put32 = [&bmp](uint32_t v) { for (int i = 0; i < 4; i++) bmp.push_back(uint8_t(v >> (i * 8))); };
+    auto put16 = [&bmp](uint16_t v) { bmp.push_back(uint8_t(v)); bmp.push_back(uint8_t(v >> 8)); };
+    uint32_t stride = ((width * bpp + 31) / 32) * 4;
+    uint32_t offset = 14 + uint32_t(std::max<size_t>(headerSize, 40 + extra.size()));
+    if (bpp == 8) offset = 14 + headerSize + uint32_t(extra.size());
+    put16(0x4D42); put32(offset + stride * height); put16(0); put16(0); put32(offset);
+    put32(headerSize); put32(width); put32(bTopDown ? uint32_t(-int32_t(height)) : height); put16(1); put16(bpp);
+    put32(compression); put32(stride * height); put32(2835); put32(2835); put32(clrUsed); put32(0);
+    bmp.insert(bmp.end(), extra.begin(), extra.end());
+    bmp.resize(offset, 0);
+    // the row padding is filled with junk, which must never show up in the image.
+    bmp.resize(offset + stride * height, 0xCD);
+    for (uint32_t row = 0; row < height; row++) {
+        uint32_t y = bTopDown ? height - 1 - row : row;
+        for (uint32_t x = 0; x < width; x++) writePixel(x, y, &bmp[offset + row * stride + x * bpp / 8]);
+    }
+    return bmp;
+}
+
+TEST_CASE("bmp decoding", "[ae::io]") {
+    utils::Seed(__LINE__);
+    const uint32_t widths[] = {1, 2, 3, 4, 5, 7, 8, 9, 13, 16, 17, 31, 33, 64};
+    auto colorAt = [](uint32_t x, uint32_t y) {
+        uint32_t h = x * 0x9E3779B1u ^ (y + 1) * 0x85EBCA77u;
+        return h ^ (h >> 15) ^ (h << 7);
+    };
+    auto check = [&](const std::vector<uint8_t> &bmp, uint32_t width, uint32_t height,
+                     const std::function<uint32_t(uint32_t, uint32_t)> &expected) {
+        uint32_t w = 0, h = 0;
+        REQUIRE(ae::io::decodeBMP(bmp.data(), bmp.size(), nullptr, &w, &h));
+        REQUIRE(w == width);
+        REQUIRE(h == height);
+        std::vector<uint32_t> pixels(width * height + 1, 0xDEADBEEF);
+        REQUIRE(ae::io::decodeBMP(bmp.data(), bmp.size(), pixels.data(), &w, &h));
+        uint32_t mismatches = 0;
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) mismatches += pixels[y * width + x] != expected(x, y);
+        }
+        REQUIRE(mismatches == 0);
+        REQUIRE(pixels[width * height] == 0xDEADBEEF);
+    };
+    auto rgba = [](uint32_t r, uint32_t g, uint32_t b, uint32_t a) { return r | (g << 8) | (b << 16) | (a << 24); };
+
+    for (bool bTopDown : {false, true}) {
+        for (uint32_t width : widths) {
+            for (uint32_t height : {1u, 3u}) {
+                std::string size = std::to_string(width) + "x" + std::to_string(height) + (bTopDown ? " top-down" : "");
+                DYNAMIC_SECTION("32 bpp BI_RGB keeps the alpha, " << size) {
+                    auto bmp = makeTestBmp(width, height, bTopDown, 32, 0, {}, 0, [&](uint32_t x, uint32_t y,
+                                                                                          uint8_t *p) {
+                        uint32_t c = colorAt(x, y);
+                        memcpy(p, &c, 4);  // 0xAARRGGBB
+                    });
+                    check(bmp, width, height, [&](uint32_t x, uint32_t y) {
+                        uint32_t c = colorAt(x, y);
+                        return rgba((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, c >> 24);
+                    });
+                }
+                DYNAMIC_SECTION("32 bpp BI_BITFIELDS in RGBA byte order, " << size) {
+                    std::vector<uint8_t> masks = {0xFF, 0, 0, 0, 0, 0xFF, 0, 0, 0, 0, 0xFF, 0, 0, 0, 0, 0xFF};
+                    auto bmp = makeTestBmp(width, height, bTopDown, 32, 6, masks, 0, [&](uint32_t x, uint32_t y,
+                                                                                          uint8_t *p) {
+                        uint32_t c = colorAt(x, y);
+                        memcpy(p, &c, 4);
+                    });
+                    check(bmp, width, height, colorAt);
+                }
+                DYNAMIC_SECTION("32 bpp BI_BITFIELDS without alpha in a V5 header, " << size) {
+                    // masks for B, G, R at bytes 1, 2, 3 and no alpha, so the low byte is padding.
+                    std::vector<uint8_t> masks = {0, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0xFF, 0, 0, 0, 0, 0, 0};
+                    auto bmp = makeTestBmp(width, height, bTopDown, 32, 3, masks, 0, [&](uint32_t x, uint32_t y,
+                                                                                          uint8_t *p) {
+                        uint32_t c = colorAt(x, y);
+                        memcpy(p, &c, 4);
+                    }, 124);
+                    check(bmp, width, height, [&](uint32_t x, uint32_t y) {
+                        uint32_t c = colorAt(x, y);
+                        return rgba(c >> 24, (c >> 16) & 0xFF, (c >> 8) & 0xFF, 0xFF);
+                    });
+                }
+                DYNAMIC_SECTION("24 bpp, " << size) {
+                    auto bmp = makeTestBmp(width, height, bTopDown, 24, 0, {}, 0, [&](uint32_t x, uint32_t y,
+                                                                                          uint8_t *p) {
+                        uint32_t c = colorAt(x, y);
+                        p[0] = uint8_t(c), p[1] = uint8_t(c >> 8), p[2] = uint8_t(c >> 16);  // B, G, R
+                    });
+                    check(bmp, width, height, [&](uint32_t x, uint32_t y) {
+                        uint32_t c = colorAt(x, y);
+                        return rgba((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, 0xFF);
+                    });
+                }
+                DYNAMIC_SECTION("8 bpp paletted, " << size) {
+                    const uint32_t clrUsed = 200;
+                    std::vector<uint8_t> palette(clrUsed * 4);
+                    for (auto &b : palette) b = uint8_t(utils::RandomUINT32(0, 255));
+                    auto bmp = makeTestBmp(width, height, bTopDown, 8, 0, palette, clrUsed,
+                        [&](uint32_t x, uint32_t y, uint8_t *p) { *p = uint8_t(colorAt(x, y)); });
+                    check(bmp, width, height, [&](uint32_t x, uint32_t y) {
+                        uint32_t i = colorAt(x, y) & 0xFF;
+                        if (i >= clrUsed) return 0xFF000000u;
+                        return rgba(palette[i * 4 + 2], palette[i * 4 + 1], palette[i * 4 + 0], 0xFF);
+                    });
+                }
+            }
+        }
+    }
+
+    SECTION("unsupported and broken files are refused") {
+        auto any = [](uint32_t, uint32_t, uint8_t *p) { *p = 1; };
+        uint32_t w, h;
+        auto bmp16 = makeTestBmp(8, 8, false, 16, 0, {}, 0, any);
+        REQUIRE(!ae::io::decodeBMP(bmp16.data(), bmp16.size(), nullptr, &w, &h));
+        auto rle8 = makeTestBmp(8, 8, false, 8, 1, std::vector<uint8_t>(1024), 0, any);
+        REQUIRE(!ae::io::decodeBMP(rle8.data(), rle8.size(), nullptr, &w, &h));
+        // a 5:6:5 style mask does not cover whole bytes.
+        std::vector<uint8_t> masks = {0, 0xF8, 0, 0, 0xE0, 0x07, 0, 0, 0x1F, 0, 0, 0};
+        auto odd = makeTestBmp(8, 8, false, 32, 3, masks, 0, any);
+        REQUIRE(!ae::io::decodeBMP(odd.data(), odd.size(), nullptr, &w, &h));
+        auto bmp = makeTestBmp(8, 8, false, 24, 0, {}, 0, any);
+        REQUIRE(ae::io::decodeBMP(bmp.data(), bmp.size(), nullptr, &w, &h));
+        REQUIRE(!ae::io::decodeBMP(bmp.data(), bmp.size() - 1, nullptr, &w, &h));
+        REQUIRE(!ae::io::decodeBMP(bmp.data(), 20, nullptr, &w, &h));
+        bmp[0] = 'X';
+        REQUIRE(!ae::io::decodeBMP(bmp.data(), bmp.size(), nullptr, &w, &h));
+    }
+}
+
+TEST_CASE("bmp decoding throughput", "[ae::io][!benchmark]") {
+    const uint32_t size = 2048;
+    utils::Seed(__LINE__);
+    std::vector<uint32_t> pixels(size * size);
+    for (uint32_t &p : pixels) p = utils::RandomUINT32(0, 0x7FFF) | (utils::RandomUINT32(0, 0x7FFF) << 16);
+    std::vector<uint8_t> palette(1024);
+    for (auto &b : palette) b = uint8_t(utils::RandomUINT32(0, 255));
+    auto bmp32 = makeTestBmp(size, size, false, 32, 0, {}, 0,
+        [&](uint32_t x, uint32_t y, uint8_t *p) { memcpy(p, &pixels[y * size + x], 4); });
+    auto bmp24 = makeTestBmp(size, size, true, 24, 0, {}, 0,
+        [&](uint32_t x, uint32_t y, uint8_t *p) { memcpy(p, &pixels[y * size + x], 3); });
+    auto bmp8 = makeTestBmp(size, size, false, 8, 0, palette, 0,
+        [&](uint32_t x, uint32_t y, uint8_t *p) { *p = uint8_t(pixels[y * size + x]); });
+    std::vector<uint32_t> dst(size * size);
+    uint32_t w, h;
+    BENCHMARK("32 bpp, scalar copy and swizzle") {
+        // what loadBMP used to do, for comparison.
+        memcpy(dst.data(), bmp32.data() + 54, dst.size() * 4);
+        for (uint32_t &p : dst) p = (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16);
+        return dst[0];
+    };
+    BENCHMARK("32 bpp") {
+        ae::io::decodeBMP(bmp32.data(), bmp32.size(), dst.data(), &w, &h);
+        return dst[0];
+    };
+    BENCHMARK("24 bpp, top-down") {
+        ae::io::decodeBMP(bmp24.data(), bmp24.size(), dst.data(), &w, &h);
+        return dst[0];
+    };
+    BENCHMARK("8 bpp paletted") {
+        ae::io::decodeBMP(bmp8.data(), bmp8.size(), dst.data(), &w, &h);
+        return dst[0];
+    };
+}
+
+TEST_CASE("batch image decoding and mip chains", "[ae::io]") {
+    utils::Seed(__LINE__);
+    const uint32_t sizes[][2] = {{1, 1}, {7, 3}, {64, 64}, {33, 17}, {1, 9}, {128, 5}, {100, 75}, {2, 2}};
+    const uint32_t imageCount = uint32_t(sizeof(sizes) / sizeof(sizes[0]));
+    std::vector<std::vector<uint8_t>> files;
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < imageCount; i++) {
+        files.push_back(makeTestBmp(sizes[i][0], sizes[i][1], i & 1, 24, 0, {}, 0, [](uint32_t, uint32_t, uint8_t *p) {
+            p[0] = uint8_t(utils::RandomUINT32(0, 255)), p[1] = uint8_t(utils::RandomUINT32(0, 255));
+            p[2] = uint8_t(utils::RandomUINT32(0, 255));
+        }));
+        names.push_back("res/textures/image" + std::to_string(i) + ".bmp");
+    }
+    std::vector<ae::archive_source_t> sources;
+    for (uint32_t i = 0; i < imageCount; i++) sources.push_back({names[i].c_str(), files[i].data(), files[i].size()});
+    size_t size = 0;
+    void *archive = ae::io::packArchive(sources.data(), imageCount, &size);
+    REQUIRE(archive != nullptr);
+    REQUIRE(ae::vfs::mountArchiveFromMemory(archive, size));
+
+    std::vector<const char *> paths;
+    for (const std::string &name : names) paths.push_back(name.c_str());
+    std::vector<ae::mip_chain_t> chains(imageCount);
+    REQUIRE(ae::io::loadImages(paths.data(), imageCount, chains.data()) == imageCount);
+
+    for (uint32_t i = 0; i < imageCount; i++) {
+        const ae::mip_chain_t &chain = chains[i];
+        REQUIRE(chain.width == sizes[i][0]);
+        REQUIRE(chain.height == sizes[i][1]);
+        REQUIRE(chain.contentHash == ae::vfs::hashContents(files[i].data(), files[i].size()));
+
+        // level 0 matches the engine's own BMP decoder, which is bottom row first too.
+        std::vector<uint32_t> expected(chain.width * chain.height);
+        uint32_t w, h;
+        REQUIRE(ae::io::decodeBMP(files[i].data(), files[i].size(), expected.data(), &w, &h));
+        REQUIRE(memcmp(chain.pixels, expected.data(), expected.size() * 4) == 0);
+
+        // each mip is the rounded average of 2x2 blocks of the level above, clamped at odd edges.
+        uint32_t level = 0, lw = chain.width, lh = chain.height;
+        while (lw > 1 || lh > 1) {
+            uint32_t mw = std::max(lw / 2, 1u), mh = std::max(lh / 2, 1u);
+            REQUIRE(chain.levelOffset[level + 1] == chain.levelOffset[level] + lw * lh);
+            const uint32_t *src = chain.pixels + chain.levelOffset[level];
+            const uint32_t *mip = chain.pixels + chain.levelOffset[level + 1];
+            uint32_t mismatches = 0;
+            for (uint32_t y = 0; y < mh; y++) {
+                for (uint32_t x = 0; x < mw; x++) {
+                    uint32_t x0 = std::min(2 * x, lw - 1), x1 = std::min(2 * x + 1, lw - 1);
+                    uint32_t y0 = std::min(2 * y, lh - 1), y1 = std::min(2 * y + 1, lh - 1);
+                    uint32_t expectedPixel = 0;
+                    for (uint32_t c = 0; c < 32; c += 8) {
+                        uint32_t sum = ((src[y0 * lw + x0] >> c) & 0xFF) + ((src[y0 * lw + x1] >> c) & 0xFF) +
+                                       ((src[y1 * lw + x0] >> c) & 0xFF) + ((src[y1 * lw + x1] >> c) & 0xFF);
+                        expectedPixel |= ((sum + 2) / 4) << c;
+                    }
+                    mismatches += mip[y * mw + x] != expectedPixel;
+                }
+            }
+            REQUIRE(mismatches == 0);
+            level++, lw = mw, lh = mh;
+        }
+        REQUIRE(chain.levelCount == level + 1);
+
+        // decoding from memory gives the same chain.
+        ae::mip_chain_t single;
+        REQUIRE(ae::io::decodeImage(files[i].data(), files[i].size(), &single));
+        REQUIRE(single.levelCount == chain.levelCount);
+        REQUIRE(memcmp(single.pixels, chain.pixels, (chain.levelOffset[chain.levelCount - 1] + 1) * 4) == 0);
+        ae::io::freeMipChain(&single);
+        REQUIRE(single.pixels == nullptr);
+    }
+    for (ae::mip_chain_t &chain : chains) ae::io::freeMipChain(&chain);
+
+    SECTION("content hashes tell apart files that differ by a single bit") {
+        std::vector<uint8_t> bytes(100);
+        for (uint8_t &b : bytes) b = uint8_t(utils::RandomUINT32(0, 255));
+        std::vector<uint64_t> hashes;
+        for (size_t length : {0, 1, 7, 8, 31, 32, 33, 100}) {
+            hashes.push_back(ae::vfs::hashContents(bytes.data(), length));
+        }
+        for (size_t bit = 0; bit < bytes.size() * 8; bit += 5) {
+            bytes[bit / 8] ^= uint8_t(1 << (bit % 8));
+            hashes.push_back(ae::vfs::hashContents(bytes.data(), bytes.size()));
+            bytes[bit / 8] ^= uint8_t(1 << (bit % 8));
+        }
+        std::sort(hashes.begin(), hashes.end());
+        REQUIRE(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+        REQUIRE(ae::vfs::hashContents(bytes.data(), bytes.size()) == ae::vfs::hashContents(bytes.data(), bytes.size()));
+    }
+
+    ae::vfs::unmountArchives();
+    free(archive);
+}
+
+TEST_CASE("mip generation options", "[ae::io]") {
+    auto makeImage = [](std::vector<uint32_t> &pixels, uint32_t width, uint32_t height) {
+        ae::loaded_image_t image = {};
+        image.pixelPointer = pixels.data(), image.width = width, image.height = height;
+        return image;
+    };
+    const ae::io::mip_filter_t filters[] = {
+        ae::io::MIP_FILTER_BOX, ae::io::MIP_FILTER_KAISER, ae::io::MIP_FILTER_LANCZOS};
+
+    SECTION("an image of one colour stays that colour, for every filter and every byte through sRGB") {
+        const uint32_t sizes[][2] = {{1, 1}, {37, 11}, {16, 16}, {1, 20}};
+        for (ae::io::mip_filter_t filter : filters) {
+            for (uint32_t v = 0; v < 256; v += (filter == ae::io::MIP_FILTER_BOX) ? 1 : 15) {
+                for (const auto &size : sizes) {
+                    uint32_t color = v | ((255 - v) << 8) | (((v * 7) & 0xFF) << 16) | 0xFF000000;
+                    std::vector<uint32_t> pixels(size[0] * size[1], color);
+                    ae::io::mip_options_t options = {filter, true, false};
+                    ae::mip_chain_t chain;
+                    REQUIRE(ae::io::generateMips(makeImage(pixels, size[0], size[1]), &chain, &options));
+                    uint32_t total = chain.levelOffset[chain.levelCount - 1] + 1, mismatches = 0;
+                    for (uint32_t i = 0; i < total; i++) mismatches += chain.pixels[i] != color;
+                    REQUIRE(mismatches == 0);
+                    ae::io::freeMipChain(&chain);
+                }
+            }
+        }
+    }
+
+    SECTION("sRGB averages in linear light") {
+        std::vector<uint32_t> pixels = {0xFFFFFFFF, 0xFF000000, 0xFF000000, 0xFFFFFFFF};
+        ae::io::mip_options_t options = {ae::io::MIP_FILTER_BOX, false, false};
+        ae::mip_chain_t chain;
+        REQUIRE(ae::io::generateMips(makeImage(pixels, 2, 2), &chain, &options));
+        REQUIRE(chain.pixels[chain.levelOffset[1]] == 0xFF808080);
+        ae::io::freeMipChain(&chain);
+        options.bSrgb = true;
+        REQUIRE(ae::io::generateMips(makeImage(pixels, 2, 2), &chain, &options));
+        REQUIRE(chain.pixels[chain.levelOffset[1]] == 0xFFBCBCBC);
+        ae::io::freeMipChain(&chain);
+    }
+
+    SECTION("premultiplied alpha keeps transparent colour out") {
+        std::vector<uint32_t> pixels = {0xFF0000FF, 0x0000FF00};
+        ae::io::mip_options_t options = {ae::io::MIP_FILTER_BOX, false, true};
+        ae::mip_chain_t chain;
+        REQUIRE(ae::io::generateMips(makeImage(pixels, 2, 1), &chain, &options));
+        REQUIRE(chain.pixels[chain.levelOffset[1]] == 0x800000FF);
+        ae::io::freeMipChain(&chain);
+        options.bPremultiplyAlpha = false;
+        REQUIRE(ae::io::generateMips(makeImage(pixels, 2, 1), &chain, &options));
+        REQUIRE(chain.pixels[chain.levelOffset[1]] == 0x80008080);
+        ae::io::freeMipChain(&chain);
+    }
+
+    SECTION("the windowed filters keep the mean of a noisy image") {
+        utils::Seed(__LINE__);
+        std::vector<uint32_t> pixels(64 * 48);
+        for (uint32_t &p : pixels) {
+            for (uint32_t c = 0; c < 32; c += 8) p |= utils::RandomUINT32(0, 255) << c;
+        }
+        for (ae::io::mip_filter_t filter : filters) {
+            ae::io::mip_options_t options = {filter, false, false};
+            ae::mip_chain_t chain;
+            REQUIRE(ae::io::generateMips(makeImage(pixels, 64, 48), &chain, &options));
+            REQUIRE(memcmp(chain.pixels, pixels.data(), pixels.size() * 4) == 0);
+            double mean[2] = {};
+            for (uint32_t level = 0; level < 2; level++) {
+                uint32_t count = (64 >> level) * (48 >> level);
+                for (uint32_t i = 0; i < count; i++) mean[level] += chain.pixels[chain.levelOffset[level] + i] & 0xFF;
+                mean[level] /= count;
+            }
+            REQUIRE(std::abs(mean[0] - mean[1]) < 2.0);
+            ae::io::freeMipChain(&chain);
+        }
+    }
+}
+
+TEST_CASE("mip generation throughput", "[ae::io][!benchmark]") {
+    utils::Seed(__LINE__);
+    const uint32_t size = 2048;
+    std::vector<uint32_t> pixels(size * size);
+    for (uint32_t &p : pixels) {
+        for (uint32_t c = 0; c < 32; c += 8) p |= utils::RandomUINT32(0, 255) << c;
+    }
+    ae::loaded_image_t image = {};
+    image.pixelPointer = pixels.data(), image.width = size, image.height = size;
+    auto run = [&](ae::io::mip_options_t options) {
+        ae::mip_chain_t chain;
+        ae::io::generateMips(image, &chain, &options);
+        uint32_t last = chain.pixels[chain.levelOffset[chain.levelCount - 1]];
+        ae::io::freeMipChain(&chain);
+        return last;
+    };
+    BENCHMARK("box") { return run({ae::io::MIP_FILTER_BOX, false, false}); };
+    BENCHMARK("box, sRGB and premultiplied alpha") { return run({ae::io::MIP_FILTER_BOX, true, true}); };
+    BENCHMARK("kaiser") { return run({ae::io::MIP_FILTER_KAISER, false, false}); };
+    BENCHMARK("lanczos, sRGB") { return run({ae::io::MIP_FILTER_LANCZOS, true, false}); };
+}
+
+static double blockRmse(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b, uint32_t channelCount) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        for (uint32_t c = 0; c < channelCount; c++) {
+            double d = double((a[i] >> (8 * c)) & 0xFF) - double((b[i] >> (8 * c)) & 0xFF);
+            sum += d * d;
+        }
+    }
+    return sqrt(sum / double(a.size() * channelCount));
+}
+
+TEST_CASE("block compression", "[ae::io]") {
+    utils::Seed(__LINE__);
+    // smooth colours along a curve, with a little noise on top, which is about what the formats are made for.
+    auto makePixels = [](uint32_t width, uint32_t height) {
+        std::vector<uint32_t> pixels(width * height);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                float v = 128.0f + 100.0f * sinf(float(x) * 0.1f) * cosf(float(y) * 0.13f);
+                float color[4] = {v, 0.5f * v + 0.002f * v * v + 20.0f, 255.0f - v, 255.0f - 0.5f * v};
+                uint32_t pixel = 0;
+                for (uint32_t c = 0; c < 4; c++) {
+                    int noisy = int(color[c]) + int(utils::RandomUINT32(0, 6)) - 3;
+                    pixel |= uint32_t(std::min(std::max(noisy, 0), 255)) << (8 * c);
+                }
+                pixels[y * width + x] = pixel;
+            }
+        }
+        return pixels;
+    };
+    auto makeImage = [](std::vector<uint32_t> &pixels, uint32_t width, uint32_t height) {
+        ae::loaded_image_t image = {};
+        image.pixelPointer = pixels.data(), image.width = width, image.height = height;
+        return image;
+    };
+    const ae::io::block_format_t formats[] = {
+        ae::io::BLOCK_FORMAT_BC1, ae::io::BLOCK_FORMAT_BC3, ae::io::BLOCK_FORMAT_BC7};
+    // the RMSE over the colour, and over alpha too for the formats that have it, at every quality.
+    const double limits[3][3] = {{4.0, 3.5, 3.5}, {3.5, 3.0, 3.0}, {2.5, 2.0, 2.0}};
+
+    SECTION("round trips stay close to the source, and more quality is never worse") {
+        const uint32_t sizes[][2] = {{64, 64}, {37, 11}, {1, 1}, {3, 7}, {16, 8}};
+        for (const auto &size : sizes) {
+            std::vector<uint32_t> pixels = makePixels(size[0], size[1]);
+            for (uint32_t f = 0; f < 3; f++) {
+                double previous = 1e9;
+                for (uint32_t q = 0; q < 3; q++) {
+                    ae::compressed_image_t image;
+                    REQUIRE(ae::io::compressImage(makeImage(pixels, size[0], size[1]), formats[f],
+                        ae::io::block_quality_t(q), &image));
+                    REQUIRE(image.levelCount == 1);
+                    REQUIRE(image.size == ae::io::blockCompressedSize(formats[f], size[0], size[1]));
+                    std::vector<uint32_t> decoded(pixels.size());
+                    REQUIRE(ae::io::decompressImage(image, 0, decoded.data()));
+                    ae::io::freeCompressedImage(&image);
+                    REQUIRE(image.blocks == nullptr);
+                    if (formats[f] == ae::io::BLOCK_FORMAT_BC1) {
+                        for (uint32_t p : decoded) REQUIRE((p >> 24) == 255);
+                    }
+                    double rmse = blockRmse(pixels, decoded, (formats[f] == ae::io::BLOCK_FORMAT_BC1) ? 3 : 4);
+                    REQUIRE(rmse < limits[f][q]);
+                    // partial blocks repeat their edge pixels, which then count for more than the rest.
+                    if (size[0] % 4 == 0 && size[1] % 4 == 0) REQUIRE(rmse <= previous);
+                    previous = rmse;
+                }
+            }
+        }
+    }
+
+    SECTION("a block of one colour comes back to within the precision of its endpoints") {
+        for (uint32_t i = 0; i < 64; i++) {
+            uint32_t color = 0;
+            for (uint32_t c = 0; c < 32; c += 8) color |= utils::RandomUINT32(0, 255) << c;
+            std::vector<uint32_t> pixels(16, color), decoded(16);
+            ae::compressed_image_t image;
+            REQUIRE(ae::io::compressImage(makeImage(pixels, 4, 4), ae::io::BLOCK_FORMAT_BC7, ae::io::BLOCK_QUALITY_HIGH,
+                &image));
+            REQUIRE(ae::io::decompressImage(image, 0, decoded.data()));
+            ae::io::freeCompressedImage(&image);
+            for (uint32_t c = 0; c < 32; c += 8) {
+                REQUIRE(std::abs(int((decoded[0] >> c) & 0xFF) - int((color >> c) & 0xFF)) <= 1);
+            }
+            REQUIRE(std::adjacent_find(decoded.begin(), decoded.end(), std::not_equal_to<uint32_t>()) == decoded.end());
+
+            // BC1 and BC3 are limited by RGB565 for colour, and alpha is exact in BC3.
+            REQUIRE(ae::io::compressImage(makeImage(pixels, 4, 4), ae::io::BLOCK_FORMAT_BC3,
+                ae::io::BLOCK_QUALITY_NORMAL, &image));
+            REQUIRE(ae::io::decompressImage(image, 0, decoded.data()));
+            ae::io::freeCompressedImage(&image);
+            REQUIRE((decoded[0] >> 24) == (color >> 24));
+            for (uint32_t c = 0; c < 24; c += 8) {
+                REQUIRE(std::abs(int((decoded[0] >> c) & 0xFF) - int((color >> c) & 0xFF)) <= 4);
+            }
+        }
+    }
+
+    SECTION("the decoders follow the formats") {
+        // BC1: red and blue with every index at 2, i.e. a third of the way from red to blue.
+        const uint8_t bc1[8] = {0x00, 0xF8, 0x1F, 0x00, 0xAA, 0xAA, 0xAA, 0xAA};
+        ae::compressed_image_t image = {};
+        image.blocks = (void *)bc1, image.width = 4, image.height = 4, image.levelCount = 1;
+        image.format = ae::io::BLOCK_FORMAT_BC1, image.size = 8;
+        std::vector<uint32_t> decoded(16);
+        REQUIRE(ae::io::decompressImage(image, 0, decoded.data()));
+        REQUIRE(decoded[5] == 0xFF5500AA);
+
+        // BC3: alphas 255 and 0 in the 8 alpha mode, pixel 0 at index 0 and pixel 1 at index 2, i.e. 6/7 of 255.
+        const uint8_t bc3[16] = {0xFF, 0x00, 0x10, 0, 0, 0, 0, 0, 0x00, 0xF8, 0x1F, 0x00, 0, 0, 0, 0};
+        image.blocks = (void *)bc3, image.format = ae::io::BLOCK_FORMAT_BC3, image.size = 16;
+        REQUIRE(ae::io::decompressImage(image, 0, decoded.data()));
+        REQUIRE(decoded[0] == 0xFF0000FF);
+        REQUIRE(decoded[1] == 0xDA0000FF);
+
+        // BC7 blocks in modes other than 6 are not decoded.
+        const uint8_t bc7[16] = {0x01};
+        image.blocks = (void *)bc7, image.format = ae::io::BLOCK_FORMAT_BC7;
+        REQUIRE_FALSE(ae::io::decompressImage(image, 0, decoded.data()));
+    }
+
+    SECTION("every level of a mip chain is compressed") {
+        std::vector<uint32_t> pixels = makePixels(40, 24);
+        ae::mip_chain_t chain;
+        REQUIRE(ae::io::generateMips(makeImage(pixels, 40, 24), &chain));
+        ae::compressed_image_t image;
+        REQUIRE(ae::io::compressMipChain(chain, ae::io::BLOCK_FORMAT_BC7, ae::io::BLOCK_QUALITY_NORMAL, &image));
+        REQUIRE(image.levelCount == chain.levelCount);
+        size_t size = 0;
+        for (uint32_t level = 0; level < chain.levelCount; level++) {
+            uint32_t w = std::max(40u >> level, 1u), h = std::max(24u >> level, 1u);
+            REQUIRE(image.levelOffset[level] == size);
+            size += ae::io::blockCompressedSize(ae::io::BLOCK_FORMAT_BC7, w, h);
+            std::vector<uint32_t> decoded(w * h);
+            REQUIRE(ae::io::decompressImage(image, level, decoded.data()));
+            std::vector<uint32_t> source(chain.pixels + chain.levelOffset[level],
+                chain.pixels + chain.levelOffset[level] + w * h);
+            REQUIRE(blockRmse(source, decoded, 4) < 3.0);
+        }
+        REQUIRE(image.size == size);
+        REQUIRE_FALSE(ae::io::decompressImage(image, chain.levelCount, nullptr));
+        ae::io::freeCompressedImage(&image);
+        ae::io::freeMipChain(&chain);
+    }
+}
+
+TEST_CASE("block compression throughput", "[ae::io][!benchmark]") {
+    utils::Seed(__LINE__);
+    const uint32_t size = 512;
+    std::vector<uint32_t> pixels(size * size);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            pixels[y * size + x] = (x / 4) | ((y / 4) << 8) | (utils::RandomUINT32(0, 63) << 16) | 0xFF000000;
+        }
+    }
+    ae::loaded_image_t image = {};
+    image.pixelPointer = pixels.data(), image.width = size, image.height = size;
+    auto run = [&](ae::io::block_format_t format, ae::io::block_quality_t quality) {
+        ae::compressed_image_t out;
+        ae::io::compressImage(image, format, quality, &out);
+        uint8_t first = *(uint8_t *)out.blocks;
+        ae::io::freeCompressedImage(&out);
+        return first;
+    };
+    BENCHMARK("bc1, fast") { return run(ae::io::BLOCK_FORMAT_BC1, ae::io::BLOCK_QUALITY_FAST); };
+    BENCHMARK("bc1, normal") { return run(ae::io::BLOCK_FORMAT_BC1, ae::io::BLOCK_QUALITY_NORMAL); };
+    BENCHMARK("bc3, normal") { return run(ae::io::BLOCK_FORMAT_BC3, ae::io::BLOCK_QUALITY_NORMAL); };
+    BENCHMARK("bc7, fast") { return run(ae::io::BLOCK_FORMAT_BC7, ae::io::BLOCK_QUALITY_FAST); };
+    BENCHMARK("bc7, normal") { return run(ae::io::BLOCK_FORMAT_BC7, ae::io::BLOCK_QUALITY_NORMAL); };
+    BENCHMARK("bc7, high") { return run(ae::io::BLOCK_FORMAT_BC7, ae::io::BLOCK_QUALITY_HIGH); };
+}
+
+TEST_CASE("lz4 throughput", "[ae::io][!benchmark]") {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + "../../examples/opengl/monkey_demo/res/monke.obj";
+    std::string text;
+    if (FILE *f = fopen(path.c_str(), "rb")) {
+        char buf[4096];
+        for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) text.append(buf, n);
+        fclose(f);
+    }
+    if (text.empty()) {
+        WARN( "could not open " << path );
+        return;
+    }
+    std::vector<uint8_t> packed(ae::io::lz4CompressBound(text.size()));
+    size_t packedSize = ae::io::lz4Compress(text.data(), text.size(), packed.data(), packed.size());
+    std::vector<char> out(text.size());
+    WARN( "monke.obj compresses " << text.size() << " -> " << packedSize );
+    BENCHMARK("compress monke.obj") {
+        return ae::io::lz4Compress(text.data(), text.size(), packed.data(), packed.size());
+    };
+    BENCHMARK("decompress monke.obj") {
+        return ae::io::lz4Decompress(packed.data(), packedSize, out.data(), out.size());
+    };
+}
+
+TEST_CASE("obj loader throughput", "[!benchmark][ae::io]") {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + "../../examples/opengl/monkey_demo/res/monke.obj";
+    std::string text;
+    if (FILE *f = fopen(path.c_str(), "rb")) {
+        char buf[4096];
+        for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) text.append(buf, n);
+        fclose(f);
+    }
+    if (text.empty()) {
+        WARN( "could not open " << path );
+        return;
+    }
+    uint32_t meshSize = 0;
+    ae::raw_model_t model = ae::io::loadObjFromMemory(text.data(), text.size());
+    void *meshFile = ae::io::packMesh(model, &meshSize);
+    ae::io::freeObj(model);
+    BENCHMARK("monke.aemesh") {
+        ae::loaded_mesh_t mesh = ae::io::loadMeshFromMemory(meshFile, meshSize);
+        return mesh.indexCount;
+    };
+    free(meshFile);
+    BENCHMARK("monke.obj") {
+        ae::raw_model_t m = ae::io::loadObjFromMemory(text.data(), text.size());
+        uint32_t count = StretchyBufferCount(m.indexData);
+        ae::io::freeObj(m);
+        return count;
+    };
+    // the parallel path only pays off on big files, so give it a big one.
+    std::string big;
+    for (uint32_t i = 0; i < 64; i++) big += text;
+    BENCHMARK("monke.obj x64") {
+        ae::raw_model_t m = ae::io::loadObjFromMemory(big.data(), big.size());
+        uint32_t count = StretchyBufferCount(m.indexData);
+        ae::io::freeObj(m);
+        return count;
+    };
+    BENCHMARK("monke.obj x64 parallel") {
+        ae::raw_model_t m = ae::io::loadObjFromMemoryParallel(big.data(), big.size());
+        uint32_t count = StretchyBufferCount(m.indexData);
+        ae::io::freeObj(m);
+        return count;
+    };
+}
+
 // TEST_CASE( name, tags )
 TEST_CASE( "Factorials are computed", "[factorial]" ) {
     REQUIRE( Factorial(1) == 1 );
@@ -83,7 +83,7 @@ void MonkeyDemoRender(ae::game_memory_t *gameMemory)
     ae::GL::setUniformMat4f(gameState->gameShader, "uview", buildViewMat(gameState->cam));
     // Do the draw call
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gameState->suzanneIbo.glHandle);
-    glDrawElements(GL_TRIANGLES, gameState->suzanneIbo.count, GL_UNSIGNED_INT, NULL);
+    glDrawElements(GL_TRIANGLES, gameState->suzanneIbo.count, gameState->suzanneIbo.type, NULL);
 }
 
 DllExport void GameClose(ae::game_memory_t *gameMemory)
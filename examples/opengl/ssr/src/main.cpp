@@ -271,7 +271,7 @@ void MonkeyDemoRender(ae::game_memory_t *gameMemory)
     // Do the draw call
     glBindVertexArray(gameState->suzanneVao);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gameState->suzanneIbo.glHandle);
-    glDrawElements(GL_TRIANGLES, gameState->suzanneIbo.count, GL_UNSIGNED_INT, NULL);
+    glDrawElements(GL_TRIANGLES, gameState->suzanneIbo.count, gameState->suzanneIbo.type, NULL);
 
     // draw the cube that's going to do the reflection stuff.
     GL_CALL(glBindVertexArray(gameState->cubeVao));
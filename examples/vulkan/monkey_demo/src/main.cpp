@@ -233,7 +233,7 @@ DllExport void GameInit(ae::game_memory_t *gameMemory)
 
     auto writeUploadBuffer = [&](uint32_t           whichRes,
                                  size_t             resSize,
-                                 void              *resData,
+                                 const void        *resData,
                                  VkBufferUsageFlags usage,
                                  VkBuffer          *buffer,
                                  VkDeviceMemory    *backing) {
@@ -342,15 +342,27 @@ DllExport void GameInit(ae::game_memory_t *gameMemory)
 
     // load the vertex and index buffers to the GPU.
     {
-        gd->suzanne = ae::io::loadObj("res\\monke2.obj");
+        // the .aemesh is mapped and uploaded as is. the first run converts the OBJ and writes it out.
+        gd->suzanne = ae::io::loadMesh("res\\monke2.aemesh");
         if (gd->suzanne.vertexData == nullptr) {
-            EM->setFatalExit();
-            return;
+            ae::raw_model_t obj = ae::io::loadObj("res\\monke2.obj");
+            if (obj.vertexData == nullptr) {
+                EM->setFatalExit();
+                return;
+            }
+            bool bWritten = ae::io::writeMesh("res\\monke2.aemesh", obj);
+            ae::io::freeObj(obj);
+            if (bWritten) gd->suzanne = ae::io::loadMesh("res\\monke2.aemesh");
+            if (gd->suzanne.vertexData == nullptr) {
+                EM->setFatalExit();
+                return;
+            }
         }
 
-        size_t resSize = StretchyBufferCount(gd->suzanne.vertexData) * sizeof(float);
+        size_t resSize = size_t(gd->suzanne.vertexCount) * gd->suzanne.layout.stride;
 
-        gd->suzanneIndexCount = StretchyBufferCount(gd->suzanne.indexData);
+        gd->suzanneIndexCount = gd->suzanne.indexCount;
+        gd->suzanneIndexType  = (gd->suzanne.indexSize == 2) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
 
         writeUploadBuffer(1,
             resSize,
@@ -360,7 +372,7 @@ DllExport void GameInit(ae::game_memory_t *gameMemory)
             &gd->suzanneVboBacking);
 
         // TODO: see if we can make the indices u16.
-        size_t resSize2 = StretchyBufferCount(gd->suzanne.indexData) * sizeof(u32);
+        size_t resSize2 = size_t(gd->suzanne.indexCount) * gd->suzanne.indexSize;
         writeUploadBuffer(2,
             resSize2,
             gd->suzanne.indexData,
@@ -368,7 +380,7 @@ DllExport void GameInit(ae::game_memory_t *gameMemory)
             &gd->suzanneIbo,
             &gd->suzanneIboBacking);
 
-        ae::io::freeObj(gd->suzanne);
+        ae::io::freeMesh(gd->suzanne);
     }
 
     // record the uploads.
@@ -584,7 +596,7 @@ void MonkeyDemoRender(ae::game_memory_t *gameMemory)
                     &verticesOffsetInBuffer);
 
                 VkDeviceSize indicesOffsetInBuffer = 0;
-                vkCmdBindIndexBuffer(cmd, gd->suzanneIbo, indicesOffsetInBuffer, VK_INDEX_TYPE_UINT32);
+                vkCmdBindIndexBuffer(cmd, gd->suzanneIbo, indicesOffsetInBuffer, gd->suzanneIndexType);
 
                 vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, gd->gameShader);
 
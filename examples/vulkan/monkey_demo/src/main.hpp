@@ -5,7 +5,7 @@ void GameUpdateAndRender(ae::game_memory_t *gameMemory);
 void WaitForAndResetFence(VkDevice device, VkFence *pFence, uint64_t waitTime = 1000 * 1000 * 1000);
 
 typedef struct game_state {
-    ae::raw_model_t suzanne;
+    ae::loaded_mesh_t suzanne;
 
     VkPhysicalDevice vkGpu;
     VkDevice         vkDevice;
@@ -51,6 +51,7 @@ typedef struct game_state {
     VkSampler sampler;
 
     uint32_t              suzanneIndexCount;
+    VkIndexType           suzanneIndexType;
     ae::math::transform_t suzanneTransform;
     VkBuffer              suzanneIbo;
     VkDeviceMemory        suzanneIboBacking;